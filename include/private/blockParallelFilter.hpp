@@ -0,0 +1,224 @@
+#ifndef PRIVATE_BLOCKPARALLELFILTER_HPP
+#define PRIVATE_BLOCKPARALLELFILTER_HPP
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include "private/filterWorkspace.hpp"
+namespace
+{
+/// Blocks shorter than this are not worth the threading overhead.
+constexpr int MIN_PARALLEL_BLOCK_SIZE = 16384;
+/// The zero-input response used to fix up a block is computed in chunks of
+/// this many samples until it decays.
+constexpr int FIXUP_CHUNK_SIZE = 512;
+
+/// @brief Determines the number of blocks into which to split a signal.
+/// @param[in] n         The number of samples in the signal.
+/// @param[in] nThreads  The number of threads.
+/// @result The number of blocks.  If this is 1 then the signal should be
+///         filtered sequentially.
+[[maybe_unused]]
+int computeNumberOfFilterBlocks(const int n, const int nThreads)
+{
+    return std::max(1, std::min(nThreads, n/MIN_PARALLEL_BLOCK_SIZE));
+}
+
+/// @brief The scratch space of blockParallelFilter().  This is allocated
+///        when the filter is initialized so that applying a block-parallel
+///        filter does not allocate.
+template<class T>
+class BlockParallelWorkspace
+{
+public:
+    BlockParallelWorkspace() = default;
+    BlockParallelWorkspace(const BlockParallelWorkspace &workspace) = delete;
+    BlockParallelWorkspace&
+        operator=(const BlockParallelWorkspace &workspace) = delete;
+    ~BlockParallelWorkspace()
+    {
+        clear();
+    }
+    /// Releases the workspace.
+    void clear() noexcept
+    {
+        RTSeis::Utilities::FilterImplementations::Workspace::release(mData);
+        mData = nullptr;
+        mBlocks = 0;
+        mStateLength = 0;
+    }
+    /// @brief Allocates the workspace.
+    /// @param[in] nBlocks  The maximum number of blocks.  This must be
+    ///                     positive.
+    /// @param[in] nState   The length of the filter's delay line.  This must
+    ///                     be positive.
+    void allocate(const int nBlocks, const int nState)
+    {
+        namespace Workspace = RTSeis::Utilities::FilterImplementations::Workspace;
+        clear();
+        auto n = (nBlocks + 4)*nState + 2*FIXUP_CHUNK_SIZE;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            mData = Workspace::allocate64f(n);
+        }
+        else
+        {
+            mData = Workspace::allocate32f(n);
+        }
+        std::fill(mData, mData + n, 0);
+        mBlocks = nBlocks;
+        mStateLength = nState;
+    }
+    /// @result The maximum number of blocks.
+    [[nodiscard]] int getNumberOfBlocks() const noexcept
+    {
+        return mBlocks;
+    }
+    /// @result The final delay line of each block filtered from zero state.
+    ///         This has dimension [nBlocks x nState].
+    T *finalStates() noexcept
+    {
+        return mData;
+    }
+    /// @result A zero delay line.  This has dimension [nState].
+    const T *zeroState() noexcept
+    {
+        return mData + static_cast<size_t> (mBlocks)*mStateLength;
+    }
+    /// @result The propagated delay line.  This has dimension [nState].
+    T *state() noexcept
+    {
+        return mData + static_cast<size_t> (mBlocks + 1)*mStateLength;
+    }
+    /// @result The delay line entering a fix-up chunk.  This has dimension
+    ///         [nState].
+    T *dlyIn() noexcept
+    {
+        return mData + static_cast<size_t> (mBlocks + 2)*mStateLength;
+    }
+    /// @result The delay line leaving a fix-up chunk.  This has dimension
+    ///         [nState].
+    T *dlyOut() noexcept
+    {
+        return mData + static_cast<size_t> (mBlocks + 3)*mStateLength;
+    }
+    /// @result A chunk of zeros.  This has dimension [FIXUP_CHUNK_SIZE].
+    const T *zeros() noexcept
+    {
+        return mData + static_cast<size_t> (mBlocks + 4)*mStateLength;
+    }
+    /// @result The zero-input response of a chunk.  This has dimension
+    ///         [FIXUP_CHUNK_SIZE].
+    T *response() noexcept
+    {
+        return mData + static_cast<size_t> (mBlocks + 4)*mStateLength
+             + FIXUP_CHUNK_SIZE;
+    }
+private:
+    T *mData = nullptr;
+    int mBlocks = 0;
+    int mStateLength = 0;
+};
+
+/// @brief Applies a linear recurrence filter, i.e., an IIR or biquad
+///        filter, to a long signal by splitting the signal into blocks.
+///        Each block is filtered concurrently from zero state.  Then, the
+///        true state at the start of each block is propagated sequentially
+///        and the block's transient is fixed by adding the zero-input
+///        response of that state.  Since the filter is linear the result
+///        matches sequential filtering to within rounding.
+/// @param[in] n        The number of samples in the signal.
+/// @param[in] x        The signal to filter.  This has dimension [n].
+/// @param[out] y       The filtered signal.  This has dimension [n].
+/// @param[in] nState   The length of the filter's delay line.
+/// @param[in] zi       The initial delay line.  This has dimension [nState].
+/// @param[out] zf      The final delay line.  This has dimension [nState].
+/// @param[in] nBlocks  The number of blocks.  The filter engine for each block
+///                     must be independent so that the blocks can be
+///                     filtered concurrently.
+/// @param[in,out] workspace  The scratch space.  This must have been
+///                           allocated for at least nBlocks blocks and a
+///                           delay line of length nState.
+/// @param[in] filter   Filters a signal with a given engine, i.e.,
+///                     filter(block, n, x, y, dlyIn, dlyOut) filters x with
+///                     the block'th engine starting from delay line dlyIn
+///                     and returns the final delay line in dlyOut.
+template<class T, class Filter>
+void blockParallelFilter(const int n, const T x[], T y[],
+                         const int nState, const T zi[], T zf[],
+                         const int nBlocks,
+                         BlockParallelWorkspace<T> &workspace,
+                         Filter &&filter)
+{
+    auto blockSize = (n + nBlocks - 1)/nBlocks;
+    T *finalStates = workspace.finalStates();
+    const T *zeroState = workspace.zeroState();
+    // Filter the blocks from zero state.  The first block is exact.
+    #pragma omp parallel for num_threads(nBlocks) schedule(static, 1) \
+     default(none) \
+     shared(x, y, zi, zeroState, finalStates, filter) \
+     firstprivate(n, nBlocks, blockSize, nState)
+    for (int k = 0; k < nBlocks; ++k)
+    {
+        auto i0 = k*blockSize;
+        auto nk = std::min(blockSize, n - i0);
+        if (nk <= 0){continue;}
+        const T *dlyIn = (k == 0) ? zi : zeroState;
+        filter(k, nk, x + i0, y + i0, dlyIn,
+               finalStates + static_cast<size_t> (k)*nState);
+    }
+    // Propagate the true state through the blocks and add each block's
+    // zero-input response.  For a stable filter this response decays so
+    // only the start of each block is revisited.
+    T *state = workspace.state();
+    T *dlyIn = workspace.dlyIn();
+    T *dlyOut = workspace.dlyOut();
+    const T *zeros = workspace.zeros();
+    T *response = workspace.response();
+    std::copy(finalStates, finalStates + nState, state);
+    for (int k = 1; k < nBlocks; ++k)
+    {
+        auto i0 = k*blockSize;
+        auto nk = std::min(blockSize, n - i0);
+        if (nk <= 0){break;}
+        T stateMax = 0;
+        for (int i = 0; i < nState; ++i)
+        {
+            stateMax = std::max(stateMax, std::abs(state[i]));
+        }
+        auto tolerance = std::numeric_limits<T>::epsilon()*stateMax;
+        std::copy(state, state + nState, dlyIn);
+        std::fill(dlyOut, dlyOut + nState, 0);
+        for (int j = 0; j < nk && stateMax > 0; j = j + FIXUP_CHUNK_SIZE)
+        {
+            auto nChunk = std::min(FIXUP_CHUNK_SIZE, nk - j);
+            filter(0, nChunk, zeros, response, dlyIn, dlyOut);
+            for (int i = 0; i < nChunk; ++i)
+            {
+                y[i0 + j + i] = y[i0 + j + i] + response[i];
+            }
+            // Once the state has decayed the rest of the response is
+            // below rounding
+            T dlyMax = 0;
+            for (int i = 0; i < nState; ++i)
+            {
+                dlyMax = std::max(dlyMax, std::abs(dlyOut[i]));
+            }
+            if (dlyMax <= tolerance)
+            {
+                std::fill(dlyOut, dlyOut + nState, 0);
+                break;
+            }
+            std::copy(dlyOut, dlyOut + nState, dlyIn);
+        }
+        // The state at the end of this block
+        auto finalState = finalStates + static_cast<size_t> (k)*nState;
+        for (int i = 0; i < nState; ++i)
+        {
+            state[i] = finalState[i] + dlyOut[i];
+        }
+    }
+    std::copy(state, state + nState, zf);
+}
+}
+#endif
@@ -0,0 +1,126 @@
+#ifndef PRIVATE_CHANNELBLOCKS_HPP
+#define PRIVATE_CHANNELBLOCKS_HPP
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <ipps.h>
+#include "private/pad.hpp"
+namespace
+{
+/// The number of channels processed together by the multi-channel
+/// characteristic functions.  This spans several SIMD registers and the
+/// state for a block of channels stays in the L1 cache.
+constexpr int CHANNEL_BLOCK_SIZE = 64;
+
+/// @brief Calls kernel(c0, nc) for each block of at most CHANNEL_BLOCK_SIZE
+///        channels.  The kernel runs every sample through channels
+///        [c0, c0 + nc) of the channel-interleaved signals.
+/// @param[in] nChannels  The number of channels.
+/// @param[in] kernel     The block kernel.
+template<class F>
+void forEachChannelBlock(const int nChannels, F &&kernel)
+{
+    for (int c0=0; c0<nChannels; c0=c0+CHANNEL_BLOCK_SIZE)
+    {
+        kernel(c0, std::min(CHANNEL_BLOCK_SIZE, nChannels - c0));
+    }
+}
+
+/// @brief The per-channel state of a multi-channel characteristic function.
+///        This is a row major matrix of dimension
+///        [nRows x getLeadingDimension()] whose rows, e.g., running sums or
+///        delay lines, each begin on a 64 byte boundary.  Rows narrower than
+///        64 bytes are instead packed densely so that, e.g., a single-channel
+///        ring buffer does not occupy a cache line per sample.
+template<class U>
+class ChannelState
+{
+public:
+    /// Default constructor
+    ChannelState() = default;
+    /// Copy constructor
+    ChannelState(const ChannelState &state)
+    {
+        *this = state;
+    }
+    /// (Deep) copy operator
+    ChannelState& operator=(const ChannelState &state)
+    {
+        if (&state == this){return *this;}
+        clear();
+        if (state.mData == nullptr){return *this;}
+        allocate(state.mRows, state.mChannels);
+        std::memcpy(mData, state.mData, getSizeInBytes());
+        return *this;
+    }
+    /// Destructor
+    ~ChannelState()
+    {
+        clear();
+    }
+    /// Releases memory
+    void clear() noexcept
+    {
+        if (mData != nullptr){ippsFree(mData);}
+        mData = nullptr;
+        mRows = 0;
+        mChannels = 0;
+        mLeadingDimension = 0;
+    }
+    /// @brief Allocates nRows rows of state for nChannels and zeros them.
+    /// @throws std::invalid_argument if the state is too large.
+    void allocate(const int nRows, const int nChannels)
+    {
+        clear();
+        auto leadingDimension = nChannels;
+        if (sizeof(U)*static_cast<size_t> (nChannels) >= 64)
+        {
+            leadingDimension = padLength(nChannels, sizeof(U), 64);
+        }
+        auto nBytes = sizeof(U)*static_cast<size_t> (nRows)
+                     *static_cast<size_t> (leadingDimension);
+        if (nBytes > static_cast<size_t> (std::numeric_limits<int>::max()))
+        {
+            throw std::invalid_argument("Too many channels or rows");
+        }
+        mData = reinterpret_cast<U *> (ippsMalloc_8u(static_cast<int> (nBytes)));
+        mRows = nRows;
+        mChannels = nChannels;
+        mLeadingDimension = leadingDimension;
+        zero();
+    }
+    /// Sets every row to zero
+    void zero() noexcept
+    {
+        if (mData != nullptr){std::memset(mData, 0, getSizeInBytes());}
+    }
+    /// @result A pointer to the ir'th row.
+    U *row(const int ir) noexcept
+    {
+        return mData + static_cast<size_t> (ir)*mLeadingDimension;
+    }
+    /// @result A pointer to the ir'th row.
+    const U *row(const int ir) const noexcept
+    {
+        return mData + static_cast<size_t> (ir)*mLeadingDimension;
+    }
+    /// @result The padded row length.
+    [[nodiscard]] int getLeadingDimension() const noexcept
+    {
+        return mLeadingDimension;
+    }
+    /// @result The size of the state in bytes.
+    [[nodiscard]] size_t getSizeInBytes() const noexcept
+    {
+        return sizeof(U)*static_cast<size_t> (mRows)
+              *static_cast<size_t> (mLeadingDimension);
+    }
+private:
+    U *mData = nullptr;
+    int mRows = 0;
+    int mChannels = 0;
+    int mLeadingDimension = 0;
+};
+}
+#endif
@@ -0,0 +1,34 @@
+#ifndef RTSEIS_PRIVATE_CONVOLUTIONWISDOM_HPP
+#define RTSEIS_PRIVATE_CONVOLUTIONWISDOM_HPP
+#include <functional>
+#include "rtseis/utilities/math/convolutionWisdom.hpp"
+
+namespace RTSeis::Utilities::Math::ConvolutionWisdom
+{
+/*!
+ * @brief Rounds a number of taps or block length to the length used in the
+ *        wisdom key.  All lengths in a bucket share an entry.
+ * @param[in] n  The number of taps or block length.
+ * @result The smallest power of 2 that is at least n.
+ */
+[[nodiscard]] int roundLength(int n) noexcept;
+/*!
+ * @brief Looks up the faster algorithm for the given key.  If there is no
+ *        entry then each algorithm is timed with the trial function and
+ *        the winner is added to the wisdom.
+ * @param[in] operation    The operation.
+ * @param[in] nTaps        The number of filter taps.
+ * @param[in] blockLength  The block length.
+ * @param[in] precision    The precision of the computation.
+ * @param[in] trial        Runs the operation with the given algorithm.
+ *                         This should be representative of the work that
+ *                         will be done in production.
+ * @param[in] mode         The processing mode.
+ * @result The faster algorithm for this key.
+ */
+Algorithm tune(Operation operation, int nTaps, int blockLength,
+               RTSeis::Precision precision,
+               const std::function<void (Algorithm)> &trial,
+               RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST);
+}
+#endif
@@ -0,0 +1,68 @@
+#ifndef RTSEIS_PRIVATE_DFTPLANCACHE_HPP
+#define RTSEIS_PRIVATE_DFTPLANCACHE_HPP
+#include <memory>
+#include <ipps.h>
+#include "rtseis/enums.hpp"
+#include "rtseis/utilities/transforms/dftPlanCache.hpp"
+
+namespace RTSeis::Utilities::Transforms::DFTPlanCache
+{
+/*!
+ * @brief Defines the input of the transform.
+ */
+enum class Domain
+{
+    REAL = 0,   /*!< Real-to-complex (CCS) transforms. */
+    COMPLEX = 1 /*!< Complex-to-complex transforms. */
+};
+/*!
+ * @brief An initialized IPP FFT or DFT specification.  IPP only reads the
+ *        specification during a transform so a plan may be used by many
+ *        transforms at once provided each has its own work buffer.
+ */
+class Plan
+{
+public:
+    Plan() = default;
+    Plan(const Plan &plan) = delete;
+    Plan& operator=(const Plan &plan) = delete;
+    ~Plan()
+    {
+        if (mMemory != nullptr){ippsFree(mMemory);}
+    }
+    /// @result The specification, e.g., IppsFFTSpec_R_64f.
+    template<class S> const S *getSpecification() const noexcept
+    {
+        return static_cast<const S *> (mSpec);
+    }
+    /// @result The size in bytes of the work buffer required by a transform.
+    [[nodiscard]] int getBufferSize() const noexcept
+    {
+        return mBufferSize;
+    }
+//private:
+    /// The memory holding the specification.
+    Ipp8u *mMemory = nullptr;
+    /// The specification.  For the FFT this may be offset from mMemory.
+    void *mSpec = nullptr;
+    /// The size of the work buffer.
+    int mBufferSize = 0;
+};
+/*!
+ * @brief Gets a plan from the cache.  If there is no plan for this key then
+ *        one is created and added to the cache.
+ * @param[in] domain         Real or complex input.
+ * @param[in] length         The transform length.  For the FFT this must be
+ *                           a power of 2.
+ * @param[in] ldoFFT         If true then this is an FFT plan.  Otherwise,
+ *                           this is a DFT plan.
+ * @param[in] precision      The precision of the transform.
+ * @param[in] normalization  The IPP normalization flag, e.g.,
+ *                           IPP_FFT_DIV_INV_BY_N.
+ * @result The plan.  This is NULL if the plan could not be created.
+ */
+std::shared_ptr<const Plan> getPlan(Domain domain, int length, bool ldoFFT,
+                                    RTSeis::Precision precision,
+                                    int normalization = IPP_FFT_DIV_INV_BY_N);
+}
+#endif
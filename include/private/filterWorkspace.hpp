@@ -0,0 +1,44 @@
+#ifndef RTSEIS_PRIVATE_FILTERWORKSPACE_HPP
+#define RTSEIS_PRIVATE_FILTERWORKSPACE_HPP
+#include <cstdint>
+#include <ipps.h>
+
+/*!
+ * @brief The filter implementations obtain their taps, delay lines, and
+ *        IPP workspaces from these functions rather than calling ippsMalloc
+ *        directly.  Since every allocation passes through one place, the
+ *        tests can verify that applying a filter does not allocate.
+ */
+namespace RTSeis::Utilities::FilterImplementations::Workspace
+{
+/*!
+ * @brief Allocates an aligned array of doubles.
+ * @param[in] n  The number of elements.  This must be positive.
+ * @result The array.  This must be released with \c release().
+ */
+Ipp64f *allocate64f(int n);
+/*!
+ * @brief Allocates an aligned array of floats.
+ * @param[in] n  The number of elements.  This must be positive.
+ * @result The array.  This must be released with \c release().
+ */
+Ipp32f *allocate32f(int n);
+/*!
+ * @brief Allocates an aligned array of bytes.
+ * @param[in] n  The number of bytes.  This must be positive.
+ * @result The array.  This must be released with \c release().
+ */
+Ipp8u *allocate8u(int n);
+/*!
+ * @brief Releases an array obtained from one of the allocate functions.
+ * @param[in] p  The array to release.  This may be NULL.
+ */
+void release(void *p) noexcept;
+/*!
+ * @result The number of arrays allocated by this process so far.
+ * @note This is a test hook.  Compare the count before and after a call
+ *       to determine whether the call allocated.
+ */
+int64_t getNumberOfAllocations() noexcept;
+}
+#endif
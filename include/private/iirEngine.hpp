@@ -0,0 +1,110 @@
+#ifndef PRIVATE_IIRENGINE_HPP
+#define PRIVATE_IIRENGINE_HPP
+#include <type_traits>
+#include <ipps.h>
+#include "private/filterWorkspace.hpp"
+namespace
+{
+namespace FilterWorkspace = RTSeis::Utilities::FilterImplementations::Workspace;
+/// @brief An IPP direct form or biquad IIR filter state.  Since the delay
+///        line is set before and extracted after each application, several
+///        engines can filter different parts of a signal concurrently.
+template<class T>
+class IIREngine
+{
+public:
+    IIREngine() = default;
+    IIREngine(const IIREngine &engine) = delete;
+    IIREngine& operator=(const IIREngine &engine) = delete;
+    ~IIREngine()
+    {
+        clear();
+    }
+    /// Releases the state.
+    void clear() noexcept
+    {
+        FilterWorkspace::release(mBuffer);
+        mBuffer = nullptr;
+        mState = nullptr;
+    }
+    /// @brief Initializes a direct form filter.
+    /// @param[in] taps   The numerator then denominator coefficients.  This
+    ///                   has dimension [2*(order+1)].
+    /// @param[in] order  The filter order.  This must be positive.
+    /// @result 0 indicates success.
+    int initialize(const T *taps, const int order)
+    {
+        clear();
+        int bufferSize = 0;
+        IppStatus status;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            status = ippsIIRGetStateSize_64f(order, &bufferSize);
+            if (status != ippStsNoErr){return -1;}
+            mBuffer = FilterWorkspace::allocate8u(bufferSize);
+            status = ippsIIRInit_64f(&mState, taps, order, nullptr, mBuffer);
+        }
+        else
+        {
+            status = ippsIIRGetStateSize_32f(order, &bufferSize);
+            if (status != ippStsNoErr){return -1;}
+            mBuffer = FilterWorkspace::allocate8u(bufferSize);
+            status = ippsIIRInit_32f(&mState, taps, order, nullptr, mBuffer);
+        }
+        if (status != ippStsNoErr){return -1;}
+        return 0;
+    }
+    /// @brief Initializes a cascade of biquad filters.
+    /// @param[in] taps  The b0, b1, b2, a0, a1, a2 coefficients of each
+    ///                  section.  This has dimension [6*ns].
+    /// @param[in] ns    The number of sections.  This must be positive.
+    /// @result 0 indicates success.
+    int initializeBiQuad(const T *taps, const int ns)
+    {
+        clear();
+        int bufferSize = 0;
+        IppStatus status;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            status = ippsIIRGetStateSize_BiQuad_64f(ns, &bufferSize);
+            if (status != ippStsNoErr){return -1;}
+            mBuffer = FilterWorkspace::allocate8u(bufferSize);
+            status = ippsIIRInit_BiQuad_64f(&mState, taps, ns,
+                                            nullptr, mBuffer);
+        }
+        else
+        {
+            status = ippsIIRGetStateSize_BiQuad_32f(ns, &bufferSize);
+            if (status != ippStsNoErr){return -1;}
+            mBuffer = FilterWorkspace::allocate8u(bufferSize);
+            status = ippsIIRInit_BiQuad_32f(&mState, taps, ns,
+                                            nullptr, mBuffer);
+        }
+        if (status != ippStsNoErr){return -1;}
+        return 0;
+    }
+    /// Filters x starting from the delay line dlyIn.
+    void apply(const int n, const T x[], T y[],
+               const T dlyIn[], T dlyOut[])
+    {
+        if constexpr (std::is_same<T, double>::value)
+        {
+            ippsIIRSetDlyLine_64f(mState, dlyIn);
+            ippsIIR_64f(x, y, n, mState);
+            ippsIIRGetDlyLine_64f(mState, dlyOut);
+        }
+        else
+        {
+            ippsIIRSetDlyLine_32f(mState, dlyIn);
+            ippsIIR_32f(x, y, n, mState);
+            ippsIIRGetDlyLine_32f(mState, dlyOut);
+        }
+    }
+private:
+    typename std::conditional<std::is_same<T, double>::value,
+                              IppsIIRState_64f, IppsIIRState_32f>::type
+        *mState = nullptr;
+    Ipp8u *mBuffer = nullptr;
+};
+}
+#endif
@@ -0,0 +1,61 @@
+#ifndef PRIVATE_IIRKURTOSIS_HPP
+#define PRIVATE_IIRKURTOSIS_HPP
+#include <cmath>
+namespace
+{
+/// @brief The constants in the recursive kurtosis estimate of
+///        Chassande-Mottin.
+template<class T>
+struct IIRKurtosisCoefficients
+{
+    /// @param[in] pole  The pole, c1, in the IIR moving average.
+    explicit IIRKurtosisCoefficients(const T pole) :
+        c1(pole),
+        a1(static_cast<T> (1) - pole),
+        c2(static_cast<T> (0.5)*(static_cast<T> (1) - a1*a1)),
+        onePlusC1(static_cast<T> (1) + pole),
+        twoC1(static_cast<T> (2)*pole),
+        bias(-3.0*pole - 3.0)
+    {
+    }
+    T c1;
+    T a1;
+    T c2;
+    T onePlusC1;
+    T twoC1;
+    /// Note, this is computed in double precision.
+    double bias;
+};
+
+/// @brief Advances the recursive kurtosis estimate by one sample.  The
+///        scalar and multi-channel implementations share this so that their
+///        results are bitwise identical.
+/// @param[in] k          The filter constants.
+/// @param[in] x          The new sample.
+/// @param[in,out] mu1    The mean of the first order moment.
+/// @param[in,out] mu2    The mean of the second order moment.
+/// @param[in,out] k4bar  The unbiased kurtosis.
+/// @result The kurtosis at this sample.
+template<class T>
+inline T iirKurtosisUpdate(const IIRKurtosisCoefficients<T> &k,
+                           const T x, T &mu1, T &mu2, T &k4bar) noexcept
+{
+    auto mu1New = k.a1*mu1 + k.c1*x; // Update IIR averaging
+    auto dx  = x - mu1;
+    auto dx2 = dx*dx;
+    auto mu2New = k.a1*mu2 + k.c2*dx2;  // Update IIR averaging
+    dx2 = dx2/mu2;
+    // onePlusC1 - twoC1*dx2
+    auto xscal = std::fma(-k.twoC1, dx2, k.onePlusC1);
+    auto dx22 = dx2*dx2;
+    auto c1dx22 = k.c1*dx22 + k.bias;
+    // xscal*k4bar + c1*dx22 + bias
+    auto y = static_cast<T> (std::fma(xscal, k4bar, c1dx22));
+    // Update delay lines
+    mu1 = mu1New;
+    mu2 = mu2New;
+    k4bar = y;
+    return y;
+}
+}
+#endif
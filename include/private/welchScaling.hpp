@@ -0,0 +1,18 @@
+#ifndef RTSEIS_PRIVATE_WELCHSCALING_HPP
+#define RTSEIS_PRIVATE_WELCHSCALING_HPP
+#include <ipps.h>
+namespace RTSeis::Utilities::Transforms::WelchScaling
+{
+/// @brief Computes the normalization of a Welch power spectral density.
+/// @param[in] npts    The number of samples in the window.
+/// @param[in] window  The window.  This is an array of dimension [npts].
+/// @result The squared sum of the window samples.
+inline double computeDensityScaling(const int npts, const double window[])
+{
+    double wsum;
+    ippsSum_64f(window, npts, &wsum);
+    wsum = wsum*wsum;
+    return wsum;
+}
+}
+#endif
@@ -703,6 +703,21 @@ public:
      */
     double getNyquistFrequency() const noexcept;
     /*! @} */
+
+    /*!
+     * @brief Sets the number of threads used by the IIR and second order
+     *        section filters.
+     * @param[in] nThreads  The number of threads.  Long signals are split
+     *                      into blocks that are filtered concurrently.
+     *                      By default this is 1.
+     * @throws std::invalid_argument if nThreads is not positive.
+     */
+    void setNumberOfThreads(int nThreads);
+    /*!
+     * @result The number of threads used by the IIR and second order
+     *         section filters.
+     */
+    [[nodiscard]] int getNumberOfThreads() const noexcept;
 private:
     class WaveformImpl;
     std::unique_ptr<WaveformImpl> pImpl;
@@ -0,0 +1,182 @@
+#ifndef RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_CHARACTERISTICFUNCTIONBANK_HPP
+#define RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_CHARACTERISTICFUNCTIONBANK_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+#include "rtseis/utilities/characteristicFunction/enums.hpp"
+
+namespace RTSeis::Utilities::CharacteristicFunction
+{
+/*!
+ * @class CharacteristicFunctionBank characteristicFunctionBank.hpp "include/rtseis/utilities/characteristicFunction/characteristicFunctionBank.hpp"
+ * @brief Computes a chosen subset of characteristic functions of the same
+ *        signal block-interleaved, i.e., every enabled characteristic
+ *        function consumes a block of the signal before the next block.
+ * @note The packet is processed in blocks small enough that the input block
+ *       and the outputs remain in the L1 cache while every enabled
+ *       characteristic function consumes the block.  Hence, the input is
+ *       read from memory once regardless of how many characteristic
+ *       functions are computed.  Each characteristic function carries its
+ *       state across blocks and calls to \c apply() as in real-time
+ *       processing so a packet's results do not depend on how it is split.
+ *       The outputs are those of the real-time variants of
+ *       \c MultiChannelClassicSTALTA (which matches \c ClassicSTALTA to within
+ *       roundoff), \c RecursiveSTALTA, \c IIRKurtosis, and
+ *       \c Transforms::FIREnvelope.
+ * @copyright Ben Baker (University of Utah) distributed under the MIT license.
+ * @ingroup rtseis_utils_characteristicFunction
+ */
+template<class T = double>
+class CharacteristicFunctionBank
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    CharacteristicFunctionBank();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] bank  The characteristic function bank from which to
+     *                  initialize this class.
+     */
+    CharacteristicFunctionBank(const CharacteristicFunctionBank &bank);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] bank  The characteristic function bank from which to
+     *                      initialize this class.  On exit, bank's behavior
+     *                      is undefined.
+     */
+    CharacteristicFunctionBank(CharacteristicFunctionBank &&bank) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] bank  The characteristic function bank to copy to this.
+     * @result A deep copy of bank.
+     */
+    CharacteristicFunctionBank& operator=(const CharacteristicFunctionBank &bank);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] bank  The characteristic function bank whose memory
+     *                      will be moved to this.  On exit, bank's behavior
+     *                      is undefined.
+     * @result The memory from bank moved to this.
+     */
+    CharacteristicFunctionBank&
+        operator=(CharacteristicFunctionBank &&bank) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~CharacteristicFunctionBank();
+    /*!
+     * @brief Disables all characteristic functions and releases memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Characteristic Functions
+     * @{
+     */
+    /*!
+     * @brief Enables the classic STA/LTA.
+     * @param[in] nSTA  The number of samples in the short-term average window.
+     *                  This must be at least 2.
+     * @param[in] nLTA  The number of samples in the long-term average window.
+     *                  This must be at least nSTA.
+     * @throws std::invalid_argument if nSTA or nLTA is invalid.
+     * @sa \c ClassicSTALTA
+     */
+    void enableClassicSTALTA(int nSTA, int nLTA);
+    /*!
+     * @brief Enables the recursive STA/LTA.
+     * @param[in] nSTA  The characteristic length of the short-term average
+     *                  in samples.  This must be at least 2.
+     * @param[in] nLTA  The characteristic length of the long-term average
+     *                  in samples.  This must be at least nSTA.
+     * @throws std::invalid_argument if nSTA or nLTA is invalid.
+     * @sa \c RecursiveSTALTA
+     */
+    void enableRecursiveSTALTA(int nSTA, int nLTA);
+    /*!
+     * @brief Enables the IIR kurtosis.
+     * @param[in] c1  The pole in the IIR moving average.  This must satisfy
+     *                \f$ |c_1| < 1 \f$.
+     * @throws std::invalid_argument if c1 is invalid.
+     * @sa \c IIRKurtosis
+     */
+    void enableIIRKurtosis(T c1);
+    /*!
+     * @brief Enables the FIR envelope.
+     * @param[in] nTaps  The number of taps in the FIR Hilbert transformer.
+     *                   This must be positive.
+     * @throws std::invalid_argument if nTaps is not positive.
+     * @sa \c Transforms::FIREnvelope
+     */
+    void enableFIREnvelope(int nTaps);
+    /*!
+     * @brief Disables a characteristic function.
+     * @param[in] type  The characteristic function to disable.
+     */
+    void disable(CharacteristicFunctionType type) noexcept;
+    /*!
+     * @brief Determines if a characteristic function is enabled.
+     * @param[in] type  The characteristic function.
+     * @retval True indicates that this characteristic function is computed.
+     */
+    [[nodiscard]] bool isEnabled(CharacteristicFunctionType type) const noexcept;
+    /*!
+     * @brief Gets the number of enabled characteristic functions.
+     * @result The number of characteristic functions computed by
+     *         \c apply().
+     */
+    [[nodiscard]] int getNumberOfCharacteristicFunctions() const noexcept;
+    /*!
+     * @brief Gets the index of the output buffer of an enabled
+     *        characteristic function.  The enabled characteristic functions
+     *        are ordered as in \c CharacteristicFunctionType.
+     * @param[in] type  The characteristic function.
+     * @result The index of the output buffer in \c apply().
+     * @throws std::invalid_argument if this characteristic function is not
+     *         enabled.
+     */
+    [[nodiscard]] int getOutputIndex(CharacteristicFunctionType type) const;
+    /*! @} */
+
+    /*!
+     * @brief Restores the initial conditions of all enabled characteristic
+     *        functions.  This is useful after a gap or before processing a
+     *        new signal.
+     */
+    void resetInitialConditions();
+    /*!
+     * @brief Computes the enabled characteristic functions.
+     * @param[in] nSamples  The number of samples in the signal.
+     * @param[in] x         The signal.  This is an array of dimension
+     *                      [nSamples].
+     * @param[out] y        The output buffers.  y[k] is the k'th enabled
+     *                      characteristic function, see
+     *                      \c getOutputIndex(), and is an array of
+     *                      dimension [nSamples].  This has dimension
+     *                      [\c getNumberOfCharacteristicFunctions()].
+     * @throws std::invalid_argument if nSamples is positive and x, y, or
+     *         any of the output buffers are NULL.
+     * @throws std::runtime_error if nSamples is positive and no
+     *         characteristic functions are enabled.
+     */
+    void apply(int nSamples, const T x[], T *y[]);
+private:
+    class CharacteristicFunctionBankImpl;
+    std::unique_ptr<CharacteristicFunctionBankImpl> pImpl;
+};
+}
+#endif
@@ -0,0 +1,19 @@
+#ifndef RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_ENUMS_HPP
+#define RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_ENUMS_HPP 1
+
+namespace RTSeis::Utilities::CharacteristicFunction
+{
+/*!
+ * @brief Defines the characteristic functions that can be computed by
+ *        the characteristic function bank.
+ */
+enum class CharacteristicFunctionType
+{
+    CLASSIC_STALTA = 0,   /*!< The classic (boxcar) STA/LTA. */
+    RECURSIVE_STALTA = 1, /*!< The recursive (exponential) STA/LTA. */
+    IIR_KURTOSIS = 2,     /*!< The recursive estimate of the kurtosis. */
+    FIR_ENVELOPE = 3      /*!< The envelope computed with an FIR Hilbert
+                               transformer. */
+};
+}
+#endif
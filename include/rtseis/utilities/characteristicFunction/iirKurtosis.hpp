@@ -1,7 +1,7 @@
 #ifndef RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_IIRKURTOSIS_HPP
 #define RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_IIRKURTOSIS_HPP
 #include <memory>
-#include "rtseis/enums.h"
+#include "rtseis/enums.hpp"
 
 namespace RTSeis::Utilities::CharacteristicFunction
 {
@@ -0,0 +1,158 @@
+#ifndef RTSEIS_UTILITIES_CHARATERISTICFUNCTION_MULTICHANNELCLASSICSTALTA_HPP
+#define RTSEIS_UTILITIES_CHARATERISTICFUNCTION_MULTICHANNELCLASSICSTALTA_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+
+namespace RTSeis::Utilities::CharacteristicFunction
+{
+/*!
+ * @class MultiChannelClassicSTALTA multiChannelClassicSTALTA.hpp "include/rtseis/utilities/characteristicFunction/multiChannelClassicSTALTA.hpp"
+ * @brief Computes the classic short-term-average to long-term-average
+ *        (STA/LTA)
+ *        \f[
+ *          y[n] = \frac{ \frac{1}{N_{sta}} \sum_{i=0}^{N_{sta}-1} x[n-i]^2 }
+ *                      { \frac{1}{N_{lta}} \sum_{i=0}^{N_{lta}-1} x[n-i]^2 }
+ *        \f]
+ *        on many channels at once.  The startup convention is the same as
+ *        \c ClassicSTALTA, i.e., the short-term window is primed with zeros
+ *        and the long-term window with a very large number so that the
+ *        characteristic function is effectively zero until the long-term
+ *        window is full.
+ * @note Rather than two boxcar FIR filters per channel, the short-term and
+ *       long-term sums are updated recursively by adding the newest squared
+ *       sample and removing the oldest.  The sums are accumulated in double
+ *       precision and, to bound the roundoff drift, they are recomputed
+ *       exactly from the squared samples every few passes through the
+ *       long-term window.  The squared samples and the running sums for all
+ *       channels are kept in one contiguous, structure-of-arrays arena so
+ *       that each update is vectorized across channels.  Consequently, the
+ *       signals are expected in a channel-interleaved layout, i.e., a row
+ *       major matrix of dimension [nSamples x nChannels].
+ * @copyright Ben Baker (University of Utah) distributed under the MIT license.
+ * @ingroup rtseis_utils_characteristicFunction
+ */
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class MultiChannelClassicSTALTA
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    MultiChannelClassicSTALTA();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] stalta  The multi-channel STA/LTA class from which to
+     *                    initialize this class.
+     */
+    MultiChannelClassicSTALTA(const MultiChannelClassicSTALTA &stalta);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] stalta  The multi-channel STA/LTA class from which to
+     *                        initialize this class.  On exit, stalta's
+     *                        behavior is undefined.
+     */
+    MultiChannelClassicSTALTA(MultiChannelClassicSTALTA &&stalta) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] stalta  The multi-channel STA/LTA class to copy to this.
+     * @result A deep copy of stalta.
+     */
+    MultiChannelClassicSTALTA&
+        operator=(const MultiChannelClassicSTALTA &stalta);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] stalta  The multi-channel STA/LTA class whose memory
+     *                        will be moved to this.  On exit, stalta's
+     *                        behavior is undefined.
+     * @result The memory from stalta moved to this.
+     */
+    MultiChannelClassicSTALTA&
+        operator=(MultiChannelClassicSTALTA &&stalta) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~MultiChannelClassicSTALTA();
+    /*!
+     * @brief Resets the class and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the multi-channel classic STA/LTA.
+     * @param[in] nChannels  The number of channels.  This must be positive.
+     * @param[in] nSTA       The number of samples in the short-term average
+     *                       window.  This must be at least 2.
+     * @param[in] nLTA       The number of samples in the long-term average
+     *                       window.  This must be at least nSTA.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(int nChannels, int nSTA, int nLTA);
+    /*!
+     * @brief Determines if the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the number of channels.
+     * @result The number of channels processed simultaneously.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfChannels() const;
+    /*!
+     * @brief Gets the short-term average window length.
+     * @result The number of samples in the short-term average window.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getShortTermWindowLength() const;
+    /*!
+     * @brief Gets the long-term average window length.
+     * @result The number of samples in the long-term average window.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getLongTermWindowLength() const;
+    /*!
+     * @brief Restores the default initial conditions on all channels.
+     *        This is useful after a gap in real-time processing.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+    /*!
+     * @brief Applies the STA/LTA to all channels.
+     * @param[in] nSamples  The number of samples in each channel.
+     * @param[in] x         The channel-interleaved signals.  This is a row
+     *                      major matrix of dimension [nSamples x nChannels],
+     *                      i.e., x[i*nChannels + c] is the i'th sample of the
+     *                      c'th channel.
+     * @param[out] y        The channel-interleaved STA/LTA characteristic
+     *                      functions.  This has the same layout as x.
+     *                      Where the long-term sum is within the roundoff
+     *                      drift of zero, e.g., the long-term window is all
+     *                      zeros, the characteristic function is set to 0.
+     * @throws std::invalid_argument if nSamples is positive and x or y is
+     *         NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     * @note In post-processing every application starts from the default
+     *       initial conditions.
+     */
+    void apply(int nSamples, const T x[], T *y[]);
+private:
+    class MultiChannelClassicSTALTAImpl;
+    std::unique_ptr<MultiChannelClassicSTALTAImpl> pImpl;
+};
+}
+#endif
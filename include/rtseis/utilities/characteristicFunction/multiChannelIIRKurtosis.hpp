@@ -0,0 +1,149 @@
+#ifndef RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_MULTICHANNELIIRKURTOSIS_HPP
+#define RTSEIS_UTILITIES_CHARACTERISTICFUNCTION_MULTICHANNELIIRKURTOSIS_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+
+namespace RTSeis::Utilities::CharacteristicFunction
+{
+/*!
+ * @class MultiChannelIIRKurtosis multiChannelIIRKurtosis.hpp "include/rtseis/utilities/characteristicFunction/multiChannelIIRKurtosis.hpp"
+ * @brief Computes the recursive (IIR) estimate of the kurtosis on many
+ *        channels at once.
+ * @note The recursion is serial in time but independent across channels.
+ *       Hence, the delay lines are stored in a structure-of-arrays layout so
+ *       that the recursion is vectorized across channels, i.e., one channel
+ *       per SIMD lane.  Consequently, the signals are expected in a
+ *       channel-interleaved layout, i.e., a row major matrix of dimension
+ *       [nSamples x nChannels].  The per-sample arithmetic is identical to
+ *       that of \c IIRKurtosis so each channel's result is bitwise identical
+ *       to the single-channel result.
+ * @copyright Ben Baker (University of Utah) distributed under the MIT license.
+ * @note For more details see: Testing the normality of gravitational wave
+ *       data with a low cost recursive estimate of the kurtosis -
+ *       E Chassande-Mottin.
+ */
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class MultiChannelIIRKurtosis
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    MultiChannelIIRKurtosis();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] kurtosis  The multi-channel IIR kurtosis class from which
+     *                      to initialize this class.
+     */
+    MultiChannelIIRKurtosis(const MultiChannelIIRKurtosis &kurtosis);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] kurtosis  The multi-channel IIR kurtosis class from
+     *                          which to initialize this class.  On exit,
+     *                          kurtosis's behavior is undefined.
+     */
+    MultiChannelIIRKurtosis(MultiChannelIIRKurtosis &&kurtosis) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] kurtosis  The class to copy to this.
+     * @result A deep copy of kurtosis.
+     */
+    MultiChannelIIRKurtosis& operator=(const MultiChannelIIRKurtosis &kurtosis);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] kurtosis  The class whose memory will be moved to this.
+     *                          On exit, kurtosis's behavior is undefined.
+     * @result The memory from kurtosis moved to this.
+     */
+    MultiChannelIIRKurtosis&
+        operator=(MultiChannelIIRKurtosis &&kurtosis) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~MultiChannelIIRKurtosis();
+    /*!
+     * @brief Resets the class and releases memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the multi-channel IIR kurtosis filter.
+     * @param[in] nChannels  The number of channels.  This must be positive.
+     * @param[in] c1         This is the pole in the IIR moving average.  For
+     *                       stability it is required that \f$ |c_1| < 1 \f$.
+     *                       One strategy is to set
+     *                       \f$ c_1 = \frac{\Delta T}{W} \f$ where
+     *                       \f$ \Delta T \f$ is the sampling period and
+     *                       \f$ W \f$ is the window length.
+     * @throws std::invalid_argument if nChannels is not positive or
+     *         \f$ |c_1| \ge 1 \f$.
+     */
+    void initialize(int nChannels, T c1);
+    /*!
+     * @brief Determines if the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the number of channels.
+     * @result The number of channels processed simultaneously.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfChannels() const;
+    /*!
+     * @brief Sets the initial conditions for a channel.  By default these
+     *        are \f$ \mu_1 = 0 \f$, \f$ \mu_2 = 1 \f$, and
+     *        \f$ \bar{k}_4 = 0 \f$.
+     * @param[in] channel  The channel index.  This must be in the range
+     *                     [0, \c getNumberOfChannels() - 1].
+     * @param[in] mu1      The mean of the first order moment.
+     * @param[in] mu2      The mean of the second order moment.
+     * @param[in] k4bar    The initial unbiased kurtosis value.
+     * @throws std::invalid_argument if channel is out of bounds.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void setInitialConditions(int channel, T mu1, T mu2, T k4bar);
+    /*!
+     * @brief Resets the delay lines to the default initial conditions or
+     *        the initial conditions set in \c setInitialConditions().
+     *        This is useful when dealing with a gap.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+    /*!
+     * @brief Applies the kurtosis filter to all channels.
+     * @param[in] nSamples  The number of samples in each channel.
+     * @param[in] x         The channel-interleaved signals.  This is a row
+     *                      major matrix of dimension [nSamples x nChannels],
+     *                      i.e., x[i*nChannels + c] is the i'th sample of the
+     *                      c'th channel.
+     * @param[out] y        The channel-interleaved kurtosis.  This has the
+     *                      same layout as x.
+     * @throws std::invalid_argument if nSamples is positive and x or y is
+     *         NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     * @note In post-processing every application starts from the initial
+     *       conditions.
+     */
+    void apply(int nSamples, const T x[], T *y[]);
+private:
+    class MultiChannelIIRKurtosisImpl;
+    std::unique_ptr<MultiChannelIIRKurtosisImpl> pImpl;
+};
+}
+#endif
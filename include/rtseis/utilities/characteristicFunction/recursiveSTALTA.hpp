@@ -0,0 +1,158 @@
+#ifndef RTSEIS_UTILITIES_CHARATERISTICFUNCTION_RECURSIVESTALTA_HPP
+#define RTSEIS_UTILITIES_CHARATERISTICFUNCTION_RECURSIVESTALTA_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+
+namespace RTSeis::Utilities::CharacteristicFunction
+{
+/*!
+ * @class RecursiveSTALTA recursiveSTALTA.hpp "include/rtseis/utilities/characteristicFunction/recursiveSTALTA.hpp"
+ * @brief Implements the recursive short-term-average to long-term-average
+ *        (STA/LTA).  The averages are exponentially weighted,
+ *        \f[
+ *          STA[n] = \frac{1}{N_{sta}} x[n]^2
+ *                 + \left (1 - \frac{1}{N_{sta}} \right ) STA[n-1]
+ *        \f]
+ *        and likewise for the LTA, and the characteristic function is
+ *        \f$ y[n] = STA[n]/LTA[n] \f$.  Here, \f$ N_{sta} \f$ and
+ *        \f$ N_{lta} \f$ are the characteristic lengths, in samples, of the
+ *        short-term and long-term averages.  Following ObsPy's
+ *        recursive_sta_lta the first \f$ N_{lta} \f$ samples of the
+ *        characteristic function are set to 0 while the LTA warms up.
+ * @note Unlike \c ClassicSTALTA, which retains the last \f$ N_{lta} \f$
+ *       samples, the state of each channel is two double precision scalars.
+ *       Many channels can be processed at once in which case the signals are
+ *       expected in a channel-interleaved layout, i.e., a row major matrix of
+ *       dimension [nSamples x nChannels], and the recursions are vectorized
+ *       across channels.
+ * @copyright Ben Baker (University of Utah) distributed under the MIT license.
+ * @ingroup rtseis_utils_characteristicFunction
+ */
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class RecursiveSTALTA
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    RecursiveSTALTA();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] stalta  The recursive STA/LTA class from which to
+     *                    initialize this class.
+     */
+    RecursiveSTALTA(const RecursiveSTALTA &stalta);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] stalta  The recursive STA/LTA class from which to
+     *                        initialize this class.  On exit, stalta's
+     *                        behavior is undefined.
+     */
+    RecursiveSTALTA(RecursiveSTALTA &&stalta) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] stalta  The recursive STA/LTA class to copy to this.
+     * @result A deep copy of stalta.
+     */
+    RecursiveSTALTA& operator=(const RecursiveSTALTA &stalta);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] stalta  The recursive STA/LTA class whose memory will
+     *                        be moved to this.  On exit, stalta's behavior
+     *                        is undefined.
+     * @result The memory from stalta moved to this.
+     */
+    RecursiveSTALTA& operator=(RecursiveSTALTA &&stalta) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~RecursiveSTALTA();
+    /*!
+     * @brief Resets the class and releases all memory.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*! @name Initialization
+     * @{
+     */
+    /*!
+     * @brief Initializes the recursive STA/LTA for a single channel.
+     * @param[in] nSTA   The characteristic length of the short-term average
+     *                   in samples.  This must be at least 2.
+     * @param[in] nLTA   The characteristic length of the long-term average
+     *                   in samples.  This must be at least nSTA.
+     * @throws std::invalid_argument if nSTA or nLTA is invalid.
+     */
+    void initialize(int nSTA, int nLTA);
+    /*!
+     * @brief Initializes the recursive STA/LTA for many channels.
+     * @param[in] nChannels  The number of channels.  This must be positive.
+     * @param[in] nSTA       The characteristic length of the short-term
+     *                       average in samples.  This must be at least 2.
+     * @param[in] nLTA       The characteristic length of the long-term
+     *                       average in samples.  This must be at least nSTA.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(int nChannels, int nSTA, int nLTA);
+    /*!
+     * @brief Determines if the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the number of channels.
+     * @result The number of channels processed simultaneously.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfChannels() const;
+    /*!
+     * @brief Restores the initial conditions, i.e., zeros the averages and
+     *        restarts the warm-up period.  This is useful after a gap in
+     *        real-time processing.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+    /*! @} */
+
+    /*!
+     * @brief Applies the recursive STA/LTA.
+     * @param[in] nSamples  The number of samples in each channel.
+     * @param[in] x         The channel-interleaved signals.  This is a row
+     *                      major matrix of dimension [nSamples x nChannels],
+     *                      i.e., x[i*nChannels + c] is the i'th sample of the
+     *                      c'th channel.  For a single channel this is simply
+     *                      an array of dimension [nSamples].
+     * @param[out] y        The channel-interleaved STA/LTA characteristic
+     *                      functions.  This has the same layout as x.  Where
+     *                      the long-term average is zero the characteristic
+     *                      function is set to 0.
+     *                      This may be x, i.e., the STA/LTA can be computed
+     *                      in place.
+     * @throws std::invalid_argument if nSamples is positive and x or y is
+     *         NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     * @note In post-processing every application starts from the initial
+     *       conditions.
+     */
+    void apply(int nSamples, const T x[], T *y[]);
+private:
+    class RecursiveSTALTAImpl;
+    std::unique_ptr<RecursiveSTALTAImpl> pImpl;
+};
+}
+#endif
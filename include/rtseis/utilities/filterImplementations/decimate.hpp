@@ -2,6 +2,7 @@
 #define RTSEIS_UTILITIES_FILTERIMPLEMENTATIONS_DECIMATE_HPP
 #include <memory>
 #include "rtseis/enums.hpp"
+#include "rtseis/utilities/filterImplementations/enums.hpp"
 namespace RTSeis::Utilities::FilterImplementations
 {
 /*!
@@ -78,17 +79,30 @@ public:
      *                               shift introduced by the FIR filter.
      *                               This is relevant when the operation mode
      *                               is for post-processing.
+     * @param[in] implementation     The decimator implementation.  For the
+     *                               multistage implementation filterLength
+     *                               is the length of the final stage's
+     *                               filter.
      * @throws std::invalid_argument if the downFactor is not positive, the
-     *         filter length is too small.
+     *         filter length is too small, or the multistage implementation
+     *         is requested and downFactor cannot be factored into stages
+     *         of 5, 4, 3, and 2.
      * @note This will design a Hamming window-based filter whose cutoff
      *       frequency is 1/downFactor.  Additionally, when post-processing
      *       and removing the phase shift, the algorithm will increase
      *       the filter length so that it's group delay + 1 is evenly
      *       divisible by the downsampling factor.
+     * @note For the multistage implementation each stage's filter has
+     *       cutoff 1/M where M is the stage's downsampling factor.  The
+     *       earlier stages only have to protect the final stage's passband
+     *       from aliasing so their filters are sized automatically and are
+     *       short.  When removing the phase shift each stage's filter is
+     *       padded as described above.
      */
     void initialize(int downFactor,
                     int filterLength = 30,
-                    bool lRemovePhaseShift = true);
+                    bool lRemovePhaseShift = true,
+                    DecimationImplementation implementation = DecimationImplementation::SINGLE_STAGE);
     /*!
      * @brief Determines if the class is initialized.
      * @result True indicates that the class is initialized.
@@ -104,8 +118,10 @@ public:
      * @brief Sets the initial conditions array.
      * @param[in] nz   The length of the initial condition array.
      *                 This must equal \c getInitialConditionLength().
-     * @param[in] zi   The initial conditions.  This is an array of 
-     *                 dimension [nz].
+     * @param[in] zi   The initial conditions.  This is an array of
+     *                 dimension [nz].  For the multistage implementation
+     *                 this is the concatenation of each stage's FIR
+     *                 initial conditions beginning with the first stage.
      * @throws std::invalid_argument if nz is invalid or nz is positive
      *         and zi is NULL.
      * @throws std::runtime_error if class is not initialized.
@@ -157,6 +173,24 @@ public:
      * @throws std::runtime_error if the class is not initialized.
      */
     [[nodiscard]] int getFIRFilterLength() const;
+    /*!
+     * @brief Gets the number of decimation stages.
+     * @result The number of decimation stages.  This is 1 for the
+     *         single stage implementation.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfStages() const;
+    /*!
+     * @brief Gets the group delay of the FIR filter(s).
+     * @result The group delay in samples at the input sampling rate.
+     *         When the phase shift is removed this delay has already
+     *         been compensated for in the output signal.  Otherwise, the
+     *         i'th output sample corresponds to input sample
+     *         \f$ i M - \tau \f$ where \f$ M \f$ is the downsampling
+     *         factor and \f$ \tau \f$ is the group delay.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] double getGroupDelay() const;
 private:
     class DecimateImpl;
     std::unique_ptr<DecimateImpl> pImpl;
@@ -20,9 +20,47 @@ enum class FIRImplementation
                  advantageous for relatively long filters
                  i.e., when \f$ \log_2 L < N \f$ where
                  \f$ L \f$ is the signal length \f$ N \f$ is
-                 the number of taps. */
-    AUTO    /*!< The implementation will decide
-                 between DIRECT or FFT based. */
+                 the number of taps.  For real-time filtering
+                 this is a uniformly partitioned overlap-save
+                 implementation which is advantageous for
+                 filters with many taps. */
+    AUTO    /*!< The DIRECT and FFT implementations are
+                 benchmarked when the filter is initialized and
+                 the faster is used.  The result is cached in the
+                 Math::ConvolutionWisdom. */
+};
+
+/*!
+ * @brief Defines the implementation of the median filter.
+ * @ingroup rtseis_utils_filters
+ */
+enum class MedianFilterImplementation
+{
+    DIRECT,        /*!< Each window is processed independently by IPP.
+                        This is advantageous for short windows. */
+    SLIDING_HEAP,  /*!< A max-heap of the lower half and min-heap of the
+                        upper half of the window are maintained about the
+                        median so each sample costs \f$ \mathcal{O}(\log w) \f$
+                        where \f$ w \f$ is the window length.  This is
+                        advantageous for long windows. */
+    AUTO           /*!< SLIDING_HEAP is used for long windows and DIRECT
+                        is used otherwise. */
+};
+
+/*!
+ * @brief Defines the implementation of the decimator.
+ * @ingroup rtseis_utils_filters
+ */
+enum class DecimationImplementation
+{
+    SINGLE_STAGE, /*!< A single lowpass filter is designed for the entire
+                       downsampling factor and is applied at the input
+                       sampling rate. */
+    MULTISTAGE    /*!< The downsampling factor is factored into stages
+                       of 5, 4, 3, and 2.  Each stage applies a short
+                       Nyquist filter in polyphase form, i.e., only the
+                       retained samples are computed.  This is
+                       advantageous for large downsampling factors. */
 };
 
 /*! 
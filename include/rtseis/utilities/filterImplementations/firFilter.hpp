@@ -9,6 +9,10 @@ namespace RTSeis::Utilities::FilterImplementations
 /*!
  * @class FIRFilter firFilter.hpp "include/rtseis/utilities/filterImplementations/firFilter.hpp"
  * @brief This is the core implementation for FIR filtering.
+ * @note The taps and IPP FIR specification are immutable and are shared
+ *       by copies of the filter; only the delay lines are copied.  To filter
+ *       many channels with the same design, initialize one filter and copy
+ *       it for each channel.
  * @copyright Ben Baker distributed under the MIT license.
  * @ingroup rtseis_utils_filters
  */
@@ -44,7 +48,7 @@ public:
     /*!
      * @brief Copy operator.
      * @param[in] fir   FIR class to copy.
-     * @result A deep copy of the FIR class.
+     * @result A copy of the FIR class that shares fir's filter design.
      */
     FIRFilter& operator=(const FIRFilter &fir);
     /*!
@@ -74,10 +78,26 @@ public:
      *                  is for post-processing.
      * @param[in] implementation  Defines the implementation.
      *                            The default is to use the direct form.
+     * @param[in] blockLength  For the AUTO implementation this is the
+     *                         expected number of samples passed to each
+     *                         call of apply().  The direct and FFT
+     *                         implementations are benchmarked for this
+     *                         length here, unless the convolution wisdom
+     *                         already has an entry, so apply() never
+     *                         benchmarks.  If this is not positive then
+     *                         1024 samples is assumed.  This is ignored by
+     *                         the other implementations.
+     * @note In real-time mode the FFT implementation uniformly partitions
+     *       long filters.  The first partition is applied in the direct
+     *       form and the remaining partitions are applied with overlap-save
+     *       convolution against a frequency domain delay line.  This adds
+     *       no latency and the per-sample cost grows like the square root
+     *       of the number of taps rather than the number of taps.
      * @throws std::invalid_argument if any of the arguments are invalid.
      */
     void initialize(int nb, const double b[],
-                    FIRImplementation implementation = FIRImplementation::DIRECT);
+                    FIRImplementation implementation = FIRImplementation::DIRECT,
+                    int blockLength = 0);
     /*!
      * @brief Determines if the module is initialized.
      * @retval True indicates that the module is initialized.
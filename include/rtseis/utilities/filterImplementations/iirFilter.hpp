@@ -9,6 +9,8 @@ namespace RTSeis::Utilities::FilterImplementations
 /*!
  * @class IIRFilter iirFilter.hpp "include/rtseis/utilities/filterImplementations/iirFilter.hpp"
  * @brief This is the core implementation for IIR filtering.
+ * @note Copies share the reference and normalized filter coefficients and
+ *       only own their delay lines.
  * @copyright Ben Baker distributed under the MIT license.
  * @ingroup rtseis_utils_filters
  */
@@ -43,7 +45,8 @@ public:
     /*! 
      * @brief Copy assignent operator.
      * @param[in] iir  IIR filter class to copy.
-     * @result A deep copy of the IIR filter class.
+     * @result A copy of the IIR filter class that shares iir's filter
+     *         design.
      */
     IIRFilter &operator=(const IIRFilter &iir);
     /*!
@@ -126,6 +129,26 @@ public:
      *        to being applied to the data.
      */
     void clear() noexcept;
+    /*!
+     * @brief Sets the number of threads used when post-processing.
+     * @param[in] nThreads  The number of threads.  When this exceeds 1 and
+     *                      the signal is long, the signal is split into
+     *                      blocks that are filtered concurrently from zero
+     *                      state.  The transient at the start of each block
+     *                      is then corrected with the zero-input response
+     *                      of the true state that preceded it.  This matches
+     *                      the sequential result to within rounding.
+     * @throws std::invalid_argument if nThreads is not positive.
+     * @note This has no effect on real-time filtering or the DF2_SLOW
+     *       implementation.  This setting is retained by \c initialize()
+     *       and \c clear().  The per-thread block filters are created here
+     *       or by \c initialize() rather than when the filter is applied.
+     */
+    void setNumberOfThreads(int nThreads);
+    /*!
+     * @result The number of threads used when post-processing.
+     */
+    [[nodiscard]] int getNumberOfThreads() const noexcept;
 private:
     class IIRFilterImpl;
     std::unique_ptr<IIRFilterImpl> pImpl;
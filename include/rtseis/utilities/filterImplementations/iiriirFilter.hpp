@@ -8,6 +8,9 @@ namespace RTSeis::Utilities::FilterImplementations
  * @class IIRIIRFilter iiriirFilter.hpp "include/rtseis/utilities/filterImplementations/iiriirFilter.hpp"
  * @brief Implements a zero-phase IIR filter.  This is for
  *        post-processing only.
+ * @note The filter may be specified as a direct form or as cascaded
+ *       second order sections.  The latter is preferable for high-order
+ *       filters whose direct forms are numerically unstable.
  * @ingroup rtseis_utils_filters
  * @copyright Ben Baker distributed under the MIT license.
  */
@@ -69,6 +72,23 @@ public:
      */
     void initialize(int nb, const double b[],
                     int na, const double a[]);
+    /*!
+     * @brief Initializes the zero-phase IIR filter from second order
+     *        sections.
+     * @param[in] ns   The number of sections.  This must be positive.
+     * @param[in] bs   The numerator coefficients of each section.  This is
+     *                 an array of dimension [3 x ns] with leading
+     *                 dimension 3.
+     * @param[in] as   The denominator coefficients of each section.  This
+     *                 is an array of dimension [3 x ns] with leading
+     *                 dimension 3.  The first coefficient of each section
+     *                 cannot be 0.
+     * @throws std::invalid_argument if any of the arguments are invalid.
+     * @note Like the direct form, the signal is extended by odd reflections
+     *       of 3 times the filter order samples and each pass starts from
+     *       the steady-state response to the signal's edge value.
+     */
+    void initialize(int ns, const double bs[], const double as[]);
     /*!
      * @brief Determines if the module is initialized.
      * @retval True indicates that the module is initialized.
@@ -86,7 +106,9 @@ public:
      * @param[in] nz   The length of the initial conditions.  This
      *                 should equal getInitialConditionLength().
      * @param[in] zi   The initial conditions to set.  This has
-     *                 has dimension [nwork_]. 
+     *                 has dimension [nz].  For second order sections
+     *                 these replace the steady-state conditions of the
+     *                 forward pass.
      * @throws std::invalid_argument if nz is invalid or nz is positive
      *         and zi is NULL.
      * @throws std::runtime_error if the class is not initialized.
@@ -123,6 +145,28 @@ public:
      * @throws std::runtime_error if the class is not initialized.
      */
     [[nodiscard]] int getFilterOrder() const;
+    /*!
+     * @brief Sets the number of threads.
+     * @param[in] nThreads  The number of threads.  When this exceeds 1 and
+     *                      the signal is long, the forward and backward
+     *                      passes of a filter initialized from second order
+     *                      sections are each split into blocks that are
+     *                      filtered concurrently.  The state entering each
+     *                      block is then propagated to correct the block's
+     *                      transient.  This matches a single-threaded
+     *                      application to within rounding.
+     * @throws std::invalid_argument if nThreads is not positive.
+     * @note The direct form is always filtered by IPP's serial
+     *       implementation so that its edge treatment does not depend on
+     *       the number of threads or the signal length.  Use second order
+     *       sections to filter long signals with multiple threads.
+     * @note This setting is retained by \c initialize() and \c clear().
+     */
+    void setNumberOfThreads(int nThreads);
+    /*!
+     * @result The number of threads used to apply the filter.
+     */
+    [[nodiscard]] int getNumberOfThreads() const noexcept;
 private:
     class IIRIIRImpl;
     std::unique_ptr<IIRIIRImpl> pIIRIIR_;
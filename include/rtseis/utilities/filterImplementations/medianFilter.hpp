@@ -2,6 +2,7 @@
 #define RTSEIS_UTILITIES_FILTERIMPLEMENTATIONS_MEDIAN_HPP 1
 #include <memory>
 #include "rtseis/enums.hpp"
+#include "rtseis/utilities/filterImplementations/enums.hpp"
 namespace RTSeis::Utilities::FilterImplementations
 {
 /*!
@@ -71,9 +72,12 @@ public:
      * @param[in] n   The window size of the median filter.  This must
      *                be a positive and odd number.  If n is not odd
      *                then it's length will be increased by 1.
+     * @param[in] implementation  Defines the implementation.  By default
+     *                            long windows use the sliding heap.
      * @throws std::invalid_argument if any of the arguments are invalid.
      */
-    void initialize(int n);
+    void initialize(int n,
+                    MedianFilterImplementation implementation = MedianFilterImplementation::AUTO);
     /*!
      * @brief Determines if the module is initialized.
      * @retval True indicates that the module is initialized.
@@ -0,0 +1,168 @@
+#ifndef RTSEIS_UTILITIES_FILTERIMPLEMENTATIONS_MULTICHANNELSOS_HPP
+#define RTSEIS_UTILITIES_FILTERIMPLEMENTATIONS_MULTICHANNELSOS_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+
+namespace RTSeis::Utilities::FilterImplementations
+{
+/*!
+ * @class MultiChannelSOSFilter multiChannelSOSFilter.hpp "include/rtseis/utilities/filterImplementations/multiChannelSOSFilter.hpp"
+ * @brief Applies the same second order section (biquad) filter to many
+ *        channels at once.
+ * @note The delay lines are stored in a structure-of-arrays layout so that
+ *       the biquad cascade is vectorized across channels, i.e., one channel
+ *       per SIMD lane.  Consequently, the signals are expected in a
+ *       channel-interleaved layout, i.e., a row major matrix of dimension
+ *       [nSamples x nChannels].  This is more efficient than maintaining
+ *       one SOSFilter per channel when the packets are short.
+ * @copyright Ben Baker distributed under the MIT license.
+ * @ingroup rtseis_utils_filters
+ */
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class MultiChannelSOSFilter
+{
+public:
+    /*!
+     * @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    MultiChannelSOSFilter();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] sos  The multi-channel SOS class from which to initialize.
+     */
+    MultiChannelSOSFilter(const MultiChannelSOSFilter &sos);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] sos  The multi-channel SOS class from which to
+     *                     initialize this class.  On exit, sos's behavior
+     *                     is undefined.
+     */
+    MultiChannelSOSFilter(MultiChannelSOSFilter &&sos) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy operator.
+     * @param[in] sos  The class to copy.
+     * @result A deep copy of the input class.
+     */
+    MultiChannelSOSFilter& operator=(const MultiChannelSOSFilter &sos);
+    /*!
+     * @brief Move operator.
+     * @param[in,out] sos  The class whose memory will be moved to this.
+     *                     On exit, sos's behavior is undefined.
+     */
+    MultiChannelSOSFilter& operator=(MultiChannelSOSFilter &&sos) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~MultiChannelSOSFilter();
+    /*!
+     * @brief Clears the module and resets all parameters.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the multi-channel second order section filter.
+     * @param[in] nChannels  The number of channels.  This must be positive.
+     * @param[in] ns    The number of second order sections.
+     * @param[in] bs    Numerator coefficients.  This is an array of
+     *                  dimension [3 x ns] with leading dimension 3.
+     *                  There is a further requirement that b[3*is]
+     *                  for \f$ i_s=0,1,\cdots,n_s-1 \f$ not be zero.
+     * @param[in] as    Denominator coefficients.  This is an array of
+     *                  dimension [3 x ns] with leading dimension 3.
+     *                  There is a further requirement that a[3*is]
+     *                  for \f$ i_s=0,1,\cdots,n_s-1 \f$ not be zero.
+     * @throws std::invalid_argument if nChannels, ns, bs, or as is invalid.
+     */
+    void initialize(int nChannels,
+                    int ns,
+                    const double bs[],
+                    const double as[]);
+    /*!
+     * @brief Determines if the module is initialized.
+     * @retval True indicates that the module is initialized.
+     * @retval False indicates that the module is not initialized.
+     */
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the number of channels.
+     * @result The number of channels filtered simultaneously.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfChannels() const;
+    /*!
+     * @brief Gets the number of second order sections in the filter.
+     * @result The number of second order sections.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfSections() const;
+    /*!
+     * @brief Returns the length of the initial conditions for a channel.
+     * @result The length of a channel's initial conditions array.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getInitialConditionLength() const;
+    /*!
+     * @brief Sets the initial conditions for the given channel.  This should
+     *        be called prior to filter application as it will reset
+     *        the channel's filter.
+     * @param[in] channel  The channel index.  This must be in the range
+     *                     [0, getNumberOfChannels() - 1].
+     * @param[in] nz       The second order section filter initial
+     *                     conditions.  This should be equal to
+     *                     getInitialConditionLength().
+     * @param[in] zi       The initial conditions.  These follow the
+     *                     same convention as SOSFilter and have
+     *                     dimension [nz].
+     * @throws std::invalid_argument if channel or nz is invalid or if zi
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void setInitialConditions(int channel, int nz, const double zi[]);
+    /*!
+     * @brief Resets the initial conditions on the source delay lines
+     *        to the default initial conditions or the initial
+     *        conditions set when setInitialConditions() was called.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+
+    /*! @name Filter Application
+     * @{
+     */
+    /*!
+     * @brief Applies the second order section filter to every channel.
+     * @param[in] nSamples  The number of samples in each channel.
+     * @param[in] x   The channel-interleaved signals to filter.  This is a
+     *                row major matrix of dimension [nSamples x nChannels]
+     *                i.e., x[i*nChannels + c] is the i'th sample of the
+     *                c'th channel.
+     * @param[out] y  The channel-interleaved filtered signals.  This has
+     *                the same layout as x.  y may be the same as x.
+     * @throws std::invalid_argument if nSamples is positive and x or y
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void apply(int nSamples, const T x[], T *y[]);
+    /*! @} */
+private:
+    class MultiChannelSOSFilterImpl;
+    std::unique_ptr<MultiChannelSOSFilterImpl> pImpl;
+}; // MultiChannelSOSFilter
+} // rtseis
+#endif
@@ -0,0 +1,203 @@
+#ifndef RTSEIS_UTILITIES_FILTERIMPLEMENTATIONS_RESAMPLE_HPP
+#define RTSEIS_UTILITIES_FILTERIMPLEMENTATIONS_RESAMPLE_HPP 1
+#include <memory>
+#include "rtseis/enums.hpp"
+namespace RTSeis::Utilities::FilterImplementations
+{
+/*!
+ * @class Resample resample.hpp "include/rtseis/utilities/filterImplementations/resample.hpp"
+ * @brief Resamples a signal by an arbitrary, and possibly time-varying,
+ *        ratio of output to input sampling rates.
+ * @note The interpolation filter is a windowed-sinc lowpass filter stored
+ *       as a polyphase filter bank.  Each output sample is computed by
+ *       applying the two phases that bracket the output sample's fractional
+ *       position and linearly interpolating between the two results.
+ *       This makes conversions like 40 Hz to 100 Hz or the removal of
+ *       clock drift (e.g., 100.0003 Hz to 100 Hz) a single pass over
+ *       the data.
+ * @copyright Ben Baker distributed under the MIT license.
+ * @ingroup rtseis_utils_filters
+ */
+template<RTSeis::ProcessingMode E, class T = double>
+class Resample
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Constructor.
+     */
+    Resample();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] resample  The resampling class from which to initialize
+     *                      this class.
+     */
+    Resample(const Resample &resample);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] resample  The resampling class from which to initialize
+     *                          this class.  On exit, resample's behavior is
+     *                          undefined.
+     */
+    Resample(Resample &&resample) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] resample  The resampling class to copy.
+     * @result A deep copy of the resampling class.
+     */
+    Resample& operator=(const Resample &resample);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] resample  The resampling class to move to this.
+     *                          On exit, resample's behavior is undefined.
+     * @result The memory from resample moved to this.
+     */
+    Resample& operator=(Resample &&resample) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~Resample();
+    /*!
+     * @brief Resets the class.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the resampler.
+     * @param[in] ratio         The ratio of the output sampling rate to the
+     *                          input sampling rate, e.g., 2.5 to resample
+     *                          40 Hz data to 100 Hz.  This must be positive.
+     * @param[in] filterLength  The number of input samples spanned by the
+     *                          interpolation filter when upsampling.  When
+     *                          downsampling this is increased by 1/ratio so
+     *                          that the transition band is preserved.
+     *                          This must be at least 8 and will be
+     *                          rounded up to an even number.
+     * @param[in] nPhases       The number of phases in the polyphase filter
+     *                          bank.  The interpolation error decreases
+     *                          with the square of the number of phases.
+     *                          This must be at least 2.
+     * @throws std::invalid_argument if any argument is invalid.
+     * @note The anti-aliasing cutoff is set from this ratio.  Subsequent
+     *       changes to the ratio with \c setRatio() are intended to be
+     *       small, e.g., to track clock drift.
+     */
+    void initialize(double ratio,
+                    int filterLength = 64,
+                    int nPhases = 256);
+    /*!
+     * @brief Determines if the class is initialized.
+     * @result True indicates that the class is initialized.
+     */
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /*!
+     * @brief Sets the resampling ratio.  This may be called between
+     *        packets to follow a time-varying sampling rate.  The position
+     *        of the next output sample has already been computed so the
+     *        new ratio determines the spacing of the output samples after
+     *        the next output sample.
+     * @param[in] ratio  The ratio of the output sampling rate to the input
+     *                   sampling rate.  This must be positive.
+     * @throws std::invalid_argument if ratio is not positive.
+     * @throws std::runtime_error if the class is not initialized.
+     * @note Ratios that are appreciably smaller than the ratio given to
+     *       \c initialize() can result in aliasing.
+     */
+    void setRatio(double ratio);
+    /*!
+     * @brief Gets the current resampling ratio.
+     * @result The ratio of the output sampling rate to the input sampling
+     *         rate.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] double getRatio() const;
+    /*!
+     * @brief Gets the length of the initial condition array.
+     * @result The length of the initial condition array.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getInitialConditionLength() const;
+    /*!
+     * @brief Sets the initial conditions.
+     * @param[in] nz   The length of the initial condition array.
+     *                 This must equal \c getInitialConditionLength().
+     * @param[in] zi   The initial conditions.  These are the input samples
+     *                 preceding the first packet in chronological order.
+     *                 This is an array of dimension [nz].
+     * @throws std::invalid_argument if nz is invalid or nz is positive
+     *         and zi is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void setInitialConditions(int nz, const double zi[]);
+    /*!
+     * @brief Resets the resampler to its default initial conditions or the
+     *        initial conditions set by \c setInitialConditions().  The next
+     *        output sample will coincide with the next input sample.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+    /*!
+     * @brief Computes the number of samples that will be output when
+     *        resampling a signal.
+     * @param[in] n  The number of input samples.  This must be non-negative.
+     * @result The number of output samples.
+     * @throws std::invalid_argument if n is negative.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int estimateSpace(int n) const;
+    /*!
+     * @brief Resamples the signal.
+     * @param[in] nx      The number of samples in x.
+     * @param[in] x       The signal to resample.  This is an array of
+     *                    dimension [nx].
+     * @param[in] ny      The maximum number of samples in y.  This must be
+     *                    at least \c estimateSpace(nx).
+     * @param[out] nyOut  The number of samples written to y.
+     * @param[out] y      The resampled signal.  This has dimension [ny]
+     *                    however only the first [nyOut] samples are defined.
+     * @throws std::invalid_argument if x or y is NULL or ny is too small.
+     * @throws std::runtime_error if the class is not initialized.
+     * @note In real-time processing the output is delayed by
+     *       \c getGroupDelay() input samples.  In post-processing this
+     *       delay is removed so the i'th output sample coincides with the
+     *       input time i/ratio.
+     */
+    void apply(int nx, const T x[], int ny, int *nyOut, T *y[]);
+    /*!
+     * @brief Gets the delay of the interpolation filter.
+     * @result The delay in input samples.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] double getGroupDelay() const;
+    /*!
+     * @brief Gets the number of phases in the polyphase filter bank.
+     * @result The number of phases.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfPhases() const;
+    /*!
+     * @brief Gets the number of input samples spanned by the interpolation
+     *        filter.
+     * @result The number of taps in each phase of the filter bank.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getFilterLength() const;
+private:
+    class ResampleImpl;
+    std::unique_ptr<ResampleImpl> pImpl;
+};
+}
+#endif
@@ -9,6 +9,9 @@ namespace RTSeis::Utilities::FilterImplementations
  * @class SOSFilter sosFilter.hpp "include/rtseis/utilities/filterImplementations/sosFilter.hpp"
  * @brief This is the core implementation for second order section (biquad)
  *        infinite impulse response filtering.
+ * @note Copies share the section coefficients.  Each copy only owns its
+ *       delay lines and IPP state, so the memory per copy scales with the
+ *       number of sections.
  * @copyright Ben Baker distributed under the MIT license.
  * @ingroup rtseis_utils_filters
 */
@@ -44,7 +47,8 @@ public:
     /*!
      * @brief Copy operator.
      * @param[in] sos  The class to copy.
-     * @result A deep copy of the input SOS class.
+     * @result A copy of the input SOS class that shares sos's filter
+     *         design.
      */
     SOSFilter& operator=(const SOSFilter &sos);
     /*!
@@ -140,6 +144,24 @@ public:
      * @throws std::runtime_error if the class is not initialized.
      */
     [[nodiscard]] int getNumberOfSections() const;
+    /*!
+     * @brief Sets the number of threads used when post-processing.
+     * @param[in] nThreads  The number of threads.  When this exceeds 1 and
+     *                      the signal is long, the signal is split into
+     *                      blocks that are filtered concurrently from zero
+     *                      state.  The transient at the start of each block
+     *                      is then corrected with the zero-input response
+     *                      of the true state that preceded it.  This matches
+     *                      the sequential result to within rounding.
+     * @throws std::invalid_argument if nThreads is not positive.
+     * @note This has no effect on real-time filtering.  This setting is
+     *       retained by \c initialize() and \c clear().
+     */
+    void setNumberOfThreads(int nThreads);
+    /*!
+     * @result The number of threads used when post-processing.
+     */
+    [[nodiscard]] int getNumberOfThreads() const noexcept;
 
 private:
     class SOSFilterImpl;
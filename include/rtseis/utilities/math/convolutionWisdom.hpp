@@ -0,0 +1,121 @@
+#ifndef RTSEIS_UTILITIES_MATH_CONVOLUTIONWISDOM_HPP
+#define RTSEIS_UTILITIES_MATH_CONVOLUTIONWISDOM_HPP 1
+#include <string>
+#include "rtseis/enums.hpp"
+
+/*!
+ * @brief The convolution wisdom is a process-wide table which records
+ *        whether the direct or FFT implementation was faster for a given
+ *        operation, number of taps, block length, precision, and processing
+ *        mode.  It is
+ *        populated by the AUTO implementations of FIRFilter and Convolve,
+ *        which briefly benchmark both algorithms the first time a key
+ *        is encountered.  The table can be exported to a file and imported
+ *        at start-up so that production processes begin already tuned.
+ * @note To keep the table small the number of taps and block length are
+ *       rounded up to the next power of 2 when forming a key.
+ * @note All functions are thread-safe.
+ * @ingroup rtseis_utils_math_convolve
+ */
+namespace RTSeis::Utilities::Math::ConvolutionWisdom
+{
+/*!
+ * @brief Defines the operation which was tuned.
+ * @ingroup rtseis_utils_math_convolve
+ */
+enum class Operation
+{
+    FIR_FILTER = 0, /*!< FIRFilter application. */
+    CONVOLVE = 1,   /*!< Convolve::convolve. */
+    CORRELATE = 2   /*!< Convolve::correlate. */
+};
+/*!
+ * @brief Defines the faster algorithm.
+ * @ingroup rtseis_utils_math_convolve
+ */
+enum class Algorithm
+{
+    DIRECT = 0, /*!< The time domain implementation is faster. */
+    FFT = 1     /*!< The frequency domain implementation is faster. */
+};
+/*!
+ * @brief Sets the algorithm to use for the given key.  This overrides any
+ *        existing entry.
+ * @param[in] operation    The operation.
+ * @param[in] nTaps        The number of filter taps or the length of the
+ *                         shorter signal.  This must be positive.
+ * @param[in] blockLength  The number of samples filtered per call or the
+ *                         length of the longer signal.  This must be
+ *                         positive.
+ * @param[in] precision    The precision of the computation.
+ * @param[in] algorithm    The algorithm to use.
+ * @param[in] mode         The processing mode.  A real-time FIR filter
+ *                         partitions its FFT so its timings differ from
+ *                         those of a post-processing filter.
+ * @throws std::invalid_argument if nTaps or blockLength is not positive.
+ * @ingroup rtseis_utils_math_convolve
+ */
+void setAlgorithm(Operation operation, int nTaps, int blockLength,
+                  RTSeis::Precision precision, Algorithm algorithm,
+                  RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST);
+/*!
+ * @brief Determines if there is wisdom for the given key.
+ * @param[in] operation    The operation.
+ * @param[in] nTaps        The number of filter taps.
+ * @param[in] blockLength  The block length.
+ * @param[in] precision    The precision of the computation.
+ * @param[in] mode         The processing mode.
+ * @retval True indicates that there is an entry for this key.
+ * @ingroup rtseis_utils_math_convolve
+ */
+[[nodiscard]] bool haveAlgorithm(Operation operation, int nTaps,
+                                 int blockLength,
+                                 RTSeis::Precision precision,
+                                 RTSeis::ProcessingMode mode
+                                     = RTSeis::ProcessingMode::POST) noexcept;
+/*!
+ * @brief Gets the algorithm for the given key.
+ * @param[in] operation    The operation.
+ * @param[in] nTaps        The number of filter taps.
+ * @param[in] blockLength  The block length.
+ * @param[in] precision    The precision of the computation.
+ * @param[in] mode         The processing mode.
+ * @result The faster algorithm for this key.
+ * @throws std::invalid_argument if there is no entry for this key.
+ * @sa haveAlgorithm()
+ * @ingroup rtseis_utils_math_convolve
+ */
+[[nodiscard]] Algorithm getAlgorithm(Operation operation, int nTaps,
+                                     int blockLength,
+                                     RTSeis::Precision precision,
+                                     RTSeis::ProcessingMode mode
+                                         = RTSeis::ProcessingMode::POST);
+/*!
+ * @result The number of entries in the wisdom table.
+ * @ingroup rtseis_utils_math_convolve
+ */
+[[nodiscard]] int getNumberOfEntries() noexcept;
+/*!
+ * @brief Writes the wisdom table to a text file.
+ * @param[in] fileName  The name of the file to write.
+ * @throws std::runtime_error if the file cannot be written.
+ * @ingroup rtseis_utils_math_convolve
+ */
+void exportWisdom(const std::string &fileName);
+/*!
+ * @brief Reads a wisdom table from a text file and merges it into the
+ *        process-wide table.  Entries in the file override existing entries.
+ *        As with any other key, the number of taps and block length in
+ *        the file are rounded up to the next power of 2.
+ * @param[in] fileName  The name of the file to read.
+ * @throws std::invalid_argument if the file does not exist or is malformed.
+ * @ingroup rtseis_utils_math_convolve
+ */
+void importWisdom(const std::string &fileName);
+/*!
+ * @brief Removes all entries from the wisdom table.
+ * @ingroup rtseis_utils_math_convolve
+ */
+void forgetWisdom() noexcept;
+}
+#endif
@@ -16,7 +16,11 @@ namespace RTSeis::Utilities::Math::Convolve
  */
 enum class Implementation
 {
-    AUTO,   /*!< Let IPP decide. */
+    AUTO,   /*!< The direct and FFT implementations are benchmarked on
+                 synthetic signals the first time a problem size is
+                 encountered and the faster is recorded in the
+                 ConvolutionWisdom.  Very long problems without wisdom
+                 are not benchmarked and IPP chooses instead. */
     DIRECT, /*!< Time domain implementation. */
     FFT     /*!< Frequency domain implementation. */
 }; // End implementation
@@ -1,6 +1,10 @@
 #ifndef RTSEIS_UTILITIES_TRANSFORMS_CONTINUOUSWAVELET_HPP
 #define RTSEIS_UTILITIES_TRANSFORMS_CONTINUOUSWAVELET_HPP 1
 #include <memory>
+#include <complex>
+#include <functional>
+#include "rtseis/enums.hpp"
+#include "rtseis/utilities/transforms/enums.hpp"
 namespace RTSeis::Utilities::Transforms
 {
 namespace Wavelets
@@ -15,6 +19,21 @@ class IContinuousWavelet;
  *           \int s(t) \psi^* \left ( \frac{t}{a} \right ) \, dt
  *        \f]
  *        where \f$ a \f$ is the scale.
+ * @note The signal is Fourier transformed once.  Each scale then costs a
+ *       pointwise multiply with the wavelet's analytic Fourier transform
+ *       and one inverse transform.
+ * @note In real-time processing the signal is given in packets.  Each
+ *       wavelet is truncated to the samples where its magnitude exceeds
+ *       \f$ 10^{-8} \f$ of its peak and the transform is computed by
+ *       overlap-save convolution.  A CWT column becomes valid once the
+ *       half-support of the widest wavelet has been received after it,
+ *       so the output lags the input by \c getLatency() samples.
+ * @note Long signals with many scales are large.  For example, one hour
+ *       at 100 Hz with 128 scales is about 7 GB of complex doubles.  The
+ *       memory can be reduced with \c setStorage() by retaining only the
+ *       amplitude or power in float precision and by decimating each scale
+ *       to its own Nyquist rate, or eliminated by streaming the rows to
+ *       \c setRowCallback().
  * @ingroup rtseis_utils_transforms
  * @sa Hilbert
  */
@@ -92,9 +111,13 @@ public:
      *                       \f$ s = \frac{\omega_0 f_s}{2 \pi f} \f$
      *                       where \f$ f_s \f$ is the sampling rate in Hz.
      * @param[in] wavelet    The wavelet to evaluate.  This must have an 
-     *                       evaluate method which, for a given scale,
-     *                       returns the wavelet's nSamples time domain samples.
+     *                       evaluateFrequencyDomain method which, for a given
+     *                       scale, returns the wavelet's Fourier transform.
      * @param[in] samplingRate  The sampling rate in Hz.
+     * @param[in] mode       The processing mode.  In post-processing
+     *                       nSamples is the length of the signal.  In
+     *                       real-time nSamples is the largest packet
+     *                       that will be given to \c transform().
      * @throws std::invalid_argument nSamples is less than 1,
      *         nScales is less than 1, samplingPeriod is not positive,
      *         or any scale is not positive.
@@ -102,13 +125,27 @@ public:
     void initialize(int nSamples,
                     int nScales, const double scales[],
                     const Wavelets::IContinuousWavelet &wavelet,
-                    double samplingRate = 1);
+                    double samplingRate = 1,
+                    RTSeis::ProcessingMode mode = RTSeis::ProcessingMode::POST);
 
     /*!
-     * @result The number of samples in the CWT.
+     * @result The number of samples in the CWT.  In real-time this is the
+     *         largest packet size.
      * @throws std::runtime_error if \c isInitialized() is false.
      */
     [[nodiscard]] int getNumberOfSamples() const;
+    /*!
+     * @result The processing mode.
+     * @throws std::runtime_error if \c isInitialized() is false.
+     */
+    [[nodiscard]] RTSeis::ProcessingMode getProcessingMode() const;
+    /*!
+     * @result The number of samples by which a real-time CWT column lags
+     *         the input.  This is the half-support of the widest wavelet.
+     *         In post-processing this is 0.
+     * @throws std::runtime_error if \c isInitialized() is false.
+     */
+    [[nodiscard]] int getLatency() const;
     /*!
      * @result The number of scales in the CWT.
      * @throws std::runtime_error if \c isInitialized() is false.
@@ -131,19 +168,86 @@ public:
     [[nodiscard]] bool isInitialized() const noexcept;
     /*! @} */
 
+    /*! @name Output Options
+     * @{
+     */
+    /*!
+     * @brief Defines what is retained by the transform.  By default the
+     *        complex transform is retained at every sample.
+     * @param[in] storage   Defines whether the complex transform, its
+     *                      amplitude, its power, or nothing is retained.
+     * @param[in] decimate  If true then each scale is only retained at
+     *                      every \c getDecimationFactor() sample.  Since the
+     *                      wavelet band-limits the scale this is the
+     *                      scale's own Nyquist rate.  The inverse transform
+     *                      is still computed at every sample and then
+     *                      subsampled so this reduces the storage and the
+     *                      data given to the callback, not the compute.
+     * @throws std::runtime_error if \c isInitialized() is false.
+     * @note \c initialize() restores the defaults.
+     */
+    void setStorage(ContinuousWaveletStorage storage, bool decimate = false);
+    /*!
+     * @result Defines what is retained by the transform.
+     * @throws std::runtime_error if \c isInitialized() is false.
+     */
+    [[nodiscard]] ContinuousWaveletStorage getStorage() const;
+    /*!
+     * @param[in] iScale  The scale index.  This must be in the range
+     *                    [0, \c getNumberOfScales() - 1].
+     * @result The scale's output is computed at every getDecimationFactor()
+     *         sample of the signal.  This is 1 if decimation is disabled.
+     *         The wavelet's Fourier transform is less than \f$ 10^{-6} \f$
+     *         of its peak beyond the decimated Nyquist frequency.
+     * @throws std::runtime_error if \c isInitialized() is false.
+     * @throws std::invalid_argument if iScale is out of bounds.
+     */
+    [[nodiscard]] int getDecimationFactor(int iScale) const;
+    /*!
+     * @brief Sets a function that is given each scale's (decimated) complex
+     *        transform as it is computed.  Combined with
+     *        \c ContinuousWaveletStorage::NONE this streams the transform
+     *        without retaining it.
+     * @param[in] callback  The function receives the scale index, the
+     *                      number of columns, and the columns.  The
+     *                      columns are only valid during the call.  In
+     *                      real-time a packet may deliver a scale in
+     *                      multiple calls.  Calls are serialized but the
+     *                      scales may be delivered in any order.
+     * @throws std::runtime_error if \c isInitialized() is false.
+     */
+    void setRowCallback(
+        const std::function<void (int iScale, int nColumns,
+                                  const std::complex<T> row[])> &callback);
+    /*!
+     * @brief Removes the row callback.
+     */
+    void clearRowCallback() noexcept;
+    /*! @} */
+
     /*! @name Transform
      * @{
      */
     /*!
      * @brief Computes the continuous wavelet transform of the given signal. 
-     * @param[in] n   The number of samples in x.  This must match
+     * @param[in] n   The number of samples in x.  In post-processing this
+     *                must match \c getNumberOfSamples().  In real-time this
+     *                is the packet size and cannot exceed
      *                \c getNumberOfSamples().
      * @param[in] x   The signal to transform.  This is an array whose dimension
      *                is [n].
      * @throws std::invalid_argument if n is the wrong size or x is NULL.
      * @throws std::runtime_error if \c isInitialized() is false. 
+     * @sa \c getNumberOfNewColumns()
      */
     void transform(int n, const T x[]);
+    /*!
+     * @brief Discards the samples retained between real-time packets.
+     *        This is useful after a gap.  The next packet's first sample
+     *        is then treated as the signal's first sample.
+     * @throws std::runtime_error if \c isInitialized() is false.
+     */
+    void resetInitialConditions();
     /*! @} */
 
     /*! @name Results
@@ -154,16 +258,69 @@ public:
      *         computed.
      */
     [[nodiscard]] bool haveTransform() const noexcept;
+    /*!
+     * @result The number of CWT columns computed by the last call to
+     *         \c transform().  In post-processing this is
+     *         \c getNumberOfSamples().  In real-time these are the columns
+     *         that became valid with the last packet.  Column i of the
+     *         output corresponds to the input sample received
+     *         \c getLatency() + (getNumberOfNewColumns() - 1 - i) samples
+     *         before the last sample of the packet.
+     * @throws std::runtime_error if \c haveTransform() is false.
+     */
+    [[nodiscard]] int getNumberOfNewColumns() const;
+    /*!
+     * @param[in] iScale  The scale index.  This must be in the range
+     *                    [0, \c getNumberOfScales() - 1].
+     * @result The number of columns of the given scale computed by the last
+     *         call to \c transform().  Without decimation this is
+     *         \c getNumberOfNewColumns().
+     * @throws std::runtime_error if \c haveTransform() is false.
+     * @throws std::invalid_argument if iScale is out of bounds.
+     */
+    [[nodiscard]] int getNumberOfColumns(int iScale) const;
+    /*!
+     * @param[in] iScale  The scale index.
+     * @result A pointer to the iScale'th row of the complex transform.
+     *         This is an array whose dimension is
+     *         [\c getNumberOfColumns(iScale)].
+     * @throws std::runtime_error if \c haveTransform() is false or the
+     *         storage is not \c ContinuousWaveletStorage::COMPLEX.
+     * @throws std::invalid_argument if iScale is out of bounds.
+     */
+    [[nodiscard]] const std::complex<T> *getTransformRowPointer(int iScale) const;
+    /*!
+     * @param[in] iScale  The scale index.
+     * @result A pointer to the iScale'th row of the amplitude of the
+     *         transform.  This is an array whose dimension is
+     *         [\c getNumberOfColumns(iScale)].
+     * @throws std::runtime_error if \c haveTransform() is false or the
+     *         storage is not \c ContinuousWaveletStorage::AMPLITUDE.
+     * @throws std::invalid_argument if iScale is out of bounds.
+     */
+    [[nodiscard]] const float *getAmplitudeRowPointer(int iScale) const;
+    /*!
+     * @param[in] iScale  The scale index.
+     * @result A pointer to the iScale'th row of the power of the
+     *         transform.  This is an array whose dimension is
+     *         [\c getNumberOfColumns(iScale)].
+     * @throws std::runtime_error if \c haveTransform() is false or the
+     *         storage is not \c ContinuousWaveletStorage::POWER.
+     * @throws std::invalid_argument if iScale is out of bounds.
+     */
+    [[nodiscard]] const float *getPowerRowPointer(int iScale) const;
     /*!
      * @brief Gets the CWT.  
      * @param[in] nSamples  The number of samples in the CWT. 
-     *                      This must match \c getNumberOfSamples().
+     *                      This must match \c getNumberOfNewColumns().
      * @param[in] nScales   The number of scales in the CWT.
      *                      This must match \c getNumberOfScales().
      * @param[out] cwt      The CWT.  This is an [nScales x nSamples] matrix
      *                      stored in row major order.  cwt[0,:] corresponds
      *                      to the first scale.
-     * @throws std::runtime_error if \c haveTransform() is false.
+     * @throws std::runtime_error if \c haveTransform() is false, the
+     *         storage is not \c ContinuousWaveletStorage::COMPLEX, or the
+     *         transform is decimated.
      * @throws std::invalid_argument if nSamples or nScales is the wrong size
      *         or cwt is NULL.
      */
@@ -171,13 +328,15 @@ public:
     /*!
      * @brief Gets the amplitude of the complex CWT.
      * @param[in] nSamples  The number of samples in the CWT.
-     *                      This must match \c getNumberOfSamples().
+     *                      This must match \c getNumberOfNewColumns().
      * @param[in] nScales   The number of scales in the CWT.
      *                      This must match \c getNumberOfScales().
      * @param[out] amplitude   The amplitude of the CWT.  This is an
      *                         [nScales x nSamples] matrix stored in row major
      *                         order.
-     * @throws std::runtime_error if \c haveTransform() is false.
+     * @throws std::runtime_error if \c haveTransform() is false, the
+     *         storage is \c ContinuousWaveletStorage::NONE, or the
+     *         transform is decimated.
      * @throws std::invalid_argument if nSamples or nScales is the wrong size
      *         or amplitude is NULL.
      * @sa \c getTransform()
@@ -186,13 +345,15 @@ public:
     /*!
      * @brief Gets the phase of the complex CWT.
      * @param[in] nSamples  The number of samples in the CWT.
-     *                      This must match \c getNumberOfSamples().
+     *                      This must match \c getNumberOfNewColumns().
      * @param[in] nScales   The number of scales in the CWT.
      *                      This must match \c getNumberOfScales().
      * @param[out] phase    The phase angle of the CWT in radians.  This is an
      *                      [nScales x nSamples] matrix stored in row major
      *                      order.
-     * @throws std::runtime_error if \c haveTransform() is false.
+     * @throws std::runtime_error if \c haveTransform() is false, the
+     *         storage is not \c ContinuousWaveletStorage::COMPLEX, or the
+     *         transform is decimated.
      * @throws std::invalid_argument if nSamples or nScales is the wrong size
      *         or phase is NULL.
      * @sa \c getTransform()
@@ -0,0 +1,48 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_DFTPLANCACHE_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_DFTPLANCACHE_HPP 1
+
+/*!
+ * @brief The DFT plan cache is a process-wide registry of initialized
+ *        Fourier transform specifications keyed on the transform length,
+ *        precision, real or complex input, FFT or DFT algorithm, and
+ *        normalization.  DFT, DFTRealToComplex, and the classes built on
+ *        them, e.g., Hilbert and Envelope, draw their plans from this
+ *        registry.  Hence, initializing or copying a transform for a length
+ *        that has already been seen costs a lookup and identical plans
+ *        share memory.  Each transform class retains its own work space so
+ *        transforms sharing a plan may be run concurrently.
+ * @note Plans are reference counted and shared with the transforms.  The
+ *       cache also keeps strong references to the most recently requested
+ *       plans so that destroying a transform and then creating one of the
+ *       same length, e.g., for a sequence of equal-length traces, reuses
+ *       the plan.  Other plans are destroyed with the last transform using
+ *       them.  Hence, the cache grows with the number of distinct plans in
+ *       use plus at most getMaximumNumberOfRetainedPlans() idle plans.
+ * @note All functions are thread-safe.
+ * @ingroup rtseis_utils_transforms
+ */
+namespace RTSeis::Utilities::Transforms::DFTPlanCache
+{
+/*!
+ * @result The number of plans in the cache.  These are the plans in use by
+ *         at least one transform and the retained, recently requested plans.
+ * @ingroup rtseis_utils_transforms
+ */
+[[nodiscard]] int getNumberOfPlans() noexcept;
+/*!
+ * @result The maximum number of recently requested plans that the cache
+ *         keeps alive after their last transform is destroyed.
+ * @ingroup rtseis_utils_transforms
+ */
+[[nodiscard]] int getMaximumNumberOfRetainedPlans() noexcept;
+/*!
+ * @brief Releases the plans that are no longer used by any transform,
+ *        including the retained plans, and removes their entries.  As it
+ *        adds plans the cache removes the entries of plans that have
+ *        already been destroyed.
+ * @result The number of entries that were removed.
+ * @ingroup rtseis_utils_transforms
+ */
+int releaseUnusedPlans() noexcept;
+}
+#endif
@@ -10,8 +10,10 @@ enum class FourierTransformImplementation
 {
     DFT, /*!< Perform a Discrete Fourier Transform computation. */
     FFT  /*!< Force an Fast Fouerier Transform computation.  The 
-              implementation will have to zero-pad the signal so that
-              its length is a power of 2. */
+              implementation will zero-pad the signal so that the prime
+              factors of its length are 2, 3, 5, or 7.  Powers of 2 use
+              the radix-2 FFT while other lengths use the mixed-radix
+              DFT. */
 };
 /*!
  * @brief Defines the detrending strategy used by the short-time
@@ -36,6 +38,29 @@ enum class SlidingWindowType
     BOXCAR,    /*!< A boxcar (all ones). */ 
     CUSTOM     /*!< A custom window was set. */
 };
+/*!
+ * @brief Defines what the continuous wavelet transform retains.
+ */
+enum class ContinuousWaveletStorage
+{
+    COMPLEX,   /*!< The complex transform. */
+    AMPLITUDE, /*!< The amplitude of the transform in float precision. */
+    POWER,     /*!< The squared amplitude of the transform in float
+                    precision. */
+    NONE       /*!< Nothing is retained.  The transform's rows are only
+                    given to the row callback. */
+};
+/*!
+ * @brief Defines how Welch's method averages the periodograms of the
+ *        segments in real-time.
+ */
+enum class WelchAveraging
+{
+    BLOCK,       /*!< The periodograms of the most recent segments are
+                      averaged with equal weight. */
+    EXPONENTIAL  /*!< The periodograms are averaged with weights that
+                      decay exponentially with segment age. */
+};
  
 }
 #endif
@@ -0,0 +1,211 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_MULTICHANNELWELCH_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_MULTICHANNELWELCH_HPP 1
+#include <memory>
+#include <complex>
+#include "rtseis/utilities/transforms/enums.hpp"
+
+namespace RTSeis::Utilities::Transforms
+{
+class SlidingWindowRealDFTParameters;
+/*!
+ * @brief Estimates the cross-spectral density matrix and coherence of many
+ *        channels using Welch's method.  For channels \f$ i \f$ and
+ *        \f$ j \f$ the cross-spectral density is the average over segments
+ *        of \f$ X_i(f) X_j^*(f) \f$.
+ * @note Each channel is transformed once per segment.  The Hermitian
+ *       cross-spectral matrix at each frequency is then accumulated as a
+ *       rank-k update of its upper triangle where k is the number of
+ *       segments.  Hence, the cost is \f$ \mathcal{O}(N^2 F K) \f$ flops
+ *       plus \f$ N \f$ sliding window transforms rather than
+ *       \f$ N^2 \f$ transforms.
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+class MultiChannelWelch
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    MultiChannelWelch();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] welch  The class from which to initialize this class.
+     */
+    MultiChannelWelch(const MultiChannelWelch &welch);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] welch  The class from which to initialize this class.
+     *                       On exit, welch's behavior is undefined.
+     */
+    MultiChannelWelch(MultiChannelWelch &&welch) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] welch  The class to copy.
+     * @result A deep copy of the multi-channel Welch class.
+     */
+    MultiChannelWelch& operator=(const MultiChannelWelch &welch);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] welch  The class to move to this.
+     *                       On exit welch's behavior is undefined.
+     * @result The memory that was moved from welch to this.
+     */
+    MultiChannelWelch& operator=(MultiChannelWelch &&welch) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~MultiChannelWelch();
+    /*!
+     * @brief Releases memory on the class.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the multi-channel Welch transform.
+     * @param[in] nChannels     The number of channels.  This must be
+     *                          positive.
+     * @param[in] parameters    The sliding window DFT parameters that define
+     *                          the segments, window, and detrending applied
+     *                          to each channel.  These must be valid and
+     *                          the processing mode must be post-processing.
+     * @param[in] samplingRate  The sampling rate in Hz.
+     * @throws std::invalid_argument if any parameters are incorrect.
+     */
+    void initialize(int nChannels,
+                    const SlidingWindowRealDFTParameters &parameters,
+                    double samplingRate = 1.0);
+    /*!
+     * @brief Flag indicating whether or not the class is initialized.
+     * @result True indicates that the class is inititalized.
+     */
+    bool isInitialized() const noexcept;
+    /*!
+     * @brief Returns the number of channels.
+     * @result The number of channels.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfChannels() const;
+    /*!
+     * @brief Returns the number of samples in each channel.
+     * @result The number of samples each channel must contain.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfSamples() const;
+    /*!
+     * @brief Returns the number of frequencies.
+     * @result The number of frequencies.
+     * @throws std::runtime_error if the class is not intitialized.
+     */
+    int getNumberOfFrequencies() const;
+    /*!
+     * @brief Gets the frequencies at which the spectra were estimated.
+     * @param[in] nFrequencies  The number of frequencies.  This must match
+     *                          the result of \c getNumberOfFrequencies().
+     * @param[out] frequencies  The frequencies (Hz).  This is an array of
+     *                          dimension [nFrequencies].
+     * @throws std::invalid_argument if nFrequencies is invalid or frequencies
+     *         is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getFrequencies(int nFrequencies, double *frequencies[]) const;
+
+    /*!
+     * @brief Computes the cross-spectral density matrix of the channels.
+     * @param[in] nChannels  The number of channels.  This must equal
+     *                       \c getNumberOfChannels().
+     * @param[in] nSamples   The number of samples in each channel.  This must
+     *                       equal \c getNumberOfSamples().
+     * @param[in] x          The signals.  This is a row major matrix of
+     *                       dimension [nChannels x nSamples], i.e.,
+     *                       x[c*nSamples + i] is the i'th sample of the c'th
+     *                       channel.
+     * @throws std::invalid_argument if nChannels, nSamples, or x is invalid.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void transform(int nChannels, int nSamples, const double x[]);
+    /*!
+     * @brief Returns whether or not the transform has been computed.
+     * @retval True indicates that the transform has been computed.
+     */
+    bool haveTransform() const noexcept;
+
+    /*! @name Results
+     * @{
+     */
+    /*!
+     * @brief Gets the cross-spectral density of two channels.
+     * @param[in] iChannel      The first channel.  This must be in the range
+     *                          [0, \c getNumberOfChannels() - 1].
+     * @param[in] jChannel      The second channel.  This must be in the range
+     *                          [0, \c getNumberOfChannels() - 1].
+     * @param[in] nFrequencies  The number of frequencies.  This must match
+     *                          the result of \c getNumberOfFrequencies().
+     * @param[out] csd          The cross-spectral density
+     *                          \f$ S_{ij}(f) \f$.  This is an array of
+     *                          dimension [nFrequencies].  When iChannel
+     *                          equals jChannel this is the power spectral
+     *                          density computed by \c Welch.
+     * @throws std::invalid_argument if the channels or nFrequencies are
+     *         invalid or csd is NULL.
+     * @throws std::runtime_error if the transform has not been computed.
+     */
+    void getCrossSpectralDensity(int iChannel, int jChannel,
+                                 int nFrequencies,
+                                 std::complex<double> *csd[]) const;
+    /*!
+     * @brief Gets the Hermitian cross-spectral density matrix at a frequency.
+     * @param[in] iFrequency  The frequency index.  This must be in the range
+     *                        [0, \c getNumberOfFrequencies() - 1].
+     * @param[in] nChannels   The number of channels.  This must equal
+     *                        \c getNumberOfChannels().
+     * @param[out] csd        The cross-spectral density matrix.  This is a
+     *                        row major matrix of dimension
+     *                        [nChannels x nChannels].
+     * @throws std::invalid_argument if iFrequency or nChannels is invalid or
+     *         csd is NULL.
+     * @throws std::runtime_error if the transform has not been computed.
+     */
+    void getCrossSpectralDensityMatrix(int iFrequency, int nChannels,
+                                       std::complex<double> *csd[]) const;
+    /*!
+     * @brief Gets the magnitude-squared coherence of two channels,
+     *        \f$ |S_{ij}|^2/(S_{ii} S_{jj}) \f$.
+     * @param[in] iChannel       The first channel.  This must be in the range
+     *                           [0, \c getNumberOfChannels() - 1].
+     * @param[in] jChannel       The second channel.  This must be in the
+     *                           range [0, \c getNumberOfChannels() - 1].
+     * @param[in] nFrequencies   The number of frequencies.  This must match
+     *                           the result of \c getNumberOfFrequencies().
+     * @param[out] coherence     The coherence which is in the range [0,1].
+     *                           Frequencies at which either channel has no
+     *                           power have zero coherence.  This is an array
+     *                           of dimension [nFrequencies].
+     * @throws std::invalid_argument if the channels or nFrequencies are
+     *         invalid or coherence is NULL.
+     * @throws std::runtime_error if the transform has not been computed.
+     * @note This reads the cross-spectral density matrices without a
+     *       workspace so concurrent calls on the same instance are safe.
+     */
+    void getCoherence(int iChannel, int jChannel,
+                      int nFrequencies, double *coherence[]) const;
+    /*! @} */
+private:
+    class MultiChannelWelchImpl;
+    std::unique_ptr<MultiChannelWelchImpl> pImpl;
+};
+}
+#endif
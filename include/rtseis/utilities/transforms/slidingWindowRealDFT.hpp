@@ -12,6 +12,11 @@ class SlidingWindowRealDFTParameters;
  *        and computes the DFT in each window.  This is the basis of many 
  *        higher order spectral analysis methods such as the STFT, spectrogram,
  *        and Welch's method.  
+ * @note In real-time processing the signal is given in arbitrary-length
+ *       packets.  The samples that do not complete a window are retained
+ *       between packets and each completed window is transformed and written
+ *       to a ring of output windows.  Hence, the cost of a packet is
+ *       proportional to its length and not to the number of retained windows.
  * @note This class is not intended for use by a large audience.  Because it is
  *       foundational to higher-order methods whose results are more desirable
  *       this interface emphasizes efficiency at the sake of clarity.
@@ -99,16 +104,36 @@ public:
      * @brief Returns the number of sliding time windows for which a
      *        DFT was computed.  This is the number of columns in the
      *        output matrix.
-     * @result The number of windows.
+     * @result The number of windows.  In real-time this is the number of
+     *         windows currently retained.  This grows until the windows
+     *         span \c getNumberOfSamples() samples.
      * @throws std::runtime_error if the class is not intitialized.
      */
     int getNumberOfTransformWindows() const;
+    /*!
+     * @brief Returns the number of windows completed by the last call to
+     *        \c transform().
+     * @result The number of new windows.  In real-time these are the last
+     *         windows, i.e., windows [\c getNumberOfTransformWindows() - 
+     *         \c getNumberOfNewTransformWindows(),
+     *         \c getNumberOfTransformWindows() - 1].  In post-processing
+     *         this is the number of transform windows.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    int getNumberOfNewTransformWindows() const;
     /*!
      * @brief Returns the expected number of samples in the time series.
-     * @result The expected number of samples.
+     * @result The expected number of samples.  In real-time this is the
+     *         number of samples spanned by the retained windows.
      * @throws std::runtime_error if the class is not initialized.
      */
     int getNumberOfSamples() const;
+    /*!
+     * @brief Gets the processing mode.
+     * @result The processing mode.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    RTSeis::ProcessingMode getProcessingMode() const;
     /*!
      * @brief Gets the precision of the underlying Fourier transform.
      * @result The precision of the underlying transform.
@@ -119,21 +144,46 @@ public:
     /*!
      * @brief Computes the sliding window DFT of the real signal.
      * @param[in] nSamples  The number of samples in the signal.
-     *                      This must match the result of 
-     *                      \c getNumberOfSamples().
+     *                      In post-processing this must match the result of
+     *                      \c getNumberOfSamples().  In real-time this is the
+     *                      number of samples in the packet and must be
+     *                      non-negative.
      * @param[in] x         The signal to transform.  This is an array whose
      *                      dimension is [nSamples].
      * @throws std::invalid_argument if any arguments are invalid.
      * @throws std::runtime_error if the class is not initalized.
-     * @sa \c getNumberOfTransformWindow(), \c getNumberOfFrequencies()
+     * @sa \c getNumberOfTransformWindow(), \c getNumberOfFrequencies(),
+     *     \c getNumberOfNewTransformWindows()
      */
     void transform(const int nSamples, const double x[]);
+    /*!
+     * @brief Computes the sliding window DFT of the real signal.
+     * @param[in] nSamples  The number of samples in the signal.
+     *                      In post-processing this must match the result of
+     *                      \c getNumberOfSamples().  In real-time this is the
+     *                      number of samples in the packet and must be
+     *                      non-negative.
+     * @param[in] x         The signal to transform.  This is an array whose
+     *                      dimension is [nSamples].
+     * @throws std::invalid_argument if any arguments are invalid.
+     * @throws std::runtime_error if the class is not initalized.
+     * @note If the precision is DOUBLE then the signal is promoted to double.
+     */
+    void transform(const int nSamples, const float x[]);
+    /*!
+     * @brief Discards the samples retained between real-time packets and
+     *        the transform windows.  This is useful after a gap.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
 
     /*!
      * @brief Gets a pointer to the transform in the iWindow'th window.
      * @param[in] iWindow  The window of the given transform.  This must
      *                     be in the range 
-     *                     [0, \c getNumberOfTransformWidnwos()-1]. 
+     *                     [0, \c getNumberOfTransformWidnwos()-1].  In
+     *                     real-time the windows are in chronological order
+     *                     so 0 is the oldest retained window. 
      * @throws std::invalid_argument if iWindow is out of bounds.
      * @throws std::runtime_error if the class precision is FLOAT 
      *         or the \c transform() has not yet been called. 
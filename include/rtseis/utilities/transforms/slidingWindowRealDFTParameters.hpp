@@ -215,6 +215,37 @@ public:
      *         computation.
      */  
     RTSeis::Precision getPrecision() const noexcept;
+    /*!
+     * @brief Defines the processing mode.
+     * @param[in] mode  The processing mode.  In post-processing the entire
+     *                  signal of length \c getNumberOfSamples() is
+     *                  transformed at once.  In real-time processing the
+     *                  signal is given in arbitrary-length packets and
+     *                  \c getNumberOfSamples() defines the number of
+     *                  samples spanned by the retained transform windows.
+     * @note By default this is post-processing.
+     */
+    void setProcessingMode(RTSeis::ProcessingMode mode) noexcept;
+    /*!
+     * @brief Returns the processing mode.
+     * @result The processing mode of the sliding window real DFT.
+     */
+    RTSeis::ProcessingMode getProcessingMode() const noexcept;
+    /*!
+     * @brief Sets the number of threads used in post-processing.  The
+     *        windows are extracted, detrended, and tapered in parallel
+     *        and the batched Fourier transform is split among the threads.
+     * @param[in] nThreads  The number of threads.  This must be positive.
+     * @throws std::invalid_argument if nThreads is not positive.
+     * @note By default this is 1.  This has no effect in real-time
+     *       processing since the packets are typically short.
+     */
+    void setNumberOfThreads(int nThreads);
+    /*!
+     * @brief Gets the number of threads.
+     * @result The number of threads used in post-processing.
+     */
+    int getNumberOfThreads() const noexcept;
     /*! @} */
 
     /*! @name Valid
@@ -0,0 +1,201 @@
+#ifndef RTSEIS_UTILITIES_TRANSFORMS_SPARSEFREQUENCYDFT_HPP
+#define RTSEIS_UTILITIES_TRANSFORMS_SPARSEFREQUENCYDFT_HPP 1
+#include <memory>
+#include <complex>
+#include "rtseis/enums.hpp"
+
+namespace RTSeis::Utilities::Transforms
+{
+/*!
+ * @class SparseFrequencyDFT sparseFrequencyDFT.hpp "include/rtseis/utilities/transforms/sparseFrequencyDFT.hpp"
+ * @brief Evaluates the discrete-time Fourier transform at a handful of
+ *        user-chosen frequencies in a window that slides over many channels.
+ *        For the window of length \f$ N \f$ ending at sample \f$ n \f$
+ *        this computes
+ *        \f[
+ *           X_n(\omega) = \sum_{m=0}^{N-1} x_{n-N+1+m} e^{-i \omega m}
+ *        \f]
+ *        where \f$ \omega = 2 \pi f/f_s \f$.  When \f$ f = k f_s/N \f$ this
+ *        is the k'th bin of the DFT of the (rectangularly windowed) segment.
+ * @note The cost is proportional to the number of frequencies and not
+ *       to \f$ N \log N \f$.  When windows are emitted often relative to
+ *       their length each frequency is updated at every sample with the
+ *       sliding DFT recurrence
+ *       \f$ X_n = e^{i \omega} (X_{n-1} - x_{n-N})
+ *               + e^{-i \omega (N-1)} x_n \f$.
+ *       The recurrences are periodically re-anchored so that roundoff
+ *       does not accumulate.  Otherwise, each emitted window is evaluated
+ *       with the Goertzel algorithm.  In both cases the accumulations are
+ *       carried out in double precision.
+ * @note The signals are expected in a channel-interleaved layout, i.e.,
+ *       a row major matrix of dimension [nSamples x nChannels], so that the
+ *       recurrences are vectorized across channels.
+ * @copyright Ben Baker distributed under the MIT license.
+ */
+template<RTSeis::ProcessingMode E = RTSeis::ProcessingMode::POST,
+         class T = double>
+class SparseFrequencyDFT
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    SparseFrequencyDFT();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] dft  The sparse frequency DFT class from which to
+     *                 initialize this class.
+     */
+    SparseFrequencyDFT(const SparseFrequencyDFT &dft);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] dft  The sparse frequency DFT class from which to
+     *                     initialize this class.  On exit, dft's behavior
+     *                     is undefined.
+     */
+    SparseFrequencyDFT(SparseFrequencyDFT &&dft) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] dft  The class to copy.
+     * @result A deep copy of the input class.
+     */
+    SparseFrequencyDFT& operator=(const SparseFrequencyDFT &dft);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] dft  The class whose memory will be moved to this.
+     *                     On exit, dft's behavior is undefined.
+     * @result The memory from dft moved to this.
+     */
+    SparseFrequencyDFT& operator=(SparseFrequencyDFT &&dft) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Default destructor.
+     */
+    ~SparseFrequencyDFT();
+    /*!
+     * @brief Releases memory on the class.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the sparse frequency DFT.
+     * @param[in] nChannels     The number of channels.  This must be positive.
+     * @param[in] nFrequencies  The number of frequencies at which to evaluate
+     *                          the DFT.  This must be positive.
+     * @param[in] frequencies   The frequencies (Hz) at which to evaluate the
+     *                          DFT.  Each frequency must be in the range
+     *                          [0, samplingRate/2].  This is an array of
+     *                          dimension [nFrequencies].
+     * @param[in] windowLength  The number of samples in each window.  This
+     *                          must be positive.
+     * @param[in] hopLength     The number of samples between the ends of
+     *                          successive windows.  This must be positive.
+     * @param[in] samplingRate  The sampling rate in Hz.  This must be
+     *                          positive.
+     * @param[in] maxPacketLength  The output for a signal of up to this
+     *                             many samples is allocated here so that
+     *                             \c transform() does not allocate.  Longer
+     *                             signals are accepted but grow the output.
+     *                             This must be positive.
+     * @throws std::invalid_argument if any arguments are invalid.
+     */
+    void initialize(int nChannels,
+                    int nFrequencies,
+                    const double frequencies[],
+                    int windowLength,
+                    int hopLength = 1,
+                    double samplingRate = 1,
+                    int maxPacketLength = 1024);
+    /*!
+     * @brief Determines if the class is initialized.
+     * @retval True indicates that the class is initialized.
+     */
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /*!
+     * @brief Gets the number of channels.
+     * @result The number of channels.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfChannels() const;
+    /*!
+     * @brief Gets the number of frequencies.
+     * @result The number of frequencies at which the DFT is evaluated.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfFrequencies() const;
+    /*!
+     * @brief Gets the window length.
+     * @result The number of samples in each window.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getWindowLength() const;
+    /*!
+     * @brief Gets the hop length.
+     * @result The number of samples between successive windows.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getHopLength() const;
+    /*!
+     * @brief Discards the samples retained between real-time packets and
+     *        zeros the recurrences.  This is useful after a gap.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+
+    /*! @name Transform
+     * @{
+     */
+    /*!
+     * @brief Evaluates the DFT at the chosen frequencies in every window
+     *        completed by this signal.
+     * @param[in] nSamples  The number of samples in each channel.
+     * @param[in] x         The channel-interleaved signals.  This is a row
+     *                      major matrix of dimension [nSamples x nChannels],
+     *                      i.e., x[i*nChannels + c] is the i'th sample of
+     *                      the c'th channel.
+     * @throws std::invalid_argument if nSamples is positive and x is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     * @note In post-processing the first window ends at sample
+     *       windowLength - 1 and every transform starts anew.  In real-time
+     *       the window ends are counted from the first sample after
+     *       initialization or \c resetInitialConditions().
+     */
+    void transform(int nSamples, const T x[]);
+    /*!
+     * @brief Gets the number of windows completed by the last call to
+     *        \c transform().
+     * @result The number of new windows.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfNewWindows() const;
+    /*!
+     * @brief Gets the DFT in the iWindow'th window completed by the last
+     *        call to \c transform().
+     * @param[in] iWindow  The window index.  This must be in the range
+     *                     [0, \c getNumberOfNewWindows() - 1].
+     * @result The DFT in this window.  This is a row major matrix of
+     *         dimension [nChannels x nFrequencies].
+     * @throws std::invalid_argument if iWindow is out of bounds.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] const std::complex<T> *getTransform(int iWindow) const;
+    /*! @} */
+private:
+    class SparseFrequencyDFTImpl;
+    std::unique_ptr<SparseFrequencyDFTImpl> pImpl;
+};
+}
+#endif
@@ -175,6 +175,21 @@ void realToComplexDFTFrequencies(int nSamples,
  * @ingroup rtseis_utils_transforms_utils
  */
 int nextPowerOfTwo(const int n);
+/*!
+ * @brief Finds the smallest number, nFast, such that nFast is greater than
+ *        or equal to n and the prime factors of nFast are 2, 3, 5, or 7.
+ *        Mixed-radix transforms of such lengths are efficient so padding
+ *        to nFast, e.g., 100001 to 100352, is often much cheaper than
+ *        padding to the next power of 2, e.g., 131072.
+ * @param[in] n  Non-negative number of which to find the next fast length.
+ * @result On successful exit this is a 2, 3, 5, 7-smooth number that is
+ *         greater than or equal to n.
+ * @throws std::invalid_argument if n is negative.
+ * @throws std::runtime_error if n is too large and there is an overflow.
+ * @sa nextPowerOfTwo()
+ * @ingroup rtseis_utils_transforms_utils
+ */
+int nextFastLength(const int n);
 
 /*! @name Shuffle
  * @{
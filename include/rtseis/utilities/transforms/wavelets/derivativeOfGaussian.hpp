@@ -77,11 +77,10 @@ public:
      * @{
      */
     /*!
-     * @brief Initializes the derivative of the Gaussian wavelet.
+     * @brief Sets the order of the derivative.
      * @param[in] order   The order of the derivative.
      *                    For example, 2 is a Ricker wavelet. 
-     * @param[in] dt      The sampling period in seconds.
-     * @throws std::invalid_argument if order is negative or dt is not positive.
+     * @throws std::invalid_argument if order is negative.
      */
     void setOrder(int order);
     /*!
@@ -90,36 +89,77 @@ public:
     int getOrder() const noexcept;
 
     /*!
-     * @brief Sets the sampling period used in evaluating the wavelet and 
-     *        cone of influence.
-     * @param[in] dt   The sampling period in seconds.
-     * @throws std::invalid_argument if dt is not positive.
+     * @brief This will normalize the wavelet by \f$ \frac{1}{\sqrt{s}} \f$
+     *        where \f$ s \f$ is the scale.
      */
-    void setSamplingPeriod(double dt) override;
+    void enableNormalization() noexcept;
     /*!
-     * @result The sampling period in seconds.
+     * @brief Will not normalize the wavelet by \f$ \frac{1}{\sqrt{s}} \f$.
      */
-    double getSamplingPeriod() const noexcept override;
+    void disableNormalization() noexcept;
+    /*!
+     * @result True indicates that the wavelet will be normalized by
+     *         \f$ \frac{1}{\sqrt{s}} \f$.
+     */
+    [[nodiscard]] bool normalize() const noexcept;
     /*! @} */
 
+    /*! @name Evaluation
+     * @{
+     */
     /*!
-     * @result The e-folding time for the derivative of a Gaussian wavelet.
-     *         This has units of seconds/radian.
+     * @brief Evaluates the derivative of a Gaussian wavelet
+     *        \f[
+     *           W = \frac{(-1)^{m+1}}{\sqrt{\Gamma(m + \frac{1}{2})}}
+     *               \frac{d^m}{d \eta^m}
+     *               e^{-\frac{1}{2} \eta^2}
+     *        \f]
+     *        where \f$ \eta = \frac{x}{s} \f$ and \f$ m \f$ is the order.
+     *        This is additionally scaled by \f$ \frac{1}{\sqrt{s}} \f$
+     *        if \c normalize() is true.
+     * @param[in] n       The number of samples at which to evaluate the
+     *                    wavelet.
+     * @param[in] scale   The unitless scale.
+     * @param[out] daughter  The daughter wavelet evaluated at the n samples.
+     *                       This is an array whose dimension is [n].
+     *                       This will be centered at \f$ x = 0 \f$ which
+     *                       corresponds to index n/2 for n odd.
      */
-    //[[nodiscard]] double getEFoldingTime(double s) const override;
-    //[[nodiscard]] double getWavelength(double s) const override;
     void evaluate(int n, double scale,
-                  const double k[],
                   std::complex<double> *daughter[]) const override;
+    /*! @copydoc evaluate() */
     void evaluate(int n, float scale,
-                  const float k[],
                   std::complex<float> *daughter[]) const override;
+    /*!
+     * @brief Evaluates the Fourier transform of the derivative of a Gaussian
+     *        wavelet
+     *        \f[
+     *           \hat{W}(\omega) = -\frac{s \sqrt{2 \pi}}
+     *                                    {\sqrt{\Gamma(m + \frac{1}{2})}}
+     *                              (-i s \omega)^m
+     *                              e^{-\frac{1}{2} (s \omega)^2}.
+     *        \f]
+     * @param[in] n       The number of frequencies at which to evaluate the
+     *                    wavelet.
+     * @param[in] scale   The unitless scale.
+     * @param[in] omega   The angular frequencies in radians/sample.  This is
+     *                    an array whose dimension is [n].
+     * @param[out] daughter  The Fourier transform of the daughter wavelet.
+     *                       This is an array whose dimension is [n].
+     */
+    void evaluateFrequencyDomain(
+        int n, double scale, const double omega[],
+        std::complex<double> *daughter[]) const override;
+    /*! @copydoc evaluateFrequencyDomain() */
+    void evaluateFrequencyDomain(
+        int n, float scale, const float omega[],
+        std::complex<float> *daughter[]) const override;
     /*!
      * @result The cone of influence scalar for the given derivative order.
      *         The cone of influence at a time is given by scalar*time
      *         where time is measured from window's start.
      */
-    [[nodiscard]] double computeConeOfInfluenceScalar() const noexcept override;
+    [[nodiscard]] double computeConeOfInfluenceScalar() const noexcept;
     /*! @} */
 private:
     class DerivativeOfGaussianImpl;
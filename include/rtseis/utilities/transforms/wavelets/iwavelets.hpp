@@ -71,6 +71,31 @@ public:
                           std::complex<double> *daughter[]) const = 0;
     virtual void evaluate(int n, float scale,
                           std::complex<float> *daughter[]) const = 0;
+    /*!
+     * @brief Evaluates the Fourier transform of the daughter wavelet.
+     *        This is the discrete-time Fourier transform of the samples
+     *        returned by \c evaluate() were they centered at \f$ x = 0 \f$,
+     *        i.e., \f$ \sum_x \psi(x/s) e^{-i \omega x} \f$.
+     * @param[in] n      The number of frequencies at which to evaluate the
+     *                   wavelet.
+     * @param[in] scale  The dimensionless scale at which to evaluate the
+     *                   wavelet.
+     * @param[in] omega  The angular frequencies in radians/sample at which
+     *                   to evaluate the wavelet.  This is an array whose
+     *                   dimension is [n].
+     * @param[out] daughter  The Fourier transform of the daughter wavelet
+     *                       evaluated at the n frequencies.  This is an
+     *                       array whose dimension is [n].
+     * @throws std::invalid_argument if scale is not positive or omega or
+     *         daughter is NULL.
+     */
+    virtual void evaluateFrequencyDomain(
+        int n, double scale, const double omega[],
+        std::complex<double> *daughter[]) const = 0;
+    /*! @copydoc evaluateFrequencyDomain() */
+    virtual void evaluateFrequencyDomain(
+        int n, float scale, const float omega[],
+        std::complex<float> *daughter[]) const = 0;
     /*!
      * @result The cone of influence scalar for the given nominal wavenumber.
      *         The cone of influence at a time is given by scalar*time
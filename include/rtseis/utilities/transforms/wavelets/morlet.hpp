@@ -144,6 +144,29 @@ public:
     /*! @copydoc evaluate() */
     void evaluate(int n, float scale,
                   std::complex<float> *daughter[]) const override;
+    /*!
+     * @brief Evaluates the Fourier transform of the Morlet wavelet
+     *        \f[
+     *           \hat{W}(\omega) = s \sqrt{2 \pi} \pi^{-1/4}
+     *                              e^{-\frac{1}{2} (s \omega - \omega_0)^2}
+     *        \f]
+     *        which is additionally scaled by \f$ \frac{1}{\sqrt{s}} \f$
+     *        if \c normalize() is true.
+     * @param[in] n       The number of frequencies at which to evaluate the
+     *                    wavelet.
+     * @param[in] scale   The unitless scale.
+     * @param[in] omega   The angular frequencies in radians/sample.  This is
+     *                    an array whose dimension is [n].
+     * @param[out] daughter  The Fourier transform of the daughter wavelet.
+     *                       This is an array whose dimension is [n].
+     */
+    void evaluateFrequencyDomain(
+        int n, double scale, const double omega[],
+        std::complex<double> *daughter[]) const override;
+    /*! @copydoc evaluateFrequencyDomain() */
+    void evaluateFrequencyDomain(
+        int n, float scale, const float omega[],
+        std::complex<float> *daughter[]) const override;
     /*!
      * @result The cone of influence scalar for the given nominal wavenumber.
      *         The cone of influence at a time is given by scalar*time 
@@ -78,39 +78,55 @@ public:
      * @{
      */
     /*!
-     * @brief Sets the sampling period in evaluating the wavelet and cone of
-     *        influence.
-     * @param[in] dt   The sampling period in seconds.
-     * @throws std::invalid_argument if dt is not positive.
+     * @brief This will normalize the wavelet by \f$ \frac{1}{\sqrt{s}} \f$
+     *        where \f$ s \f$ is the scale.
      */
-    void setSamplingPeriod(double dt) override;
+    void enableNormalization() noexcept;
     /*!
-     * @result The sampling period in seconds.
+     * @brief Will not normalize the wavelet by \f$ \frac{1}{\sqrt{s}} \f$.
      */
-    double getSamplingPeriod() const noexcept override;
+    void disableNormalization() noexcept;
+    /*!
+     * @result True indicates that the wavelet will be normalized by
+     *         \f$ \frac{1}{\sqrt{s}} \f$.
+     */
+    [[nodiscard]] bool normalize() const noexcept;
     /*! @} */
 
     /*! @name Evaluation
      * @{
      */
     /*!
-     * @result The e-folding time for the derivative of a Gaussian wavelet.
-     *         This has units of seconds/radian.
+     * @brief Evaluates the Ricker wavelet
+     *        \f[
+     *           W = \frac{1}{\sqrt{\Gamma(\frac{5}{2})}}
+     *               (1 - \eta^2) e^{-\frac{1}{2} \eta^2}
+     *        \f]
+     *        where \f$ \eta = \frac{x}{s} \f$.
+     * @copydetails DerivativeOfGaussian::evaluate()
      */
-    //[[nodiscard]] double getEFoldingTime(double s) const override;
-    //[[nodiscard]] double getWavelength(double s) const override;
     void evaluate(int n, double scale,
-                  const double k[],
                   std::complex<double> *daughter[]) const override;
+    /*! @copydoc evaluate() */
     void evaluate(int n, float scale,
-                  const float k[],
                   std::complex<float> *daughter[]) const override;
+    /*!
+     * @brief Evaluates the Fourier transform of the Ricker wavelet.
+     * @copydetails DerivativeOfGaussian::evaluateFrequencyDomain()
+     */
+    void evaluateFrequencyDomain(
+        int n, double scale, const double omega[],
+        std::complex<double> *daughter[]) const override;
+    /*! @copydoc evaluateFrequencyDomain() */
+    void evaluateFrequencyDomain(
+        int n, float scale, const float omega[],
+        std::complex<float> *daughter[]) const override;
     /*!
      * @result The cone of influence scalar for the second derivative of
      *         a Gaussian.  The cone of influence at a time is given by
      *         scalar*time where time is measured from window's start.
      */
-    [[nodiscard]] double computeConeOfInfluenceScalar() const noexcept override;
+    [[nodiscard]] double computeConeOfInfluenceScalar() const noexcept;
     /*! @} */
 private:
     class RickerImpl;
@@ -1,6 +1,7 @@
 #ifndef RTSEIS_UTILITIES_TRANSFORMS_WELCH_HPP
 #define RTSEIS_UTILITIES_TRANSFORMS_WELCH_HPP 1
 #include <memory>
+#include "rtseis/enums.hpp"
 #include "rtseis/utilities/transforms/enums.hpp"
 
 namespace RTSeis::Utilities::Transforms
@@ -11,6 +12,11 @@ class SlidingWindowRealDFTParameters;
  *        This amounts to first dividing the data into overlapping segments.
  *        Next, a modified periodogram is computed in each segment. 
  *        Finally, the modified periodogram for all segments are averaged. 
+ * @note In real-time the signal is given in arbitrary-length packets and
+ *       a running estimate is maintained.  Each update costs one Fourier
+ *       transform per new segment.  Either the most recent segments
+ *       spanning \c getNumberOfSamples() samples are averaged or the
+ *       periodograms are exponentially forgotten.
  * @author Ben Baker, University of Utah
  * @copyright Ben Baker distributed under the MIT license.
  * @date July 2019
@@ -121,17 +127,68 @@ public:
      * @brief Returns the expected number of time domain samples in the signal
      *        to transform.
      * @result The number of samples the signal to transform to contain should
-     *         contain.
+     *         contain.  In real-time this is the number of samples spanned
+     *         by the segments averaged with block averaging.
      * @throws std::runtime_error if the class is not inititalized.
      */
     int getNumberOfSamples() const;
+    /*!
+     * @brief Gets the processing mode.
+     * @result The processing mode set on the sliding window DFT parameters.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    RTSeis::ProcessingMode getProcessingMode() const;
+
+    /*! @name Real-Time Averaging
+     * @{
+     */
+    /*!
+     * @brief Averages the periodograms of the most recent segments spanning
+     *        \c getNumberOfSamples() samples with equal weight.  This is
+     *        the default and discards the running estimate.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void setBlockAveraging();
+    /*!
+     * @brief Averages the periodograms with exponentially decaying weights.
+     *        After each new segment the running sum is
+     *        \f$ S \leftarrow \lambda S + P \f$ and the estimate is
+     *        normalized by the sum of the weights.  This discards the
+     *        running estimate.
+     * @param[in] forgettingFactor  The forgetting factor, \f$ \lambda \f$.
+     *                              This must be in the range (0,1).
+     * @throws std::invalid_argument if forgettingFactor is out of range.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void setExponentialAveraging(double forgettingFactor);
+    /*!
+     * @brief Gets the real-time averaging strategy.
+     * @result The averaging strategy.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    WelchAveraging getAveraging() const;
+    /*!
+     * @brief Discards the retained samples and the running estimate.
+     *        This is useful after a gap.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
+    /*! @} */
+
     /*!
      * @brief Computes the Welch transform of a signal.
-     * @param[in] nSamples   The number of samples in the signal.  This must
-     *                       equal the result of \c getNumberOfSamples().
+     * @param[in] nSamples   The number of samples in the signal.  In
+     *                       post-processing this must equal the result of
+     *                       \c getNumberOfSamples().  In real-time this is
+     *                       the number of samples in the packet and must be
+     *                       non-negative.
      * @param[in] x          The signal to transform.
      * @throws std::invalid_argument if nSamples or x is invalid.
      * @throws std::runtime_error if the class is not initialized.
+     * @note In real-time the estimate is available once a segment has been
+     *       completed.  Segments that would be overwritten in the sliding
+     *       window DFT's ring during a packet are not averaged so packets
+     *       should not span more than \c getNumberOfSamples() samples.
      * @sa \c isInitialized(), \c getNumberOfSamples()
      */
     void transform(int nSamples, const double x[]);
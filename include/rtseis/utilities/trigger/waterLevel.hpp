@@ -2,8 +2,11 @@
 #define RTSEIS_UTILITIES_TRIGGER_WATERLEVEL_HPP
 #include <memory>
 #include <vector>
+#include <cstdint>
 
-namespace RTSeis::Utilities::Trigger::PostProcessing
+namespace RTSeis::Utilities::Trigger
+{
+namespace PostProcessing
 {
 /*!
  * @brief Defines the waterlevel-based trigger.  Effectively, this begins
@@ -121,6 +124,176 @@ private:
     class WaterLevelImpl;
     std::unique_ptr<WaterLevelImpl> pImpl;
 };
+} // End namespace on post-processing
+
+namespace RealTime
+{
+/*!
+ * @brief Defines a trigger on or trigger off event.
+ */
+struct WaterLevelEvent
+{
+    /*!
+     * The sample index at which the event occurred.  This is counted from
+     * the first sample after initialization or resetting the initial
+     * conditions.
+     */
+    int64_t sample = 0;
+    /*!
+     * True indicates that the trigger window commences at this sample.
+     * False indicates that the trigger window ended at this sample.
+     */
+    bool isOn = true;
+};
+
+/*!
+ * @brief Defines the real-time waterlevel-based trigger.  This is a state
+ *        machine that begins a trigger window when the characteristic
+ *        function exceeds the on waterlevel and ends the trigger window
+ *        when the characteristic function drops below the off waterlevel.
+ *        The trigger state and the previous sample are carried across
+ *        packets so that windows straddling packets are neither split nor
+ *        duplicated.  Concatenating the windows found in every packet
+ *        yields the windows found by \c PostProcessing::WaterLevel on the
+ *        entire signal.
+ * @note The events are written to a buffer allocated at initialization so
+ *       no memory is allocated while processing packets.
+ */
+template<class T = double>
+class WaterLevel
+{
+public:
+    /*! @name Constructors
+     * @{
+     */
+    /*!
+     * @brief Default constructor.
+     */
+    WaterLevel();
+    /*!
+     * @brief Copy constructor.
+     * @param[in] trigger  The trigger class from which to initialize
+     *                     this class.
+     */
+    WaterLevel(const WaterLevel &trigger);
+    /*!
+     * @brief Move constructor.
+     * @param[in,out] trigger  The waterlevel trigger class from which to
+     *                         intialize this class.  On exit, trigger's
+     *                         behavior is undefined.
+     */
+    WaterLevel(WaterLevel &&trigger) noexcept;
+    /*! @} */
+
+    /*! @name Operators
+     * @{
+     */
+    /*!
+     * @brief Copy assignment operator.
+     * @param[in] trigger   The waterlevel trigger class to copy to this.
+     * @result A deep copy of trigger.
+     */
+    WaterLevel& operator=(const WaterLevel &trigger);
+    /*!
+     * @brief Move assignment operator.
+     * @param[in,out] trigger  The waterlevel trigger class whose memory will
+     *                         be moved to this.  On exit, trigger's behavior
+     *                         is undefined.
+     * @result The memory from trigger moved to this.
+     */
+    WaterLevel& operator=(WaterLevel &&trigger) noexcept;
+    /*! @} */
+
+    /*! @name Destructors
+     * @{
+     */
+    /*!
+     * @brief Destructor.
+     */
+    ~WaterLevel();
+    /*!
+     * @brief Releases memory and resets the class.
+     */
+    void clear() noexcept;
+    /*! @} */
+
+    /*!
+     * @brief Initializes the trigger class.
+     * @param[in] onTolerance   When the characteristic function first exceeds
+     *                          this tolerance the trigger window commences.
+     * @param[in] offTolerance  When the characteristic function first drops
+     *                          below this tolerance the trigger window
+     *                          finalizes.
+     * @param[in] maxEvents     The maximum number of events that can be
+     *                          reported by a single call to \c apply().
+     *                          This must be positive.
+     * @throws std::invalid_argument if maxEvents is not positive.
+     */
+    void initialize(double onTolerance, double offTolerance,
+                    int maxEvents = 2048);
+    /*!
+     * @brief Determines if the class is initialized.
+     * @result True indicates that the class is initialized.
+     */
+    [[nodiscard]] bool isInitialized() const noexcept;
+    /*!
+     * @brief Resets the trigger state and the sample counter.  This is
+     *        useful after a gap.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void resetInitialConditions();
 
+    /*!
+     * @brief Advances the trigger state machine with the next packet.
+     * @param[in] nSamples  The number of samples in the packet.
+     * @param[in] x         The characteristic function from which to compute
+     *                      the triggers.  This is an array whose dimension is
+     *                      [nSamples].
+     * @throws std::invalid_argument if nSamples is positive and x is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     * @note If more than maxEvents events occur then the later events are
+     *       dropped though the trigger state is still updated.
+     * @sa \c getNumberOfDroppedEvents()
+     */
+    void apply(int nSamples, const T x[]);
+    /*!
+     * @brief Determines if a trigger window is open, i.e., whether the
+     *        last trigger on event has not yet been followed by a trigger
+     *        off event.
+     * @result True indicates that the trigger is on.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] bool isTriggered() const;
+    /*!
+     * @brief Gets the number of events found by the last call to
+     *        \c apply().
+     * @result The number of events.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfEvents() const;
+    /*!
+     * @brief Gets the number of events that did not fit in the event buffer
+     *        during the last call to \c apply().
+     * @result The number of dropped events.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    [[nodiscard]] int getNumberOfDroppedEvents() const;
+    /*!
+     * @brief Gets the events found by the last call to \c apply().
+     * @param[in] nEvents  The length of the events array.  This must equal
+     *                     \c getNumberOfEvents().
+     * @param[out] events  The trigger on and off events in the order in
+     *                     which they occurred.  This is an array whose
+     *                     dimension is [nEvents].
+     * @throws std::invalid_argument if nEvents is invalid or nEvents is
+     *         positive and events is NULL.
+     * @throws std::runtime_error if the class is not initialized.
+     */
+    void getEvents(int nEvents, WaterLevelEvent *events[]) const;
+private:
+    class WaterLevelImpl;
+    std::unique_ptr<WaterLevelImpl> pImpl;
+};
+} // End namespace on real-time
 }
 #endif
@@ -261,6 +261,8 @@ public:
     int nx_ = 0;
     /// Number of elements in y
     int ny_ = 0;
+    /// Number of threads used by the IIR and SOS filters
+    int nThreads_ = 1;
     /// Flag indicating this is the first filtering operation on the input data
     bool lfirstFilter_ = true; 
 };
@@ -388,6 +390,22 @@ double Waveform<T>::getNyquistFrequency() const noexcept
     return fnyq;
 } 
 
+template<class T>
+void Waveform<T>::setNumberOfThreads(const int nThreads)
+{
+    if (nThreads < 1)
+    {
+        RTSEIS_THROW_IA("Number of threads = %d must be positive", nThreads);
+    }
+    pImpl->nThreads_ = nThreads;
+}
+
+template<class T>
+int Waveform<T>::getNumberOfThreads() const noexcept
+{
+    return pImpl->nThreads_;
+}
+
 //----------------------------------------------------------------------------//
 //                     Convolution/Correlation/AutoCorrelation                //
 //----------------------------------------------------------------------------//
@@ -1137,6 +1155,7 @@ void Waveform<T>::iirFilter(const Utilities::FilterRepresentations::BA &ba,
         iirFilter.initialize(nb, b.data(),
                              na, a.data(),
                Utilities::FilterImplementations::IIRDFImplementation::DF2_FAST);
+        iirFilter.setNumberOfThreads(pImpl->nThreads_);
         pImpl->resizeOutputData(len);
         const T *x = pImpl->getInputDataPointer();
         T *yout = pImpl->getOutputDataPointer();
@@ -1179,6 +1198,7 @@ void Waveform<double>::sosFilter(
     RTSeis::Utilities::FilterImplementations::SOSFilter
          <RTSeis::ProcessingMode::POST, double> sosFilter;
     sosFilter.initialize(ns, bs.data(), as.data());
+    sosFilter.setNumberOfThreads(pImpl->nThreads_);
     pImpl->resizeOutputData(len);
     // Get handles on pointers
     const double *x = pImpl->getInputDataPointer();
@@ -0,0 +1,291 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <stdexcept>
+#include <array>
+#include <algorithm>
+#include "rtseis/enums.hpp"
+#include "rtseis/utilities/characteristicFunction/characteristicFunctionBank.hpp"
+#include "rtseis/utilities/characteristicFunction/multiChannelClassicSTALTA.hpp"
+#include "rtseis/utilities/characteristicFunction/recursiveSTALTA.hpp"
+#include "rtseis/utilities/characteristicFunction/iirKurtosis.hpp"
+#include "rtseis/utilities/transforms/firEnvelope.hpp"
+
+using namespace RTSeis::Utilities::CharacteristicFunction;
+
+namespace
+{
+/// The number of samples processed by all the characteristic functions
+/// before moving to the next block.  The input block and the output blocks
+/// should comfortably fit in the L1 cache.
+constexpr int BLOCK_SIZE = 512;
+/// The number of characteristic functions.
+constexpr int N_TYPES = 4;
+
+int toIndex(const CharacteristicFunctionType type) noexcept
+{
+    return static_cast<int> (type);
+}
+}
+
+template<class T>
+class CharacteristicFunctionBank<T>::CharacteristicFunctionBankImpl
+{
+public:
+    /// Applies the enabled characteristic functions to a block
+    void applyBlock(const int n, const T x[], T *y[], const int offset)
+    {
+        int k = 0;
+        if (mEnabled[toIndex(CharacteristicFunctionType::CLASSIC_STALTA)])
+        {
+            auto yk = y[k] + offset;
+            mClassicSTALTA.apply(n, x, &yk);
+            k = k + 1;
+        }
+        if (mEnabled[toIndex(CharacteristicFunctionType::RECURSIVE_STALTA)])
+        {
+            auto yk = y[k] + offset;
+            mRecursiveSTALTA.apply(n, x, &yk);
+            k = k + 1;
+        }
+        if (mEnabled[toIndex(CharacteristicFunctionType::IIR_KURTOSIS)])
+        {
+            auto yk = y[k] + offset;
+            mIIRKurtosis.apply(n, x, &yk);
+            k = k + 1;
+        }
+        if (mEnabled[toIndex(CharacteristicFunctionType::FIR_ENVELOPE)])
+        {
+            auto yk = y[k] + offset;
+            mFIREnvelope.transform(n, x, &yk);
+        }
+    }
+    /// The number of enabled characteristic functions
+    [[nodiscard]] int getNumberEnabled() const noexcept
+    {
+        return static_cast<int> (std::count(mEnabled.begin(), mEnabled.end(),
+                                            true));
+    }
+///private:
+    /// The classic STA/LTA.  With one channel its ring of squared samples
+    /// is dense so the long-term window occupies nLTA samples.
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::REAL_TIME, T>
+        mClassicSTALTA;
+    RecursiveSTALTA<RTSeis::ProcessingMode::REAL_TIME, T> mRecursiveSTALTA;
+    RealTime::IIRKurtosis<T> mIIRKurtosis;
+    RTSeis::Utilities::Transforms::FIREnvelope<
+        RTSeis::ProcessingMode::REAL_TIME, T> mFIREnvelope;
+    /// Flags indicating which characteristic functions are enabled.  This
+    /// is indexed by CharacteristicFunctionType.
+    std::array<bool, N_TYPES> mEnabled = {false, false, false, false};
+};
+
+/// C'tor
+template<class T>
+CharacteristicFunctionBank<T>::CharacteristicFunctionBank() :
+    pImpl(std::make_unique<CharacteristicFunctionBankImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+CharacteristicFunctionBank<T>::CharacteristicFunctionBank(
+    const CharacteristicFunctionBank &bank)
+{
+    *this = bank;
+}
+
+/// Move c'tor
+template<class T>
+CharacteristicFunctionBank<T>::CharacteristicFunctionBank(
+    CharacteristicFunctionBank &&bank) noexcept
+{
+    *this = std::move(bank);
+}
+
+/// Copy assignment
+template<class T>
+CharacteristicFunctionBank<T>&
+CharacteristicFunctionBank<T>::operator=(const CharacteristicFunctionBank &bank)
+{
+    if (&bank == this){return *this;}
+    pImpl = std::make_unique<CharacteristicFunctionBankImpl> (*bank.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<class T>
+CharacteristicFunctionBank<T>&
+CharacteristicFunctionBank<T>::operator=(
+    CharacteristicFunctionBank &&bank) noexcept
+{
+    if (&bank == this){return *this;}
+    pImpl = std::move(bank.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+CharacteristicFunctionBank<T>::~CharacteristicFunctionBank() = default;
+
+/// Clear
+template<class T>
+void CharacteristicFunctionBank<T>::clear() noexcept
+{
+    disable(CharacteristicFunctionType::CLASSIC_STALTA);
+    disable(CharacteristicFunctionType::RECURSIVE_STALTA);
+    disable(CharacteristicFunctionType::IIR_KURTOSIS);
+    disable(CharacteristicFunctionType::FIR_ENVELOPE);
+}
+
+/// Enable the classic STA/LTA
+template<class T>
+void CharacteristicFunctionBank<T>::enableClassicSTALTA(const int nSTA,
+                                                        const int nLTA)
+{
+    disable(CharacteristicFunctionType::CLASSIC_STALTA);
+    pImpl->mClassicSTALTA.initialize(1, nSTA, nLTA); // Throws
+    pImpl->mEnabled[toIndex(CharacteristicFunctionType::CLASSIC_STALTA)]
+        = true;
+}
+
+/// Enable the recursive STA/LTA
+template<class T>
+void CharacteristicFunctionBank<T>::enableRecursiveSTALTA(const int nSTA,
+                                                          const int nLTA)
+{
+    disable(CharacteristicFunctionType::RECURSIVE_STALTA);
+    pImpl->mRecursiveSTALTA.initialize(nSTA, nLTA); // Throws
+    pImpl->mEnabled[toIndex(CharacteristicFunctionType::RECURSIVE_STALTA)]
+        = true;
+}
+
+/// Enable the kurtosis
+template<class T>
+void CharacteristicFunctionBank<T>::enableIIRKurtosis(const T c1)
+{
+    disable(CharacteristicFunctionType::IIR_KURTOSIS);
+    pImpl->mIIRKurtosis.initialize(c1); // Throws
+    pImpl->mEnabled[toIndex(CharacteristicFunctionType::IIR_KURTOSIS)] = true;
+}
+
+/// Enable the envelope
+template<class T>
+void CharacteristicFunctionBank<T>::enableFIREnvelope(const int nTaps)
+{
+    disable(CharacteristicFunctionType::FIR_ENVELOPE);
+    pImpl->mFIREnvelope.initialize(nTaps); // Throws
+    pImpl->mEnabled[toIndex(CharacteristicFunctionType::FIR_ENVELOPE)] = true;
+}
+
+/// Disable a characteristic function
+template<class T>
+void CharacteristicFunctionBank<T>::disable(
+    const CharacteristicFunctionType type) noexcept
+{
+    if (type == CharacteristicFunctionType::CLASSIC_STALTA)
+    {
+        pImpl->mClassicSTALTA.clear();
+    }
+    else if (type == CharacteristicFunctionType::RECURSIVE_STALTA)
+    {
+        pImpl->mRecursiveSTALTA.clear();
+    }
+    else if (type == CharacteristicFunctionType::IIR_KURTOSIS)
+    {
+        pImpl->mIIRKurtosis.clear();
+    }
+    else if (type == CharacteristicFunctionType::FIR_ENVELOPE)
+    {
+        pImpl->mFIREnvelope.clear();
+    }
+    pImpl->mEnabled[toIndex(type)] = false;
+}
+
+/// Is enabled?
+template<class T>
+bool CharacteristicFunctionBank<T>::isEnabled(
+    const CharacteristicFunctionType type) const noexcept
+{
+    return pImpl->mEnabled[toIndex(type)];
+}
+
+/// Number of enabled characteristic functions
+template<class T>
+int CharacteristicFunctionBank<T>::getNumberOfCharacteristicFunctions()
+    const noexcept
+{
+    return pImpl->getNumberEnabled();
+}
+
+/// Output index
+template<class T>
+int CharacteristicFunctionBank<T>::getOutputIndex(
+    const CharacteristicFunctionType type) const
+{
+    if (!isEnabled(type))
+    {
+        throw std::invalid_argument("Characteristic function "
+                                  + std::to_string(toIndex(type))
+                                  + " is not enabled");
+    }
+    auto index = toIndex(type);
+    return static_cast<int> (std::count(pImpl->mEnabled.begin(),
+                                        pImpl->mEnabled.begin() + index,
+                                        true));
+}
+
+/// Reset initial conditions
+template<class T>
+void CharacteristicFunctionBank<T>::resetInitialConditions()
+{
+    if (isEnabled(CharacteristicFunctionType::CLASSIC_STALTA))
+    {
+        pImpl->mClassicSTALTA.resetInitialConditions();
+    }
+    if (isEnabled(CharacteristicFunctionType::RECURSIVE_STALTA))
+    {
+        pImpl->mRecursiveSTALTA.resetInitialConditions();
+    }
+    if (isEnabled(CharacteristicFunctionType::IIR_KURTOSIS))
+    {
+        pImpl->mIIRKurtosis.resetInitialConditions();
+    }
+    if (isEnabled(CharacteristicFunctionType::FIR_ENVELOPE))
+    {
+        pImpl->mFIREnvelope.resetInitialConditions();
+    }
+}
+
+/// Apply
+template<class T>
+void CharacteristicFunctionBank<T>::apply(const int nSamples, const T x[],
+                                          T *y[])
+{
+    if (nSamples <= 0){return;}
+    auto nOutputs = getNumberOfCharacteristicFunctions();
+    if (nOutputs < 1)
+    {
+        throw std::runtime_error("No characteristic functions enabled");
+    }
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    if (y == nullptr){throw std::invalid_argument("y is NULL");}
+    for (int k=0; k<nOutputs; k++)
+    {
+        if (y[k] == nullptr)
+        {
+            throw std::invalid_argument("y[" + std::to_string(k)
+                                      + "] is NULL");
+        }
+    }
+    // Every characteristic function consumes a block while it is in cache
+    for (int i0=0; i0<nSamples; i0=i0+BLOCK_SIZE)
+    {
+        auto n = std::min(BLOCK_SIZE, nSamples - i0);
+        pImpl->applyBlock(n, x + i0, y, i0);
+    }
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::CharacteristicFunction::CharacteristicFunctionBank<double>;
+template class RTSeis::Utilities::CharacteristicFunction::CharacteristicFunctionBank<float>;
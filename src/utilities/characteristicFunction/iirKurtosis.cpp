@@ -1,9 +1,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <stdexcept>
 #include <cmath>
 #include <array>
-#include "rtseis/private/throw.hpp"
+#include "private/throw.hpp"
+#include "private/iirKurtosis.hpp"
 #include "rtseis/utilities/characteristicFunction/iirKurtosis.hpp"
 
 namespace RealTime = RTSeis::Utilities::CharacteristicFunction::RealTime;
@@ -28,16 +30,7 @@ public:
     /// Applies the filter
     void apply(const int n, const T x[], T y[]) noexcept
     {
-        // Compute some constants 
-        const T two = 2;
-        const T one = 1;
-        const T half = one/two;
-        auto c1 = mC1;
-        auto a1 = one - c1; 
-        auto c2 = half*(one - a1*a1);
-        auto one_p_c1 = one + c1; 
-        auto two_c1 = two*c1;
-        auto bias =-3.0*c1 - 3.0;
+        const IIRKurtosisCoefficients<T> coeffs(mC1);
         // Get the delay lines
         auto mu1Delay = mDelay[0];
         auto mu2Delay = mDelay[1];
@@ -45,21 +38,8 @@ public:
         // Apply the filter
         for (int i=0; i<n; i++)
         {
-             auto mu1 = a1*mu1Delay + c1*x[i]; // Update IIR averaging
-             auto dx  = x[i] - mu1Delay;
-             auto dx2 = dx*dx;
-             auto mu2 = a1*mu2Delay + c2*dx2;  // Update IIR averaging
-             dx2 = dx2/mu2Delay;
-             // one_p_c1 - two_c1*dx2
-             auto xscal = std::fma(-two_c1, dx2, one_p_c1); // one_p_c1 - two_c1*dx2;
-             auto dx22 = dx2*dx2;
-             auto c1_dx22 = c1*dx22 + bias;
-             // xscal*k4barDelay + c1_dx22 + bias
-             y[i] = std::fma(xscal, k4barDelay, c1_dx22);
-             // Update delay lines 
-             mu1Delay = mu1;
-             mu2Delay = mu2;
-             k4barDelay = y[i]; // This is k4bar
+            y[i] = iirKurtosisUpdate(coeffs, x[i],
+                                     mu1Delay, mu2Delay, k4barDelay);
         }
         // Update the final conditions
         if (mRealTime)
@@ -92,8 +72,8 @@ public:
         mDelay = {0, 1, 0};
         mZi = {0, 1, 0};
         mC1 = 0.9;
-        mRealTime = false;
         mInitialized = false;
+        // Note: Do not touch mRealTime
     }
 //private:
     /// The delay line.  This is ordered the mean of the first order moment,
@@ -0,0 +1,426 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <ipps.h>
+#include "rtseis/enums.hpp"
+#include "private/throw.hpp"
+#include "private/channelBlocks.hpp"
+#include "rtseis/utilities/characteristicFunction/multiChannelClassicSTALTA.hpp"
+
+using namespace RTSeis::Utilities::CharacteristicFunction;
+
+namespace
+{
+/// The running sums are recomputed from the squared samples after this many
+/// passes through the long-term window.  Between re-summations the relative
+/// drift is at most this many times the long-term window length times the
+/// double precision machine epsilon.
+constexpr int RESUMMATION_PERIOD = 8;
+/// @result The drift bound relative to the largest long-term sum since the
+///         last re-summation.  Smaller long-term sums are indistinguishable
+///         from zero, e.g., when the long-term window is digitally quiet.
+double driftTolerance(const int nLTA)
+{
+    return static_cast<double> ((RESUMMATION_PERIOD + 1)*nLTA)
+          *std::numeric_limits<double>::epsilon();
+}
+
+/// @brief Updates the STA/LTA of a block of channels.
+/// @param[in] nSamples    The number of samples in each channel.
+/// @param[in] nChannels   The total number of channels.
+/// @param[in] c0          The first channel in this block.
+/// @param[in] nc          The number of channels in this block.
+/// @param[in] nLTA        The number of samples in the long-term window.
+/// @param[in] staLag      The offset from the oldest sample in the long-term
+///                        window to the oldest sample in the short-term
+///                        window, i.e., nLTA - nSTA.
+/// @param[in] position    The row of the ring holding the oldest sample in
+///                        the long-term window.
+/// @param[in] warmUp      The number of primed samples that remain in the
+///                        long-term window.
+/// @param[in] primer      The value with which the long-term window is
+///                        primed.
+/// @param[in] staScale    1/nSTA.
+/// @param[in] ltaScale    1/nLTA.
+/// @param[in] tol         Long-term sums smaller than tol times the largest
+///                        long-term sum since the last re-summation yield 0.
+/// @param[in,out] staSum  The running short-term sums.
+/// @param[in,out] ltaSum  The running long-term sums.
+/// @param[in,out] ltaMax  The largest long-term sums since the last
+///                        re-summation.
+/// @param[in,out] ring    The squared samples in the long-term window.  This
+///                        is a row major matrix of dimension [nLTA x ldr].
+/// @param[in] ldr         The leading dimension of ring.
+/// @param[in] x           The channel-interleaved input signals.
+/// @param[out] y          The channel-interleaved STA/LTA.
+template<class T>
+void staltaBlock(const int nSamples, const int nChannels,
+                 const int c0, const int nc,
+                 const int nLTA, const int staLag,
+                 int position, int warmUp,
+                 const double primer,
+                 const double staScale, const double ltaScale,
+                 const double tol,
+                 double *__restrict__ staSum, double *__restrict__ ltaSum,
+                 double *__restrict__ ltaMax,
+                 T *ring, const int ldr,
+                 const T *x, T *y)
+{
+    staSum = staSum + c0;
+    ltaSum = ltaSum + c0;
+    ltaMax = ltaMax + c0;
+    for (int i=0; i<nSamples; i++)
+    {
+        auto xi = x + static_cast<size_t> (i)*nChannels + c0;
+        auto yi = y + static_cast<size_t> (i)*nChannels + c0;
+        auto staPosition = position + staLag;
+        if (staPosition >= nLTA){staPosition = staPosition - nLTA;}
+        // These rows coincide when nSTA = nLTA so they cannot be restricted
+        T *ltaOld = ring + static_cast<size_t> (position)*ldr + c0;
+        const T *staOld = ring + static_cast<size_t> (staPosition)*ldr + c0;
+        const double primed = primer*static_cast<double> (warmUp);
+        #pragma omp simd
+        for (int ic=0; ic<nc; ic++)
+        {
+            T x2 = xi[ic]*xi[ic];
+            auto x2d = static_cast<double> (x2);
+            auto sta = staSum[ic] + (x2d - static_cast<double> (staOld[ic]));
+            auto lta = ltaSum[ic] + (x2d - static_cast<double> (ltaOld[ic]));
+            staSum[ic] = sta;
+            ltaSum[ic] = lta;
+            ltaMax[ic] = std::max(ltaMax[ic], lta);
+            ltaOld[ic] = x2;
+            auto staMean = std::max(0.0, sta)*staScale;
+            auto ltaMean = (lta + primed)*ltaScale;
+            // This also guards the division when the window is all zeros
+            yi[ic] = (lta <= tol*ltaMax[ic]) ?
+                     0 : static_cast<T> (staMean/ltaMean);
+        }
+        position = position + 1;
+        if (position == nLTA){position = 0;}
+        warmUp = std::max(0, warmUp - 1);
+    }
+}
+
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class MultiChannelClassicSTALTA<E, T>::MultiChannelClassicSTALTAImpl
+{
+public:
+    /// Default constructor
+    MultiChannelClassicSTALTAImpl() = default;
+    /// Copy constructor
+    MultiChannelClassicSTALTAImpl(const MultiChannelClassicSTALTAImpl &stalta)
+    {
+        *this = stalta;
+    }
+    /// (Deep) copy operator
+    MultiChannelClassicSTALTAImpl&
+        operator=(const MultiChannelClassicSTALTAImpl &stalta)
+    {
+        if (&stalta == this){return *this;}
+        clear();
+        if (!stalta.mInitialized){return *this;}
+        initialize(stalta.mChannels, stalta.mSTA, stalta.mLTA);
+        mSums = stalta.mSums;
+        mRing = stalta.mRing;
+        mPosition = stalta.mPosition;
+        mWarmUp = stalta.mWarmUp;
+        mSamplesSinceResummation = stalta.mSamplesSinceResummation;
+        return *this;
+    }
+    /// Destructor
+    ~MultiChannelClassicSTALTAImpl()
+    {
+        clear();
+    }
+    /// Releases memory
+    void clear() noexcept
+    {
+        mSums.clear();
+        mRing.clear();
+        mChannels = 0;
+        mSTA = 0;
+        mLTA = 0;
+        mPosition = 0;
+        mWarmUp = 0;
+        mSamplesSinceResummation = 0;
+        mInitialized = false;
+    }
+    /// Initializes the running sums and the squared samples
+    void initialize(const int nChannels, const int nSTA, const int nLTA)
+    {
+        clear();
+        mChannels = nChannels;
+        mSTA = nSTA;
+        mLTA = nLTA;
+        try
+        {
+            mSums.allocate(3, mChannels);
+            mRing.allocate(mLTA, mChannels);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            clear();
+            RTSEIS_THROW_IA("%s", "Too many channels or nLTA too large");
+        }
+        // The long-term window is primed with a large number so that the
+        // startup calculation is like 0/big which is 0.  This matches the
+        // initial conditions of ClassicSTALTA.
+        mPrimer = static_cast<double> (std::numeric_limits<T>::max()
+                                      /static_cast<T> (4*mLTA));
+        mInitialized = true;
+        resetInitialConditions();
+    }
+    /// Resets the initial conditions
+    void resetInitialConditions() noexcept
+    {
+        mSums.zero();
+        mRing.zero();
+        mPosition = 0;
+        mWarmUp = mLTA - 1;
+        mSamplesSinceResummation = 0;
+    }
+    /// Recomputes the running sums from the squared samples
+    void resum() noexcept
+    {
+        mSums.zero();
+        for (int ir=0; ir<mLTA; ir++)
+        {
+            const T *__restrict__ row = mRing.row(ir);
+            double *__restrict__ ltaSum = mSums.row(1);
+            #pragma omp simd
+            for (int c=0; c<mChannels; c++)
+            {
+                ltaSum[c] = ltaSum[c] + static_cast<double> (row[c]);
+            }
+        }
+        // The short-term window is the newest nSTA rows
+        auto ir = mPosition + (mLTA - mSTA);
+        for (int k=0; k<mSTA; k++)
+        {
+            if (ir >= mLTA){ir = ir - mLTA;}
+            const T *__restrict__ row = mRing.row(ir);
+            double *__restrict__ staSum = mSums.row(0);
+            #pragma omp simd
+            for (int c=0; c<mChannels; c++)
+            {
+                staSum[c] = staSum[c] + static_cast<double> (row[c]);
+            }
+            ir = ir + 1;
+        }
+        // The roundoff is now that of a single summation
+        std::copy(mSums.row(1), mSums.row(1) + mChannels, mSums.row(2));
+    }
+    /// Applies the STA/LTA
+    void apply(const int nSamples, const T x[], T y[]) noexcept
+    {
+        const double staScale = 1.0/static_cast<double> (mSTA);
+        const double ltaScale = 1.0/static_cast<double> (mLTA);
+        const auto tol = driftTolerance(mLTA);
+        const int resummationInterval = RESUMMATION_PERIOD*mLTA;
+        auto staLag = mLTA - mSTA;
+        auto staSum = mSums.row(0);
+        auto ltaSum = mSums.row(1);
+        auto ltaMax = mSums.row(2);
+        auto ring = mRing.row(0);
+        auto ldr = mRing.getLeadingDimension();
+        int i0 = 0;
+        while (i0 < nSamples)
+        {
+            // Process up to the next re-summation
+            auto nloc = std::min(nSamples - i0,
+                                 resummationInterval
+                               - mSamplesSinceResummation);
+            auto xi = x + static_cast<size_t> (i0)*mChannels;
+            auto yi = y + static_cast<size_t> (i0)*mChannels;
+            forEachChannelBlock(mChannels, [&](const int c0, const int nc)
+            {
+                staltaBlock(nloc, mChannels, c0, nc, mLTA, staLag,
+                            mPosition, mWarmUp, mPrimer,
+                            staScale, ltaScale, tol,
+                            staSum, ltaSum, ltaMax, ring, ldr, xi, yi);
+            });
+            mPosition = (mPosition + nloc)%mLTA;
+            mWarmUp = std::max(0, mWarmUp - nloc);
+            mSamplesSinceResummation = mSamplesSinceResummation + nloc;
+            if (mSamplesSinceResummation == resummationInterval)
+            {
+                resum();
+                mSamplesSinceResummation = 0;
+            }
+            i0 = i0 + nloc;
+        }
+        // In post-processing every application starts anew
+        if (mMode == RTSeis::ProcessingMode::POST){resetInitialConditions();}
+    }
+///private:
+    /// The running short-term sums, the running long-term sums, and the
+    /// largest long-term sums since the last re-summation.
+    ChannelState<double> mSums;
+    /// The squared samples in the long-term window.  This has mLTA rows
+    /// and is used as a circular buffer.
+    ChannelState<T> mRing;
+    /// The value with which the long-term window is primed.
+    double mPrimer = 0;
+    /// The number of channels.
+    int mChannels = 0;
+    /// The number of samples in the short-term window.
+    int mSTA = 0;
+    /// The number of samples in the long-term window.
+    int mLTA = 0;
+    /// The ring row holding the oldest sample in the long-term window.
+    int mPosition = 0;
+    /// The number of primed samples remaining in the long-term window.
+    int mWarmUp = 0;
+    /// The number of samples processed since the sums were recomputed.
+    int mSamplesSinceResummation = 0;
+    /// Real-time or post-processing.
+    const RTSeis::ProcessingMode mMode = E;
+    /// Flag indicating the module is initialized.
+    bool mInitialized = false;
+};
+
+//============================================================================//
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelClassicSTALTA<E, T>::MultiChannelClassicSTALTA() :
+    pImpl(std::make_unique<MultiChannelClassicSTALTAImpl>())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelClassicSTALTA<E, T>::MultiChannelClassicSTALTA(
+    const MultiChannelClassicSTALTA &stalta)
+{
+    *this = stalta;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelClassicSTALTA<E, T>::MultiChannelClassicSTALTA(
+    MultiChannelClassicSTALTA &&stalta) noexcept
+{
+    *this = std::move(stalta);
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelClassicSTALTA<E, T>::~MultiChannelClassicSTALTA() = default;
+
+/// Clear the class
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelClassicSTALTA<E, T>::clear() noexcept
+{
+    pImpl->clear();
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelClassicSTALTA<E, T>&
+MultiChannelClassicSTALTA<E, T>::operator=(
+    const MultiChannelClassicSTALTA &stalta)
+{
+    if (&stalta == this){return *this;}
+    if (pImpl){pImpl->clear();}
+    pImpl = std::make_unique<MultiChannelClassicSTALTAImpl> (*stalta.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelClassicSTALTA<E, T>&
+MultiChannelClassicSTALTA<E, T>::operator=(
+    MultiChannelClassicSTALTA &&stalta) noexcept
+{
+    if (&stalta == this){return *this;}
+    pImpl = std::move(stalta.pImpl);
+    return *this;
+}
+
+/// Initialization
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelClassicSTALTA<E, T>::initialize(const int nChannels,
+                                                 const int nSTA,
+                                                 const int nLTA)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must be positive", nChannels);
+    }
+    if (nSTA < 2){RTSEIS_THROW_IA("nSTA = %d must be at least 2", nSTA);}
+    if (nLTA < nSTA)
+    {
+        RTSEIS_THROW_IA("nLTA = %d must be at least %d", nLTA, nSTA);
+    }
+    pImpl->initialize(nChannels, nSTA, nLTA);
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelClassicSTALTA<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Apply the STA/LTA
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelClassicSTALTA<E, T>::apply(const int nSamples, const T x[],
+                                            T *yIn[])
+{
+    if (nSamples <= 0){return;}
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    auto y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+        RTSEIS_THROW_IA("%s", "y is NULL");
+    }
+    pImpl->apply(nSamples, x, y);
+}
+
+/// Get number of channels
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelClassicSTALTA<E, T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Get the short-term window length
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelClassicSTALTA<E, T>::getShortTermWindowLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mSTA;
+}
+
+/// Get the long-term window length
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelClassicSTALTA<E, T>::getLongTermWindowLength() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mLTA;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool MultiChannelClassicSTALTA<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::CharacteristicFunction::MultiChannelClassicSTALTA<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Utilities::CharacteristicFunction::MultiChannelClassicSTALTA<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Utilities::CharacteristicFunction::MultiChannelClassicSTALTA<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Utilities::CharacteristicFunction::MultiChannelClassicSTALTA<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -0,0 +1,288 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <ipps.h>
+#include "rtseis/enums.hpp"
+#include "private/throw.hpp"
+#include "private/channelBlocks.hpp"
+#include "private/iirKurtosis.hpp"
+#include "rtseis/utilities/characteristicFunction/multiChannelIIRKurtosis.hpp"
+
+using namespace RTSeis::Utilities::CharacteristicFunction;
+
+namespace
+{
+/// @brief Applies the kurtosis recursion to a block of channels.
+/// @param[in] nSamples     The number of samples in each channel.
+/// @param[in] nChannels    The total number of channels.
+/// @param[in] c0           The first channel in this block.
+/// @param[in] nc           The number of channels in this block.
+/// @param[in] coeffs       The filter constants.
+/// @param[in,out] mu1      The means of the first order moment.
+/// @param[in,out] mu2      The means of the second order moment.
+/// @param[in,out] k4bar    The unbiased kurtosis values.
+/// @param[in] x            The channel-interleaved input signals.
+/// @param[out] y           The channel-interleaved kurtosis.
+template<class T>
+void kurtosisBlock(const int nSamples, const int nChannels,
+                   const int c0, const int nc,
+                   const IIRKurtosisCoefficients<T> &coeffs,
+                   T *__restrict__ mu1, T *__restrict__ mu2,
+                   T *__restrict__ k4bar,
+                   const T *x, T *y)
+{
+    mu1 = mu1 + c0;
+    mu2 = mu2 + c0;
+    k4bar = k4bar + c0;
+    for (int i=0; i<nSamples; i++)
+    {
+        // x and y may alias.  Each output is written after its input is read.
+        const T *xi = x + static_cast<size_t> (i)*nChannels + c0;
+        T *yi = y + static_cast<size_t> (i)*nChannels + c0;
+        #pragma omp simd
+        for (int ic=0; ic<nc; ic++)
+        {
+            yi[ic] = iirKurtosisUpdate(coeffs, xi[ic],
+                                       mu1[ic], mu2[ic], k4bar[ic]);
+        }
+    }
+}
+
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class MultiChannelIIRKurtosis<E, T>::MultiChannelIIRKurtosisImpl
+{
+public:
+    /// Default constructor
+    MultiChannelIIRKurtosisImpl() = default;
+    /// Copy constructor
+    MultiChannelIIRKurtosisImpl(const MultiChannelIIRKurtosisImpl &kurtosis)
+    {
+        *this = kurtosis;
+    }
+    /// (Deep) copy operator
+    MultiChannelIIRKurtosisImpl&
+        operator=(const MultiChannelIIRKurtosisImpl &kurtosis)
+    {
+        if (&kurtosis == this){return *this;}
+        clear();
+        if (!kurtosis.mInitialized){return *this;}
+        initialize(kurtosis.mChannels, kurtosis.mC1);
+        mZi = kurtosis.mZi;
+        mDelay = kurtosis.mDelay;
+        return *this;
+    }
+    /// Destructor
+    ~MultiChannelIIRKurtosisImpl()
+    {
+        clear();
+    }
+    /// Releases memory
+    void clear() noexcept
+    {
+        mDelay.clear();
+        mZi.clear();
+        mC1 = 0.9;
+        mChannels = 0;
+        mInitialized = false;
+    }
+    /// Initializes the delay lines
+    void initialize(const int nChannels, const T c1)
+    {
+        clear();
+        mChannels = nChannels;
+        mC1 = c1;
+        mZi.allocate(3, mChannels);
+        // Default initial conditions are mu1 = 0, mu2 = 1, k4bar = 0
+        std::fill(mZi.row(1), mZi.row(1) + mChannels, 1);
+        mDelay = mZi;
+        mInitialized = true;
+    }
+    /// Sets the initial conditions for a channel
+    void setInitialConditions(const int channel,
+                              const T mu1, const T mu2, const T k4bar) noexcept
+    {
+        mZi.row(0)[channel] = mu1;
+        mZi.row(1)[channel] = mu2;
+        mZi.row(2)[channel] = k4bar;
+        mDelay.row(0)[channel] = mu1;
+        mDelay.row(1)[channel] = mu2;
+        mDelay.row(2)[channel] = k4bar;
+    }
+    /// Resets the initial conditions
+    void resetInitialConditions() noexcept
+    {
+        std::memcpy(mDelay.row(0), mZi.row(0), mZi.getSizeInBytes());
+    }
+    /// Applies the filter
+    void apply(const int nSamples, const T x[], T y[]) noexcept
+    {
+        const IIRKurtosisCoefficients<T> coeffs(mC1);
+        auto mu1 = mDelay.row(0);
+        auto mu2 = mDelay.row(1);
+        auto k4bar = mDelay.row(2);
+        forEachChannelBlock(mChannels, [&](const int c0, const int nc)
+        {
+            kurtosisBlock(nSamples, mChannels, c0, nc, coeffs,
+                          mu1, mu2, k4bar, x, y);
+        });
+        // In post-processing every application starts anew
+        if (mMode == RTSeis::ProcessingMode::POST){resetInitialConditions();}
+    }
+///private:
+    /// The structure-of-arrays delay lines.  The rows are the means of the
+    /// first and second order moments and the unbiased kurtosis.
+    ChannelState<T> mDelay;
+    /// The initial conditions.  This has the same layout as mDelay.
+    ChannelState<T> mZi;
+    /// The pole in the filter.
+    T mC1 = 0.9;
+    /// The number of channels.
+    int mChannels = 0;
+    /// Real-time or post-processing.
+    const RTSeis::ProcessingMode mMode = E;
+    /// Flag indicating the module is initialized.
+    bool mInitialized = false;
+};
+
+//============================================================================//
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelIIRKurtosis<E, T>::MultiChannelIIRKurtosis() :
+    pImpl(std::make_unique<MultiChannelIIRKurtosisImpl>())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelIIRKurtosis<E, T>::MultiChannelIIRKurtosis(
+    const MultiChannelIIRKurtosis &kurtosis)
+{
+    *this = kurtosis;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelIIRKurtosis<E, T>::MultiChannelIIRKurtosis(
+    MultiChannelIIRKurtosis &&kurtosis) noexcept
+{
+    *this = std::move(kurtosis);
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelIIRKurtosis<E, T>::~MultiChannelIIRKurtosis() = default;
+
+/// Clear the class
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelIIRKurtosis<E, T>::clear() noexcept
+{
+    pImpl->clear();
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelIIRKurtosis<E, T>&
+MultiChannelIIRKurtosis<E, T>::operator=(
+    const MultiChannelIIRKurtosis &kurtosis)
+{
+    if (&kurtosis == this){return *this;}
+    if (pImpl){pImpl->clear();}
+    pImpl = std::make_unique<MultiChannelIIRKurtosisImpl> (*kurtosis.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelIIRKurtosis<E, T>&
+MultiChannelIIRKurtosis<E, T>::operator=(
+    MultiChannelIIRKurtosis &&kurtosis) noexcept
+{
+    if (&kurtosis == this){return *this;}
+    pImpl = std::move(kurtosis.pImpl);
+    return *this;
+}
+
+/// Initialization
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelIIRKurtosis<E, T>::initialize(const int nChannels,
+                                               const T c1)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must be positive", nChannels);
+    }
+    if (std::abs(c1) >= 1)
+    {
+        RTSEIS_THROW_IA("|c1| = %e must be less than 1", c1);
+    }
+    pImpl->initialize(nChannels, c1);
+}
+
+/// Set initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelIIRKurtosis<E, T>::setInitialConditions(const int channel,
+                                                         const T mu1,
+                                                         const T mu2,
+                                                         const T k4bar)
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (channel < 0 || channel >= pImpl->mChannels)
+    {
+        RTSEIS_THROW_IA("channel = %d must be in range [0,%d]",
+                        channel, pImpl->mChannels - 1);
+    }
+    pImpl->setInitialConditions(channel, mu1, mu2, k4bar);
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelIIRKurtosis<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Apply the filter
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelIIRKurtosis<E, T>::apply(const int nSamples, const T x[],
+                                          T *yIn[])
+{
+    if (nSamples <= 0){return;}
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    auto y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+        RTSEIS_THROW_IA("%s", "y is NULL");
+    }
+    pImpl->apply(nSamples, x, y);
+}
+
+/// Get number of channels
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelIIRKurtosis<E, T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool MultiChannelIIRKurtosis<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::CharacteristicFunction::MultiChannelIIRKurtosis<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Utilities::CharacteristicFunction::MultiChannelIIRKurtosis<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Utilities::CharacteristicFunction::MultiChannelIIRKurtosis<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Utilities::CharacteristicFunction::MultiChannelIIRKurtosis<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -0,0 +1,272 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <ipps.h>
+#include "rtseis/enums.hpp"
+#include "private/throw.hpp"
+#include "private/channelBlocks.hpp"
+#include "rtseis/utilities/characteristicFunction/recursiveSTALTA.hpp"
+
+using namespace RTSeis::Utilities::CharacteristicFunction;
+
+namespace
+{
+/// @brief Updates the recursive STA/LTA of a block of channels.
+/// @param[in] nSamples     The number of samples in each channel.
+/// @param[in] nChannels    The total number of channels.
+/// @param[in] c0           The first channel in this block.
+/// @param[in] nc           The number of channels in this block.
+/// @param[in] nQuiet       The number of leading samples whose output is 0
+///                         while the LTA warms up.
+/// @param[in] csta         1/nSTA.
+/// @param[in] clta         1/nLTA.
+/// @param[in,out] staAvg   The short-term averages.
+/// @param[in,out] ltaAvg   The long-term averages.
+/// @param[in] x            The channel-interleaved input signals.
+/// @param[out] y           The channel-interleaved STA/LTA.
+template<class T>
+void recursiveSTALTABlock(const int nSamples, const int nChannels,
+                          const int c0, const int nc, const int nQuiet,
+                          const double csta, const double clta,
+                          double *__restrict__ staAvg,
+                          double *__restrict__ ltaAvg,
+                          const T *x, T *y)
+{
+    staAvg = staAvg + c0;
+    ltaAvg = ltaAvg + c0;
+    const double omcsta = 1 - csta;
+    const double omclta = 1 - clta;
+    for (int i=0; i<nSamples; i++)
+    {
+        // x and y may alias.  Each output is written after its input is read.
+        const T *xi = x + static_cast<size_t> (i)*nChannels + c0;
+        T *yi = y + static_cast<size_t> (i)*nChannels + c0;
+        const bool quiet = (i < nQuiet);
+        #pragma omp simd
+        for (int ic=0; ic<nc; ic++)
+        {
+            auto x2 = static_cast<double> (xi[ic])*static_cast<double> (xi[ic]);
+            auto sta = csta*x2 + omcsta*staAvg[ic];
+            auto lta = clta*x2 + omclta*ltaAvg[ic];
+            staAvg[ic] = sta;
+            ltaAvg[ic] = lta;
+            yi[ic] = (quiet || lta <= 0) ? 0 : static_cast<T> (sta/lta);
+        }
+    }
+}
+
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class RecursiveSTALTA<E, T>::RecursiveSTALTAImpl
+{
+public:
+    /// Default constructor
+    RecursiveSTALTAImpl() = default;
+    /// Copy constructor
+    RecursiveSTALTAImpl(const RecursiveSTALTAImpl &stalta)
+    {
+        *this = stalta;
+    }
+    /// (Deep) copy operator
+    RecursiveSTALTAImpl& operator=(const RecursiveSTALTAImpl &stalta)
+    {
+        if (&stalta == this){return *this;}
+        clear();
+        if (!stalta.mInitialized){return *this;}
+        initialize(stalta.mChannels, stalta.mSTA, stalta.mLTA);
+        mAverages = stalta.mAverages;
+        mWarmUp = stalta.mWarmUp;
+        return *this;
+    }
+    /// Destructor
+    ~RecursiveSTALTAImpl()
+    {
+        clear();
+    }
+    /// Releases memory
+    void clear() noexcept
+    {
+        mAverages.clear();
+        mChannels = 0;
+        mSTA = 0;
+        mLTA = 0;
+        mWarmUp = 0;
+        mInitialized = false;
+    }
+    /// Initializes the averages
+    void initialize(const int nChannels, const int nSTA, const int nLTA)
+    {
+        clear();
+        mChannels = nChannels;
+        mSTA = nSTA;
+        mLTA = nLTA;
+        mAverages.allocate(2, mChannels);
+        mInitialized = true;
+        resetInitialConditions();
+    }
+    /// Resets the initial conditions
+    void resetInitialConditions() noexcept
+    {
+        mAverages.zero();
+        mWarmUp = mLTA;
+    }
+    /// Applies the STA/LTA
+    void apply(const int nSamples, const T x[], T y[]) noexcept
+    {
+        const double csta = 1.0/static_cast<double> (mSTA);
+        const double clta = 1.0/static_cast<double> (mLTA);
+        auto nQuiet = std::min(nSamples, mWarmUp);
+        auto staAvg = mAverages.row(0);
+        auto ltaAvg = mAverages.row(1);
+        forEachChannelBlock(mChannels, [&](const int c0, const int nc)
+        {
+            recursiveSTALTABlock(nSamples, mChannels, c0, nc, nQuiet,
+                                 csta, clta, staAvg, ltaAvg, x, y);
+        });
+        mWarmUp = mWarmUp - nQuiet;
+        // In post-processing every application starts anew
+        if (mMode == RTSeis::ProcessingMode::POST){resetInitialConditions();}
+    }
+///private:
+    /// The short-term averages followed by the long-term averages.
+    ChannelState<double> mAverages;
+    /// The number of channels.
+    int mChannels = 0;
+    /// The short-term characteristic length.
+    int mSTA = 0;
+    /// The long-term characteristic length.
+    int mLTA = 0;
+    /// The number of samples remaining in the warm-up period.
+    int mWarmUp = 0;
+    /// Real-time or post-processing.
+    const RTSeis::ProcessingMode mMode = E;
+    /// Flag indicating the module is initialized.
+    bool mInitialized = false;
+};
+
+//============================================================================//
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+RecursiveSTALTA<E, T>::RecursiveSTALTA() :
+    pImpl(std::make_unique<RecursiveSTALTAImpl>())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+RecursiveSTALTA<E, T>::RecursiveSTALTA(const RecursiveSTALTA &stalta)
+{
+    *this = stalta;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+RecursiveSTALTA<E, T>::RecursiveSTALTA(RecursiveSTALTA &&stalta) noexcept
+{
+    *this = std::move(stalta);
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+RecursiveSTALTA<E, T>::~RecursiveSTALTA() = default;
+
+/// Clear the class
+template<RTSeis::ProcessingMode E, class T>
+void RecursiveSTALTA<E, T>::clear() noexcept
+{
+    pImpl->clear();
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+RecursiveSTALTA<E, T>&
+RecursiveSTALTA<E, T>::operator=(const RecursiveSTALTA &stalta)
+{
+    if (&stalta == this){return *this;}
+    if (pImpl){pImpl->clear();}
+    pImpl = std::make_unique<RecursiveSTALTAImpl> (*stalta.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+RecursiveSTALTA<E, T>&
+RecursiveSTALTA<E, T>::operator=(RecursiveSTALTA &&stalta) noexcept
+{
+    if (&stalta == this){return *this;}
+    pImpl = std::move(stalta.pImpl);
+    return *this;
+}
+
+/// Initialization
+template<RTSeis::ProcessingMode E, class T>
+void RecursiveSTALTA<E, T>::initialize(const int nSTA, const int nLTA)
+{
+    initialize(1, nSTA, nLTA);
+}
+
+template<RTSeis::ProcessingMode E, class T>
+void RecursiveSTALTA<E, T>::initialize(const int nChannels,
+                                       const int nSTA,
+                                       const int nLTA)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must be positive", nChannels);
+    }
+    if (nSTA < 2){RTSEIS_THROW_IA("nSTA = %d must be at least 2", nSTA);}
+    if (nLTA < nSTA)
+    {
+        RTSEIS_THROW_IA("nLTA = %d must be at least %d", nLTA, nSTA);
+    }
+    pImpl->initialize(nChannels, nSTA, nLTA);
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void RecursiveSTALTA<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Apply the STA/LTA
+template<RTSeis::ProcessingMode E, class T>
+void RecursiveSTALTA<E, T>::apply(const int nSamples, const T x[], T *yIn[])
+{
+    if (nSamples <= 0){return;}
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    auto y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+        RTSEIS_THROW_IA("%s", "y is NULL");
+    }
+    pImpl->apply(nSamples, x, y);
+}
+
+/// Get number of channels
+template<RTSeis::ProcessingMode E, class T>
+int RecursiveSTALTA<E, T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool RecursiveSTALTA<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::CharacteristicFunction::RecursiveSTALTA<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Utilities::CharacteristicFunction::RecursiveSTALTA<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Utilities::CharacteristicFunction::RecursiveSTALTA<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Utilities::CharacteristicFunction::RecursiveSTALTA<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -1,6 +1,11 @@
 #include <cstdio>
+#include <cmath>
 #include <climits>
 #include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <type_traits>
 #ifndef NDEBBUG
 #include <cassert>
 #endif
@@ -16,6 +21,162 @@
 using namespace RTSeis::Utilities;
 using namespace RTSeis::Utilities::FilterImplementations;
 
+namespace
+{
+
+/// The downsampling factors available to a multistage decimator.  These
+/// are taken largest first so that the later, sharper, stages run at
+/// the lowest sampling rates.
+const std::array<int, 4> STAGE_FACTORS{5, 4, 3, 2};
+/// The fraction of the output Nyquist frequency that the earlier stages
+/// will protect from aliasing is never less than this.
+constexpr double MIN_PASSBAND_FRACTION = 0.25;
+/// Unless the phase shift is removed, the multistage decimator processes
+/// at most this many input samples at a time.  This lets its workspace be
+/// sized at initialization.
+constexpr int MULTISTAGE_BLOCK_SIZE = 4096;
+
+/// Factors the downsampling factor into stages of 5, 4, 3, and 2.
+/// If this is not possible then the result is empty.
+std::vector<int> factorDownsamplingFactor(const int downFactor)
+{
+    std::vector<int> factors;
+    int remainder = downFactor;
+    for (const auto factor : STAGE_FACTORS)
+    {
+        while (remainder%factor == 0)
+        {
+            factors.push_back(factor);
+            remainder = remainder/factor;
+        }
+    }
+    if (remainder != 1){factors.clear();}
+    return factors;
+}
+
+/// The transition width of a Hamming window-based filter of length n is
+/// approximately 6.6/n where 1 is the Nyquist frequency.  This returns the
+/// odd filter length that achieves the given transition width.
+int computeHammingFilterLength(const double transitionWidth)
+{
+    auto nfir = static_cast<int> (std::ceil(6.6/transitionWidth));
+    nfir = std::max(5, nfir);
+    if (nfir%2 == 0){nfir = nfir + 1;}
+    return nfir;
+}
+
+/// Increases the filter length until it is odd and its group delay is
+/// evenly divisible by the downsampling factor.
+int padFilterLength(const int filterLength, const int downFactor)
+{
+    int nfir = filterLength;
+    while ((nfir - 1)/2%downFactor != 0 || nfir%2 == 0)
+    {
+        nfir = nfir + 1;
+    }
+    return nfir;
+}
+
+/// A single stage of a multistage decimator.  The lowpass filter is applied
+/// in polyphase form, i.e., the filter is only evaluated at the retained
+/// samples.
+template<class T>
+class DecimationStage
+{
+public:
+    /// Initializes the stage.
+    void initialize(const int downFactor, const int nfir,
+                    const bool lRemovePhaseShift)
+    {
+        auto r = 1.0/static_cast<double> (downFactor);
+        auto fir = FilterDesign::FIR::FIR1Lowpass(nfir - 1, r,
+                                                  FilterDesign::FIRWindow::HAMMING);
+        auto b = fir.getFilterTaps();
+        // Reverse the taps so each output is a dot product with the signal
+        mTaps.resize(b.size());
+        std::reverse_copy(b.begin(), b.end(), mTaps.begin());
+        mDownFactor = downFactor;
+        mOrder = static_cast<int> (b.size()) - 1;
+        mGroupDelay = 0;
+        if (lRemovePhaseShift){mGroupDelay = mOrder/2;}
+        mZi.assign(mOrder, 0);
+        mSignal.assign(std::max(1, mOrder), 0);
+        mPhase = 0;
+    }
+    /// Sets the initial conditions.
+    void setInitialConditions(const double zi[])
+    {
+        std::copy(zi, zi + mOrder, mZi.begin());
+        resetInitialConditions();
+    }
+    /// Resets the initial conditions.
+    void resetInitialConditions()
+    {
+        std::copy(mZi.begin(), mZi.end(), mSignal.begin());
+        mPhase = 0;
+    }
+    /// Sizes the workspace so that up to n samples can be filtered
+    /// without allocating.
+    void reserve(const int n)
+    {
+        auto nWork = static_cast<size_t> (mOrder + n + mGroupDelay);
+        if (mSignal.size() < nWork){mSignal.resize(nWork, 0);}
+    }
+    /// Estimates the number of output samples.
+    [[nodiscard]] int estimateSpace(const int n) const
+    {
+        return (n + mDownFactor - 1 - mPhase)/mDownFactor;
+    }
+    /// Filters and downsamples.  The result is the number of samples
+    /// written to y.
+    int apply(const int n, const T x[], T y[])
+    {
+        if (n <= 0){return 0;}
+        // The signal is the delay line followed by x followed by zeros
+        // so that the filter delay can be removed
+        auto nWork = static_cast<size_t> (mOrder + n + mGroupDelay);
+        if (mSignal.size() < nWork){mSignal.resize(nWork);}
+        std::copy(x, x + n, mSignal.data() + mOrder);
+        std::fill(mSignal.begin() + mOrder + n, mSignal.begin() + nWork, 0);
+        int ny = 0;
+        int nTaps = mOrder + 1;
+        int i = mPhase + mGroupDelay;
+        for (; i < n + mGroupDelay; i = i + mDownFactor)
+        {
+            if constexpr (std::is_same<T, double>::value)
+            {
+                ippsDotProd_64f(mTaps.data(), &mSignal[i], nTaps, &y[ny]);
+            }
+            else
+            {
+                ippsDotProd_32f(mTaps.data(), &mSignal[i], nTaps, &y[ny]);
+            }
+            ny = ny + 1;
+        }
+        // Save the delay line and the phase of the next retained sample
+        std::copy(mSignal.begin() + n, mSignal.begin() + n + mOrder,
+                  mSignal.begin());
+        mPhase = i - n - mGroupDelay;
+        return ny;
+    }
+    /// The reversed filter taps.
+    std::vector<T> mTaps;
+    /// The delay line followed by the current signal.
+    std::vector<T> mSignal;
+    /// The initial conditions.
+    std::vector<double> mZi;
+    /// The downsampling factor.
+    int mDownFactor = 1;
+    /// The filter order.
+    int mOrder = 0;
+    /// The filter delay removed from the output.
+    int mGroupDelay = 0;
+    /// The index of the next retained sample in the next packet.
+    int mPhase = 0;
+};
+
+}
+
 template<RTSeis::ProcessingMode E, class T>
 class Decimate<E, T>::DecimateImpl
 {
@@ -24,6 +185,7 @@ public:
                     const int filterLength,
                     const bool lRemovePhaseShift)
     {
+        mImplementation = DecimationImplementation::SINGLE_STAGE;
         mDownFactor = downFactor;
         int nfir = filterLength;
         // Postprocessing is a little trickier - may have to extend filter length
@@ -71,11 +233,190 @@ public:
                         + e.what();
             throw std::runtime_error(errmsg);
         }
+        mStageDownFactors.resize(1, downFactor);
+        mFilterGroupDelay = static_cast<double> (nfir - 1)/2;
         mInitialized = true;
     }
+    void initializeMultistage(const int downFactor,
+                              const int filterLength,
+                              const bool lRemovePhaseShift)
+    {
+        mImplementation = DecimationImplementation::MULTISTAGE;
+        mDownFactor = downFactor;
+        mStageDownFactors = factorDownsamplingFactor(downFactor);
+        auto nStages = static_cast<int> (mStageDownFactors.size());
+        if (mMode == RTSeis::ProcessingMode::POST_PROCESSING &&
+            lRemovePhaseShift)
+        {
+            mRemovePhaseShift = true;
+        }
+        // The final stage determines the sharpness of the cutoff.  Its
+        // passband, as a fraction of the output Nyquist frequency, is
+        // about 1 - 3.3 M/N.  The earlier stages must only keep energy
+        // that would alias into this passband from leaking through so
+        // they can have very wide transition bands.
+        int nLast = std::max(5, filterLength);
+        auto mLast = mStageDownFactors.back();
+        if (mRemovePhaseShift){nLast = padFilterLength(nLast, mLast);}
+        auto passband = 1.0 - 3.3*mLast/static_cast<double> (nLast);
+        passband = std::max(MIN_PASSBAND_FRACTION, passband);
+        mStages.resize(nStages);
+        mFilterGroupDelay = 0;
+        int inputRate = 1;
+        int remainingFactor = downFactor;
+        for (int is = 0; is < nStages; ++is)
+        {
+            auto m = mStageDownFactors[is];
+            int nfir = nLast;
+            if (is < nStages - 1)
+            {
+                auto transitionWidth
+                   = 2.0/m - 2.0*passband/static_cast<double> (remainingFactor);
+                nfir = computeHammingFilterLength(transitionWidth);
+                if (mRemovePhaseShift){nfir = padFilterLength(nfir, m);}
+            }
+            try
+            {
+                mStages[is].initialize(m, nfir, mRemovePhaseShift);
+            }
+            catch (std::exception &e)
+            {
+                auto errmsg = std::string("Stage initialization failed with: ")
+                            + e.what();
+                throw std::runtime_error(errmsg);
+            }
+            mFilterGroupDelay = mFilterGroupDelay
+                              + inputRate*static_cast<double> (nfir - 1)/2;
+            inputRate = inputRate*m;
+            remainingFactor = remainingFactor/m;
+        }
+        // Size the workspace for the largest block that can reach each
+        // stage.  With phase shift removal the whole signal is filtered
+        // at once so the workspace grows to fit it instead.
+        if (!mRemovePhaseShift)
+        {
+            int nStage = MULTISTAGE_BLOCK_SIZE;
+            for (int is = 0; is < nStages; ++is)
+            {
+                mStages[is].reserve(nStage);
+                auto m = mStageDownFactors[is];
+                nStage = (nStage + m - 1)/m;
+                if (is < nStages - 1)
+                {
+                    auto &work = mStageSignals[is%2];
+                    auto nWork = static_cast<size_t> (nStage);
+                    if (work.size() < nWork){work.resize(nWork, 0);}
+                }
+            }
+        }
+        mFIRLength = nLast;
+        mInitialized = true;
+    }
+    [[nodiscard]] int estimateSpace(const int n) const
+    {
+        if (mImplementation == DecimationImplementation::SINGLE_STAGE)
+        {
+            return mDownsampler.estimateSpace(n);
+        }
+        int ny = n;
+        for (const auto &stage : mStages)
+        {
+            ny = stage.estimateSpace(ny);
+        }
+        return ny;
+    }
+    [[nodiscard]] int getInitialConditionLength() const
+    {
+        if (mImplementation == DecimationImplementation::SINGLE_STAGE)
+        {
+            return mFIRFilter.getInitialConditionLength();
+        }
+        int nz = 0;
+        for (const auto &stage : mStages){nz = nz + stage.mOrder;}
+        return nz;
+    }
+    void setInitialConditions(const int nz, const double zi[])
+    {
+        if (mImplementation == DecimationImplementation::SINGLE_STAGE)
+        {
+            mFIRFilter.setInitialConditions(nz, zi);
+            mDownsampler.resetInitialConditions();
+            return;
+        }
+        int i0 = 0;
+        for (auto &stage : mStages)
+        {
+            stage.setInitialConditions(&zi[i0]);
+            i0 = i0 + stage.mOrder;
+        }
+    }
+    void resetInitialConditions()
+    {
+        if (mImplementation == DecimationImplementation::SINGLE_STAGE)
+        {
+            mFIRFilter.resetInitialConditions();
+            mDownsampler.resetInitialConditions();
+            return;
+        }
+        for (auto &stage : mStages){stage.resetInitialConditions();}
+    }
+    void applyMultistage(const int nx, const T x[], int *nyDown, T y[])
+    {
+        // Post-processing restarts from the initial conditions
+        if (mMode == RTSeis::ProcessingMode::POST_PROCESSING)
+        {
+            for (auto &stage : mStages){stage.resetInitialConditions();}
+        }
+        // The padding that removes the phase shift is only correct at the
+        // end of the signal so the signal cannot be split into blocks
+        if (mRemovePhaseShift)
+        {
+            applyStages(nx, x, nyDown, y);
+            return;
+        }
+        // Otherwise the blocks fit in the workspace allocated at
+        // initialization
+        int ny = 0;
+        for (int i = 0; i < nx; i = i + MULTISTAGE_BLOCK_SIZE)
+        {
+            auto nBlock = std::min(MULTISTAGE_BLOCK_SIZE, nx - i);
+            int nyBlock = 0;
+            applyStages(nBlock, x + i, &nyBlock, y + ny);
+            ny = ny + nyBlock;
+        }
+        *nyDown = ny;
+    }
+    /// Passes a block of the signal through every stage.
+    void applyStages(const int nx, const T x[], int *nyDown, T y[])
+    {
+        auto nStages = static_cast<int> (mStages.size());
+        const T *xStage = x;
+        int nStage = nx;
+        for (int is = 0; is < nStages; ++is)
+        {
+            // The last stage writes directly to the output
+            T *yStage = y;
+            if (is < nStages - 1)
+            {
+                auto &work = mStageSignals[is%2];
+                auto nWork = static_cast<size_t>
+                             (std::max(1, mStages[is].estimateSpace(nStage)));
+                if (work.size() < nWork){work.resize(nWork);}
+                yStage = work.data();
+            }
+            nStage = mStages[is].apply(nStage, xStage, yStage);
+            xStage = yStage;
+        }
+        *nyDown = nStage;
+    }
     void apply(const int nx, const T x[],
                const int ny, int *nyDown, T y[])
     {
+        if (mImplementation == DecimationImplementation::MULTISTAGE)
+        {
+            applyMultistage(nx, x, nyDown, y);
+            return;
+        }
         if (mRemovePhaseShift)
         {
 #ifndef NDEBUG
@@ -113,6 +454,16 @@ public:
     //class MultiRateFIRFilter mMRFIRFilter; // TODO implementation is slow!
     class FIRFilter<E, T> mFIRFilter;
     class Downsample<E, T> mDownsampler; 
+    /// The stages of the multistage decimator.
+    std::vector<DecimationStage<T>> mStages;
+    /// Workspace for the intermediate stages' outputs.
+    std::array<std::vector<T>, 2> mStageSignals;
+    /// The downsampling factor of each stage.
+    std::vector<int> mStageDownFactors;
+    /// The group delay of the filter(s) at the input sampling rate.
+    double mFilterGroupDelay = 0;
+    DecimationImplementation mImplementation
+        = DecimationImplementation::SINGLE_STAGE;
     int mDownFactor = 1;
     int mGroupDelay = 0;
     int mFIRLength = 0;
@@ -173,6 +524,10 @@ void Decimate<E, T>::clear() noexcept
     //pImpl->mMRFIRFilter.clear();
     pImpl->mFIRFilter.clear();
     pImpl->mDownsampler.clear();
+    pImpl->mStages.clear();
+    pImpl->mStageDownFactors.clear();
+    pImpl->mFilterGroupDelay = 0;
+    pImpl->mImplementation = DecimationImplementation::SINGLE_STAGE;
     //pImpl->mMode = RTSeis::ProcessingMode::POST_PROCESSING;
     //pImpl->mPrecision = RTSeis::Precision::DOUBLE;
     pImpl->mDownFactor = 1;
@@ -186,7 +541,8 @@ void Decimate<E, T>::clear() noexcept
 template<RTSeis::ProcessingMode E, class T>
 void Decimate<E, T>::initialize(const int downFactor,
                                 const int filterLength,
-                                const bool lRemovePhaseShift)
+                                const bool lRemovePhaseShift,
+                                const DecimationImplementation implementation)
 {
     clear();
     if (downFactor < 2)
@@ -200,6 +556,18 @@ void Decimate<E, T>::initialize(const int downFactor,
         auto errmsg = "Filter length = " + std::to_string(filterLength)
             + " must be at least 5";
     }
+    if (implementation == DecimationImplementation::MULTISTAGE)
+    {
+        if (factorDownsamplingFactor(downFactor).empty())
+        {
+            auto errmsg = "Downsampling factor = " + std::to_string(downFactor)
+                        + " cannot be factored into stages of 5, 4, 3, and 2";
+            throw std::invalid_argument(errmsg);
+        }
+        pImpl->initializeMultistage(downFactor, filterLength,
+                                    lRemovePhaseShift);
+        return;
+    }
     pImpl->initialize(downFactor, filterLength, lRemovePhaseShift);
     /*
     // Set some properties
@@ -355,7 +723,7 @@ int Decimate<E, T>::estimateSpace(const int n) const
 {
     if (!isInitialized()){throw std::runtime_error("Class not initialized");}
     if (n < 0){RTSEIS_THROW_IA("n=%d cannot be negative", n);}
-    return pImpl->mDownsampler.estimateSpace(n);
+    return pImpl->estimateSpace(n);
 }
 /* TODO - when lashing in a more performant multirate fir filter use this fn
 int Decimate::estimateSpace(const int n) const
@@ -385,7 +753,7 @@ template<RTSeis::ProcessingMode E, class T>
 int Decimate<E, T>::getInitialConditionLength() const
 {
     if (!isInitialized()){throw std::runtime_error("Class not initialized");}
-    return pImpl->mFIRFilter.getInitialConditionLength();
+    return pImpl->getInitialConditionLength();
 }
 
 /// Set initial conditions
@@ -400,8 +768,7 @@ void Decimate<E, T>::setInitialConditions(const int nz,const double zi[])
     }
     if (nz > 0 && zi == nullptr){throw std::invalid_argument("zi is NULL");}
     //pImpl->mMRFIRFilter.setInitialConditions(nz, zi);
-    pImpl->mFIRFilter.setInitialConditions(nz, zi);
-    pImpl->mDownsampler.resetInitialConditions();
+    pImpl->setInitialConditions(nz, zi);
 }
 
 /// Reset initial conditions
@@ -410,8 +777,7 @@ void Decimate<E, T>::resetInitialConditions()
 {
     if (!isInitialized()){throw std::runtime_error("Class not initialized");}
     //pImpl->mMRFIRFilter.resetInitialConditions();
-    pImpl->mFIRFilter.resetInitialConditions();
-    pImpl->mDownsampler.resetInitialConditions();
+    pImpl->resetInitialConditions();
 }
 
 /// Apply decimator (double)
@@ -593,6 +959,22 @@ int Decimate<E, T>::getFIRFilterLength() const
     return pImpl->mFIRLength;
 }
 
+/// Get number of stages
+template<RTSeis::ProcessingMode E, class T>
+int Decimate<E, T>::getNumberOfStages() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return static_cast<int> (pImpl->mStageDownFactors.size());
+}
+
+/// Get group delay
+template<RTSeis::ProcessingMode E, class T>
+double Decimate<E, T>::getGroupDelay() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mFilterGroupDelay;
+}
+
 ///--------------------------------------------------------------------------///
 ///                         Template instantiation                           ///
 ///--------------------------------------------------------------------------///
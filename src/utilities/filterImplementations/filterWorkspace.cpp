@@ -0,0 +1,40 @@
+#include <atomic>
+#include <cstdint>
+#include <ipps.h>
+#include "private/filterWorkspace.hpp"
+
+using namespace RTSeis::Utilities::FilterImplementations;
+
+namespace
+{
+/// The number of arrays allocated so far.
+std::atomic<int64_t> gAllocations{0};
+}
+
+Ipp64f *Workspace::allocate64f(const int n)
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    return ippsMalloc_64f(n);
+}
+
+Ipp32f *Workspace::allocate32f(const int n)
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    return ippsMalloc_32f(n);
+}
+
+Ipp8u *Workspace::allocate8u(const int n)
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    return ippsMalloc_8u(n);
+}
+
+void Workspace::release(void *p) noexcept
+{
+    if (p != nullptr){ippsFree(p);}
+}
+
+int64_t Workspace::getNumberOfAllocations() noexcept
+{
+    return gAllocations.load(std::memory_order_relaxed);
+}
@@ -1,5 +1,9 @@
 #include <iostream>
 #include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 #ifndef NDEBUG
 #include <cassert>
 #endif
@@ -7,13 +11,86 @@
 #include "rtseis/enums.hpp"
 #include "private/throw.hpp"
 #include "rtseis/utilities/filterImplementations/firFilter.hpp"
+#include "rtseis/utilities/transforms/dftRealToComplex.hpp"
+#include "rtseis/utilities/transforms/enums.hpp"
+#include "private/convolutionWisdom.hpp"
+#include "private/filterWorkspace.hpp"
 
 using namespace RTSeis::Utilities::FilterImplementations;
+namespace ConvolutionWisdom = RTSeis::Utilities::Math::ConvolutionWisdom;
+
+namespace
+{
+/// Chooses the partition length, L, for the uniformly partitioned FFT
+/// implementation.  Per sample, the direct form head costs O(L) while the
+/// frequency domain tail costs O(N/L + log L) so L ~ 2 sqrt(N) balances them.
+int computePartitionLength(const int nb)
+{
+    int length = 16;
+    while (length*length < 4*nb && length < 4096){length = 2*length;}
+    return length;
+}
+/// The block length for which AUTO is tuned when none is given.
+constexpr int DEFAULT_AUTO_BLOCK_LENGTH = 1024;
+}
 
 template<RTSeis::ProcessingMode E, class T>
 class FIRFilter<E, T>::FIRImpl
 {
 public:
+    /// Holds the immutable filter design, i.e., the taps and the IPP spec.
+    /// This is created once in initialize and is shared by all copies of
+    /// the filter.  The IPP spec is only read during filtering.
+    class FIRPlan
+    {
+    public:
+        /// Default constructor
+        FIRPlan() = default;
+        /// The plan cannot be copied.  Share it instead.
+        FIRPlan(const FIRPlan &plan) = delete;
+        FIRPlan& operator=(const FIRPlan &plan) = delete;
+        /// Destructor
+        ~FIRPlan()
+        {
+            Workspace::release(pSpec64_);
+            Workspace::release(pTaps64_);
+            Workspace::release(pSpec32_);
+            Workspace::release(pTaps32_);
+            Workspace::release(tapsRef_);
+        }
+        /// The filter state.
+        IppsFIRSpec_64f *pSpec64_ = nullptr;
+        /// The filter taps.  This has dimension [tapsLen_].
+        Ipp64f *pTaps64_ = nullptr;
+        /// The filter state.
+        IppsFIRSpec_32f *pSpec32_ = nullptr;
+        /// The filter taps.  This has dimension [tapsLen_].
+        Ipp32f *pTaps32_ = nullptr;
+        /// A copy of the input taps. This has dimension [tapsLen_].
+        double *tapsRef_ = nullptr;
+        /// The number of taps.
+        int tapsLen_ = 0;
+        /// Size of the workspace required by each filter instance.
+        int bufferSize_ = 0;
+        /// Size of state.
+        int specSize_ = 0;
+        /// Filter order.
+        int order_ = 0;
+        /// The order of the direct form filter applied by IPP.  When the
+        /// filter is partitioned this is the order of the head partition.
+        /// Otherwise, this is the filter order.
+        int headOrder_ = 0;
+        /// The partition length of the uniformly partitioned overlap-save
+        /// implementation.  This is 0 when the filter is not partitioned.
+        int partitionLength_ = 0;
+        /// The number of partitions in the tail of the filter.
+        int nPartitions_ = 0;
+        /// The spectra of the tail partitions.  This has dimension
+        /// [nPartitions_ x partitionLength_ + 1].
+        std::vector<std::complex<T>> tailSpectra_;
+        /// Implementation.
+        FIRImplementation implementation_ = FIRImplementation::DIRECT;
+    };
     /// Default constructor
     FIRImpl() = default;
     /// Copy constructor
@@ -26,27 +103,24 @@ public:
     {
         clear();
     }
-    /// (Deep) copy operator
+    /// Copy operator.  The filter design is shared with fir and only the
+    /// delay lines and initial conditions are copied.
     FIRImpl& operator=(const FIRImpl &fir)
     {
         if (&fir == this){return *this;}
+        clear();
         if (!fir.mInitialized){return *this;}
-        int ierr = initialize(fir.tapsLen_, fir.tapsRef_,
-                              fir.implementation_);
-        if (ierr != 0)
+        allocateState(fir.plan_);
+        // Copy the initial conditions
+        if (plan_->order_ > 0){ippsCopy_64f(fir.zi_, zi_, plan_->order_);}
+        if (plan_->partitionLength_ > 0)
         {
-            std::cerr << "Initialization failed in impl copy assignment"
-                      << std::endl;
-            clear();
-            return *this;
+            tailFrame_ = fir.tailFrame_;
+            tailOutput_ = fir.tailOutput_;
+            fdl_ = fir.fdl_;
+            fdlHead_ = fir.fdlHead_;
+            blockPosition_ = fir.blockPosition_;
         }
-        // Now copy the filter states
-        if (bufferSize_ > 0)
-        {
-            ippsCopy_8u(fir.pBuf_, pBuf_, bufferSize_);
-        }   
-        // Copy the initial conditions
-        if (order_ > 0){ippsCopy_64f(fir.zi_, zi_, order_);}
         if (nwork_ > 0)
         {
             if (mPrecision == RTSeis::Precision::DOUBLE)
@@ -60,119 +134,349 @@ public:
                 ippsCopy_32f(fir.dlydst32_, dlydst32_, nwork_);
             }
         }
+        mInitialized = true;
         return *this;
     }
     /// Clears memory off the module.
     void clear() noexcept
     {
-        if (pSpec64_ != nullptr){ippsFree(pSpec64_);}
-        if (pTaps64_ != nullptr){ippsFree(pTaps64_);}
-        if (dlysrc64_ != nullptr){ippsFree(dlysrc64_);}
-        if (dlydst64_ != nullptr){ippsFree(dlydst64_);}
-        if (pSpec32_ != nullptr){ippsFree(pSpec32_);}
-        if (pTaps32_ != nullptr){ippsFree(pTaps32_);}
-        if (dlysrc32_ != nullptr){ippsFree(dlysrc32_);}
-        if (dlydst32_ != nullptr){ippsFree(dlydst32_);}
-        if (pBuf_ != nullptr){ippsFree(pBuf_);}
-        if (tapsRef_ != nullptr){ippsFree(tapsRef_);}
-        if (zi_ != nullptr){ippsFree(zi_);}
-        pSpec64_ = nullptr;
-        pTaps64_ = nullptr;
+        Workspace::release(dlysrc64_);
+        Workspace::release(dlydst64_);
+        Workspace::release(dlysrc32_);
+        Workspace::release(dlydst32_);
+        Workspace::release(pBuf_);
+        Workspace::release(zi_);
+        plan_ = nullptr;
         dlysrc64_ = nullptr;
         dlydst64_ = nullptr;
-        pSpec32_ = nullptr;
-        pTaps32_ = nullptr;
         dlysrc32_ = nullptr;
         dlydst32_ = nullptr;
         pBuf_ = nullptr;
-        tapsRef_ = nullptr;
         zi_ = nullptr;
-        tapsLen_ = 0;
+        dft_.clear();
+        tailFrame_.clear();
+        tailOutput_.clear();
+        tailWork_.clear();
+        fdl_.clear();
+        spectrum_.clear();
+        fdlHead_ = 0;
+        blockPosition_ = 0;
         nwork_ = 0;
-        bufferSize_ = 0;
-        specSize_ = 0;
         order_ = 0;
-        implementation_ = FIRImplementation::DIRECT;
+        headOrder_ = 0;
         mInitialized = false;
     }
     //========================================================================//
     /// Initializes the filter 
     int initialize(const int nb, const double b[],
-                   const FIRImplementation implementation)
+                   const FIRImplementation implementation,
+                   const int blockLength = 0)
     {
         clear();
+        // AUTO is resolved from the convolution wisdom now so that the
+        // first application does not pay for the benchmark
+        if (implementation == FIRImplementation::AUTO)
+        {
+            auto n = (blockLength > 0) ? blockLength :
+                     DEFAULT_AUTO_BLOCK_LENGTH;
+            return initializeAuto(nb, b, n);
+        }
+        auto plan = std::make_shared<FIRPlan> ();
         // Figure out sizes and save some basic info
-        tapsLen_ = nb;
-        order_ = nb - 1;
-        nwork_ = std::max(128, order_+1);
-        tapsRef_ = ippsMalloc_64f(nb);
-        ippsCopy_64f(b, tapsRef_, nb);
-        zi_ = ippsMalloc_64f(std::max(1, order_));
-        ippsZero_64f(zi_, std::max(1, order_));
+        plan->tapsLen_ = nb;
+        plan->order_ = nb - 1;
+        plan->tapsRef_ = Workspace::allocate64f(nb);
+        ippsCopy_64f(b, plan->tapsRef_, nb);
         // Determine the algorithm type
         IppAlgType algType = ippAlgDirect;
         if (implementation == FIRImplementation::FFT){algType = ippAlgFFT;}
-        if (implementation == FIRImplementation::AUTO){algType = ippAlgAuto;}
+        // In real-time the FFT implementation uniformly partitions the
+        // filter.  The first partition is applied in the direct form so
+        // that no latency is introduced and the remaining partitions are
+        // applied in the frequency domain with overlap-save.
+        int headLen = nb;
+        if (mMode == RTSeis::ProcessingMode::REAL_TIME &&
+            implementation == FIRImplementation::FFT)
+        {
+            int partitionLength = computePartitionLength(nb);
+            if (nb > partitionLength)
+            {
+                int ierr = initializeTail(nb, b, partitionLength, plan.get());
+                if (ierr != 0)
+                {
+                    std::cerr << "Failed to initialize partitions"
+                              << std::endl;
+                    return -1;
+                }
+                headLen = partitionLength;
+                algType = ippAlgDirect;
+            }
+        }
+        plan->headOrder_ = headLen - 1;
         // Initialize FIR filter
         if (mPrecision == RTSeis::Precision::DOUBLE)
         {
-            dlysrc64_ = ippsMalloc_64f(nwork_);
-            ippsZero_64f(dlysrc64_, nwork_);
-            dlydst64_ = ippsMalloc_64f(nwork_);
-            ippsZero_64f(dlydst64_, nwork_);
-            pTaps64_ = ippsMalloc_64f(tapsLen_);
-            ippsCopy_64f(b, pTaps64_, tapsLen_);
-            IppStatus status = ippsFIRSRGetSize(tapsLen_, ipp64f,
-                                                &specSize_, &bufferSize_);
+            plan->pTaps64_ = Workspace::allocate64f(headLen);
+            ippsCopy_64f(b, plan->pTaps64_, headLen);
+            IppStatus status = ippsFIRSRGetSize(headLen, ipp64f,
+                                                &plan->specSize_,
+                                                &plan->bufferSize_);
             if (status != ippStsNoErr)
             {
                 std::cerr << "Error getting double state size" << std::endl;
-                clear();
                 return -1; 
             }
-            pSpec64_ = reinterpret_cast<IppsFIRSpec_64f *>
-                       (ippsMalloc_8u(specSize_));
-            pBuf_ = ippsMalloc_8u(bufferSize_);
-            status = ippsFIRSRInit_64f(pTaps64_, tapsLen_,
-                                       algType, pSpec64_);
+            plan->pSpec64_ = reinterpret_cast<IppsFIRSpec_64f *>
+                             (Workspace::allocate8u(plan->specSize_));
+            status = ippsFIRSRInit_64f(plan->pTaps64_, headLen,
+                                       algType, plan->pSpec64_);
             if (status != ippStsNoErr)
             {
                 std::cerr << "Error initializing double state structure"
                           << std::endl;
-                clear();
                 return -1; 
             }
         }
         else
         {
-            dlysrc32_ = ippsMalloc_32f(nwork_);
-            ippsZero_32f(dlysrc32_, nwork_);
-            dlydst32_ = ippsMalloc_32f(nwork_);
-            ippsZero_32f(dlydst32_, nwork_);
-            pTaps32_ = ippsMalloc_32f(tapsLen_);
-            ippsConvert_64f32f(b, pTaps32_, tapsLen_);
-            IppStatus status = ippsFIRSRGetSize(tapsLen_, ipp32f,
-                                                &specSize_, &bufferSize_);
+            plan->pTaps32_ = Workspace::allocate32f(headLen);
+            ippsConvert_64f32f(b, plan->pTaps32_, headLen);
+            IppStatus status = ippsFIRSRGetSize(headLen, ipp32f,
+                                                &plan->specSize_,
+                                                &plan->bufferSize_);
             if (status != ippStsNoErr)
             {
                 std::cerr << "Error getting float state size" << std::endl;
-                clear();
                 return -1; 
             }
-            pSpec32_ = reinterpret_cast<IppsFIRSpec_32f *>
-                       (ippsMalloc_8u(specSize_));
-            pBuf_ = ippsMalloc_8u(bufferSize_);
-            status = ippsFIRSRInit_32f(pTaps32_, tapsLen_,
-                                       algType, pSpec32_);
+            plan->pSpec32_ = reinterpret_cast<IppsFIRSpec_32f *>
+                             (Workspace::allocate8u(plan->specSize_));
+            status = ippsFIRSRInit_32f(plan->pTaps32_, headLen,
+                                       algType, plan->pSpec32_);
             if (status != ippStsNoErr)
             {
                 std::cerr << "Error initializing float state structure"
                           << std::endl;
-                clear();
                 return -1;
             }
         }
-        implementation_ = implementation;
+        plan->implementation_ = implementation;
+        allocateState(plan);
+        mInitialized = true;
+        return 0;
+    }
+    /// Attaches the filter design and allocates the per-channel state.
+    /// The delay lines scale with the filter order.
+    void allocateState(std::shared_ptr<const FIRPlan> plan)
+    {
+        plan_ = std::move(plan);
+        order_ = plan_->order_;
+        headOrder_ = plan_->headOrder_;
+        nwork_ = std::max(1, headOrder_);
+        zi_ = Workspace::allocate64f(std::max(1, order_));
+        ippsZero_64f(zi_, std::max(1, order_));
+        if (plan_->partitionLength_ > 0)
+        {
+            auto partitionLength = plan_->partitionLength_;
+            auto nfft = 2*partitionLength;
+            auto nbins = partitionLength + 1;
+            dft_.initialize(nfft,
+               RTSeis::Utilities::Transforms::FourierTransformImplementation::FFT);
+            tailFrame_.resize(nfft, 0);
+            tailOutput_.resize(partitionLength, 0);
+            tailWork_.resize(nfft, 0);
+            fdl_.resize(static_cast<size_t> (plan_->nPartitions_*nbins), 0);
+            spectrum_.resize(nbins, 0);
+            fdlHead_ = 0;
+            blockPosition_ = 0;
+        }
+        if (mPrecision == RTSeis::Precision::DOUBLE)
+        {
+            dlysrc64_ = Workspace::allocate64f(nwork_);
+            ippsZero_64f(dlysrc64_, nwork_);
+            dlydst64_ = Workspace::allocate64f(nwork_);
+            ippsZero_64f(dlydst64_, nwork_);
+        }
+        else
+        {
+            dlysrc32_ = Workspace::allocate32f(nwork_);
+            ippsZero_32f(dlysrc32_, nwork_);
+            dlydst32_ = Workspace::allocate32f(nwork_);
+            ippsZero_32f(dlydst32_, nwork_);
+        }
+        pBuf_ = Workspace::allocate8u(std::max(1, plan_->bufferSize_));
+    }
+    /// Computes the spectra of the tail partitions, i.e., the taps after
+    /// the first partition.  Each partition is zero-padded to twice the
+    /// partition length for overlap-save.
+    int initializeTail(const int nb, const double b[],
+                       const int partitionLength, FIRPlan *plan) const
+    {
+        auto nfft = 2*partitionLength;
+        auto nbins = partitionLength + 1;
+        auto nTail = nb - partitionLength;
+        auto nPartitions = (nTail + partitionLength - 1)/partitionLength;
+        RTSeis::Utilities::Transforms::DFTRealToComplex<T> dft;
+        try
+        {
+            dft.initialize(nfft,
+               RTSeis::Utilities::Transforms::FourierTransformImplementation::FFT);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return -1;
+        }
+        plan->tailSpectra_.resize(static_cast<size_t> (nPartitions*nbins));
+        std::vector<T> partition(nfft, 0);
+        for (int ip = 0; ip < nPartitions; ++ip)
+        {
+            auto i1 = partitionLength + ip*partitionLength;
+            auto i2 = std::min(nb, i1 + partitionLength);
+            std::fill(partition.begin(), partition.end(), 0);
+            std::transform(b + i1, b + i2, partition.begin(),
+                           [](const double bi){return static_cast<T> (bi);});
+            auto spectrumPtr = plan->tailSpectra_.data() + ip*nbins;
+            dft.forwardTransform(nfft, partition.data(), nbins, &spectrumPtr);
+        }
+        plan->partitionLength_ = partitionLength;
+        plan->nPartitions_ = nPartitions;
+        return 0;
+    }
+    /// Pushes samples through the frequency domain tail of a partitioned
+    /// filter.  If y is not NULL then the tail's contribution is added to
+    /// y.  This works on at most one partition of samples at a time so the
+    /// tail contribution for the current block is always available.
+    template<typename U>
+    void applyTail(const int n, const U x[], T y[])
+    {
+        const auto partitionLength = plan_->partitionLength_;
+        const auto nPartitions = plan_->nPartitions_;
+        const auto nfft = 2*partitionLength;
+        const auto nbins = partitionLength + 1;
+        int i = 0;
+        while (i < n)
+        {
+            auto nCopy = std::min(n - i, partitionLength - blockPosition_);
+            auto frame = tailFrame_.data() + partitionLength + blockPosition_;
+            for (int j = 0; j < nCopy; ++j)
+            {
+                frame[j] = static_cast<T> (x[i + j]);
+            }
+            if (y != nullptr)
+            {
+                auto tail = tailOutput_.data() + blockPosition_;
+                for (int j = 0; j < nCopy; ++j){y[i + j] += tail[j];}
+            }
+            blockPosition_ = blockPosition_ + nCopy;
+            i = i + nCopy;
+            // A block is complete.  Transform it into the frequency domain
+            // delay line and compute the tail for the next block.
+            if (blockPosition_ == partitionLength)
+            {
+                fdlHead_ = (fdlHead_ + 1)%nPartitions;
+                auto spectrumPtr = fdl_.data() + fdlHead_*nbins;
+                dft_.forwardTransform(nfft, tailFrame_.data(),
+                                      nbins, &spectrumPtr);
+                std::fill(spectrum_.begin(), spectrum_.end(), 0);
+                for (int ip = 0; ip < nPartitions; ++ip)
+                {
+                    auto jp = (fdlHead_ - ip + nPartitions)%nPartitions;
+                    auto xPtr = fdl_.data() + jp*nbins;
+                    auto hPtr = plan_->tailSpectra_.data() + ip*nbins;
+                    if constexpr (std::is_same<T, double>::value)
+                    {
+                        ippsAddProduct_64fc(
+                            reinterpret_cast<const Ipp64fc *> (xPtr),
+                            reinterpret_cast<const Ipp64fc *> (hPtr),
+                            reinterpret_cast<Ipp64fc *> (spectrum_.data()),
+                            nbins);
+                    }
+                    else
+                    {
+                        ippsAddProduct_32fc(
+                            reinterpret_cast<const Ipp32fc *> (xPtr),
+                            reinterpret_cast<const Ipp32fc *> (hPtr),
+                            reinterpret_cast<Ipp32fc *> (spectrum_.data()),
+                            nbins);
+                    }
+                }
+                auto workPtr = tailWork_.data();
+                dft_.inverseTransform(nbins, spectrum_.data(), nfft, &workPtr);
+                // Overlap-save: only the last half of the result is valid
+                std::copy(tailWork_.begin() + partitionLength, tailWork_.end(),
+                          tailOutput_.begin());
+                std::copy(tailFrame_.begin() + partitionLength,
+                          tailFrame_.end(), tailFrame_.begin());
+                blockPosition_ = 0;
+            }
+        }
+    }
+    /// Resolves the AUTO implementation for packets of length n.  If the
+    /// convolution wisdom has no entry then the direct and FFT filters are
+    /// benchmarked.  The winning trial filter's design is then adopted so
+    /// the filter is not built a second time.
+    int initializeAuto(const int nb, const double b[], const int n)
+    {
+        FIRImpl direct;
+        FIRImpl fft;
+        if (direct.initialize(nb, b, FIRImplementation::DIRECT) != 0)
+        {
+            std::cerr << "Failed to initialize direct filter" << std::endl;
+            return -1;
+        }
+        auto algorithm = ConvolutionWisdom::Algorithm::DIRECT;
+        try
+        {
+            if (ConvolutionWisdom::haveAlgorithm(
+                   ConvolutionWisdom::Operation::FIR_FILTER, nb, n,
+                   mPrecision, mMode))
+            {
+                algorithm = ConvolutionWisdom::getAlgorithm(
+                    ConvolutionWisdom::Operation::FIR_FILTER, nb, n,
+                    mPrecision, mMode);
+            }
+            else
+            {
+                if (fft.initialize(nb, b, FIRImplementation::FFT) != 0)
+                {
+                    std::cerr << "Failed to initialize FFT filter"
+                              << std::endl;
+                    return -1;
+                }
+                // Allocate the trial signals before anything is timed
+                std::vector<T> xWork(n, 0);
+                std::vector<T> yWork(n, 0);
+                auto trial = [&](const ConvolutionWisdom::Algorithm a)
+                {
+                    auto &fir = (a == ConvolutionWisdom::Algorithm::FFT) ?
+                                fft : direct;
+                    fir.apply(n, xWork.data(), yWork.data());
+                };
+                algorithm = ConvolutionWisdom::tune(
+                    ConvolutionWisdom::Operation::FIR_FILTER, nb, n,
+                    mPrecision, trial, mMode);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return -1;
+        }
+        if (algorithm == ConvolutionWisdom::Algorithm::FFT)
+        {
+            if (!fft.mInitialized &&
+                fft.initialize(nb, b, FIRImplementation::FFT) != 0)
+            {
+                std::cerr << "Failed to initialize FFT filter" << std::endl;
+                return -1;
+            }
+            allocateState(fft.plan_);
+        }
+        else
+        {
+            allocateState(direct.plan_);
+        }
         mInitialized = true;
         return 0;
     }
@@ -194,7 +498,6 @@ public:
     /// Sets the initial conditions
     int setInitialConditions(const int nz, const double zi[])
     {
-        resetInitialConditions();
         int nzRef = getInitialConditionLength();
 #ifndef NDEBUG
         assert(nzRef == nz);
@@ -202,137 +505,117 @@ public:
         if (nzRef > 0)
         {
             ippsCopy_64f(zi, zi_, nzRef);
-            if (mPrecision == RTSeis::Precision::DOUBLE)
-            {
-                ippsCopy_64f(zi_, dlysrc64_, nzRef);
-            }
-            else
-            {
-                ippsConvert_64f32f(zi_, dlysrc32_, nzRef);
-            }
+            resetInitialConditions();
         }
         return 0;
     }
     /// Resets the initial conditions
     void resetInitialConditions() noexcept
     {
-        if (order_ > 0)
-        {   
+        // The direct form filter gets the most recent samples
+        if (headOrder_ > 0)
+        {
+            const double *zHead = zi_ + (order_ - headOrder_);
             if (mPrecision == RTSeis::Precision::DOUBLE)
             {
-                ippsCopy_64f(zi_, dlysrc64_, order_);
+                ippsCopy_64f(zHead, dlysrc64_, headOrder_);
             }
             else
             {
-                ippsConvert_64f32f(zi_, dlysrc32_, order_);
+                ippsConvert_64f32f(zHead, dlysrc32_, headOrder_);
             }
         }
-    }
-    /// Applies the filter
-    int apply(const int n, const double x[], double y[])
-    {
-        if (n <= 0){return 0;} // Nothing to do
-        if (mPrecision == RTSeis::Precision::FLOAT)
-        {
-            Ipp32f *x32 = ippsMalloc_32f(n);
-            Ipp32f *y32 = ippsMalloc_32f(n);
-            ippsConvert_64f32f(x, x32, n);
-            int ierr = apply(n, x32, y32);
-            ippsFree(x32);
-            if (ierr != 0)
-            {
-                std::cerr << "Failed to apply float filter in double"
-                          << std::endl;
-                ippsFree(y32);
-                return -1; 
-            }
-            ippsConvert_32f64f(y32, y, n);
-            ippsFree(y32);
-            return 0;
-        }
-        IppStatus status = ippsFIRSR_64f(x, y, n, pSpec64_,
-                                         dlysrc64_, dlydst64_, pBuf_);
-        if (status != ippStsNoErr)
-        {
-            std::cerr << "Failed to apply double FIR filter" << std::endl;
-            return -1; 
-        }   
-        if (mMode == RTSeis::ProcessingMode::REAL_TIME && order_ > 0)
+        // Rebuild the frequency domain delay line by replaying the initial
+        // conditions through the tail
+        if (plan_ != nullptr && plan_->partitionLength_ > 0)
         {
-            ippsCopy_64f(dlydst64_, dlysrc64_, order_);
+            std::fill(tailFrame_.begin(), tailFrame_.end(), 0);
+            std::fill(tailOutput_.begin(), tailOutput_.end(), 0);
+            std::fill(fdl_.begin(), fdl_.end(), 0);
+            fdlHead_ = 0;
+            blockPosition_ = 0;
+            applyTail<double>(order_, zi_, nullptr);
         }
-        return 0;
     }
-    /// Applies the filter
-    int apply(const int n, const float x[], float y[])
+    /// Applies the filter.  The precision is fixed by T so there is never
+    /// a conversion and, consequently, never an allocation on this path.
+    int apply(const int n, const T x[], T y[])
     {
         if (n <= 0){return 0;} // Nothing to do
-        if (mPrecision == RTSeis::Precision::DOUBLE)
+        IppStatus status;
+        if constexpr (std::is_same<T, double>::value)
         {
-            Ipp64f *x64 = ippsMalloc_64f(n);
-            Ipp64f *y64 = ippsMalloc_64f(n);
-            ippsConvert_32f64f(x, x64, n);
-            int ierr = apply(n, x64, y64);
-            ippsFree(x64);
-            if (ierr != 0)
-            {
-                std::cerr << "Failed to apply double filter in float"
-                          << std::endl;
-                ippsFree(y64);
-                return -1; 
-            }
-            ippsConvert_64f32f(y64, y, n);
-            ippsFree(y64);
-            return 0;
+            status = ippsFIRSR_64f(x, y, n, plan_->pSpec64_,
+                                   dlysrc64_, dlydst64_, pBuf_);
+        }
+        else
+        {
+            status = ippsFIRSR_32f(x, y, n, plan_->pSpec32_,
+                                   dlysrc32_, dlydst32_, pBuf_);
         }
-        IppStatus status = ippsFIRSR_32f(x, y, n, pSpec32_, 
-                                         dlysrc32_, dlydst32_, pBuf_);
         if (status != ippStsNoErr)
         {
-            std::cerr << "Failed to apply float FIR filter" << std::endl;
+            std::cerr << "Failed to apply FIR filter" << std::endl;
             return -1;
         }
-        if (mMode == RTSeis::ProcessingMode::REAL_TIME && order_ > 0)
+        if (mMode == RTSeis::ProcessingMode::REAL_TIME && headOrder_ > 0)
         {
-            ippsCopy_32f(dlydst32_, dlysrc32_, order_);
+            if constexpr (std::is_same<T, double>::value)
+            {
+                ippsCopy_64f(dlydst64_, dlysrc64_, headOrder_);
+            }
+            else
+            {
+                ippsCopy_32f(dlydst32_, dlysrc32_, headOrder_);
+            }
         }
+        // Add the contribution of the partitioned tail
+        if (plan_->partitionLength_ > 0){applyTail<T>(n, x, y);}
         return 0;
     }
 //private:
-    /// The filter state.
-    IppsFIRSpec_64f *pSpec64_ = nullptr;
-    /// The filter taps.  This has dimension [tapsLen_].
-    Ipp64f *pTaps64_ = nullptr;
+    /// The shared filter design.
+    std::shared_ptr<const FIRPlan> plan_ = nullptr;
     /// The input delay line.  This has dimension [nwork_].
     Ipp64f *dlysrc64_ = nullptr;
     /// The output delay line.  This has dimension [nwork_].
     Ipp64f *dlydst64_ = nullptr;
-    /// The filter state.
-    IppsFIRSpec_32f *pSpec32_ = nullptr;
-    /// The filter taps.  This has dimension [tapsLen_].
-    Ipp32f *pTaps32_ = nullptr;
     /// The input delay line.  This has dimension [nwork_].
     Ipp32f *dlysrc32_ = nullptr;
     /// The output delay line.  This has dimension [nwork_].
     Ipp32f *dlydst32_ = nullptr;
-    /// Workspace.  This has dimension [bufferSize_].
+    /// Workspace.  This has dimension [plan_->bufferSize_].
     Ipp8u *pBuf_ = nullptr;
-    /// A copy of the input taps. This has dimension [tapsLen_].
-    double *tapsRef_ = nullptr;
     /// A copy of the initial conditions.  This has dimension [order_].
     double *zi_ = nullptr;
-    /// The number of taps.
-    int tapsLen_ = 0;
-    /// The length of the delay line which is max(128, order+1).
+    /// The Fourier transform for the partitioned tail.
+    RTSeis::Utilities::Transforms::DFTRealToComplex<T> dft_;
+    /// The overlap-save input frame.  The first partition is the previous
+    /// block and the second partition is the block being filled.  This has
+    /// dimension [2 x plan_->partitionLength_].
+    std::vector<T> tailFrame_;
+    /// The tail's contribution to the current block.  This has dimension
+    /// [plan_->partitionLength_].
+    std::vector<T> tailOutput_;
+    /// Workspace for the inverse transform.  This has dimension
+    /// [2 x plan_->partitionLength_].
+    std::vector<T> tailWork_;
+    /// The frequency domain delay line.  This is a ring buffer of the
+    /// spectra of the last plan_->nPartitions_ input frames.
+    std::vector<std::complex<T>> fdl_;
+    /// The accumulated spectrum of the tail.  This has dimension
+    /// [plan_->partitionLength_ + 1].
+    std::vector<std::complex<T>> spectrum_;
+    /// The most recent spectrum in the frequency domain delay line.
+    int fdlHead_ = 0;
+    /// The number of samples in the block being filled.
+    int blockPosition_ = 0;
+    /// The length of the delay line which is max(1, headOrder_).
     int nwork_ = 0;
-    /// Size of pBuf.
-    int bufferSize_ = 0;
-    /// Size of state.
-    int specSize_ = 0;
     /// Filter order.
     int order_ = 0;
-    /// Implementation.
-    FIRImplementation implementation_ = FIRImplementation::DIRECT;
+    /// Order of the direct form filter.
+    int headOrder_ = 0;
     /// Real-time or post-processing.
     const RTSeis::ProcessingMode mMode = E;
     /// Single or double precision.
@@ -393,7 +676,8 @@ FIRFilter<E, T>& FIRFilter<E, T>::operator=(FIRFilter &&fir) noexcept
 /// Initialization
 template<RTSeis::ProcessingMode E, class T>
 void FIRFilter<E, T>::initialize(const int nb, const double b[],
-                                 FIRImplementation implementation)
+                                 FIRImplementation implementation,
+                                 const int blockLength)
 {
     clear();
     // Checks
@@ -403,10 +687,10 @@ void FIRFilter<E, T>::initialize(const int nb, const double b[],
         throw std::invalid_argument("b is NULL");
     }
 #ifndef NDEBUG
-    int ierr = pImpl->initialize(nb, b, implementation);
+    int ierr = pImpl->initialize(nb, b, implementation, blockLength);
     assert(ierr == 0);
 #else
-    pImpl->initialize(nb, b, implementation);
+    pImpl->initialize(nb, b, implementation, blockLength);
 #endif
 }
 
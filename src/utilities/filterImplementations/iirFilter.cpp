@@ -1,5 +1,7 @@
 #include <iostream>
 #include <cmath>
+#include <vector>
+#include <type_traits>
 #ifndef NDEBUG
 #include <cassert>
 #endif
@@ -8,6 +10,8 @@
 #include <ippcore.h>
 #include <ipptypes.h>
 #include "rtseis/enums.hpp"
+#include "private/blockParallelFilter.hpp"
+#include "private/iirEngine.hpp"
 #include "rtseis/utilities/filterImplementations/iirFilter.hpp"
 
 using namespace RTSeis::Utilities::FilterImplementations;
@@ -16,6 +20,60 @@ template<RTSeis::ProcessingMode E, class T>
 class IIRFilter<E, T>::IIRFilterImpl
 {
 public:
+    /// Holds the immutable filter design, i.e., the reference and normalized
+    /// filter coefficients.  This is created once in initialize and is
+    /// shared by all copies of the filter.
+    class IIRPlan
+    {
+    public:
+        /// Default constructor
+        IIRPlan() = default;
+        /// The plan cannot be copied.  Share it instead.
+        IIRPlan(const IIRPlan &plan) = delete;
+        IIRPlan& operator=(const IIRPlan &plan) = delete;
+        /// Destructor
+        ~IIRPlan()
+        {
+            if (pTaps64f_ != nullptr){ippsFree(pTaps64f_);}
+            if (pTaps32f_ != nullptr){ippsFree(pTaps32f_);}
+            if (bRef_ != nullptr){ippsFree(bRef_);}
+            if (aRef_ != nullptr){ippsFree(aRef_);}
+            if (bNorm64f_ != nullptr){ippsFree(bNorm64f_);}
+            if (aNorm64f_ != nullptr){ippsFree(aNorm64f_);}
+            if (bNorm32f_ != nullptr){ippsFree(bNorm32f_);}
+            if (aNorm32f_ != nullptr){ippsFree(aNorm32f_);}
+        }
+        /// The Filter taps.  This has dimension [2*(order_+1)].
+        Ipp64f *pTaps64f_ = nullptr;
+        /// The Filter taps.  This has dimension [2*(order_+1)].
+        Ipp32f *pTaps32f_ = nullptr;
+        /// The reference filter numerator coefficients.
+        /// This has dimension [nbRef_].
+        Ipp64f *bRef_ = nullptr;
+        /// The reference filter denominator coefficients.
+        /// This has dimension [naRef_].
+        Ipp64f *aRef_ = nullptr;
+        /// These are the normalized numerator coefficients.
+        /// This has dimension [order_+1].
+        Ipp64f *bNorm64f_ = nullptr;
+        /// These are the normalized denominator coefficients.
+        /// This has dimension [order_+1].
+        Ipp64f *aNorm64f_ = nullptr;
+        /// These are the normalized numerator coefficients.
+        /// This has dimension [order_+1].
+        Ipp32f *bNorm32f_ = nullptr;
+        /// These are the normalized denominator coefficients.
+        /// This has dimension [order_+1].
+        Ipp32f *aNorm32f_ = nullptr;
+        /// The filter order = max(nbRef_, naRef_) - 1.
+        int order_ = 0;
+        /// Reference number of numerator coefficients
+        int nbRef_ = 0;
+        /// Reference number of denominator coefficients
+        int naRef_ = 0;
+        /// Filter implementation
+        IIRDFImplementation implementation_ = IIRDFImplementation::DF2_FAST;
+    };
     /// Default constructor
     IIRFilterImpl() = default;
     /// Copy constructor
@@ -28,15 +86,15 @@ public:
     {
         clear();
     }
-    /// Copy operator
+    /// Copy operator.  The filter design is shared with iir and only the
+    /// delay lines and initial conditions are copied.
     IIRFilterImpl& operator=(const IIRFilterImpl &iir)
     {
         if (&iir == this){return *this;}
         clear();
+        mThreads = iir.mThreads;
         if (!iir.linit_){return *this;}
-        int ierr = initialize(iir.nbRef_, iir.bRef_,
-                              iir.naRef_, iir.aRef_,
-                              iir.implementation_);
+        int ierr = allocateState(iir.plan_);
         if (ierr != 0)
         {
             std::cerr << "Failed to initialize filter in impl c'tor"
@@ -44,65 +102,59 @@ public:
             clear();
             return *this;
         }
-        if (bufferSize_ > 0)
-        {
-            ippsCopy_8u(iir.pBuf_, pBuf_, bufferSize_);
-        }
         ippsCopy_64f(iir.zi_, zi_, nbDly_);
         if (mPrecision == RTSeis::Precision::DOUBLE)
         {
-            ippsCopy_64f(iir.pBufIPP64f_, pBufIPP64f_, bufIPPLen_);
             ippsCopy_64f(iir.pDlySrc64f_, pDlySrc64f_, nbDly_);
             ippsCopy_64f(iir.pDlyDst64f_, pDlyDst64f_, nbDly_);
+            if (implementation_ == IIRDFImplementation::DF2_FAST)
+            {
+                // Copy the current delay line out of the source's IPP state
+                ippsIIRGetDlyLine_64f(iir.pIIRState64f_, pBufIPP64f_);
+                ippsIIRSetDlyLine_64f(pIIRState64f_, pBufIPP64f_);
+            }
         }
         else
         {
-            ippsCopy_32f(iir.pBufIPP32f_, pBufIPP32f_, bufIPPLen_);
             ippsCopy_32f(iir.pDlySrc32f_, pDlySrc32f_, nbDly_);
             ippsCopy_32f(iir.pDlyDst32f_, pDlyDst32f_, nbDly_);
+            if (implementation_ == IIRDFImplementation::DF2_FAST)
+            {
+                // Copy the current delay line out of the source's IPP state
+                ippsIIRGetDlyLine_32f(iir.pIIRState32f_, pBufIPP32f_);
+                ippsIIRSetDlyLine_32f(pIIRState32f_, pBufIPP32f_);
+            }
         }
+        linit_ = true;
         return *this;
     }
     /// Releases memory on the module
     void clear() noexcept
     {
-        if (pTaps64f_ != nullptr){ippsFree(pTaps64f_);}
         if (pBufIPP64f_ != nullptr){ippsFree(pBufIPP64f_);}
         if (pDlySrc64f_ != nullptr){ippsFree(pDlySrc64f_);}
         if (pDlyDst64f_ != nullptr){ippsFree(pDlyDst64f_);}
-        if (pTaps32f_ != nullptr){ippsFree(pTaps32f_);}
         if (pBufIPP32f_ != nullptr){ippsFree(pBufIPP32f_);}
         if (pDlySrc32f_ != nullptr){ippsFree(pDlySrc32f_);}
         if (pDlyDst32f_ != nullptr){ippsFree(pDlyDst32f_);}
         if (pBuf_ != nullptr){ippsFree(pBuf_);}
-        if (bRef_ != nullptr){ippsFree(bRef_);}
-        if (aRef_ != nullptr){ippsFree(aRef_);}
-        if (bNorm64f_ != nullptr){ippsFree(bNorm64f_);}
-        if (aNorm64f_ != nullptr){ippsFree(aNorm64f_);}
-        if (bNorm32f_ != nullptr){ippsFree(bNorm32f_);}
-        if (aNorm32f_ != nullptr){ippsFree(aNorm32f_);}
         if (zi_ != nullptr){ippsFree(zi_);}
+        mEngines.clear();
+        mBlockWorkspace.clear();
+        plan_ = nullptr;
         pIIRState64f_ = nullptr;
-        pTaps64f_ = nullptr;
         pBufIPP64f_ = nullptr;
         pDlySrc64f_ = nullptr;
         pDlyDst64f_ = nullptr;
         pIIRState32f_ = nullptr;
-        pTaps32f_ = nullptr;
         pBufIPP32f_ = nullptr;
         pDlySrc32f_ = nullptr;
         pDlyDst32f_ = nullptr;
         pBuf_ = nullptr;
-        bRef_ = nullptr;
-        aRef_ = nullptr;
-        bNorm64f_ = nullptr;
-        aNorm64f_ = nullptr;
         zi_ = nullptr;
         nbDly_ = 0;
         bufIPPLen_ = 0;
         order_ = 0;
-        nbRef_ = 0;
-        naRef_ = 0;
         bufferSize_ = 0;
         implementation_ = IIRDFImplementation::DF2_FAST;
         linit_ = false;
@@ -152,53 +204,109 @@ public:
             std::cout << "Overriding IIR implementation to DF2_SLOW"
                       << std::endl;
         }
+        auto plan = std::make_shared<IIRPlan> ();
         // Set sizes
         double a0 = a[0];
-        nbRef_ = nb;
-        naRef_ = na;
-        order_ = std::max(nbRef_, naRef_) - 1;
-        bufIPPLen_ = 2*std::max(order_+1, 1024);
-        nbDly_ = std::max(8, order_ + 1);
+        plan->nbRef_ = nb;
+        plan->naRef_ = na;
+        plan->order_ = std::max(nb, na) - 1;
+        auto order = plan->order_;
         // Copy and normalize the filter coefficients
-        bRef_ = ippsMalloc_64f(nbRef_);
-        ippsCopy_64f(b, bRef_, nbRef_);
-        aRef_ = ippsMalloc_64f(naRef_);
-        ippsCopy_64f(a, aRef_, naRef_);
+        plan->bRef_ = ippsMalloc_64f(nb);
+        ippsCopy_64f(b, plan->bRef_, nb);
+        plan->aRef_ = ippsMalloc_64f(na);
+        ippsCopy_64f(a, plan->aRef_, na);
+        if (mPrecision == RTSeis::Precision::DOUBLE)
+        {
+            if (impUse == IIRDFImplementation::DF2_FAST)
+            {
+                // Set the (normalized) filter taps
+                plan->pTaps64f_ = ippsMalloc_64f(2*(order + 1));
+                ippsZero_64f(plan->pTaps64f_, 2*(order + 1));
+                ippsDivC_64f(plan->bRef_, a0, &plan->pTaps64f_[0], nb);
+                ippsDivC_64f(plan->aRef_, a0, &plan->pTaps64f_[order+1], na);
+            }
+            else
+            {
+                plan->bNorm64f_ = ippsMalloc_64f(order+1);
+                ippsZero_64f(plan->bNorm64f_, order+1);
+                ippsDivC_64f(plan->bRef_, a0, plan->bNorm64f_, nb);
+                plan->aNorm64f_ = ippsMalloc_64f(order+1);
+                ippsZero_64f(plan->aNorm64f_, order+1);
+                ippsDivC_64f(plan->aRef_, a0, plan->aNorm64f_, na);
+            }
+        }
+        else
+        {
+            auto a04 = static_cast<float> (a0);
+            if (impUse == IIRDFImplementation::DF2_FAST)
+            {
+                // Set the (normalized) filter taps
+                plan->pTaps32f_ = ippsMalloc_32f(2*(order + 1));
+                ippsZero_32f(plan->pTaps32f_, 2*(order + 1));
+                ippsConvert_64f32f(plan->bRef_, &plan->pTaps32f_[0], nb);
+                ippsConvert_64f32f(plan->aRef_, &plan->pTaps32f_[order+1], na);
+                ippsDivC_32f_I(a04, &plan->pTaps32f_[0],       nb);
+                ippsDivC_32f_I(a04, &plan->pTaps32f_[order+1], na);
+            }
+            else
+            {
+                plan->bNorm32f_ = ippsMalloc_32f(order+1);
+                ippsZero_32f(plan->bNorm32f_, order+1);
+                ippsConvert_64f32f(plan->bRef_, plan->bNorm32f_, nb);
+                ippsDivC_32f_I(a04, plan->bNorm32f_, nb);
+                plan->aNorm32f_ = ippsMalloc_32f(order+1);
+                ippsZero_32f(plan->aNorm32f_, order+1);
+                ippsConvert_64f32f(plan->aRef_, plan->aNorm32f_, na);
+                ippsDivC_32f_I(a04, plan->aNorm32f_, na);
+            }
+        }
+        plan->implementation_ = impUse;
+        if (allocateState(plan) != 0)
+        {
+            clear();
+            return -1;
+        }
+        linit_ = true;
+        return 0;
+    }
+    /// Attaches the filter design and creates the per-channel IPP state and
+    /// delay lines.  The memory scales with the filter order.
+    int allocateState(std::shared_ptr<const IIRPlan> plan)
+    {
+        plan_ = std::move(plan);
+        order_ = plan_->order_;
+        implementation_ = plan_->implementation_;
+        bufIPPLen_ = std::max(8, order_ + 1);
+        nbDly_ = std::max(8, order_ + 1);
         zi_ = ippsMalloc_64f(nbDly_);
         ippsZero_64f(zi_, nbDly_);
-        // Alllocate space
+        IppStatus status;
         if (mPrecision == RTSeis::Precision::DOUBLE)
         {
-            if (impUse == IIRDFImplementation::DF2_FAST)
+            pDlySrc64f_ = ippsMalloc_64f(nbDly_);
+            ippsZero_64f(pDlySrc64f_, nbDly_);
+            pDlyDst64f_ = ippsMalloc_64f(nbDly_);
+            ippsZero_64f(pDlyDst64f_, nbDly_);
+            if (implementation_ == IIRDFImplementation::DF2_FAST)
             {
                 status = ippsIIRGetStateSize_64f(order_, &bufferSize_);
                 if (status != ippStsNoErr)
                 {
                     std::cerr << "Failed to get state size" << std::endl;
-                    clear();
                     return -1;
                 }
                 // Set the workspace
                 pBufIPP64f_ = ippsMalloc_64f(bufIPPLen_);
                 ippsZero_64f(pBufIPP64f_, bufIPPLen_);
-                pDlySrc64f_ = ippsMalloc_64f(nbDly_);
-                ippsZero_64f(pDlySrc64f_, nbDly_);
-                pDlyDst64f_ = ippsMalloc_64f(nbDly_);
-                ippsZero_64f(pDlyDst64f_, nbDly_);
                 pBuf_ = ippsMalloc_8u(bufferSize_);
-                // Set the (normalized) filter taps
-                pTaps64f_ = ippsMalloc_64f(2*(order_ + 1));
-                ippsZero_64f(pTaps64f_, 2*(order_ + 1));
-                ippsDivC_64f(bRef_, a0, &pTaps64f_[0],        nbRef_);
-                ippsDivC_64f(aRef_, a0, &pTaps64f_[order_+1], naRef_);
                 // Initialize the filter
-                status = ippsIIRInit_64f(&pIIRState64f_, pTaps64f_, order_,
-                                         pDlySrc64f_, pBuf_);
+                status = ippsIIRInit_64f(&pIIRState64f_, plan_->pTaps64f_,
+                                         order_, pDlySrc64f_, pBuf_);
                 if (status != ippStsNoErr)
                 {
                     std::cerr << "Failed to initialize filter in double"
                               << std::endl;
-                    clear();
                     return -1;
                 }
                 // Set the delay line
@@ -207,61 +315,36 @@ public:
                 {
                     std::cerr << "Failed to set delay line in double"
                               << std::endl;
-                    clear();
                     return -1;
                 }
             }
-            else
-            {
-                bNorm64f_ = ippsMalloc_64f(order_+1);
-                ippsZero_64f(bNorm64f_, order_+1);
-                ippsDivC_64f(bRef_,a0,  bNorm64f_, nbRef_);
-                aNorm64f_ = ippsMalloc_64f(order_+1);
-                ippsZero_64f(aNorm64f_, order_+1);
-                ippsDivC_64f(aRef_, a0, aNorm64f_, naRef_);
-                // Initial/final conditions
-                pDlySrc64f_ = ippsMalloc_64f(nbDly_);
-                ippsZero_64f(pDlySrc64f_, nbDly_);
-                pDlyDst64f_ = ippsMalloc_64f(nbDly_);
-                ippsZero_64f(pDlyDst64f_, nbDly_);
-            }
         }
         else
         {
-            if (impUse == IIRDFImplementation::DF2_FAST)
+            pDlySrc32f_ = ippsMalloc_32f(nbDly_);
+            ippsZero_32f(pDlySrc32f_, nbDly_);
+            pDlyDst32f_ = ippsMalloc_32f(nbDly_);
+            ippsZero_32f(pDlyDst32f_, nbDly_);
+            if (implementation_ == IIRDFImplementation::DF2_FAST)
             {
                 status = ippsIIRGetStateSize_32f(order_, &bufferSize_);
                 if (status != ippStsNoErr)
                 {
                     std::cerr << "Failed to get state size in float"
                               << std::endl;
-                    clear();
                     return -1;
                 }
                 // Set the workspace
                 pBufIPP32f_ = ippsMalloc_32f(bufIPPLen_);
                 ippsZero_32f(pBufIPP32f_, bufIPPLen_);
-                pDlySrc32f_ = ippsMalloc_32f(nbDly_);
-                ippsZero_32f(pDlySrc32f_, nbDly_);
-                pDlyDst32f_ = ippsMalloc_32f(nbDly_); 
-                ippsZero_32f(pDlyDst32f_, nbDly_);
                 pBuf_ = ippsMalloc_8u(bufferSize_);
-                // Set the (normalized) filter taps
-                pTaps32f_ = ippsMalloc_32f(2*(order_ + 1));
-                ippsZero_32f(pTaps32f_, 2*(order_ + 1));
-                ippsConvert_64f32f(bRef_, &pTaps32f_[0],        nbRef_);
-                ippsConvert_64f32f(aRef_, &pTaps32f_[order_+1], naRef_);
-                auto a04 = static_cast<float> (a0);
-                ippsDivC_32f_I(a04, &pTaps32f_[0],        nbRef_);
-                ippsDivC_32f_I(a04, &pTaps32f_[order_+1], naRef_);
                 // Initialize the filter
-                status = ippsIIRInit_32f(&pIIRState32f_, pTaps32f_, order_,
-                                         pDlySrc32f_, pBuf_);
+                status = ippsIIRInit_32f(&pIIRState32f_, plan_->pTaps32f_,
+                                         order_, pDlySrc32f_, pBuf_);
                 if (status != ippStsNoErr)
                 {
                     std::cerr << "Failed to initialize float filter"
                               << std::endl;
-                    clear();
                     return -1;
                 }
                 // Set the delay line
@@ -270,30 +353,44 @@ public:
                 {
                     std::cerr << "Failed to set delay line in float"
                               << std::endl;
-                    clear();
                     return -1;
                 }
             }
-            else
+        }
+        return createBlockEngines();
+    }
+    /// Creates the filter engines for the block-parallel application.  This
+    /// is done when the filter is initialized or the number of threads
+    /// changes so that applying the filter does not create them.
+    int createBlockEngines()
+    {
+        mEngines.clear();
+        mBlockWorkspace.clear();
+        if (mMode != RTSeis::ProcessingMode::POST || mThreads < 2 ||
+            implementation_ != IIRDFImplementation::DF2_FAST || order_ < 1)
+        {
+            return 0;
+        }
+        const T *taps = nullptr;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            taps = plan_->pTaps64f_;
+        }
+        else
+        {
+            taps = plan_->pTaps32f_;
+        }
+        mEngines = std::vector<IIREngine<T>> (mThreads);
+        for (auto &engine : mEngines)
+        {
+            if (engine.initialize(taps, order_) != 0)
             {
-                auto a04 = static_cast<float> (a0);
-                bNorm32f_ = ippsMalloc_32f(order_+1);
-                ippsZero_32f(bNorm32f_, order_+1);
-                ippsConvert_64f32f(bRef_, bNorm32f_, nbRef_);
-                ippsDivC_32f_I(a04, bNorm32f_, nbRef_);
-                aNorm32f_ = ippsMalloc_32f(order_+1);
-                ippsZero_32f(aNorm32f_, order_+1);
-                ippsConvert_64f32f(aRef_, aNorm32f_, naRef_);
-                ippsDivC_32f_I(a04, aNorm32f_, naRef_);
-                // Initial/final conditions
-                pDlySrc32f_ = ippsMalloc_32f(nbDly_);
-                ippsZero_32f(pDlySrc32f_, nbDly_);
-                pDlyDst32f_ = ippsMalloc_32f(nbDly_);
-                ippsZero_32f(pDlyDst32f_, nbDly_);
+                std::cerr << "Failed to initialize block filter" << std::endl;
+                mEngines.clear();
+                return -1;
             }
         }
-        implementation_ = impUse;
-        linit_ = true;
+        mBlockWorkspace.allocate(mThreads, order_);
         return 0;
     }
     /// Determines if the filter is initialized
@@ -375,6 +472,11 @@ public:
             ippsFree(y32);
             return 0;
         }
+        if constexpr (std::is_same<T, double>::value)
+        {
+            auto nBlocks = computeNumberOfParallelBlocks(n);
+            if (nBlocks > 1){return applyParallel(n, x, y, nBlocks);}
+        }
         IppStatus status;
         if (implementation_ == IIRDFImplementation::DF2_FAST)
         {
@@ -418,6 +520,11 @@ public:
             ippsFree(y64);
             return 0;
         }
+        if constexpr (std::is_same<T, float>::value)
+        {
+            auto nBlocks = computeNumberOfParallelBlocks(n);
+            if (nBlocks > 1){return applyParallel(n, x, y, nBlocks);}
+        }
         IppStatus status;
         if (implementation_ == IIRDFImplementation::DF2_FAST)
         {
@@ -439,11 +546,69 @@ public:
         }
         return 0;
     }
+    /// Sets the number of threads used in post-processing.  If the block
+    /// filters cannot be created then the filter is applied sequentially.
+    void setNumberOfThreads(const int nThreads)
+    {
+        mThreads = nThreads;
+        if (linit_){createBlockEngines();}
+    }
+    /// Gets the number of threads used in post-processing.
+    [[nodiscard]] int getNumberOfThreads() const noexcept
+    {
+        return mThreads;
+    }
+    /// Determines the number of blocks for the block-parallel filter.  If
+    /// this is 1 then the filter is applied sequentially.
+    [[nodiscard]] int computeNumberOfParallelBlocks(const int n) const
+    {
+        // The engines only exist when the block-parallel filter applies
+        auto nEngines = static_cast<int> (mEngines.size());
+        if (nEngines < 2){return 1;}
+        return computeNumberOfFilterBlocks(n, nEngines);
+    }
+    /// Applies the filter to blocks of the signal concurrently.  As with
+    /// the sequential filter the IPP state is left with the final delay line.
+    [[nodiscard]] int applyParallel(const int n, const T x[], T y[],
+                                    const int nBlocks)
+    {
+        T *zi = nullptr;
+        T *zf = nullptr;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            zi = pBufIPP64f_;
+            zf = pDlyDst64f_;
+            ippsIIRGetDlyLine_64f(pIIRState64f_, zi);
+        }
+        else
+        {
+            zi = pBufIPP32f_;
+            zf = pDlyDst32f_;
+            ippsIIRGetDlyLine_32f(pIIRState32f_, zi);
+        }
+        blockParallelFilter(n, x, y, order_, zi, zf, nBlocks, mBlockWorkspace,
+                            [this](const int block, const int nb,
+                                   const T *xb, T *yb,
+                                   const T *dlyIn, T *dlyOut)
+                            {
+                                mEngines[block].apply(nb, xb, yb,
+                                                      dlyIn, dlyOut);
+                            });
+        if constexpr (std::is_same<T, double>::value)
+        {
+            ippsIIRSetDlyLine_64f(pIIRState64f_, zf);
+        }
+        else
+        {
+            ippsIIRSetDlyLine_32f(pIIRState32f_, zf);
+        }
+        return 0;
+    }
     /// A more numerically robust yet slower filter implementation
     int iirDF2Transpose(const int n, const double x[], double y[])
     {
-        Ipp64f *b = bNorm64f_;
-        Ipp64f *a = aNorm64f_;
+        const Ipp64f *b = plan_->bNorm64f_;
+        const Ipp64f *a = plan_->aNorm64f_;
         Ipp64f *vi = pDlySrc64f_;
         Ipp64f *v  = pDlyDst64f_;
         // Loop on samples
@@ -475,8 +640,8 @@ public:
     /// A more numerically robust yet slower filter implementation
     int iirDF2Transpose(const int n, const float x[], float y[])
     {
-        Ipp32f *b = bNorm32f_;
-        Ipp32f *a = aNorm32f_;
+        const Ipp32f *b = plan_->bNorm32f_;
+        const Ipp32f *a = plan_->aNorm32f_;
         Ipp32f *vi = pDlySrc32f_;
         Ipp32f *v  = pDlyDst32f_;
         // Loop on samples
@@ -506,22 +671,26 @@ public:
         return 0;
     }
 private:
+    /// Filter engines for the block-parallel application.  There is one
+    /// per thread.
+    std::vector<IIREngine<T>> mEngines;
+    /// Scratch space for the block-parallel application.
+    BlockParallelWorkspace<T> mBlockWorkspace;
+    /// The shared filter design.
+    std::shared_ptr<const IIRPlan> plan_ = nullptr;
     /// IIR filtering state
     IppsIIRState_64f *pIIRState64f_ = nullptr;
-    /// The Filter taps.  This has dimension [2*(order_+1)].
-    Ipp64f *pTaps64f_ = nullptr;
-    /// Every 1024 points sampled we need to rollover the IIR filter
-    /// in IPP.  This has dimension [bufIPPLen_].
+    /// Holds the delay line when getting/setting the IPP filter state.
+    /// This has dimension [bufIPPLen_].
     Ipp64f *pBufIPP64f_ = nullptr;
     /// Holds the input IIR filter delay line.  This has dimension [nbDly_].
     Ipp64f *pDlySrc64f_ = nullptr;
     /// Holds the output IIR filter delay line.  This has dimension [nbDly_].
     Ipp64f *pDlyDst64f_ = nullptr;
     /// IIR filtering state
-    IppsIIRState_32f *pIIRState32f_ = nullptr;;
-    /// The Filter taps.  This has dimension [2*(order_+1)].
-    Ipp32f *pTaps32f_ = nullptr;
-    /// Holds the input IIR filter conditions.  This has dimension [bufIPPLen_].
+    IppsIIRState_32f *pIIRState32f_ = nullptr;
+    /// Holds the delay line when getting/setting the IPP filter state.
+    /// This has dimension [bufIPPLen_].
     Ipp32f *pBufIPP32f_ = nullptr;
     /// Holds the input IIR filter delay line.  This has dimension [nbDly_].
     Ipp32f *pDlySrc32f_ = nullptr;
@@ -529,24 +698,6 @@ private:
     Ipp32f *pDlyDst32f_ = nullptr;
     /// The workspace buffer for the filter.
     Ipp8u *pBuf_ = nullptr;
-    /// The reference filter numerator coefficients.
-    /// This has dimension [nbRef_].
-    Ipp64f *bRef_ = nullptr;
-    /// The reference filter denominator coefficients.
-    /// This has dimension [naRef_].
-    Ipp64f *aRef_ = nullptr;
-    /// These are the normalized numerator coefficients.
-    /// This has dimension [order_+1].
-    Ipp64f *bNorm64f_ = nullptr;
-    /// These are the normalized denominator coefficients.
-    /// This has dimension [order_+1].
-    Ipp64f *aNorm64f_ = nullptr;
-    /// These are the normalized numerator coefficients.
-    /// This has dimension [order_+1].
-    Ipp32f *bNorm32f_ = nullptr;
-    /// These are the normalized denominator coefficients.
-    /// This has dimension [order_+1].
-    Ipp32f *aNorm32f_ = nullptr;
     /// Holds a copy of the initial conditions
     Ipp64f *zi_ = nullptr;
     /// The length of the delay line.  This is length order_ + 1.
@@ -555,14 +706,12 @@ private:
     int bufIPPLen_ = 0;
     /// The filter order = max(nbRef_, naRef_) - 1. 
     int order_ = 0;
-    /// Reference number of numerator coefficients
-    int nbRef_ = 0; 
-    /// Reference number of denominator coefficients
-    int naRef_ = 0;
     /// The length of the pBuf.
     int bufferSize_ = 0;
     /// Filter implementation
     IIRDFImplementation implementation_ = IIRDFImplementation::DF2_FAST;
+    /// The number of threads used in post-processing.
+    int mThreads = 1;
     /// Real-time vs. post-processing.
     const RTSeis::ProcessingMode mMode = E;
     /// Precision of filter application
@@ -713,6 +862,25 @@ void IIRFilter<E, T>::apply(const int n, const T x[], T *yIn[])
 #endif
 }
 
+/// Set number of threads
+template<RTSeis::ProcessingMode E, class T>
+void IIRFilter<E, T>::setNumberOfThreads(const int nThreads)
+{
+    if (nThreads < 1)
+    {
+        throw std::invalid_argument("nThreads = " + std::to_string(nThreads)
+                                  + " must be positive");
+    }
+    pImpl->setNumberOfThreads(nThreads);
+}
+
+/// Get number of threads
+template<RTSeis::ProcessingMode E, class T>
+int IIRFilter<E, T>::getNumberOfThreads() const noexcept
+{
+    return pImpl->getNumberOfThreads();
+}
+
 template<RTSeis::ProcessingMode E, class T>
 bool IIRFilter<E, T>::isInitialized() const noexcept
 {
@@ -1,30 +1,67 @@
 #include <iostream>
 #include <cmath>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 #ifndef NDEBUG
 #include <cassert>
 #endif
 #include <ipps.h>
 #include "rtseis/enums.hpp"
+#include "private/blockParallelFilter.hpp"
+#include "private/iirEngine.hpp"
 #include "rtseis/utilities/filterImplementations/iiriirFilter.hpp"
 
 using namespace RTSeis::Utilities::FilterImplementations;
 
+namespace
+{
+/// @brief Computes the delay line of a direct form II transposed filter
+///        in steady-state for a unit step input.  This is equivalent to
+///        SciPy's lfilter_zi.
+/// @param[in] order  The filter order.
+/// @param[in] b      The numerator coefficients.  This has dimension
+///                   [order+1].
+/// @param[in] a      The denominator coefficients normalized so that a[0]
+///                   is 1.  This has dimension [order+1].
+/// @param[out] zi    The steady-state delay line.  This has dimension
+///                   [order].
+void computeStepResponseDelayLine(const int order,
+                                  const double b[], const double a[],
+                                  double zi[])
+{
+    if (order < 1){return;}
+    // In steady-state the output is the DC gain, G, so the delay line
+    // satisfies z[k] = z[k+1] + b[k+1] - a[k+1] G with z[order] = 0.
+    double bsum = 0;
+    double asum = 0;
+    for (int k = 0; k <= order; ++k)
+    {
+        bsum = bsum + b[k];
+        asum = asum + a[k];
+    }
+    auto gain = bsum/asum;
+    double z = 0;
+    for (int k = order - 1; k >= 0; --k)
+    {
+        z = z + b[k + 1] - a[k + 1]*gain;
+        zi[k] = z;
+    }
+}
+}
+
 template<class T>
 class IIRIIRFilter<T>::IIRIIRImpl
 {
 public:
     /// Default constructor
-    /*
-    IIRIIRImpl()
-    {
-    }
+    IIRIIRImpl() = default;
     /// Copy constructor
     IIRIIRImpl(const IIRIIRImpl &iiriir)
     {
         *this = iiriir;
     }
-    */
     /// Destructor
     ~IIRIIRImpl()
     {
@@ -34,10 +71,19 @@ public:
     IIRIIRImpl& operator=(const IIRIIRImpl &iiriir)
     {
         if (&iiriir == this){return *this;}
+        mThreads = iiriir.mThreads;
         if (!iiriir.linit_ ){return *this;}
         // Reinitialize the filter
-        int ierr = initialize(iiriir.nbRef_, iiriir.bRef_,
+        int ierr = 0;
+        if (iiriir.nSections_ > 0)
+        {
+            ierr = initialize(iiriir.nSections_, iiriir.bRef_, iiriir.aRef_);
+        }
+        else
+        {
+            ierr = initialize(iiriir.nbRef_, iiriir.bRef_,
                               iiriir.naRef_, iiriir.aRef_);
+        }
         if (ierr != 0)
         {
             std::cerr << "Failed to initialize filter in impl copy assignment"
@@ -87,11 +133,20 @@ public:
         bRef_ = nullptr;
         aRef_ = nullptr;
         zi_ = nullptr;
+        mEngines.clear();
+        mBlockWorkspace.clear();
+        mTaps.clear();
+        mStepState.clear();
+        mExtended.clear();
+        mWork.clear();
+        mDlyIn.clear();
+        mDlyOut.clear();
         nwork_ = 0;
         bufferSize_ = 0;
         order_ = 0;
         nbRef_ = 0;
         naRef_ = 0;
+        nSections_ = 0;
         lhaveZI_ = false;
         linit_ = false;
     }
@@ -177,6 +232,95 @@ public:
         linit_ = true;
         return 0;
     }
+    /// Initializes the filter from second order sections
+    [[nodiscard]]
+    int initialize(const int ns, const double bs[], const double as[])
+    {
+        clear();
+        nSections_ = ns;
+        nbRef_ = 3*ns;
+        naRef_ = 3*ns;
+        order_ = 2*ns;
+        nwork_ = std::max(32, order_);
+        bRef_ = ippsMalloc_64f(nbRef_);
+        ippsCopy_64f(bs, bRef_, nbRef_);
+        aRef_ = ippsMalloc_64f(naRef_);
+        ippsCopy_64f(as, aRef_, naRef_);
+        zi_ = ippsMalloc_64f(nwork_);
+        ippsZero_64f(zi_, nwork_);
+        if (mPrecision == RTSeis::Precision::DOUBLE)
+        {
+            dlysrc64_ = ippsMalloc_64f(nwork_);
+            ippsZero_64f(dlysrc64_, nwork_);
+        }
+        else
+        {
+            dlysrc32_ = ippsMalloc_32f(nwork_);
+            ippsZero_32f(dlysrc32_, nwork_);
+        }
+        // Each section's steady-state delay line is scaled by the DC gain
+        // of the preceding sections
+        mTaps.resize(6*ns);
+        mStepState.resize(2*ns);
+        double gain = 1;
+        for (int is = 0; is < ns; ++is)
+        {
+            double bn[3], an[3], zi[2];
+            for (int i = 0; i < 3; ++i)
+            {
+                bn[i] = bs[3*is + i]/as[3*is];
+                an[i] = as[3*is + i]/as[3*is];
+                mTaps[6*is + i] = static_cast<T> (bn[i]);
+                mTaps[6*is + 3 + i] = static_cast<T> (an[i]);
+            }
+            computeStepResponseDelayLine(2, bn, an, zi);
+            mStepState[2*is]     = static_cast<T> (gain*zi[0]);
+            mStepState[2*is + 1] = static_cast<T> (gain*zi[1]);
+            gain = gain*(bn[0] + bn[1] + bn[2])/(an[0] + an[1] + an[2]);
+        }
+        mDlyIn.resize(order_);
+        mDlyOut.resize(order_);
+        if (createBlockEngines() != 0)
+        {
+            clear();
+            return -1;
+        }
+        lhaveZI_ = false;
+        linit_ = true;
+        return 0;
+    }
+    /// Creates a filter engine per thread and the scratch space for the
+    /// block-parallel passes of the second order sections.
+    int createBlockEngines()
+    {
+        mEngines.clear();
+        mBlockWorkspace.clear();
+        if (nSections_ < 1){return 0;}
+        auto nEngines = std::max(1, mThreads);
+        mEngines = std::vector<IIREngine<T>> (nEngines);
+        for (auto &engine : mEngines)
+        {
+            if (engine.initializeBiQuad(mTaps.data(), nSections_) != 0)
+            {
+                std::cerr << "Failed to initialize block filter" << std::endl;
+                mEngines.clear();
+                return -1;
+            }
+        }
+        mBlockWorkspace.allocate(nEngines, order_);
+        return 0;
+    }
+    /// Sets the number of threads
+    void setNumberOfThreads(const int nThreads)
+    {
+        mThreads = nThreads;
+        if (nSections_ > 0){createBlockEngines();}
+    }
+    /// Gets the number of threads
+    [[nodiscard]] int getNumberOfThreads() const noexcept
+    {
+        return mThreads;
+    }
     /// Determines if the module is initialized
     [[nodiscard]] bool isInitialized() const
     {
@@ -240,6 +384,10 @@ public:
             ippsFree(y32);
             return 0;
         }
+        if constexpr (std::is_same<T, double>::value)
+        {
+            if (nSections_ > 0){return applyBlockPasses(n, x, y);}
+        }
         // Set a delay line if the user desires it.  Note, the
         // initialization sets a NULL delay line.
         IppStatus status;
@@ -285,6 +433,10 @@ public:
             ippsFree(y64);
             return 0;
         }
+        if constexpr (std::is_same<T, float>::value)
+        {
+            if (nSections_ > 0){return applyBlockPasses(n, x, y);}
+        }
         // Set a delay line if the user desires it.  Note, the
         // initialization sets a NULL delay line.
         IppStatus status;
@@ -308,7 +460,98 @@ public:
         if (lhaveZI_){ippsIIRIIRSetDlyLine_32f(pState32_, nullptr);}
         return 0;
     }
+    /// The number of samples reflected about each edge of the signal.
+    [[nodiscard]] int getEdgeLength(const int n) const noexcept
+    {
+        return std::min(3*order_, n - 1);
+    }
+    /// Applies the second order sections forwards then backwards to the
+    /// signal with odd reflections about its edges.  Each pass is
+    /// block-parallel.  The engines and their scratch space are created at
+    /// initialization while the extended signal is retained between
+    /// applications.  The edges are treated identically for any number of
+    /// blocks.
+    [[nodiscard]] int applyBlockPasses(const int n, const T x[], T y[])
+    {
+        auto nfact = getEdgeLength(n);
+        auto ne = n + 2*nfact;
+        auto nState = order_;
+        auto nEngines = static_cast<int> (mEngines.size());
+        if (nEngines < 1){return -1;}
+        auto nBlocks = computeNumberOfFilterBlocks(ne, nEngines);
+        if (static_cast<int> (mExtended.size()) < ne)
+        {
+            mExtended.resize(ne);
+            mWork.resize(ne);
+        }
+        auto filter = [this](const int block, const int nb,
+                             const T *xb, T *yb,
+                             const T *dlyIn, T *dlyOut)
+                      {
+                          mEngines[block].apply(nb, xb, yb, dlyIn, dlyOut);
+                      };
+        // Extend the signal with odd reflections about its edges
+        T *ext = mExtended.data();
+        T *work = mWork.data();
+        auto x0 = x[0];
+        auto xn = x[n - 1];
+        for (int i = 0; i < nfact; ++i)
+        {
+            ext[i] = 2*x0 - x[nfact - i];
+            ext[nfact + n + i] = 2*xn - x[n - 2 - i];
+        }
+        std::copy(x, x + n, ext + nfact);
+        // Forward pass
+        for (int i = 0; i < nState; ++i)
+        {
+            mDlyIn[i] = mStepState[i]*ext[0];
+        }
+        if (lhaveZI_)
+        {
+            if constexpr (std::is_same<T, double>::value)
+            {
+                std::copy(dlysrc64_, dlysrc64_ + nState, mDlyIn.begin());
+            }
+            else
+            {
+                std::copy(dlysrc32_, dlysrc32_ + nState, mDlyIn.begin());
+            }
+        }
+        blockParallelFilter(ne, ext, work, nState,
+                            mDlyIn.data(), mDlyOut.data(), nBlocks,
+                            mBlockWorkspace, filter);
+        // Backward pass
+        std::reverse(work, work + ne);
+        for (int i = 0; i < nState; ++i)
+        {
+            mDlyIn[i] = mStepState[i]*work[0];
+        }
+        blockParallelFilter(ne, work, ext, nState,
+                            mDlyIn.data(), mDlyOut.data(), nBlocks,
+                            mBlockWorkspace, filter);
+        // Reverse and remove the extensions
+        std::reverse_copy(ext + nfact, ext + nfact + n, y);
+        return 0;
+    }
 //private:
+    /// Filter engines for the block-parallel passes.  There is one per
+    /// thread.
+    std::vector<IIREngine<T>> mEngines;
+    /// Scratch space for the block-parallel passes.
+    BlockParallelWorkspace<T> mBlockWorkspace;
+    /// The normalized second order section taps.
+    std::vector<T> mTaps;
+    /// The delay line of the sections for a unit step in steady-state.
+    /// This has dimension [order_].
+    std::vector<T> mStepState;
+    /// Holds the extended signal.
+    std::vector<T> mExtended;
+    /// Holds the filtered extended signal.
+    std::vector<T> mWork;
+    /// The delay line entering a pass.
+    std::vector<T> mDlyIn;
+    /// The delay line exiting a pass.
+    std::vector<T> mDlyOut;
     /// The IIR filter state. 
     IppsIIRState_64f *pState64_ = nullptr;
     /// The IIR filter taps.  This has dimension [2*(order_+1)].
@@ -341,6 +584,10 @@ public:
     int nbRef_ = 0;
     /// The number of denominator coefficients.
     int naRef_ = 0;
+    /// The number of second order sections.  This is 0 for the direct form.
+    int nSections_ = 0;
+    /// The number of threads.
+    int mThreads = 1;
     /// Flag indicating that the initial conditions have been set.
     bool lhaveZI_ = false;
     /// The default module implementation.
@@ -434,6 +681,46 @@ void IIRIIRFilter<double>::initialize(const int nb, const double b[],
 #endif
 }
 
+/// Initialize the filter from second order sections
+template<class T>
+void IIRIIRFilter<T>::initialize(const int ns,
+                                 const double bs[], const double as[])
+{
+    clear();
+    if (ns < 1){throw std::invalid_argument("No sections");}
+    if (bs == nullptr){throw std::invalid_argument("bs is NULL");}
+    if (as == nullptr){throw std::invalid_argument("as is NULL");}
+    for (int is = 0; is < ns; ++is)
+    {
+        if (as[3*is] == 0)
+        {
+            throw std::invalid_argument("as[" + std::to_string(3*is)
+                                      + "] cannot equal 0");
+        }
+    }
+    int ierr = pIIRIIR_->initialize(ns, bs, as);
+    if (ierr != 0){throw std::runtime_error("Failed to initialize filter");}
+}
+
+/// Sets the number of threads
+template<class T>
+void IIRIIRFilter<T>::setNumberOfThreads(const int nThreads)
+{
+    if (nThreads < 1)
+    {
+        throw std::invalid_argument("nThreads = " + std::to_string(nThreads)
+                                  + " must be positive");
+    }
+    pIIRIIR_->setNumberOfThreads(nThreads);
+}
+
+/// Gets the number of threads
+template<class T>
+int IIRIIRFilter<T>::getNumberOfThreads() const noexcept
+{
+    return pIIRIIR_->getNumberOfThreads();
+}
+
 /*
 /// Initialize the filter (float)
 template<>
@@ -1,4 +1,7 @@
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 #include <ipps.h>
 #ifndef NDEBUG
 #include <cassert>
@@ -9,6 +12,169 @@
 
 using namespace RTSeis::Utilities::FilterImplementations;
 
+namespace
+{
+/// Windows at least this long use the sliding heap when the
+/// implementation is AUTO.
+constexpr int SLIDING_HEAP_MIN_WINDOW = 64;
+
+/// Maintains the median of a sliding window with O(log w) updates.  This
+/// is the `mediator' data structure: a max-heap holding the lower half of
+/// the window and a min-heap holding the upper half are arranged about the
+/// median.  Heap index 0 is the median, indices -1, -2, ... are the
+/// max-heap, and indices 1, 2, ... are the min-heap.  The heaps index into
+/// a ring buffer of the window's samples so the oldest sample is replaced
+/// in place and no memory is allocated after initialization.
+template<class T>
+class SlidingMedian
+{
+public:
+    /// Sets the window length.  This must be odd.
+    void initialize(const int windowLength)
+    {
+        mWindowLength = windowLength;
+        mHalf = windowLength/2;
+        mData.resize(windowLength);
+        mPosition.resize(windowLength);
+        mHeap.resize(windowLength);
+        reset(nullptr);
+    }
+    /// Fills the window with the initial conditions which have dimension
+    /// [windowLength - 1].  The oldest sample in the window is a
+    /// placeholder which is replaced by the first sample to be filtered.
+    void reset(const double zi[])
+    {
+        mData[0] = 0;
+        for (int i = 1; i < mWindowLength; ++i)
+        {
+            mData[i] = (zi != nullptr) ? static_cast<T> (zi[i-1]) : 0;
+        }
+        mOldest = 0;
+        // A sorted window satisfies both heap properties
+        for (int i = 0; i < mWindowLength; ++i){mHeap[i] = i;}
+        std::sort(mHeap.begin(), mHeap.end(),
+                  [this](const int i, const int j)
+                  {
+                      return mData[i] < mData[j];
+                  });
+        for (int i = 0; i < mWindowLength; ++i)
+        {
+            mPosition[mHeap[i]] = i - mHalf;
+        }
+    }
+    /// Replaces the oldest sample in the window with x and returns the
+    /// median of the updated window.
+    T insert(const T x)
+    {
+        const int p = mPosition[mOldest];
+        const T old = mData[mOldest];
+        mData[mOldest] = x;
+        mOldest = mOldest + 1;
+        if (mOldest == mWindowLength){mOldest = 0;}
+        if (p > 0)
+        {
+            // The new sample is in the min-heap
+            if (old < x)
+            {
+                minSortDown(2*p);
+            }
+            else if (minSortUp(p))
+            {
+                maxSortDown(-1);
+            }
+        }
+        else if (p < 0)
+        {
+            // The new sample is in the max-heap
+            if (x < old)
+            {
+                maxSortDown(2*p);
+            }
+            else if (maxSortUp(p))
+            {
+                minSortDown(1);
+            }
+        }
+        else
+        {
+            // The new sample is the median
+            if (mHalf > 0 && maxSortUp(-1)){maxSortDown(-2);}
+            if (mHalf > 0 && minSortUp(1)){minSortDown(2);}
+        }
+        return mData[heap(0)];
+    }
+private:
+    /// The ring buffer index at heap index i.
+    [[nodiscard]] int heap(const int i) const noexcept
+    {
+        return mHeap[i + mHalf];
+    }
+    /// True if the sample at heap index i is less than the sample at heap
+    /// index j.
+    [[nodiscard]] bool less(const int i, const int j) const noexcept
+    {
+        return mData[heap(i)] < mData[heap(j)];
+    }
+    /// Swaps the samples at heap indices i and j if heap[i] < heap[j].
+    bool compareExchange(const int i, const int j) noexcept
+    {
+        if (!less(i, j)){return false;}
+        auto &hi = mHeap[i + mHalf];
+        auto &hj = mHeap[j + mHalf];
+        std::swap(hi, hj);
+        mPosition[hi] = i;
+        mPosition[hj] = j;
+        return true;
+    }
+    /// Restores the min-heap property below i/2.
+    void minSortDown(int i) noexcept
+    {
+        for (; i <= mHalf; i = 2*i)
+        {
+            if (i > 1 && i < mHalf && less(i + 1, i)){i = i + 1;}
+            if (!compareExchange(i, i/2)){break;}
+        }
+    }
+    /// Restores the max-heap property below i/2.
+    void maxSortDown(int i) noexcept
+    {
+        for (; i >= -mHalf; i = 2*i)
+        {
+            if (i < -1 && i > -mHalf && less(i, i - 1)){i = i - 1;}
+            if (!compareExchange(i/2, i)){break;}
+        }
+    }
+    /// Moves the min-heap sample at i towards the median.  Returns true if
+    /// it became the median.
+    bool minSortUp(int i) noexcept
+    {
+        while (i > 0 && compareExchange(i, i/2)){i = i/2;}
+        return i == 0;
+    }
+    /// Moves the max-heap sample at i towards the median.  Returns true if
+    /// it became the median.
+    bool maxSortUp(int i) noexcept
+    {
+        while (i < 0 && compareExchange(i/2, i)){i = i/2;}
+        return i == 0;
+    }
+
+    /// The samples in the window.  This has dimension [mWindowLength].
+    std::vector<T> mData;
+    /// The heap index of each sample.  This has dimension [mWindowLength].
+    std::vector<int> mPosition;
+    /// The ring buffer index at each heap index offset by mHalf.
+    /// This has dimension [mWindowLength].
+    std::vector<int> mHeap;
+    /// The window length.
+    int mWindowLength = 0;
+    /// Half the window length.  This is the size of either heap.
+    int mHalf = 0;
+    /// The ring buffer index of the oldest sample.
+    int mOldest = 0;
+};
+}
+
 template<RTSeis::ProcessingMode E, class T>
 class MedianFilter<E, T>::MedianFilterImpl
 {
@@ -26,7 +192,7 @@ public:
         if (&median == this){return *this;}
         if (!median.mInitialized){return *this;}
         // Reinitialize the filter
-        int ierr = initialize(median.maskSize_);
+        int ierr = initialize(median.maskSize_, median.implementation_);
         if (ierr != 0)
         {
             std::cerr << "Failed to initialize median filter in impl c'tor"
@@ -35,13 +201,15 @@ public:
             return *this;
         }
         // Now copy the filter states
+        mSlidingMedian = median.mSlidingMedian;
         if (bufferSize_ > 0)
         {
             ippsCopy_8u(median.pBuf_, pBuf_, bufferSize_);
         }
-        if (nwork_ > 0)
+        if (nwork_ > 0){ippsCopy_64f(median.zi_, zi_, nwork_);}
+        if (nwork_ > 0 &&
+            implementation_ == MedianFilterImplementation::DIRECT)
         {
-            ippsCopy_64f(median.zi_, zi_, nwork_);
             if (mPrecision == RTSeis::Precision::DOUBLE)
             {
                 ippsCopy_64f(median.dlysrc64_, dlysrc64_, nwork_);
@@ -70,6 +238,7 @@ public:
         if (dlydst32_ != nullptr){ippsFree(dlydst32_);}
         if (pBuf_     != nullptr){ippsFree(pBuf_);}
         if (zi_       != nullptr){ippsFree(zi_);}
+        mSlidingMedian = SlidingMedian<T> ();
         dlysrc64_ = nullptr;
         dlydst64_ = nullptr;
         dlysrc32_ = nullptr;
@@ -78,17 +247,35 @@ public:
         zi_ = nullptr;
         maskSize_ = 0;
         bufferSize_ = 0;
+        implementation_ = MedianFilterImplementation::DIRECT;
         mInitialized = false;
     }
     /// Initializes the filter
-    int initialize(const int n)
+    int initialize(const int n,
+                   const MedianFilterImplementation implementation)
     {
         clear();
         maskSize_ = n; // This better be odd by this point
+        implementation_ = implementation;
+        if (implementation_ == MedianFilterImplementation::AUTO)
+        {
+            implementation_ = MedianFilterImplementation::DIRECT;
+            if (maskSize_ >= SLIDING_HEAP_MIN_WINDOW)
+            {
+                implementation_ = MedianFilterImplementation::SLIDING_HEAP;
+            }
+        }
         // Set the space
         nwork_ = std::max(8, maskSize_ - 1);
         zi_ = ippsMalloc_64f(nwork_);
         ippsZero_64f(zi_, nwork_);
+        // The sliding heap keeps its own window
+        if (implementation_ == MedianFilterImplementation::SLIDING_HEAP)
+        {
+            mSlidingMedian.initialize(maskSize_);
+            mInitialized = true;
+            return 0;
+        }
         if (mPrecision == RTSeis::Precision::DOUBLE)
         {
             IppStatus status = ippsFilterMedianGetBufferSize(maskSize_,
@@ -143,25 +330,21 @@ public:
     /// Set the initial conditions
     int setInitialConditions(const int nz, const double zi[])
     {
-        resetInitialConditions();
         int nzRef = getInitialConditionLength();
 #ifndef NDEBUG
         assert(nzRef == nz);
 #endif
         if (nzRef > 0){ippsCopy_64f(zi, zi_, nzRef);}
-        if (mPrecision == RTSeis::Precision::DOUBLE)
-        {   
-            if (nzRef > 0){ippsCopy_64f(zi, dlysrc64_, nzRef);}
-        }
-        else
-        {
-            if (nzRef > 0){ippsConvert_64f32f(zi, dlysrc32_, nzRef);}
-        }   
-        return 0;
+        return resetInitialConditions();
     }
     /// Resets the initial conditions
     int resetInitialConditions()
     {
+        if (implementation_ == MedianFilterImplementation::SLIDING_HEAP)
+        {
+            mSlidingMedian.reset(zi_);
+            return 0;
+        }
         if (mPrecision == RTSeis::Precision::DOUBLE)
         {
             if (nwork_ > 0){ippsCopy_64f(zi_, dlysrc64_, nwork_);}
@@ -172,102 +355,68 @@ public:
         }   
         return 0;
     }
-    /// Apply the filter
-    int apply(const int n, const double x[], double y[])
+    /// Apply the filter.  The precision is fixed by T.
+    int apply(const int n, const T x[], T y[])
     {
         if (n <= 0){return 0;} // Nothing to do
-        if (mPrecision == RTSeis::Precision::FLOAT)
+        if (implementation_ == MedianFilterImplementation::SLIDING_HEAP)
         {
-            Ipp32f *x32 = ippsMalloc_32f(n);
-            Ipp32f *y32 = ippsMalloc_32f(n);
-            ippsConvert_64f32f(x, x32, n);
-            int ierr = apply(n, x32, y32);
-            ippsFree(x32);
-            if (ierr != 0)
+            // Post-processing always starts from the initial conditions
+            if (mMode == RTSeis::ProcessingMode::POST)
             {
-                std::cerr << "Failed to apply float filter in double"
-                          << std::endl;
-                ippsFree(y32);
-                return -1;
+                mSlidingMedian.reset(zi_);
+            }
+            for (int i = 0; i < n; ++i)
+            {
+                y[i] = mSlidingMedian.insert(x[i]);
             }
-            ippsConvert_32f64f(y32, y, n);
-            ippsFree(y32);
             return 0;
         }
         IppStatus status;
         if (mMode == RTSeis::ProcessingMode::REAL_TIME)
         {
-            status = ippsFilterMedian_64f(x, y, n, maskSize_,
-                                          dlysrc64_, dlydst64_, pBuf_);
-            if (status != ippStsNoErr)
+            if constexpr (std::is_same<T, double>::value)
             {
-                std::cerr << "Failed to apply real-time filter in double"
-                          << std::endl;
-                return -1;
+                status = ippsFilterMedian_64f(x, y, n, maskSize_,
+                                              dlysrc64_, dlydst64_, pBuf_);
             }
-            if (maskSize_ > 1)
+            else
             {
-                ippsCopy_64f(dlydst64_, dlysrc64_, maskSize_-1);
+                status = ippsFilterMedian_32f(x, y, n, maskSize_,
+                                              dlysrc32_, dlydst32_, pBuf_);
             }
-        }
-        else
-        {
-            status = ippsFilterMedian_64f(x, y, n, maskSize_,
-                                          dlysrc64_, nullptr, pBuf_);
             if (status != ippStsNoErr)
             {
-                std::cerr << "Failed to apply post-processing filter in double"
-                          << std::endl;
+                std::cerr << "Failed to apply real-time filter" << std::endl;
                 return -1;
             }
-        }
-        return 0;
-    }
-    /// Apply the filter
-    int apply(const int n, const float x[], float y[])
-    {
-        if (n <= 0){return 0;} // Nothing to do
-        if (mPrecision == RTSeis::Precision::DOUBLE)
-        {
-            Ipp64f *x64 = ippsMalloc_64f(n);
-            Ipp64f *y64 = ippsMalloc_64f(n);
-            ippsConvert_32f64f(x, x64, n);
-            int ierr = apply(n, x64, y64);
-            ippsFree(x64);
-            if (ierr != 0)
+            if (maskSize_ > 1)
             {
-                std::cerr << "Failed to apply double filter in float"
-                          << std::endl;
-                ippsFree(y64);
-                return -1;
+                if constexpr (std::is_same<T, double>::value)
+                {
+                    ippsCopy_64f(dlydst64_, dlysrc64_, maskSize_-1);
+                }
+                else
+                {
+                    ippsCopy_32f(dlydst32_, dlysrc32_, maskSize_-1);
+                }
             }
-            ippsConvert_64f32f(y64, y, n);
-            ippsFree(y64);
-            return 0;
         }
-        IppStatus status;
-        if (mMode == RTSeis::ProcessingMode::REAL_TIME)
+        else
         {
-            status = ippsFilterMedian_32f(x, y, n, maskSize_,
-                                          dlysrc32_, dlydst32_, pBuf_);
-            if (status != ippStsNoErr)
+            if constexpr (std::is_same<T, double>::value)
             {
-                std::cerr << "Failed to apply real-time filter in float"
-                          << std::endl;
-                return -1;
+                status = ippsFilterMedian_64f(x, y, n, maskSize_,
+                                              dlysrc64_, nullptr, pBuf_);
             }
-            if (maskSize_ > 1)
+            else
             {
-                ippsCopy_32f(dlydst32_, dlysrc32_, maskSize_-1);
+                status = ippsFilterMedian_32f(x, y, n, maskSize_,
+                                              dlysrc32_, nullptr, pBuf_);
             }
-        }
-        else
-        {
-            status = ippsFilterMedian_32f(x, y, n, maskSize_,
-                                          dlysrc32_, nullptr, pBuf_);
             if (status != ippStsNoErr)
             {
-                std::cerr << "Failed to apply post-processing filter in float"
+                std::cerr << "Failed to apply post-processing filter"
                           << std::endl;
                 return -1;
             }
@@ -275,6 +424,8 @@ public:
         return 0;
     }
 //private:
+    /// The sliding median for long windows.
+    SlidingMedian<T> mSlidingMedian;
     /// Delay line source vector.  This has dimension [nwork_].
     Ipp64f *dlysrc64_ = nullptr;
     /// Delay line destination vector.  This has dimension [nwork_].
@@ -295,6 +446,9 @@ public:
     int nwork_ = 0;
     /// The size of the workspace buffer.
     int bufferSize_ = 0;
+    /// The implementation.  This is never AUTO after initialization.
+    MedianFilterImplementation implementation_
+        = MedianFilterImplementation::DIRECT;
     /// Real-time vs. post-processing.
     const RTSeis::ProcessingMode mMode = E;
     /// The default module implementation.
@@ -360,7 +514,8 @@ void MedianFilter<E, T>::clear() noexcept
 
 /// Initialization
 template<RTSeis::ProcessingMode E, class T>
-void MedianFilter<E, T>::initialize(const int n)
+void MedianFilter<E, T>::initialize(
+    const int n, const MedianFilterImplementation implementation)
 {
     clear();
     // Set the mask size
@@ -378,10 +533,10 @@ void MedianFilter<E, T>::initialize(const int n)
                   << maskSize << std::endl;
     }
 #ifndef NDEBUG
-    int ierr = pImpl->initialize(maskSize);
+    int ierr = pImpl->initialize(maskSize, implementation);
     assert(ierr == 0);
 #else
-    pImpl->initialize(maskSize);
+    pImpl->initialize(maskSize, implementation);
 #endif
 }
 
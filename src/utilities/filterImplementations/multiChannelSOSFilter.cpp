@@ -0,0 +1,407 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#ifndef NDEBUG
+#include <cassert>
+#endif
+#include <ipps.h>
+#include "rtseis/enums.hpp"
+#include "private/pad.hpp"
+#include "rtseis/utilities/filterImplementations/multiChannelSOSFilter.hpp"
+
+using namespace RTSeis::Utilities::FilterImplementations;
+
+namespace
+{
+/// The number of channels processed together.  The delay lines for a block
+/// of this many channels should comfortably fit in the L1 cache.
+constexpr int CHANNEL_BLOCK_SIZE = 64;
+
+/// @brief Applies the biquad cascade to a block of channels.
+/// @param[in] nSamples   The number of samples in each channel.
+/// @param[in] nChannels  The total number of channels.
+/// @param[in] c0         The first channel in this block.
+/// @param[in] nc         The number of channels in this block.  This cannot
+///                       exceed CHANNEL_BLOCK_SIZE.
+/// @param[in] ns         The number of sections.
+/// @param[in] coeffs     The normalized filter coefficients b0, b1, b2, a1, a2
+///                       for each section.  This has dimension [5 x ns].
+/// @param[in,out] dly    The structure-of-arrays delay lines.  This is a row
+///                       major matrix of dimension [2*ns x ldd].
+/// @param[in] ldd        The leading dimension of dly.
+/// @param[in] x          The channel-interleaved input signals.
+/// @param[out] y         The channel-interleaved output signals.
+template<class T>
+void sosCascade(const int nSamples, const int nChannels,
+                const int c0, const int nc, const int ns,
+                const T *__restrict__ coeffs,
+                T *__restrict__ dly, const int ldd,
+                const T *x, T *y)
+{
+    alignas(64) T work[CHANNEL_BLOCK_SIZE];
+    for (int i=0; i<nSamples; i++)
+    {
+        auto xi = x + static_cast<size_t> (i)*nChannels + c0;
+        auto yi = y + static_cast<size_t> (i)*nChannels + c0;
+        std::copy(xi, xi + nc, work);
+        for (int is=0; is<ns; is++)
+        {
+            const T b0 = coeffs[5*is+0];
+            const T b1 = coeffs[5*is+1];
+            const T b2 = coeffs[5*is+2];
+            const T a1 = coeffs[5*is+3];
+            const T a2 = coeffs[5*is+4];
+            T *__restrict__ z1 = dly + static_cast<size_t> (2*is)*ldd + c0;
+            T *__restrict__ z2 = dly + static_cast<size_t> (2*is+1)*ldd + c0;
+            // Transposed direct form II with one channel per lane
+            #pragma omp simd
+            for (int ic=0; ic<nc; ic++)
+            {
+                T xin = work[ic];
+                T yout = b0*xin + z1[ic];
+                z1[ic] = b1*xin - a1*yout + z2[ic];
+                z2[ic] = b2*xin - a2*yout;
+                work[ic] = yout;
+            }
+        }
+        std::copy(work, work + nc, yi);
+    }
+}
+
+template<class T> T *ippsMallocT(int n);
+template<> double *ippsMallocT(const int n){return ippsMalloc_64f(n);}
+template<> float  *ippsMallocT(const int n){return ippsMalloc_32f(n);}
+
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class MultiChannelSOSFilter<E, T>::MultiChannelSOSFilterImpl
+{
+public:
+    /// Default constructor
+    MultiChannelSOSFilterImpl() = default;
+    /// Copy constructor
+    MultiChannelSOSFilterImpl(const MultiChannelSOSFilterImpl &sos)
+    {
+        *this = sos;
+    }
+    /// (Deep) copy operator
+    MultiChannelSOSFilterImpl& operator=(const MultiChannelSOSFilterImpl &sos)
+    {
+        if (&sos == this){return *this;}
+        clear();
+        if (!sos.mInitialized){return *this;}
+        initialize(sos.mChannels, sos.mSections, sos.mBsRef, sos.mAsRef);
+        auto len = 2*mSections*mLeadingDimension;
+        std::copy(sos.mZi, sos.mZi + len, mZi);
+        std::copy(sos.mDelay, sos.mDelay + len, mDelay);
+        return *this;
+    }
+    /// Destructor
+    ~MultiChannelSOSFilterImpl()
+    {
+        clear();
+    }
+    /// Clears the memory off the module
+    void clear() noexcept
+    {
+        if (mCoeffs != nullptr){ippsFree(mCoeffs);}
+        if (mDelay != nullptr){ippsFree(mDelay);}
+        if (mZi != nullptr){ippsFree(mZi);}
+        if (mBsRef != nullptr){ippsFree(mBsRef);}
+        if (mAsRef != nullptr){ippsFree(mAsRef);}
+        mCoeffs = nullptr;
+        mDelay = nullptr;
+        mZi = nullptr;
+        mBsRef = nullptr;
+        mAsRef = nullptr;
+        mChannels = 0;
+        mSections = 0;
+        mLeadingDimension = 0;
+        mInitialized = false;
+    }
+    //========================================================================//
+    /// Initializes the filter
+    void initialize(const int nChannels, const int ns,
+                    const double bs[], const double as[])
+    {
+        clear();
+        mChannels = nChannels;
+        mSections = ns;
+        mLeadingDimension = padLength(mChannels, sizeof(T), 64);
+        mBsRef = ippsMalloc_64f(3*mSections);
+        ippsCopy_64f(bs, mBsRef, 3*mSections);
+        mAsRef = ippsMalloc_64f(3*mSections);
+        ippsCopy_64f(as, mAsRef, 3*mSections);
+        // Normalize the coefficients by a0 - note, the leading numerator
+        // and denominator coefficients were verified as non-zero
+        mCoeffs = ippsMallocT<T> (5*mSections);
+        for (int is=0; is<mSections; is++)
+        {
+            auto a0 = as[3*is];
+            mCoeffs[5*is+0] = static_cast<T> (bs[3*is+0]/a0);
+            mCoeffs[5*is+1] = static_cast<T> (bs[3*is+1]/a0);
+            mCoeffs[5*is+2] = static_cast<T> (bs[3*is+2]/a0);
+            mCoeffs[5*is+3] = static_cast<T> (as[3*is+1]/a0);
+            mCoeffs[5*is+4] = static_cast<T> (as[3*is+2]/a0);
+        }
+        // Set space for the delay lines and initial conditions
+        auto len = 2*mSections*mLeadingDimension;
+        mZi = ippsMalloc_64f(len);
+        ippsZero_64f(mZi, len);
+        mDelay = ippsMallocT<T> (len);
+        std::fill(mDelay, mDelay + len, 0);
+        mInitialized = true;
+    }
+    /// Determines the length of the initial conditions
+    [[nodiscard]] int getInitialConditionLength() const noexcept
+    {
+        return 2*mSections;
+    }
+    /// Sets the initial conditions for a channel
+    void setInitialConditions(const int channel, const int nz,
+                              const double zi[]) noexcept
+    {
+#ifndef NDEBUG
+        assert(nz == getInitialConditionLength());
+#endif
+        for (int iz=0; iz<nz; iz++)
+        {
+            auto indx = static_cast<size_t> (iz)*mLeadingDimension + channel;
+            mZi[indx] = zi[iz];
+            mDelay[indx] = static_cast<T> (zi[iz]);
+        }
+    }
+    /// Resets the initial conditions
+    void resetInitialConditions() noexcept
+    {
+        auto len = 2*mSections*mLeadingDimension;
+        std::copy(mZi, mZi + len, mDelay);
+    }
+    /// Applies the filter
+    void apply(const int nSamples, const T x[], T y[]) noexcept
+    {
+        if (nSamples <= 0){return;}
+        for (int c0=0; c0<mChannels; c0=c0+CHANNEL_BLOCK_SIZE)
+        {
+            auto nc = std::min(CHANNEL_BLOCK_SIZE, mChannels - c0);
+            sosCascade(nSamples, mChannels, c0, nc, mSections,
+                       mCoeffs, mDelay, mLeadingDimension, x, y);
+        }
+        // In post-processing the delay lines are restored so that every
+        // application starts from the initial conditions
+        if (mMode == RTSeis::ProcessingMode::POST){resetInitialConditions();}
+    }
+///private:
+    /// The normalized filter coefficients.  This has dimension [5 x ns].
+    T *mCoeffs = nullptr;
+    /// The structure-of-arrays delay lines.  This is a row major matrix
+    /// of dimension [2*mSections x mLeadingDimension].
+    T *mDelay = nullptr;
+    /// A copy of the initial conditions.  This has the same layout
+    /// as mDelay.
+    double *mZi = nullptr;
+    /// A copy of the numerator filter coefficients.  This has
+    /// dimension [3 x mSections].
+    double *mBsRef = nullptr;
+    /// A copy of the denominator filter coefficients.  This has
+    /// dimension [3 x mSections].
+    double *mAsRef = nullptr;
+    /// The number of channels.
+    int mChannels = 0;
+    /// The number of sections.
+    int mSections = 0;
+    /// The padded number of channels so that each delay line row
+    /// begins on a 64 byte boundary.
+    int mLeadingDimension = 0;
+    /// Real-time or post-processing.
+    const RTSeis::ProcessingMode mMode = E;
+    /// Flag indicating the module is intiialized
+    bool mInitialized = false;
+};
+
+//============================================================================//
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelSOSFilter<E, T>::MultiChannelSOSFilter() :
+    pImpl(std::make_unique<MultiChannelSOSFilterImpl>())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelSOSFilter<E, T>::MultiChannelSOSFilter(
+    const MultiChannelSOSFilter &sos)
+{
+    *this = sos;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelSOSFilter<E, T>::MultiChannelSOSFilter(
+    MultiChannelSOSFilter &&sos) noexcept
+{
+    *this = std::move(sos);
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelSOSFilter<E, T>::~MultiChannelSOSFilter() = default;
+
+/// Clear the class
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelSOSFilter<E, T>::clear() noexcept
+{
+    pImpl->clear();
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelSOSFilter<E, T>&
+MultiChannelSOSFilter<E, T>::operator=(const MultiChannelSOSFilter &sos)
+{
+    if (&sos == this){return *this;}
+    if (pImpl){pImpl->clear();}
+    pImpl = std::make_unique<MultiChannelSOSFilterImpl> (*sos.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+MultiChannelSOSFilter<E, T>&
+MultiChannelSOSFilter<E, T>::operator=(MultiChannelSOSFilter &&sos) noexcept
+{
+    if (&sos == this){return *this;}
+    pImpl = std::move(sos.pImpl);
+    return *this;
+}
+
+/// Initialization
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelSOSFilter<E, T>::initialize(const int nChannels,
+                                             const int ns,
+                                             const double bs[],
+                                             const double as[])
+{
+    clear();
+    // Checks
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = "
+                                  + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (ns < 1 || bs == nullptr || as == nullptr)
+    {
+        if (ns < 1){throw std::invalid_argument("No sections");}
+        if (bs == nullptr){throw std::invalid_argument("bs is NULL");}
+        throw std::invalid_argument("as is NULL");
+    }
+    // Verify the highest order coefficients make sense
+    for (auto i=0; i<ns; i++)
+    {
+        if (bs[3*i] == 0.0)
+        {
+            throw std::invalid_argument("Leading bs coefficient of section "
+                                      + std::to_string(i) + " is zero");
+        }
+        if (as[3*i] == 0.0)
+        {
+            throw std::invalid_argument("Leading as coefficient of section "
+                                      + std::to_string(i) + " is zero");
+        }
+    }
+    pImpl->initialize(nChannels, ns, bs, as);
+}
+
+/// Set initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelSOSFilter<E, T>::setInitialConditions(const int channel,
+                                                       const int nz,
+                                                       const double zi[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (channel < 0 || channel >= pImpl->mChannels)
+    {
+        throw std::invalid_argument("channel = " + std::to_string(channel)
+                                  + " must be in range [0,"
+                                  + std::to_string(pImpl->mChannels - 1)
+                                  + "]");
+    }
+    auto nzRef = pImpl->getInitialConditionLength();
+    if (nz != nzRef || zi == nullptr)
+    {
+        if (nz != nzRef)
+        {
+            auto errmsg = "nz = " + std::to_string(nz) + " must equal "
+                        + std::to_string(nzRef);
+            throw std::invalid_argument(errmsg);
+        }
+        throw std::invalid_argument("zi is NULL");
+    }
+    pImpl->setInitialConditions(channel, nz, zi);
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelSOSFilter<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Apply filter
+template<RTSeis::ProcessingMode E, class T>
+void MultiChannelSOSFilter<E, T>::apply(const int nSamples, const T x[],
+                                        T *yIn[])
+{
+    if (nSamples <= 0){return;}
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    auto y = *yIn;
+    if (x == nullptr || y == nullptr)
+    {
+        if (x == nullptr){throw std::invalid_argument("x is NULL");}
+        throw std::invalid_argument("y is NULL");
+    }
+    pImpl->apply(nSamples, x, y);
+}
+
+/// Get initial conditions
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelSOSFilter<E, T>::getInitialConditionLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->getInitialConditionLength();
+}
+
+/// Get number of sections
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelSOSFilter<E, T>::getNumberOfSections() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mSections;
+}
+
+/// Get number of channels
+template<RTSeis::ProcessingMode E, class T>
+int MultiChannelSOSFilter<E, T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool MultiChannelSOSFilter<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::FilterImplementations::MultiChannelSOSFilter<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Utilities::FilterImplementations::MultiChannelSOSFilter<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Utilities::FilterImplementations::MultiChannelSOSFilter<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Utilities::FilterImplementations::MultiChannelSOSFilter<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -0,0 +1,402 @@
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <ipps.h>
+#include "rtseis/enums.hpp"
+#include "rtseis/utilities/filterImplementations/resample.hpp"
+#include "rtseis/utilities/filterDesign/fir.hpp"
+#include "rtseis/utilities/filterRepresentations/fir.hpp"
+
+using namespace RTSeis::Utilities;
+using namespace RTSeis::Utilities::FilterImplementations;
+
+namespace
+{
+/// In real-time the input is filtered in blocks of at most this many
+/// samples so that the workspace can be sized at initialization.
+constexpr int BLOCK_SIZE = 4096;
+/// Computes y = dot(a, b).
+template<class T>
+T dotProduct(const int n, const T *a, const T *b)
+{
+    T result = 0;
+    if constexpr (std::is_same<T, double>::value)
+    {
+        ippsDotProd_64f(a, b, n, &result);
+    }
+    else
+    {
+        ippsDotProd_32f(a, b, n, &result);
+    }
+    return result;
+}
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class Resample<E, T>::ResampleImpl
+{
+public:
+    void initialize(const double ratio,
+                    const int filterLength,
+                    const int nPhases)
+    {
+        // The filter spans an even number of input samples so that its
+        // delay is an integer number of input samples
+        int nTaps = filterLength + filterLength%2;
+        auto bandwidth = std::min(1.0, ratio);
+        // The Blackman window's transition band is about 11/N wide where 1
+        // is the Nyquist frequency.  Put the stopband edge at the Nyquist
+        // frequency of the lower of the two sampling rates.
+        auto cutoff = bandwidth*(1.0 - 5.5/static_cast<double> (nTaps));
+        if (ratio < 1)
+        {
+            nTaps = static_cast<int> (std::ceil(nTaps/ratio));
+            nTaps = nTaps + nTaps%2;
+        }
+        // Design the prototype at the oversampled rate
+        auto order = nTaps*nPhases;
+        auto r = cutoff/static_cast<double> (nPhases);
+        auto fir = FilterDesign::FIR::FIR1Lowpass(order, r,
+                                         FilterDesign::FIRWindow::BLACKMAN_OPT);
+        auto h = fir.getFilterTaps();
+        // Unpack into the (reversed) phases.  The phases are ordered so that
+        // each output is a dot product with the signal.  The last phase is
+        // the first phase advanced by one input sample and allows the
+        // interpolation to bracket fractional positions close to 1.
+        mFilterBank.resize(static_cast<size_t> (nPhases + 1)*nTaps);
+        for (int ip = 0; ip <= nPhases; ++ip)
+        {
+            auto phase = mFilterBank.data() + static_cast<size_t> (ip)*nTaps;
+            for (int i = 0; i < nTaps; ++i)
+            {
+                // The prototype has unit gain at the oversampled rate
+                phase[i] = static_cast<T> (nPhases*h[(nTaps - 1 - i)*nPhases
+                                                    + ip]);
+            }
+        }
+        mTaps = nTaps;
+        mPhases = nPhases;
+        mDelay = nTaps/2;
+        mShift = 0;
+        if (mMode == RTSeis::ProcessingMode::POST){mShift = mDelay;}
+        mZi.assign(mTaps - 1, 0);
+        if (mMode == RTSeis::ProcessingMode::POST)
+        {
+            mSignal.assign(mTaps - 1, 0);
+        }
+        else
+        {
+            mSignal.assign(mTaps - 1 + BLOCK_SIZE, 0);
+        }
+        mRatio = ratio;
+        mStep = 1.0/ratio;
+        mTime = 0;
+        mInitialized = true;
+    }
+    void setInitialConditions(const double zi[])
+    {
+        std::copy(zi, zi + mZi.size(), mZi.begin());
+        resetInitialConditions();
+    }
+    void resetInitialConditions()
+    {
+        std::copy(mZi.begin(), mZi.end(), mSignal.begin());
+        mTime = 0;
+    }
+    /// Counts the output samples, k, for which mTime + k*mStep < n.  The
+    /// positions are computed exactly as in apply so the counts agree.
+    [[nodiscard]] int estimateSpace(const int n) const
+    {
+        double time = mTime;
+        if (mMode == RTSeis::ProcessingMode::POST){time = 0;}
+        if (!(time < n)){return 0;}
+        auto ny = static_cast<int> (std::ceil((n - time)/mStep));
+        while (ny > 0 && !(time + (ny - 1)*mStep < n)){ny = ny - 1;}
+        while (time + ny*mStep < n){ny = ny + 1;}
+        return ny;
+    }
+    int apply(const int nx, const T x[], T y[])
+    {
+        if (mMode == RTSeis::ProcessingMode::POST){resetInitialConditions();}
+        // Post-processing pads the end of the signal with zeros to remove
+        // the filter delay so the whole signal is filtered at once.  In
+        // real-time the blocks fit in the workspace from initialization.
+        auto blockSize = (mShift > 0) ? nx : BLOCK_SIZE;
+        auto nWork = static_cast<size_t> (mTaps - 1 + blockSize + mShift);
+        if (mSignal.size() < nWork){mSignal.resize(nWork);}
+        // The output positions are relative to the start of the packet
+        int ny = 0;
+        for (int i0 = 0; i0 < nx; i0 = i0 + blockSize)
+        {
+            auto nb = std::min(blockSize, nx - i0);
+            // The signal is the delay line followed by the block followed
+            // by zeros
+            std::copy(x + i0, x + i0 + nb, mSignal.data() + mTaps - 1);
+            std::fill(mSignal.begin() + mTaps - 1 + nb,
+                      mSignal.begin() + mTaps - 1 + nb + mShift, 0);
+            while (true)
+            {
+                auto time = mTime + ny*mStep;
+                if (!(time < i0 + nb)){break;}
+                auto t = time - i0;
+                auto n = std::min(static_cast<int> (t), nb - 1);
+                auto p = (t - n)*mPhases;
+                auto ip = std::min(static_cast<int> (p), mPhases - 1);
+                auto alpha = static_cast<T> (p - ip);
+                auto signal = mSignal.data() + n + mShift;
+                auto phase = mFilterBank.data()
+                           + static_cast<size_t> (ip)*mTaps;
+                auto y0 = dotProduct(mTaps, phase, signal);
+                auto y1 = dotProduct(mTaps, phase + mTaps, signal);
+                y[ny] = y0 + alpha*(y1 - y0);
+                ny = ny + 1;
+            }
+            // Save the delay line
+            std::copy(mSignal.begin() + nb, mSignal.begin() + nb + mTaps - 1,
+                      mSignal.begin());
+        }
+        // Save the position of the next output sample
+        mTime = mTime + ny*mStep - nx;
+        return ny;
+    }
+    /// The reversed phases of the filter bank.  This has dimension
+    /// [mPhases + 1 x mTaps].
+    std::vector<T> mFilterBank;
+    /// The delay line followed by the current signal.
+    std::vector<T> mSignal;
+    /// The initial conditions.
+    std::vector<double> mZi;
+    /// The resampling ratio.
+    double mRatio = 1;
+    /// The number of input samples between output samples.
+    double mStep = 1;
+    /// The position of the next output sample relative to the start of
+    /// the next packet in input samples.
+    double mTime = 0;
+    /// The number of taps in each phase.
+    int mTaps = 0;
+    /// The number of phases.
+    int mPhases = 0;
+    /// The filter delay in input samples.
+    int mDelay = 0;
+    /// The filter delay removed from the output.
+    int mShift = 0;
+    const RTSeis::ProcessingMode mMode = E;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+Resample<E, T>::Resample() :
+    pImpl(std::make_unique<ResampleImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+Resample<E, T>::Resample(const Resample &resample)
+{
+    *this = resample;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+Resample<E, T>::Resample(Resample &&resample) noexcept
+{
+    *this = std::move(resample);
+}
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+Resample<E, T>& Resample<E, T>::operator=(const Resample &resample)
+{
+    if (&resample == this){return *this;}
+    if (pImpl){pImpl.reset();}
+    pImpl = std::make_unique<ResampleImpl> (*resample.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+Resample<E, T>& Resample<E, T>::operator=(Resample &&resample) noexcept
+{
+    if (&resample == this){return *this;}
+    pImpl = std::move(resample.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+Resample<E, T>::~Resample() = default;
+
+/// Clears the class
+template<RTSeis::ProcessingMode E, class T>
+void Resample<E, T>::clear() noexcept
+{
+    pImpl->mFilterBank.clear();
+    pImpl->mSignal.clear();
+    pImpl->mZi.clear();
+    pImpl->mRatio = 1;
+    pImpl->mStep = 1;
+    pImpl->mTime = 0;
+    pImpl->mTaps = 0;
+    pImpl->mPhases = 0;
+    pImpl->mDelay = 0;
+    pImpl->mShift = 0;
+    pImpl->mInitialized = false;
+}
+
+/// Initialization
+template<RTSeis::ProcessingMode E, class T>
+void Resample<E, T>::initialize(const double ratio,
+                                const int filterLength,
+                                const int nPhases)
+{
+    clear();
+    if (!(ratio > 0) || !std::isfinite(ratio))
+    {
+        throw std::invalid_argument("ratio = " + std::to_string(ratio)
+                                  + " must be positive");
+    }
+    if (filterLength < 8)
+    {
+        throw std::invalid_argument("filterLength = "
+                                  + std::to_string(filterLength)
+                                  + " must be at least 8");
+    }
+    if (nPhases < 2)
+    {
+        throw std::invalid_argument("nPhases = " + std::to_string(nPhases)
+                                  + " must be at least 2");
+    }
+    pImpl->initialize(ratio, filterLength, nPhases);
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool Resample<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Set the ratio
+template<RTSeis::ProcessingMode E, class T>
+void Resample<E, T>::setRatio(const double ratio)
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (!(ratio > 0) || !std::isfinite(ratio))
+    {
+        throw std::invalid_argument("ratio = " + std::to_string(ratio)
+                                  + " must be positive");
+    }
+    pImpl->mRatio = ratio;
+    pImpl->mStep = 1.0/ratio;
+}
+
+/// Get the ratio
+template<RTSeis::ProcessingMode E, class T>
+double Resample<E, T>::getRatio() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mRatio;
+}
+
+/// Initial condition length
+template<RTSeis::ProcessingMode E, class T>
+int Resample<E, T>::getInitialConditionLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mTaps - 1;
+}
+
+/// Set initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void Resample<E, T>::setInitialConditions(const int nz, const double zi[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    auto nzRef = getInitialConditionLength();
+    if (nz != nzRef)
+    {
+        throw std::invalid_argument("nz = " + std::to_string(nz)
+                                  + " must equal " + std::to_string(nzRef));
+    }
+    if (nz > 0 && zi == nullptr){throw std::invalid_argument("zi is NULL");}
+    pImpl->setInitialConditions(zi);
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void Resample<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Estimate space
+template<RTSeis::ProcessingMode E, class T>
+int Resample<E, T>::estimateSpace(const int n) const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (n < 0)
+    {
+        throw std::invalid_argument("n = " + std::to_string(n)
+                                  + " cannot be negative");
+    }
+    return pImpl->estimateSpace(n);
+}
+
+/// Apply
+template<RTSeis::ProcessingMode E, class T>
+void Resample<E, T>::apply(const int nx, const T x[],
+                           const int ny, int *nyOut, T *yIn[])
+{
+    *nyOut = 0;
+    if (nx <= 0){return;}
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (x == nullptr){throw std::invalid_argument("x is NULL");}
+    int nyRef = estimateSpace(nx);
+    if (ny < nyRef)
+    {
+        throw std::invalid_argument("ny = " + std::to_string(ny)
+                                  + " must be at least "
+                                  + std::to_string(nyRef));
+    }
+    auto y = *yIn;
+    if (nyRef > 0 && y == nullptr){throw std::invalid_argument("y is NULL");}
+    *nyOut = pImpl->apply(nx, x, y);
+}
+
+/// Group delay
+template<RTSeis::ProcessingMode E, class T>
+double Resample<E, T>::getGroupDelay() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return static_cast<double> (pImpl->mDelay);
+}
+
+/// Number of phases
+template<RTSeis::ProcessingMode E, class T>
+int Resample<E, T>::getNumberOfPhases() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mPhases;
+}
+
+/// Filter length
+template<RTSeis::ProcessingMode E, class T>
+int Resample<E, T>::getFilterLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mTaps;
+}
+
+///--------------------------------------------------------------------------///
+///                         Template instantiation                           ///
+///--------------------------------------------------------------------------///
+template class RTSeis::Utilities::FilterImplementations::Resample<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Utilities::FilterImplementations::Resample<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Utilities::FilterImplementations::Resample<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Utilities::FilterImplementations::Resample<RTSeis::ProcessingMode::REAL_TIME, float>;
@@ -2,11 +2,16 @@
 #include <cstdio>
 #include <cmath>
 #include <string>
+#include <vector>
+#include <type_traits>
 #ifndef NDEBUG
 #include <cassert>
 #endif
 #include <ipps.h>
 #include "rtseis/enums.hpp"
+#include "private/blockParallelFilter.hpp"
+#include "private/iirEngine.hpp"
+#include "private/filterWorkspace.hpp"
 #include "rtseis/utilities/filterImplementations/sosFilter.hpp"
 
 using namespace RTSeis::Utilities::FilterImplementations;
@@ -15,6 +20,40 @@ template<RTSeis::ProcessingMode E, class T>
 class SOSFilter<E, T>::SOSFilterImpl
 {
 public:
+    /// Holds the immutable filter design, i.e., the filter coefficients.
+    /// This is created once in initialize and is shared by all copies of
+    /// the filter.
+    class SOSPlan
+    {
+    public:
+        /// Default constructor
+        SOSPlan() = default;
+        /// The plan cannot be copied.  Share it instead.
+        SOSPlan(const SOSPlan &plan) = delete;
+        SOSPlan& operator=(const SOSPlan &plan) = delete;
+        /// Destructor
+        ~SOSPlan()
+        {
+            Workspace::release(pTaps64f_);
+            Workspace::release(pTaps32f_);
+            Workspace::release(bsRef_);
+            Workspace::release(asRef_);
+        }
+        /// Filter taps.  This has dimension [tapsLen_].
+        Ipp64f *pTaps64f_ = nullptr;
+        /// Filter taps.  This has dimension [tapsLen_].
+        Ipp32f *pTaps32f_ = nullptr;
+        /// A copy of the numerator filter coefficients.  This has
+        /// dimension [3 x nsections_].
+        double *bsRef_ = nullptr;
+        /// A copy of the denominator filter coefficients.  This has
+        /// dimension [3 x nsections_].
+        double *asRef_ = nullptr;
+        /// The number of sections.
+        int nsections_ = 0;
+        /// The number of filter taps.  This equals 6*nsections_.
+        int tapsLen_ = 0;
+    };
     /// Default constructor
     SOSFilterImpl() = default;
 
@@ -23,21 +62,24 @@ public:
     {
         *this = sos;
     }
-    /// (Deep) copy operator
+    /// Copy operator.  The filter design is shared with sos and only the
+    /// delay lines and initial conditions are copied.
     SOSFilterImpl& operator=(const SOSFilterImpl &sos)
     {
         if (&sos == this){return *this;}
+        clear();
+        mThreads = sos.mThreads;
         if (!sos.mInitialized){return *this;}
-        // Reinitialize the filter
-        initialize(sos.nsections_, sos.bsRef_, sos.asRef_);
-        // Now copy the filter states
-        if (bufferSize_ > 0)
+        if (allocateState(sos.plan_) != 0)
         {
-            ippsCopy_8u(sos.pBuf_, pBuf_, bufferSize_);
+            std::cerr << "Failed to initialize state in copy" << std::endl;
+            clear();
+            return *this;
         }
         // Copy the initial conditions
         if (nsections_ > 0){ippsCopy_64f(sos.zi_, zi_, 2*nsections_);}
-        // And the delay lines
+        // And the delay lines.  The IPP state is loaded from the source
+        // delay line prior to every filter application.
         if (nwork_ > 0)
         {
             if (mPrecision == RTSeis::Precision::DOUBLE)
@@ -51,6 +93,7 @@ public:
                 ippsCopy_32f(sos.dlyDst32f_, dlyDst32f_, nwork_);
             }
         }
+        mInitialized = true;
         return *this;
     }
     /// Default constructor
@@ -61,30 +104,24 @@ public:
     /// Clears the memory off the module
     void clear()
     {
-        if (pTaps64f_ != nullptr){ippsFree(pTaps64f_);}
-        if (dlySrc64f_ != nullptr){ippsFree(dlySrc64f_);}
-        if (dlyDst64f_ != nullptr){ippsFree(dlyDst64f_);}
-        if (pTaps32f_ != nullptr){ippsFree(pTaps32f_);}
-        if (dlySrc32f_ != nullptr){ippsFree(dlySrc32f_);}
-        if (dlyDst32f_ != nullptr){ippsFree(dlyDst64f_);}
-        if (pBuf_ != nullptr){ippsFree(pBuf_);}
-        if (bsRef_ != nullptr){ippsFree(bsRef_);}
-        if (asRef_ != nullptr){ippsFree(asRef_);} 
-        if (zi_ != nullptr){ippsFree(zi_);}
+        Workspace::release(dlySrc64f_);
+        Workspace::release(dlyDst64f_);
+        Workspace::release(dlySrc32f_);
+        Workspace::release(dlyDst32f_);
+        Workspace::release(pBuf_);
+        Workspace::release(zi_);
+        mEngines.clear();
+        mBlockWorkspace.clear();
+        plan_ = nullptr;
         pState64f_ = nullptr;
-        pTaps64f_ = nullptr;
         dlySrc64f_ = nullptr;
         dlyDst64f_ = nullptr;
         pState32f_ = nullptr;
-        pTaps32f_ = nullptr;
         dlySrc32f_ = nullptr;
         dlyDst32f_ = nullptr; 
         pBuf_ = nullptr;
-        bsRef_ = nullptr;
-        asRef_ = nullptr;
         zi_ = nullptr;
         nsections_ = 0;
-        tapsLen_ = 0;
         nwork_ = 0;
         bufferSize_ = 0;
         mInitialized = false;
@@ -95,15 +132,56 @@ public:
                    const double as[])
     {
         clear();
+        auto plan = std::make_shared<SOSPlan> ();
         // Figure out sizes and copy the inputs
-        nsections_ = ns;
-        tapsLen_ = 6*nsections_;
-        nwork_ = std::max(128, 2*nsections_);
-        bsRef_ = ippsMalloc_64f(3*nsections_);
-        ippsCopy_64f(bs, bsRef_, 3*nsections_);
-        asRef_ = ippsMalloc_64f(3*nsections_);
-        ippsCopy_64f(as, asRef_, 3*nsections_);
-        zi_ = ippsMalloc_64f(2*nsections_);
+        plan->nsections_ = ns;
+        plan->tapsLen_ = 6*ns;
+        plan->bsRef_ = Workspace::allocate64f(3*ns);
+        ippsCopy_64f(bs, plan->bsRef_, 3*ns);
+        plan->asRef_ = Workspace::allocate64f(3*ns);
+        ippsCopy_64f(as, plan->asRef_, 3*ns);
+        if (mPrecision == RTSeis::Precision::DOUBLE)
+        {
+            plan->pTaps64f_ = Workspace::allocate64f(plan->tapsLen_);
+            for (int i=0; i<ns; i++)
+            {
+                plan->pTaps64f_[6*i+0] = bs[3*i+0];
+                plan->pTaps64f_[6*i+1] = bs[3*i+1];
+                plan->pTaps64f_[6*i+2] = bs[3*i+2];
+                plan->pTaps64f_[6*i+3] = as[3*i+0];
+                plan->pTaps64f_[6*i+4] = as[3*i+1];
+                plan->pTaps64f_[6*i+5] = as[3*i+2];
+            }
+        }
+        else
+        {
+            plan->pTaps32f_ = Workspace::allocate32f(plan->tapsLen_);
+            for (int i=0; i<ns; i++)
+            {
+                plan->pTaps32f_[6*i+0] = static_cast<float> (bs[3*i+0]);
+                plan->pTaps32f_[6*i+1] = static_cast<float> (bs[3*i+1]);
+                plan->pTaps32f_[6*i+2] = static_cast<float> (bs[3*i+2]);
+                plan->pTaps32f_[6*i+3] = static_cast<float> (as[3*i+0]);
+                plan->pTaps32f_[6*i+4] = static_cast<float> (as[3*i+1]);
+                plan->pTaps32f_[6*i+5] = static_cast<float> (as[3*i+2]);
+            }
+        }
+        if (allocateState(plan) != 0)
+        {
+            clear();
+            return -1;
+        }
+        mInitialized = true;
+        return 0;
+    }
+    /// Attaches the filter design and creates the per-channel IPP state and
+    /// delay lines.  The memory scales with the number of sections.
+    int allocateState(std::shared_ptr<const SOSPlan> plan)
+    {
+        plan_ = std::move(plan);
+        nsections_ = plan_->nsections_;
+        nwork_ = 2*nsections_;
+        zi_ = Workspace::allocate64f(2*nsections_);
         ippsZero_64f(zi_, 2*nsections_);
         IppStatus status;
         if (mPrecision == RTSeis::Precision::DOUBLE)
@@ -113,31 +191,19 @@ public:
             if (status != ippStsNoErr)
             {
                 std::cerr << "Failed to get state size" << std::endl;
-                clear();
                 return -1;
             }
-            pBuf_ = ippsMalloc_8u(bufferSize_);
-            pTaps64f_ = ippsMalloc_64f(tapsLen_);
-            for (int i=0; i<nsections_; i++)
-            {
-                pTaps64f_[6*i+0] = bs[3*i+0];
-                pTaps64f_[6*i+1] = bs[3*i+1];
-                pTaps64f_[6*i+2] = bs[3*i+2];
-                pTaps64f_[6*i+3] = as[3*i+0];
-                pTaps64f_[6*i+4] = as[3*i+1];
-                pTaps64f_[6*i+5] = as[3*i+2];
-            }
-            dlySrc64f_ = ippsMalloc_64f(nwork_);
+            pBuf_ = Workspace::allocate8u(bufferSize_);
+            dlySrc64f_ = Workspace::allocate64f(nwork_);
             ippsZero_64f(dlySrc64f_, nwork_);
-            dlyDst64f_ = ippsMalloc_64f(nwork_);
+            dlyDst64f_ = Workspace::allocate64f(nwork_);
             ippsZero_64f(dlyDst64f_, nwork_);
-            status = ippsIIRInit_BiQuad_64f(&pState64f_, pTaps64f_,
+            status = ippsIIRInit_BiQuad_64f(&pState64f_, plan_->pTaps64f_,
                                             nsections_,
                                             dlySrc64f_, pBuf_);
             if (status != ippStsNoErr)
             {
                 std::cerr << "Failed to initialize biquad filter" << std::endl;
-                clear();
                 return -1;
             }
         }
@@ -148,37 +214,73 @@ public:
             if (status != ippStsNoErr)
             {
                 std::cerr << "Failed to get state size" << std::endl;
-                clear();
                 return -1; 
             }
-            pBuf_ = ippsMalloc_8u(bufferSize_);
-            pTaps32f_ = ippsMalloc_32f(tapsLen_);
-            for (int i=0; i<nsections_; i++)
-            {
-                pTaps32f_[6*i+0] = static_cast<float> (bs[3*i+0]);
-                pTaps32f_[6*i+1] = static_cast<float> (bs[3*i+1]);
-                pTaps32f_[6*i+2] = static_cast<float> (bs[3*i+2]);
-                pTaps32f_[6*i+3] = static_cast<float> (as[3*i+0]);
-                pTaps32f_[6*i+4] = static_cast<float> (as[3*i+1]);
-                pTaps32f_[6*i+5] = static_cast<float> (as[3*i+2]);
-            }
-            dlySrc32f_ = ippsMalloc_32f(nwork_);
+            pBuf_ = Workspace::allocate8u(bufferSize_);
+            dlySrc32f_ = Workspace::allocate32f(nwork_);
             ippsZero_32f(dlySrc32f_, nwork_);
-            dlyDst32f_ = ippsMalloc_32f(nwork_);
+            dlyDst32f_ = Workspace::allocate32f(nwork_);
             ippsZero_32f(dlyDst32f_, nwork_);
-            status = ippsIIRInit_BiQuad_32f(&pState32f_, pTaps32f_,
+            status = ippsIIRInit_BiQuad_32f(&pState32f_, plan_->pTaps32f_,
                                             nsections_,
                                             dlySrc32f_, pBuf_);
             if (status != ippStsNoErr)
             {
                 std::cerr << "Failed to initialized biquad filter" << std::endl;
-                clear();
                 return -1;
             }
         }
-        mInitialized = true;
+        return createBlockEngines();
+    }
+    /// Creates a filter engine per thread and the scratch space for the
+    /// block-parallel application.  This is a no-op when the filter will
+    /// be applied sequentially.
+    int createBlockEngines()
+    {
+        mEngines.clear();
+        mBlockWorkspace.clear();
+        if (mMode != RTSeis::ProcessingMode::POST || mThreads < 2 ||
+            nsections_ < 1)
+        {
+            return 0;
+        }
+        const T *taps = nullptr;
+        if constexpr (std::is_same<T, double>::value)
+        {
+            taps = plan_->pTaps64f_;
+        }
+        else
+        {
+            taps = plan_->pTaps32f_;
+        }
+        mEngines = std::vector<IIREngine<T>> (mThreads);
+        for (auto &engine : mEngines)
+        {
+            if (engine.initializeBiQuad(taps, nsections_) != 0)
+            {
+                std::cerr << "Failed to initialize block filter" << std::endl;
+                mEngines.clear();
+                return -1;
+            }
+        }
+        mBlockWorkspace.allocate(mThreads, nwork_);
         return 0;
     }
+    /// Sets the number of threads used in post-processing.
+    void setNumberOfThreads(const int nThreads)
+    {
+        mThreads = nThreads;
+        if (mInitialized){createBlockEngines();}
+    }
+    /// Determines the number of blocks for the block-parallel filter.  If
+    /// this is 1 then the filter is applied sequentially.
+    [[nodiscard]] int computeNumberOfParallelBlocks(const int n) const
+    {
+        // The engines only exist when the block-parallel filter applies
+        auto nEngines = static_cast<int> (mEngines.size());
+        if (nEngines < 2){return 1;}
+        return computeNumberOfFilterBlocks(n, nEngines);
+    }
     /// Determines the length of the initial conditions
     [[nodiscard]] int getInitialConditionLength() const
     {
@@ -220,139 +322,127 @@ public:
             ippsConvert_64f32f(zi_, dlySrc32f_, 2*nsections_);
         }
     }
-    /// Applies the filter
-    [[nodiscard]] int apply(const int n, const double x[], double y[])
+    /// Applies the filter.  The precision is fixed by T so there is never
+    /// a conversion and, consequently, never an allocation on this path.
+    [[nodiscard]] int apply(const int n, const T x[], T y[])
     {
         if (n <= 0){return 0;}
-        if (mPrecision == RTSeis::Precision::FLOAT)
+        auto nBlocks = computeNumberOfParallelBlocks(n);
+        if (nBlocks > 1){return applyParallel(n, x, y, nBlocks);}
+        if constexpr (std::is_same<T, double>::value)
         {
-            Ipp32f *x32 = ippsMalloc_32f(n);
-            Ipp32f *y32 = ippsMalloc_32f(n);
-            ippsConvert_64f32f(x, x32, n);
-            int ierr = apply(n, x32, y32);
-            ippsFree(x32);
-            if (ierr != 0)
+            // Set the initial conditions then apply the filters
+            IppStatus status = ippsIIRSetDlyLine_64f(pState64f_, dlySrc64f_);
+            if (status != ippStsNoErr)
             {
-                std::cerr << "Failed to apply float filter in double"
-                          << std::endl;
-                ippsFree(y32);
+                std::cerr << "Failed to set delay line in double" << std::endl;
                 return -1;
             }
-            ippsConvert_32f64f(y32, y, n); 
-            ippsFree(y32);
-            return 0;
-        }
-        // Get a pointer to the filter state and set the initial conditions
-        IppStatus status = ippsIIRSetDlyLine_64f(pState64f_, dlySrc64f_);
-        if (status != ippStsNoErr)
-        {
-            std::cerr << "Failed to set delay line in double" << std::endl;
-            return -1;
-        }
-        // Apply the filters
-        status = ippsIIR_64f(x, y, n, pState64f_);
-        if (status != ippStsNoErr)
-        {
-            std::cerr << "Failed to apply filter in double" << std::endl;
-            return -1;
+            status = ippsIIR_64f(x, y, n, pState64f_);
+            if (status != ippStsNoErr)
+            {
+                std::cerr << "Failed to apply filter in double" << std::endl;
+                return -1;
+            }
+            if (mMode == RTSeis::ProcessingMode::REAL_TIME)
+            {
+                status = ippsIIRGetDlyLine_64f(pState64f_, dlyDst64f_);
+                if (status != ippStsNoErr)
+                {
+                    std::cerr << "Failed to apply real-time filter in double"
+                              << std::endl;
+                    return -1;
+                }
+                ippsCopy_64f(dlyDst64f_, dlySrc64f_, 2*nsections_);
+            }
         }
-        if (mMode == RTSeis::ProcessingMode::REAL_TIME)
+        else
         {
-            status = ippsIIRGetDlyLine_64f(pState64f_, dlyDst64f_);
+            // Set the initial conditions then apply the filters
+            IppStatus status = ippsIIRSetDlyLine_32f(pState32f_, dlySrc32f_);
+            if (status != ippStsNoErr)
+            {
+                std::cerr << "Failed to set delay line in float" << std::endl;
+                return -1;
+            }
+            status = ippsIIR_32f(x, y, n, pState32f_);
             if (status != ippStsNoErr)
             {
-                std::cerr << "Failed to apply real-time filter in double"
-                          << std::endl;
+                std::cerr << "Failed to apply filter in float" << std::endl;
                 return -1;
             }
-            ippsCopy_64f(dlyDst64f_, dlySrc64f_, 2*nsections_);
+            if (mMode == RTSeis::ProcessingMode::REAL_TIME)
+            {
+                status = ippsIIRGetDlyLine_32f(pState32f_, dlyDst32f_);
+                if (status != ippStsNoErr)
+                {
+                    std::cerr << "Failed to get delay line" << std::endl;
+                    return -1;
+                }
+                ippsCopy_32f(dlyDst32f_, dlySrc32f_, 2*nsections_);
+            }
         }
         return 0;
     }
-    /// Applies the filter
-    [[nodiscard]] int apply(const int n, const float x[], float y[])
+    /// Applies the filter to blocks of the signal concurrently.
+    [[nodiscard]] int applyParallel(const int n, const T x[], T y[],
+                                    const int nBlocks)
     {
-        if (n <= 0){return 0;} 
-        if (mPrecision == RTSeis::Precision::DOUBLE)
+        const T *zi = nullptr;
+        T *zf = nullptr;
+        if constexpr (std::is_same<T, double>::value)
         {
-            Ipp64f *x64 = ippsMalloc_64f(n);
-            Ipp64f *y64 = ippsMalloc_64f(n);
-            ippsConvert_32f64f(x, x64, n);
-            int ierr = apply(n, x64, y64);
-            ippsFree(x64);
-            if (ierr != 0)
-            {
-                std::cerr << "Failed to apply double filter in float"
-                          << std::endl;
-                ippsFree(y64);
-                return -1; 
-            }
-            ippsConvert_64f32f(y64, y, n); 
-            ippsFree(y64);
-            return 0;
-        }
-        // Get a pointer to the filter state and set the initial conditions
-        IppStatus status = ippsIIRSetDlyLine_32f(pState32f_, dlySrc32f_);
-        if (status != ippStsNoErr)
-        {
-            std::cerr << "Failed to set delay line in float" << std::endl;
-            return -1;
-        }
-        // Apply the filters
-        status = ippsIIR_32f(x, y, n, pState32f_);
-        if (status != ippStsNoErr)
-        {
-            std::cerr << "Failed to apply filter in float" << std::endl;
-            return -1;
+            zi = dlySrc64f_;
+            zf = dlyDst64f_;
         }
-        if (mMode == RTSeis::ProcessingMode::REAL_TIME)
+        else
         {
-            status = ippsIIRGetDlyLine_32f(pState32f_, dlyDst32f_);
-            if (status != ippStsNoErr)
-            {
-                std::cerr << "Failed to get delay line" << std::endl;
-                return -1;
-            }
-            ippsCopy_32f(dlyDst32f_, dlySrc32f_, 2*nsections_);
+            zi = dlySrc32f_;
+            zf = dlyDst32f_;
         }
+        blockParallelFilter(n, x, y, nwork_, zi, zf, nBlocks, mBlockWorkspace,
+                            [this](const int block, const int nb,
+                                   const T *xb, T *yb,
+                                   const T *dlyIn, T *dlyOut)
+                            {
+                                mEngines[block].apply(nb, xb, yb,
+                                                      dlyIn, dlyOut);
+                            });
         return 0;
     }
 ///private:
+    /// Filter engines for the block-parallel application.  There is one
+    /// per thread.
+    std::vector<IIREngine<T>> mEngines;
+    /// Scratch space for the block-parallel application.
+    BlockParallelWorkspace<T> mBlockWorkspace;
+    /// The shared filter design.
+    std::shared_ptr<const SOSPlan> plan_ = nullptr;
+    /// Handle on filter state.
     IppsIIRState_64f *pState64f_ = nullptr;
-    /// Filter taps.  This has dimension [tapsLen_].
-    Ipp64f *pTaps64f_ = nullptr;
     /// Initial conditions. This has dimension [nwork_].
     Ipp64f *dlySrc64f_ = nullptr;
     /// Final conditions.  This has dimension [nwork_].
     Ipp64f *dlyDst64f_ = nullptr;
-    /// Final conditions.  This has dimension [nwork_].
     /// Handle on filter state. 
     IppsIIRState_32f *pState32f_ = nullptr;
-    /// Filter taps.  This has dimension [tapsLen_].
-    Ipp32f *pTaps32f_ = nullptr;
     /// Initial conditions. This has dimension [nwork_].
     Ipp32f *dlySrc32f_ = nullptr;
     /// Final conditions.  This has dimension [nwork_].
     Ipp32f *dlyDst32f_ = nullptr;
-    /// The workspace buffer.
+    /// The workspace buffer which holds the IPP state.
     Ipp8u *pBuf_ = nullptr;
-    /// A copy of the numerator filter coefficients.  This has
-    /// dimension [3 x nsections_].
-    double *bsRef_ = nullptr;
-    /// A copy of the denominator filter coefficients.  This has
-    /// dimension [3 x nsections_].
-    double *asRef_ = nullptr; 
     /// A copy of the initial conditions.  This has dimension
     /// [2 x nsections_].
     double *zi_ = nullptr;
     /// The number of sections.
     int nsections_ = 0;
-    /// The number of filter taps.  This equals 6*nsections_.
-    int tapsLen_ = 0;
-    /// Workspace for the delay lines.
+    /// Workspace for the delay lines.  This equals 2*nsections_.
     int nwork_ = 0;
     /// Size of workspace buffer.
     int bufferSize_ = 0;
+    /// The number of threads used in post-processing.
+    int mThreads = 1;
     /// Real-time or post-processing.
     const RTSeis::ProcessingMode mMode = E;
     /// Single or double precision.
@@ -591,6 +681,25 @@ int SOSFilter<E, T>::getNumberOfSections() const
     return pImpl->getNumberOfSections();
 }
 
+/// Set number of threads
+template<RTSeis::ProcessingMode E, class T>
+void SOSFilter<E, T>::setNumberOfThreads(const int nThreads)
+{
+    if (nThreads < 1)
+    {
+        throw std::invalid_argument("nThreads = " + std::to_string(nThreads)
+                                  + " must be positive");
+    }
+    pImpl->setNumberOfThreads(nThreads);
+}
+
+/// Get number of threads
+template<RTSeis::ProcessingMode E, class T>
+int SOSFilter<E, T>::getNumberOfThreads() const noexcept
+{
+    return pImpl->mThreads;
+}
+
 /// Initialized?
 template<RTSeis::ProcessingMode E, class T>
 bool SOSFilter<E, T>::isInitialized() const noexcept
@@ -12,9 +12,11 @@
 #include "rtseis/utilities/interpolation/interpolate.hpp"
 #include "rtseis/utilities/math/vectorMath.hpp"
 #include "rtseis/log.h"
+#include "private/dftPlanCache.hpp"
 
 namespace VM = RTSeis::Utilities::Math::VectorMath;
 using namespace RTSeis::Utilities;
+namespace DFTPlanCache = RTSeis::Utilities::Transforms::DFTPlanCache;
 
 /*
 std::vector<double>
@@ -65,74 +67,31 @@ void Interpolation::interpft<>(const int nx, const double x[],
         ippsSet_64f(x[0], yint, npnew);
         return;
     }
-    // Figure out the size of the forward and inverse transforms
-    IppStatus status;
-    int bufferSizeI, bufferSizeF, specSizeF, specSizeI, sizeInitF, sizeInitI;
-    status = ippsDFTGetSize_R_64f(nx,
-                                  IPP_FFT_DIV_INV_BY_N,
-                                  ippAlgHintNone,
-                                  &specSizeF,
-                                  &sizeInitF,
-                                  &bufferSizeF);
-    if (status != ippStsNoErr)
-    {
-        std::string errmsg;
-        if (status == ippStsNullPtrErr)
-        {
-            RTSEIS_THROW_RTE("%s", "Null pointer in transform inquiry");
-        }
-        if (status == ippStsSizeErr)
-        {
-            RTSEIS_THROW_RTE("Forward transform inquiry failed for nx = %d",
-                              nx);
-        }
-        if (status == ippStsFftOrderErr)
-        {
-            RTSEIS_THROW_RTE("Insufficient memory for nx = %d", nx);
-        }
-        RTSEIS_THROW_RTE("Forward transform inquiry failed with %d", status);
-    }
-    status = ippsDFTGetSize_R_64f(npnew,
-                                  IPP_FFT_DIV_INV_BY_N,
-                                  ippAlgHintNone,
-                                  &specSizeI,
-                                  &sizeInitI,
-                                  &bufferSizeI);
-    if (status != ippStsNoErr)
-    {   
-        RTSEIS_THROW_RTE("%s", "Inverse transform inquiry failed");
-    }
-    // Initialize the forward transform
-    auto *pDFTForwardSpec = (IppsDFTSpec_R_64f *) ippsMalloc_8u(specSizeF);
-    Ipp8u *pDFTInitBuf = ippsMalloc_8u(std::max(sizeInitF, sizeInitI));
-    status = ippsDFTInit_R_64f(nx, 
-                               IPP_FFT_DIV_FWD_BY_N,
-                               ippAlgHintNone,
-                               pDFTForwardSpec,
-                               pDFTInitBuf);
-    if (status != ippStsNoErr)
-    {
-        ippsFree(pDFTForwardSpec);
-        ippsFree(pDFTInitBuf);
-        RTSEIS_THROW_RTE("%s", "Forward transform init failed");
-    }
-    // Initialize the inverse transform
-    auto *pDFTInverseSpec = (IppsDFTSpec_R_64f *) ippsMalloc_8u(specSizeI);
-    status = ippsDFTInit_R_64f(npnew,
-                               IPP_FFT_DIV_FWD_BY_N,
-                               ippAlgHintNone,
-                               pDFTInverseSpec,
-                               pDFTInitBuf);
-    if (pDFTInitBuf){ippsFree(pDFTInitBuf);}
-    if (status != ippStsNoErr)
-    {
-        ippsFree(pDFTForwardSpec);
-        ippsFree(pDFTInverseSpec);
-        ippsFree(pDFTInitBuf);
-        RTSEIS_THROW_RTE("%s", "Inverse transform init failed");
+    // Get the forward and inverse transforms from the plan cache
+    auto forwardPlan
+        = DFTPlanCache::getPlan(DFTPlanCache::Domain::REAL, nx, false,
+                                RTSeis::Precision::DOUBLE,
+                                IPP_FFT_DIV_FWD_BY_N);
+    if (forwardPlan == nullptr)
+    {
+        RTSEIS_THROW_RTE("Forward transform init failed for nx = %d", nx);
+    }
+    auto inversePlan
+        = DFTPlanCache::getPlan(DFTPlanCache::Domain::REAL, npnew, false,
+                                RTSeis::Precision::DOUBLE,
+                                IPP_FFT_DIV_FWD_BY_N);
+    if (inversePlan == nullptr)
+    {
+        RTSEIS_THROW_RTE("Inverse transform init failed for npnew = %d",
+                         npnew);
     }
+    auto pDFTForwardSpec
+        = forwardPlan->getSpecification<IppsDFTSpec_R_64f> ();
+    auto pDFTInverseSpec
+        = inversePlan->getSpecification<IppsDFTSpec_R_64f> ();
     // Set the workspace
-    Ipp8u *pBuf = ippsMalloc_8u(std::max(bufferSizeF, bufferSizeI));
+    Ipp8u *pBuf = ippsMalloc_8u(std::max(forwardPlan->getBufferSize(),
+                                         inversePlan->getBufferSize()));
     int maxDFTLen = std::max(nx/2+1, npnew/2+1);
     Ipp64f *pDst = ippsMalloc_64f(2*maxDFTLen); // Hold real and complex
     ippsZero_64f(pDst, 2*maxDFTLen); // Pre-zero-pad in frequency domain
@@ -143,8 +102,6 @@ void Interpolation::interpft<>(const int nx, const double x[],
     // Clean up
     ippsFree(pBuf);
     ippsFree(pDst);
-    ippsFree(pDFTForwardSpec);
-    ippsFree(pDFTInverseSpec);
 }
 
 template<>
@@ -175,60 +132,31 @@ void Interpolation::interpft<>(const int nx, const float x[],
         ippsSet_32f(x[0], yint, npnew);
         return;
     }
-    // Figure out the size of the forward and inverse transforms
-    IppStatus status;
-    int bufferSizeI, bufferSizeF, specSizeF, specSizeI, sizeInitF, sizeInitI;
-    status = ippsDFTGetSize_R_32f(nx,
-                                  IPP_FFT_DIV_INV_BY_N,
-                                  ippAlgHintNone,
-                                  &specSizeF,
-                                  &sizeInitF,
-                                  &bufferSizeF);
-    if (status != ippStsNoErr)
-    {
-        RTSEIS_THROW_RTE("%s", "Forward transform inquiry failed");
-    }
-    status = ippsDFTGetSize_R_32f(npnew,
-                                  IPP_FFT_DIV_INV_BY_N,
-                                  ippAlgHintNone,
-                                  &specSizeI,
-                                  &sizeInitI,
-                                  &bufferSizeI);
-    if (status != ippStsNoErr)
-    {
-        RTSEIS_THROW_RTE("%s", "Inverse transform inquiry failed");
-    }
-    // Initialize the forward transform
-    auto *pDFTForwardSpec = (IppsDFTSpec_R_32f *) ippsMalloc_8u(specSizeF);
-    Ipp8u *pDFTInitBuf = ippsMalloc_8u(std::max(sizeInitF, sizeInitI));
-    status = ippsDFTInit_R_32f(nx,
-                               IPP_FFT_DIV_FWD_BY_N,
-                               ippAlgHintNone,
-                               pDFTForwardSpec,
-                               pDFTInitBuf);
-    if (status != ippStsNoErr)
-    {
-        ippsFree(pDFTForwardSpec);
-        ippsFree(pDFTInitBuf);
-        RTSEIS_THROW_RTE("%s", "Forward transform init failed");
-    }
-    // Initialize the inverse transform
-    auto *pDFTInverseSpec = (IppsDFTSpec_R_32f *) ippsMalloc_8u(specSizeI);
-    status = ippsDFTInit_R_32f(npnew,
-                               IPP_FFT_DIV_FWD_BY_N,
-                               ippAlgHintNone,
-                               pDFTInverseSpec,
-                               pDFTInitBuf);
-    if (pDFTInitBuf){ippsFree(pDFTInitBuf);}
-    if (status != ippStsNoErr)
-    {
-        ippsFree(pDFTForwardSpec);
-        ippsFree(pDFTInverseSpec);
-        ippsFree(pDFTInitBuf);
-        RTSEIS_THROW_RTE("%s", "Inverse transform init failed");
+    // Get the forward and inverse transforms from the plan cache
+    auto forwardPlan
+        = DFTPlanCache::getPlan(DFTPlanCache::Domain::REAL, nx, false,
+                                RTSeis::Precision::FLOAT,
+                                IPP_FFT_DIV_FWD_BY_N);
+    if (forwardPlan == nullptr)
+    {
+        RTSEIS_THROW_RTE("Forward transform init failed for nx = %d", nx);
+    }
+    auto inversePlan
+        = DFTPlanCache::getPlan(DFTPlanCache::Domain::REAL, npnew, false,
+                                RTSeis::Precision::FLOAT,
+                                IPP_FFT_DIV_FWD_BY_N);
+    if (inversePlan == nullptr)
+    {
+        RTSEIS_THROW_RTE("Inverse transform init failed for npnew = %d",
+                         npnew);
     }
+    auto pDFTForwardSpec
+        = forwardPlan->getSpecification<IppsDFTSpec_R_32f> ();
+    auto pDFTInverseSpec
+        = inversePlan->getSpecification<IppsDFTSpec_R_32f> ();
     // Set the workspace
-    Ipp8u *pBuf = ippsMalloc_8u(std::max(bufferSizeF, bufferSizeI));
+    Ipp8u *pBuf = ippsMalloc_8u(std::max(forwardPlan->getBufferSize(),
+                                         inversePlan->getBufferSize()));
     int maxDFTLen = std::max(nx/2+1, npnew/2+1);
     Ipp32f *pDst = ippsMalloc_32f(2*maxDFTLen); // Hold real and complex
     ippsZero_32f(pDst, 2*maxDFTLen); // Pre-zero-pad in frequency domain
@@ -239,8 +167,6 @@ void Interpolation::interpft<>(const int nx, const float x[],
     // Clean up
     ippsFree(pBuf);
     ippsFree(pDst);
-    ippsFree(pDFTForwardSpec);
-    ippsFree(pDFTInverseSpec);
 }
 
 std::vector<double>
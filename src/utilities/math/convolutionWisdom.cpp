@@ -0,0 +1,256 @@
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "rtseis/utilities/math/convolutionWisdom.hpp"
+#include "private/convolutionWisdom.hpp"
+
+using namespace RTSeis::Utilities::Math;
+
+namespace
+{
+
+/// The first line of a wisdom file.
+const std::string WISDOM_HEADER = "# RTSeis convolution wisdom 2";
+/// Number of times each algorithm is run when benchmarking.  The fastest
+/// run is kept so that a single cold run does not decide the outcome.
+constexpr int N_TRIALS = 3;
+
+/// (operation, taps, block length, precision, processing mode)
+using WisdomKey = std::tuple<int, int, int, int, int>;
+
+/// The process-wide wisdom table.
+class WisdomTable
+{
+public:
+    std::map<WisdomKey, ConvolutionWisdom::Algorithm> mTable;
+    std::mutex mMutex;
+};
+
+WisdomTable &getTable()
+{
+    static WisdomTable table;
+    return table;
+}
+
+WisdomKey makeKey(const ConvolutionWisdom::Operation operation,
+                  const int nTaps, const int blockLength,
+                  const RTSeis::Precision precision,
+                  const RTSeis::ProcessingMode mode)
+{
+    return WisdomKey(static_cast<int> (operation),
+                     ConvolutionWisdom::roundLength(nTaps),
+                     ConvolutionWisdom::roundLength(blockLength),
+                     static_cast<int> (precision),
+                     static_cast<int> (mode));
+}
+
+/// Times the trial function for the given algorithm.  An untimed run
+/// comes first so that first-touch costs are not attributed to either
+/// algorithm.
+double timeTrial(const std::function<void (ConvolutionWisdom::Algorithm)> &trial,
+                 const ConvolutionWisdom::Algorithm algorithm)
+{
+    trial(algorithm);
+    double tmin = std::numeric_limits<double>::max();
+    for (int i = 0; i < N_TRIALS; ++i)
+    {
+        auto timeStart = std::chrono::steady_clock::now();
+        trial(algorithm);
+        auto timeEnd = std::chrono::steady_clock::now();
+        std::chrono::duration<double> tdif = timeEnd - timeStart;
+        tmin = std::min(tmin, tdif.count());
+    }
+    return tmin;
+}
+
+}
+
+/// Rounds n up to the next power of 2
+int ConvolutionWisdom::roundLength(const int n) noexcept
+{
+    int n2 = 1;
+    while (n2 < n && n2 < std::numeric_limits<int>::max()/2){n2 = 2*n2;}
+    return n2;
+}
+
+/// Sets an algorithm
+void ConvolutionWisdom::setAlgorithm(const Operation operation,
+                                     const int nTaps,
+                                     const int blockLength,
+                                     const RTSeis::Precision precision,
+                                     const Algorithm algorithm,
+                                     const RTSeis::ProcessingMode mode)
+{
+    if (nTaps < 1)
+    {
+        throw std::invalid_argument("nTaps = " + std::to_string(nTaps)
+                                  + " must be positive");
+    }
+    if (blockLength < 1)
+    {
+        throw std::invalid_argument("blockLength = "
+                                  + std::to_string(blockLength)
+                                  + " must be positive");
+    }
+    auto key = makeKey(operation, nTaps, blockLength, precision, mode);
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    table.mTable[key] = algorithm;
+}
+
+/// Checks for an algorithm
+bool ConvolutionWisdom::haveAlgorithm(const Operation operation,
+                                      const int nTaps,
+                                      const int blockLength,
+                                      const RTSeis::Precision precision,
+                                      const RTSeis::ProcessingMode mode) noexcept
+{
+    auto key = makeKey(operation, nTaps, blockLength, precision, mode);
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    return table.mTable.find(key) != table.mTable.end();
+}
+
+/// Gets an algorithm
+ConvolutionWisdom::Algorithm
+ConvolutionWisdom::getAlgorithm(const Operation operation,
+                                const int nTaps,
+                                const int blockLength,
+                                const RTSeis::Precision precision,
+                                const RTSeis::ProcessingMode mode)
+{
+    auto key = makeKey(operation, nTaps, blockLength, precision, mode);
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    auto entry = table.mTable.find(key);
+    if (entry == table.mTable.end())
+    {
+        throw std::invalid_argument("No wisdom for nTaps = "
+                                  + std::to_string(nTaps)
+                                  + " and blockLength = "
+                                  + std::to_string(blockLength));
+    }
+    return entry->second;
+}
+
+/// Number of entries
+int ConvolutionWisdom::getNumberOfEntries() noexcept
+{
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    return static_cast<int> (table.mTable.size());
+}
+
+/// Clears the table
+void ConvolutionWisdom::forgetWisdom() noexcept
+{
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    table.mTable.clear();
+}
+
+/// Export
+void ConvolutionWisdom::exportWisdom(const std::string &fileName)
+{
+    std::ofstream ofl(fileName);
+    if (!ofl.is_open())
+    {
+        throw std::runtime_error("Failed to open " + fileName);
+    }
+    ofl << WISDOM_HEADER << std::endl;
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    for (const auto &entry : table.mTable)
+    {
+        ofl << std::get<0> (entry.first) << " "
+            << std::get<1> (entry.first) << " "
+            << std::get<2> (entry.first) << " "
+            << std::get<3> (entry.first) << " "
+            << std::get<4> (entry.first) << " "
+            << static_cast<int> (entry.second) << std::endl;
+    }
+    if (!ofl.good())
+    {
+        throw std::runtime_error("Failed to write " + fileName);
+    }
+}
+
+/// Import
+void ConvolutionWisdom::importWisdom(const std::string &fileName)
+{
+    std::ifstream ifl(fileName);
+    if (!ifl.is_open())
+    {
+        throw std::invalid_argument(fileName + " does not exist");
+    }
+    std::string line;
+    if (!std::getline(ifl, line) || line != WISDOM_HEADER)
+    {
+        throw std::invalid_argument(fileName + " is not a wisdom file");
+    }
+    // Parse everything before touching the table
+    std::map<WisdomKey, Algorithm> wisdom;
+    while (std::getline(ifl, line))
+    {
+        if (line.empty()){continue;}
+        std::istringstream stream(line);
+        int operation, nTaps, blockLength, precision, mode, algorithm;
+        if (!(stream >> operation >> nTaps >> blockLength
+                     >> precision >> mode >> algorithm) ||
+            operation < 0 || operation > 2 ||
+            nTaps < 1 || blockLength < 1 ||
+            (precision != static_cast<int> (RTSeis::Precision::DOUBLE) &&
+             precision != static_cast<int> (RTSeis::Precision::FLOAT)) ||
+            (mode != static_cast<int> (RTSeis::ProcessingMode::POST) &&
+             mode != static_cast<int> (RTSeis::ProcessingMode::REAL_TIME)) ||
+            algorithm < 0 || algorithm > 1)
+        {
+            throw std::invalid_argument("Malformed line: " + line);
+        }
+        // Files written by hand may not use rounded lengths
+        auto key = makeKey(static_cast<Operation> (operation),
+                           nTaps, blockLength,
+                           static_cast<RTSeis::Precision> (precision),
+                           static_cast<RTSeis::ProcessingMode> (mode));
+        wisdom[key] = static_cast<Algorithm> (algorithm);
+    }
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    for (const auto &entry : wisdom)
+    {
+        table.mTable[entry.first] = entry.second;
+    }
+}
+
+/// Tune
+ConvolutionWisdom::Algorithm
+ConvolutionWisdom::tune(const Operation operation,
+                        const int nTaps,
+                        const int blockLength,
+                        const RTSeis::Precision precision,
+                        const std::function<void (Algorithm)> &trial,
+                        const RTSeis::ProcessingMode mode)
+{
+    auto key = makeKey(operation, nTaps, blockLength, precision, mode);
+    auto &table = getTable();
+    {
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    auto entry = table.mTable.find(key);
+    if (entry != table.mTable.end()){return entry->second;}
+    }
+    // Benchmark without holding the lock.  If another thread tunes the same
+    // key in the meantime then the last result wins which is harmless.
+    auto tDirect = timeTrial(trial, Algorithm::DIRECT);
+    auto tFFT = timeTrial(trial, Algorithm::FFT);
+    auto algorithm = (tFFT < tDirect) ? Algorithm::FFT : Algorithm::DIRECT;
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    table.mTable[key] = algorithm;
+    return algorithm;
+}
@@ -2,6 +2,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #include <cassert>
 #include <ipps.h>
 #define RTSEIS_LOGGING 1
@@ -9,6 +10,7 @@
 #include "rtseis/utilities/math/convolve.hpp"
 #include "rtseis/log.h"
 #include "private/convolve.hpp"
+#include "private/convolutionWisdom.hpp"
 
 using namespace  RTSeis::Utilities::Math;
 
@@ -39,6 +41,93 @@ IppEnum getImplementation(const Convolve::Implementation implementation)
         return ippAlgAuto;
     }
 }
+
+/// AUTO only benchmarks problems whose longer signal, once rounded to its
+/// wisdom bucket, is at most this long.  Larger problems defer to IPP's
+/// own choice unless there is wisdom for them.
+constexpr int MAX_TUNING_LENGTH = 65536;
+
+/*!
+ * @brief Resolves the AUTO implementation from the convolution wisdom.
+ *        If this problem size has not been seen then the direct and FFT
+ *        implementations are benchmarked on synthetic signals whose lengths
+ *        are those of the wisdom bucket.  The caller's signals are never
+ *        used for the benchmark.
+ * @param[in] implementation  The requested implementation.
+ * @param[in] operation       Convolution or correlation.
+ * @param[in] src1Len         The length of the first signal.
+ * @param[in] src2Len         The length of the second signal.
+ * @result The implementation to use.  This is DIRECT or FFT when there is,
+ *         or can cheaply be made, wisdom for this problem size.  Otherwise,
+ *         this is AUTO and IPP chooses.  If implementation is not AUTO
+ *         then it is returned.
+ * @ingroup rtseis_utils_convolve
+ */
+Convolve::Implementation resolveImplementation(
+    const Convolve::Implementation implementation,
+    const ConvolutionWisdom::Operation operation,
+    const int src1Len, const int src2Len)
+{
+    if (implementation != Convolve::Implementation::AUTO)
+    {
+        return implementation;
+    }
+    auto nTaps = std::min(src1Len, src2Len);
+    auto blockLength = std::max(src1Len, src2Len);
+    auto algorithm = ConvolutionWisdom::Algorithm::DIRECT;
+    if (ConvolutionWisdom::haveAlgorithm(operation, nTaps, blockLength,
+                                         RTSeis::Precision::DOUBLE))
+    {
+        algorithm = ConvolutionWisdom::getAlgorithm(operation, nTaps,
+                                                    blockLength,
+                                                    RTSeis::Precision::DOUBLE);
+    }
+    else
+    {
+        auto nTrial1 = ConvolutionWisdom::roundLength(nTaps);
+        auto nTrial2 = ConvolutionWisdom::roundLength(blockLength);
+        if (nTrial2 > MAX_TUNING_LENGTH)
+        {
+            return Convolve::Implementation::AUTO;
+        }
+        // Allocate the trial signals before anything is timed
+        std::vector<double> a(nTrial1, 0);
+        std::vector<double> b(nTrial2, 0);
+        std::vector<double> c(nTrial1 + nTrial2 - 1);
+        auto trial = [&](const ConvolutionWisdom::Algorithm trialAlgorithm)
+        {
+            auto trialImplementation = Convolve::Implementation::DIRECT;
+            if (trialAlgorithm == ConvolutionWisdom::Algorithm::FFT)
+            {
+                trialImplementation = Convolve::Implementation::FFT;
+            }
+            double *cPtr = c.data();
+            int nc;
+            if (operation == ConvolutionWisdom::Operation::CORRELATE)
+            {
+                Convolve::correlate(nTrial1, a.data(), nTrial2, b.data(),
+                                    static_cast<int> (c.size()), &nc, &cPtr,
+                                    Convolve::Mode::FULL,
+                                    trialImplementation);
+            }
+            else
+            {
+                Convolve::convolve(nTrial1, a.data(), nTrial2, b.data(),
+                                   static_cast<int> (c.size()), &nc, &cPtr,
+                                   Convolve::Mode::FULL,
+                                   trialImplementation);
+            }
+        };
+        algorithm = ConvolutionWisdom::tune(operation, nTaps, blockLength,
+                                            RTSeis::Precision::DOUBLE,
+                                            trial);
+    }
+    if (algorithm == ConvolutionWisdom::Algorithm::FFT)
+    {
+        return Convolve::Implementation::FFT;
+    }
+    return Convolve::Implementation::DIRECT;
+}
 }
 
 std::vector<double>
@@ -99,7 +188,11 @@ void Convolve::convolve(const int src1Len, const double a[],
     int len = src1Len + src2Len - 1;
     // Figure out the buffer size
     int bufSize = 0;
-    IppEnum funCfg = getImplementation(implementation);
+    auto implementationToUse
+        = resolveImplementation(implementation,
+                                ConvolutionWisdom::Operation::CONVOLVE,
+                                src1Len, src2Len);
+    IppEnum funCfg = getImplementation(implementationToUse);
     IppStatus status = ippsConvolveGetBufferSize(src1Len, src2Len, ipp64f,
                                                  funCfg, &bufSize);
     if (status != ippStsNoErr)
@@ -202,7 +295,11 @@ void Convolve::correlate(const int src1Len, const double a[],
     }
     int len = src1Len + src2Len - 1;
     // Figure out the buffer size
-    IppEnum funCfg = getImplementation(implementation) | ippsNormNone;
+    auto implementationToUse
+        = resolveImplementation(implementation,
+                                ConvolutionWisdom::Operation::CORRELATE,
+                                src1Len, src2Len);
+    IppEnum funCfg = getImplementation(implementationToUse) | ippsNormNone;
     int bufSize = 0;
     const int lowLag =-src2Len + 1; //(std::max(src1Len, src2Len) - 1);
     IppStatus status = ippsCrossCorrNormGetBufferSize(src2Len, src1Len, len,
@@ -2,170 +2,94 @@
 #include <cstring>
 #include <string>
 #include <vector>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
 #include <complex> // Put this before fftw
 #include <mkl.h>
-#include <mkl_vsl.h>
 #include <fftw/fftw3.h>
-#include "rtseis/utilities/transforms/dftRealToComplex.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "rtseis/utilities/transforms/continuousWavelet.hpp"
-#include "rtseis/utilities/transforms/wavelets/morlet.hpp"
-#include "rtseis/utilities/filterImplementations/detrend.hpp"
-#include "rtseis/utilities/math/convolve.hpp"
-#include "private/convolve.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+#include "rtseis/utilities/transforms/wavelets/iwavelets.hpp"
 #include "private/pad.hpp"
 
 using namespace RTSeis::Utilities::Transforms;
 
-namespace Convolve = RTSeis::Utilities::Math::Convolve;
-
 namespace
 {
-
-template<class T>
-void realToComplex(const int n, const T *x, std::complex<T> *z)
+/// The number of threads a parallel region may use
+int getMaxThreads() noexcept
 {
-    #pragma omp simd
-    for (int i=0; i<n; ++i)
-    {
-        z[i] = std::complex<T> (x[i], 0);
-    }
+#ifdef _OPENMP
+    return std::max(1, omp_get_max_threads());
+#else
+    return 1;
+#endif
 }
-
-/*
-int convolve(const int n, const int ldx, const double x[],
-             const int nWidths, const double widths[],
-             const Wavelets::IContinuousWavelet &wavelet,
-             std::complex<double> *cwt,
-             const int option,
-             const double dt)
+/// The calling thread's index in the parallel region
+int getThreadIndex() noexcept
 {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
 }
-*/
-
-int convolve(const int n, const int ldx, const double x[],
-             const int nWidths, const double widths[],
-             const Wavelets::IContinuousWavelet &wavelet,
-             std::complex<double> *cwt,
-             const int option,
-             const double dt)
+/// Finds the half-width, in samples, beyond which the wavelet's magnitude
+/// is less than tol of its peak.  The wavelets' Gaussian envelopes are
+/// negligible beyond 10 scales.
+int computeHalfSupport(const Wavelets::IContinuousWavelet &wavelet,
+                       const double scale, const double tol = 1.e-8)
 {
-    // Get correlation length
-    auto indices = computeTrimIndices(Convolve::Mode::SAME, n, n);
-    auto nCopy = Convolve::computeConvolutionLength(n, n, Convolve::Mode::SAME); 
-    auto i1 = indices.first;
-#ifndef NDEBUG
-    auto i2 = indices.second;
-    assert(i2 - i1 == nCopy);
-#endif
-    // Figure out the convolution mode
-    MKL_INT mode = VSL_CONV_MODE_AUTO;
-    if (option == 1){mode = VSL_CONV_MODE_DIRECT;}
-    if (option == 2){mode = VSL_CONV_MODE_FFT;}
-    // Set space on each thread
-    int ierr = 0;
-    #pragma omp parallel \
-     shared(cwt, x, std::cerr, wavelet, widths) \
-     firstprivate(i1, nCopy, mode) \
-     reduction(+ : ierr) \
-     default(none)
-    {
-    // Set space for the transform
-    auto *xz = static_cast<MKL_Complex16 *>
-               (mkl_calloc(static_cast<int> (n), sizeof(MKL_Complex16), 64));
-    auto xzPtr = reinterpret_cast<std::complex<double> *> (xz);
-    realToComplex(n, x, xzPtr); // Copy real to complex 
-    // Since x won't change - set it here.  If using an FFT this will let MKL
-    // potentially precompute the FFT once.
-    VSLConvTaskPtr task;
-    const MKL_INT xStride = 1;
-    const MKL_INT yStride = 1;
-    const MKL_INT zStride = 1;
-    auto xShape = static_cast<MKL_INT> (n);
-    auto yShape = static_cast<MKL_INT> (n);
-    auto zShape = xShape + yShape - 1;
-    auto status = vslzConvNewTaskX1D(&task, mode, xShape, yShape, zShape,
-                                     xz, xStride);
-    if (status != VSL_STATUS_OK)
-    {
-        std::cerr << "Failed to initialize convolution engine" << std::endl;
-        ierr = 1;
-    }
-    // Set space for wavelet
-    auto *y = static_cast<MKL_Complex16 *> 
-              (mkl_calloc(yShape, sizeof(MKL_Complex16), 64));
-    auto *z = static_cast<MKL_Complex16 *>
-              (mkl_calloc(zShape, sizeof(MKL_Complex16), 64));
-    // Have each thread contribute to the correlation
-    #pragma omp for
-    for (int j=0; j<nWidths; ++j)
-    {
-        // Evaluate the wavelet transform
-        auto wPtr = reinterpret_cast<std::complex<double> *> (y);
-        wavelet.evaluate(n, widths[j], &wPtr);
-        // Formula is signal convolved with time reversed conjugate of wavelet
-        #pragma omp simd
-        for (int i=0; i<n/2; ++i)
-        {
-            auto temp = std::conj(wPtr[n-1-i]);
-            wPtr[n-1-i] = std::conj(wPtr[i]);
-            wPtr[i] = temp;
-        }
-/*
-// Slow convolution
-std::vector<double> wRe(n);
-std::vector<double> wIm(n);
-std::vector<double> xRe(n);
-for (int i=0; i<n; ++i)
-{
-  wRe[i] = std::real(wPtr[i]);
-  wIm[i] = std::imag(wPtr[i]);
-  xRe[i] = x[i];
-} 
-std::cout << n << " " << widths[j] << " " << 1./std::sqrt(widths[j])*wPtr[500]
-                                   << " " << 1./std::sqrt(widths[j])*wPtr[510] << std::endl;
-auto xwRe = Convolve::convolve(xRe, wRe, Convolve::Mode::SAME);
-auto xwIm = Convolve::convolve(xRe, wIm, Convolve::Mode::SAME);
-std::vector<std::complex<double>> xw(n);
-for (int i=0; i<n; ++i)
-{
-    xw[i] = std::complex<double> (xwRe[i], xwIm[i]);
-}
-*/
-        // Convolve
-        status = vslzConvExecX1D(task, y, yStride, z, zStride); 
-        if (status != VSL_STATUS_OK)
-        {
-             std::cerr << "Convolution failed" << std::endl;
-             ierr = 1;
-        }
-        // Only take the center component of the convolution and normalize
-        // by 1/sqrt(|a|) ala the formula.  Note, MKL only implements the
-        // convolutional sum; to make it match the convolutional integral
-        // we multiply by dt.
-        auto xnorm = dt/std::sqrt(std::abs(widths[j]));
-        auto cwtPtr = cwt + j*ldx;
-        auto zPtr = reinterpret_cast<std::complex<double> *> (z);
-        //double emax = 0;
-        #pragma omp simd aligned(cwtPtr : 64)
-        for (int i=0; i<nCopy; ++i)
+    auto nHalf = static_cast<int> (std::ceil(10*scale)) + 1;
+    auto n = 2*nHalf + 1;
+    std::vector<std::complex<double>> w(n);
+    auto wPtr = w.data();
+    wavelet.evaluate(n, scale, &wPtr);
+    double peak = 0;
+    for (const auto &wi : w){peak = std::max(peak, std::abs(wi));}
+    for (int i=0; i<nHalf; ++i)
+    {
+        if (std::abs(w[i]) > tol*peak || std::abs(w[n-1-i]) > tol*peak)
         {
-             //emax = std::max(emax, std::abs(zPtr[i1 + i] - xw[i]));
-             cwtPtr[i] = xnorm*zPtr[i1 + i];
+            return nHalf - i;
         }
     }
-    // Clean up
-    vslConvDeleteTask(&task);
-    MKL_free(xz);
-    MKL_free(y);
-    MKL_free(z);
-    } // End parallel 
-    if (ierr != 0)
+    return 0;
+}
+
+/// Finds the decimation factor that places the scale's Nyquist frequency
+/// above the frequencies where the wavelet's Fourier transform exceeds tol
+/// of its peak.
+int computeDecimationFactor(const Wavelets::IContinuousWavelet &wavelet,
+                            const double scale, const double tol = 1.e-6)
+{
+    const int nOmega = 4096;
+    const double dOmega = M_PI/nOmega;
+    std::vector<double> omega(2*nOmega + 1);
+    for (int k=0; k<2*nOmega+1; ++k){omega[k] = dOmega*(k - nOmega);}
+    std::vector<std::complex<double>> w(omega.size());
+    auto wPtr = w.data();
+    wavelet.evaluateFrequencyDomain(static_cast<int> (w.size()), scale,
+                                    omega.data(), &wPtr);
+    double peak = 0;
+    for (const auto &wi : w){peak = std::max(peak, std::abs(wi));}
+    double omegaMax = 0;
+    for (int k=0; k<static_cast<int> (w.size()); ++k)
     {
-        std::cerr << "Errors detected during convolution" << std::endl;
+        if (std::abs(w[k]) > tol*peak)
+        {
+            omegaMax = std::max(omegaMax, std::abs(omega[k]));
+        }
     }
-    return ierr;
+    // The threshold is crossed somewhere before the next grid point
+    omegaMax = std::min(M_PI, omegaMax + dOmega);
+    return std::max(1, static_cast<int> (M_PI/omegaMax));
 }
-
 }
 
 ///--------------------------------------------------------------------------///
@@ -186,28 +110,30 @@ public:
     ContinuousWaveletImpl& operator=(const ContinuousWaveletImpl &cwt)
     {
         if (&cwt == this){return *this;}
+        clear();
         mScales = cwt.mScales;
         if (cwt.mWavelet){mWavelet = cwt.mWavelet->clone();}
         mSamplingRate = cwt.mSamplingRate;
         mSamples = cwt.mSamples;
-        mLeadingDimension = cwt.mLeadingDimension;
+        mMode = cwt.mMode;
+        mStorage = cwt.mStorage;
+        mDecimation = cwt.mDecimation;
+        mCallback = cwt.mCallback;
         mHaveTransform = cwt.mHaveTransform;
         mInitialized = cwt.mInitialized;
-        auto nScales = static_cast<int> (mScales.size());
-        if (mLeadingDimension > 0 && nScales > 0)
+        if (mInitialized)
         {
-            auto num = static_cast<size_t> (mLeadingDimension)
-                      *static_cast<size_t> (nScales);
-            if (mDoublePrecision)
-            {
-                mCWT = mkl_calloc(num, sizeof(MKL_Complex16), 64);
-                std::memcpy(mCWT, cwt.mCWT, num*sizeof(MKL_Complex16));
-            }
-            else
-            {
-                mCWT = mkl_calloc(num, sizeof(MKL_Complex8), 64);
-                std::memcpy(mCWT, cwt.mCWT, num*sizeof(MKL_Complex8)); 
-            }
+            createEngine();
+            allocateStorage();
+        }
+        mPending = cwt.mPending;
+        mPendingSize = cwt.mPendingSize;
+        mRowColumns = cwt.mRowColumns;
+        mColumnCount = cwt.mColumnCount;
+        mNewColumns = cwt.mNewColumns;
+        if (mStorageBytes > 0)
+        {
+            std::memcpy(mCWT, cwt.mCWT, mStorageBytes);
         }
         return *this;
     }
@@ -219,19 +145,407 @@ public:
     /// Clear the class
     void clear() noexcept
     {
+        if (mHavePlans)
+        {
+            fftw_destroy_plan(mForwardPlan);
+            fftw_destroy_plan(mInversePlan);
+        }
+        if (mSignal){fftw_free(mSignal);}
+        if (mSpectrum){fftw_free(mSpectrum);}
+        if (mWork){fftw_free(mWork);}
         if (mCWT){MKL_free(mCWT);}
+        mSignal = nullptr;
+        mSpectrum = nullptr;
+        mWork = nullptr;
         mCWT = nullptr;
+        mOmega.clear();
+        mShift.clear();
+        mFilterSpectra.clear();
+        mPending.clear();
+        mRowOffsets.clear();
+        mRowColumns.clear();
+        mDecimation.clear();
+        mCallback = nullptr;
+        mStorageBytes = 0;
+        mColumnCount = 0;
+        mPendingSize = 0;
+        mWorkThreads = 0;
+        mFFTLength = 0;
+        mHalfSupport = 0;
+        mNewColumns = 0;
+        mMode = RTSeis::ProcessingMode::POST;
+        mStorage = ContinuousWaveletStorage::COMPLEX;
+        mHavePlans = false;
         mScales.clear();
         mWavelet = nullptr;
         mSamplingRate = 1;
         mSamples = 0;
-        mLeadingDimension = 0;
         mHaveTransform = false;
         mInitialized = false;
     } 
-    /// CWT.  This is an [nScales x mLeadingDimension] row major matrix.
-    //std::vector<std::complex<T>> mCWT;
+    /// Creates the Fourier transform plans and the frequency grid.  In
+    /// post-processing the signal is zero padded to a fast length of at
+    /// least 2n - 1 so that the circular correlation with the wavelet does
+    /// not wrap around.  In real-time each overlap-save block holds the
+    /// widest wavelet's support and at least one full packet.
+    void createEngine()
+    {
+        if (mMode == RTSeis::ProcessingMode::POST)
+        {
+            mFFTLength = DFTUtilities::nextFastLength(2*mSamples - 1);
+        }
+        else
+        {
+            mHalfSupport = 0;
+            for (const auto &scale : mScales)
+            {
+                mHalfSupport = std::max(mHalfSupport,
+                                        computeHalfSupport(*mWavelet, scale));
+            }
+            auto filterLength = 2*mHalfSupport + 1;
+            mFFTLength = DFTUtilities::nextFastLength(
+                             filterLength - 1
+                           + std::max(mSamples, filterLength));
+        }
+        auto nfft = mFFTLength;
+        mSignal = static_cast<double *>
+                  (fftw_malloc(static_cast<size_t> (nfft)*sizeof(double)));
+        mSpectrum = static_cast<std::complex<double> *>
+                    (fftw_malloc(static_cast<size_t> (nfft)
+                                *sizeof(fftw_complex)));
+        // Each thread gets its own inverse transform workspace
+        mWorkThreads = getMaxThreads();
+        mWork = static_cast<std::complex<double> *>
+                (fftw_malloc(static_cast<size_t> (nfft)*mWorkThreads
+                            *sizeof(fftw_complex)));
+        auto work = reinterpret_cast<fftw_complex *> (mWork);
+        mForwardPlan
+            = fftw_plan_dft_r2c_1d(nfft, mSignal,
+                                   reinterpret_cast<fftw_complex *> (mSpectrum),
+                                   FFTW_MEASURE);
+        // Each thread executes this in-place on its own workspace
+        mInversePlan = fftw_plan_dft_1d(nfft, work, work,
+                                        FFTW_BACKWARD, FFTW_MEASURE);
+        mHavePlans = true;
+        if (mMode == RTSeis::ProcessingMode::REAL_TIME)
+        {
+            createFilterSpectra(work);
+            // The primed zeros and the unused tail of the last block are
+            // at most 2*halfSupport samples followed by a full packet
+            mPending.assign(2*mHalfSupport + mSamples, 0);
+            resetInitialConditions();
+            return;
+        }
+        // Angular frequencies in radians/sample in FFT order.  For an even
+        // number of samples SAME-mode convolution centers the wavelet half
+        // a sample to the left which is a linear phase shift.  The
+        // sampling period and 1/nfft of the inverse transform are folded
+        // into the shift.
+        mOmega.resize(nfft);
+        mShift.resize(nfft);
+        auto dt = 1./mSamplingRate;
+        auto delta = (mSamples%2 == 0) ? 0.5 : 0.0;
+        auto xnorm = dt/static_cast<double> (nfft);
+        for (int k=0; k<nfft; ++k)
+        {
+            auto kSigned = (k <= nfft/2) ? k : k - nfft;
+            mOmega[k] = (2*M_PI*kSigned)/static_cast<double> (nfft);
+            mShift[k] = std::polar(xnorm, -mOmega[k]*delta);
+        }
+    }
+    /// Checks the dimensions of an output matrix
+    void checkMatrixDimensions(const int nSamples, const int nScales) const
+    {
+        if (nSamples != mNewColumns)
+        {
+            throw std::invalid_argument("nSamples = "
+                                      + std::to_string(nSamples)
+                                      + " must equal "
+                                      + std::to_string(mNewColumns));
+        }
+        auto ns = static_cast<int> (mScales.size());
+        if (nScales != ns)
+        {
+            throw std::invalid_argument("nScales = " + std::to_string(nScales)
+                                      + " must equal " + std::to_string(ns));
+        }
+    }
+    /// True indicates any scale is decimated
+    bool isDecimated() const noexcept
+    {
+        for (const auto &d : mDecimation){if (d > 1){return true;}}
+        return false;
+    }
+    /// Computes each scale's decimation factor
+    void computeDecimationFactors(const bool decimate)
+    {
+        auto nScales = static_cast<int> (mScales.size());
+        mDecimation.assign(nScales, 1);
+        if (!decimate){return;}
+        for (int j=0; j<nScales; ++j)
+        {
+            mDecimation[j] = std::min(mSamples,
+                               computeDecimationFactor(*mWavelet, mScales[j]));
+        }
+    }
+    /// Allocates the retained rows.  Each row holds the most columns a
+    /// transform can produce at the scale's decimation factor and begins
+    /// on a 64 byte boundary.
+    void allocateStorage()
+    {
+        if (mCWT){MKL_free(mCWT);}
+        mCWT = nullptr;
+        mStorageBytes = 0;
+        auto nScales = static_cast<int> (mScales.size());
+        mRowOffsets.assign(nScales, 0);
+        mRowColumns.assign(nScales, 0);
+        if (mStorage == ContinuousWaveletStorage::NONE){return;}
+        size_t elementSize = sizeof(float);
+        if (mStorage == ContinuousWaveletStorage::COMPLEX)
+        {
+            elementSize = sizeof(std::complex<T>);
+        }
+        size_t offset = 0;
+        for (int j=0; j<nScales; ++j)
+        {
+            mRowOffsets[j] = offset;
+            auto nColumns = (mSamples + mDecimation[j] - 1)/mDecimation[j];
+            offset = offset + padLength(nColumns, elementSize, 64);
+        }
+        mStorageBytes = offset*elementSize;
+        mCWT = mkl_calloc(offset, elementSize, 64);
+    }
+    /// Decimates the columns [i0, i0 + nColumns) of the scale's inverse
+    /// transform in place, retains them, and gives them to the row
+    /// callback.  The first column is the firstColumn'th column of the
+    /// signal.
+    void emitColumns(const int j, std::complex<double> *work,
+                     const int i0, const int nColumns,
+                     const int64_t firstColumn)
+    {
+        auto decimation = mDecimation[j];
+        auto iFirst = static_cast<int> ((decimation - firstColumn%decimation)
+                                        %decimation);
+        int nKeep = 0;
+        for (int i=iFirst; i<nColumns; i=i+decimation)
+        {
+            work[nKeep] = work[i0 + i];
+            nKeep = nKeep + 1;
+        }
+        auto column = static_cast<size_t> (mRowColumns[j]);
+        if (mStorage == ContinuousWaveletStorage::COMPLEX)
+        {
+            auto row = static_cast<std::complex<T> *> (mCWT)
+                     + mRowOffsets[j] + column;
+            std::copy(work, work + nKeep, row);
+        }
+        else if (mStorage == ContinuousWaveletStorage::AMPLITUDE)
+        {
+            auto row = static_cast<float *> (mCWT) + mRowOffsets[j] + column;
+            for (int k=0; k<nKeep; ++k)
+            {
+                row[k] = static_cast<float> (std::abs(work[k]));
+            }
+        }
+        else if (mStorage == ContinuousWaveletStorage::POWER)
+        {
+            auto row = static_cast<float *> (mCWT) + mRowOffsets[j] + column;
+            for (int k=0; k<nKeep; ++k)
+            {
+                row[k] = static_cast<float> (std::norm(work[k]));
+            }
+        }
+        if (mCallback)
+        {
+            #pragma omp critical(rtseisContinuousWaveletRowCallback)
+            mCallback(j, nKeep, work);
+        }
+        mRowColumns[j] = mRowColumns[j] + nKeep;
+    }
+    /// Computes the spectra of the truncated, time reversed, and conjugated
+    /// wavelets for overlap-save convolution.  The sampling period,
+    /// 1/sqrt(|a|), and 1/nfft of the inverse transform are folded in.
+    void createFilterSpectra(fftw_complex *work)
+    {
+        auto nfft = mFFTLength;
+        auto filterLength = 2*mHalfSupport + 1;
+        auto nScales = static_cast<int> (mScales.size());
+        auto forwardPlan = fftw_plan_dft_1d(nfft, work, work,
+                                            FFTW_FORWARD, FFTW_ESTIMATE);
+        mFilterSpectra.resize(static_cast<size_t> (nfft)*nScales);
+        std::vector<std::complex<double>> w(filterLength);
+        auto workPtr = reinterpret_cast<std::complex<double> *> (work);
+        for (int j=0; j<nScales; ++j)
+        {
+            auto wPtr = w.data();
+            mWavelet->evaluate(filterLength, mScales[j], &wPtr);
+            auto xnorm = 1/(mSamplingRate*std::sqrt(std::abs(mScales[j]))
+                           *static_cast<double> (nfft));
+            std::fill(workPtr, workPtr + nfft, std::complex<double> (0, 0));
+            for (int i=0; i<filterLength; ++i)
+            {
+                workPtr[i] = xnorm*std::conj(w[filterLength - 1 - i]);
+            }
+            fftw_execute_dft(forwardPlan, work, work);
+            std::copy(workPtr, workPtr + nfft,
+                      mFilterSpectra.data() + static_cast<size_t> (j)*nfft);
+        }
+        fftw_destroy_plan(forwardPlan);
+    }
+    /// Primes the overlap-save buffer with the zeros preceding the signal
+    void resetInitialConditions()
+    {
+        std::fill(mPending.begin(), mPending.begin() + mHalfSupport, 0);
+        mPendingSize = mHalfSupport;
+        std::fill(mRowColumns.begin(), mRowColumns.end(), 0);
+        mColumnCount = 0;
+        mNewColumns = 0;
+    }
+    /// Appends the packet to the retained samples and computes the CWT
+    /// columns whose wavelet support has been fully received.  Column t
+    /// is the output at index t + 2*halfSupport of a block so each block
+    /// yields at most nfft - 2*halfSupport columns.
+    void transformRealTime(const int n, const double x[])
+    {
+        mNewColumns = 0;
+        std::fill(mRowColumns.begin(), mRowColumns.end(), 0);
+        std::copy(x, x + n, mPending.data() + mPendingSize);
+        mPendingSize = mPendingSize + n;
+        auto nfft = mFFTLength;
+        auto nScales = static_cast<int> (mScales.size());
+        auto i0 = 2*mHalfSupport;
+        auto maxColumns = nfft - i0;
+        const auto *spectrum = mSpectrum;
+        const auto *filterSpectra = mFilterSpectra.data();
+        auto inversePlan = mInversePlan;
+        auto pool = mWork;
+        while (mPendingSize > i0)
+        {
+            auto nPending = mPendingSize;
+            auto nColumns = std::min(maxColumns, nPending - i0);
+            auto nCopy = i0 + nColumns;
+            std::copy(mPending.data(), mPending.data() + nCopy, mSignal);
+            std::fill(mSignal + nCopy, mSignal + nfft, 0);
+            fftw_execute(mForwardPlan);
+            for (int k=nfft/2+1; k<nfft; ++k)
+            {
+                mSpectrum[k] = std::conj(mSpectrum[nfft - k]);
+            }
+            auto firstColumn = mColumnCount;
+            #pragma omp parallel num_threads(mWorkThreads) \
+             shared(spectrum, filterSpectra, inversePlan, pool) \
+             firstprivate(nfft, nScales, i0, nColumns, firstColumn) \
+             default(none)
+            {
+            auto work = pool + static_cast<size_t> (getThreadIndex())*nfft;
+            auto workPtr = reinterpret_cast<fftw_complex *> (work);
+            #pragma omp for
+            for (int j=0; j<nScales; ++j)
+            {
+                const auto *filter = filterSpectra
+                                   + static_cast<size_t> (j)*nfft;
+                #pragma omp simd
+                for (int k=0; k<nfft; ++k)
+                {
+                    work[k] = spectrum[k]*filter[k];
+                }
+                fftw_execute_dft(inversePlan, workPtr, workPtr);
+                emitColumns(j, work, i0, nColumns, firstColumn);
+            }
+            } // End parallel
+            mNewColumns = mNewColumns + nColumns;
+            mColumnCount = mColumnCount + nColumns;
+            std::copy(mPending.data() + nColumns, mPending.data() + nPending,
+                      mPending.data());
+            mPendingSize = nPending - nColumns;
+        }
+    }
+    /// Computes the CWT.  The signal is transformed once.  Each scale then
+    /// requires the wavelet's analytic Fourier transform, a pointwise
+    /// multiply, and one inverse transform.
+    void transform(const double x[])
+    {
+        auto nfft = mFFTLength;
+        auto nSamples = mSamples;
+        auto nScales = static_cast<int> (mScales.size());
+        mNewColumns = nSamples;
+        std::fill(mRowColumns.begin(), mRowColumns.end(), 0);
+        // Transform the zero-padded signal
+        std::copy(x, x + nSamples, mSignal);
+        std::fill(mSignal + nSamples, mSignal + nfft, 0);
+        fftw_execute(mForwardPlan);
+        // The wavelets are complex so fill in the negative frequencies
+        for (int k=nfft/2+1; k<nfft; ++k)
+        {
+            mSpectrum[k] = std::conj(mSpectrum[nfft - k]);
+        }
+        // The CWT is the signal convolved with the time reversed conjugate
+        // of the wavelet.  In the frequency domain this is conj(W).
+        const auto *spectrum = mSpectrum;
+        const auto *omega = mOmega.data();
+        const auto *shift = mShift.data();
+        const auto *scales = mScales.data();
+        const auto *wavelet = mWavelet.get();
+        auto inversePlan = mInversePlan;
+        auto pool = mWork;
+        #pragma omp parallel num_threads(mWorkThreads) \
+         shared(spectrum, omega, shift, scales, wavelet, inversePlan, pool) \
+         firstprivate(nfft, nSamples, nScales) \
+         default(none)
+        {
+        auto work = pool + static_cast<size_t> (getThreadIndex())*nfft;
+        auto workPtr = reinterpret_cast<fftw_complex *> (work);
+        #pragma omp for
+        for (int j=0; j<nScales; ++j)
+        {
+            wavelet->evaluateFrequencyDomain(nfft, scales[j], omega, &work);
+            // Normalize by 1/sqrt(|a|) ala the formula
+            auto xnorm = 1/std::sqrt(std::abs(scales[j]));
+            #pragma omp simd
+            for (int k=0; k<nfft; ++k)
+            {
+                work[k] = xnorm*spectrum[k]*std::conj(work[k])*shift[k];
+            }
+            fftw_execute_dft(inversePlan, workPtr, workPtr);
+            emitColumns(j, work, 0, nSamples, 0);
+        }
+        } // End parallel
+    }
+    /// Forward real-to-complex plan of the padded signal
+    fftw_plan mForwardPlan;
+    /// Inverse complex-to-complex plan.  This is in-place.
+    fftw_plan mInversePlan;
+    /// The zero-padded signal.  This has dimension [mFFTLength].
+    double *mSignal = nullptr;
+    /// The signal's spectrum.  This has dimension [mFFTLength].
+    std::complex<double> *mSpectrum = nullptr;
+    /// Inverse transform workspaces.  This is an
+    /// [mWorkThreads x mFFTLength] row major matrix.
+    std::complex<double> *mWork = nullptr;
+    /// Angular frequencies (radians/sample) in FFT order
+    std::vector<double> mOmega;
+    /// Linear phase shift and normalization applied to each frequency
+    std::vector<std::complex<double>> mShift;
+    /// Real-time wavelet spectra.  This is an [nScales x mFFTLength] row
+    /// major matrix.
+    std::vector<std::complex<double>> mFilterSpectra;
+    /// Real-time samples retained for the next overlap-save block.  This
+    /// is sized in initialize() and the first mPendingSize are valid.
+    std::vector<double> mPending;
+    /// Offset to each scale's row in mCWT
+    std::vector<size_t> mRowOffsets;
+    /// Columns of each scale computed by the last transform
+    std::vector<int> mRowColumns;
+    /// Each scale's decimation factor
+    std::vector<int> mDecimation;
+    /// Receives each scale's columns
+    std::function<void (int, int, const std::complex<T> *)> mCallback;
+    /// The retained rows.  The element type is given by mStorage.
     void *mCWT = nullptr;
+    /// Size of mCWT in bytes
+    size_t mStorageBytes = 0;
+    /// Real-time columns computed since the stream began
+    int64_t mColumnCount = 0;
     /// Scales
     std::vector<T> mScales;
     /// Wavelet
@@ -240,14 +554,26 @@ public:
     double mSamplingRate = 1;
     /// Number of samples
     int mSamples = 0;
-    /// Leading dimension of mCWT
-    int mLeadingDimension = 0;
+    /// Length of the Fourier transforms
+    int mFFTLength = 0;
+    /// Half-support of the widest real-time wavelet
+    int mHalfSupport = 0;
+    /// Number of columns computed by the last transform
+    int mNewColumns = 0;
+    /// Number of valid samples in mPending
+    int mPendingSize = 0;
+    /// Number of workspaces in mWork
+    int mWorkThreads = 0;
+    /// Processing mode
+    RTSeis::ProcessingMode mMode = RTSeis::ProcessingMode::POST;
+    /// What is retained
+    ContinuousWaveletStorage mStorage = ContinuousWaveletStorage::COMPLEX;
+    /// Have FFT plans?
+    bool mHavePlans = false;
     /// Have CWT?
     bool mHaveTransform = false;
     /// Initialized?
     bool mInitialized = false;
-    /// Double precision?
-    const bool mDoublePrecision = (sizeof(T) == 8);
 };
 
 ///--------------------------------------------------------------------------///
@@ -310,7 +636,8 @@ void ContinuousWavelet<T>::clear() noexcept
 template<class T>
 void ContinuousWavelet<T>::initialize(
     const int nSamples, const int nScales, const double scales[],
-    const Wavelets::IContinuousWavelet &wavelet, const double samplingRate)
+    const Wavelets::IContinuousWavelet &wavelet, const double samplingRate,
+    const RTSeis::ProcessingMode mode)
 {
     clear();
     if (nSamples < 1){throw std::invalid_argument("nSamples must be positive");}
@@ -320,22 +647,23 @@ void ContinuousWavelet<T>::initialize(
     {
         throw std::invalid_argument("Sampling rate must be positive");
     }
-    int ldx = padLength(nSamples, sizeof(std::complex<T>), 64);
-    auto num = static_cast<size_t> (ldx)*static_cast<size_t> (nScales);
-    if (pImpl->mDoublePrecision)
+    for (int i=0; i<nScales; ++i)
     {
-        pImpl->mCWT = mkl_calloc(num, sizeof(MKL_Complex16), 64);
-    }
-    else
-    {
-        pImpl->mCWT = mkl_calloc(num, sizeof(MKL_Complex8), 64);
+        if (scales[i] <= 0)
+        {
+            throw std::invalid_argument("scales[" + std::to_string(i)
+                                      + "] must be positive");
+        }
     }
     pImpl->mWavelet = wavelet.clone();
     pImpl->mScales.resize(nScales);
     std::copy(scales, scales + nScales, pImpl->mScales.data());
     pImpl->mSamplingRate = samplingRate;
     pImpl->mSamples = nSamples;
-    pImpl->mLeadingDimension = ldx;
+    pImpl->mMode = mode;
+    pImpl->createEngine();
+    pImpl->computeDecimationFactors(false);
+    pImpl->allocateStorage();
     pImpl->mHaveTransform = false;
     pImpl->mInitialized = true;
 }
@@ -346,6 +674,20 @@ void ContinuousWavelet<T>::transform(const int n, const T x[])
 {
     pImpl->mHaveTransform = false;
     int nSamples = getNumberOfSamples(); // Throws on initialized
+    if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
+    {
+        if (n < 0 || n > nSamples)
+        {
+            throw std::invalid_argument("Number of samples in x = "
+                                      + std::to_string(n)
+                                      + " must be in range [0,"
+                                      + std::to_string(nSamples) + "]");
+        }
+        if (n > 0 && x == nullptr){throw std::invalid_argument("x is NULL");}
+        pImpl->transformRealTime(n, x);
+        pImpl->mHaveTransform = true;
+        return;
+    }
     if (n != nSamples)
     {
         throw std::invalid_argument("Number of samples in x = "
@@ -354,18 +696,44 @@ void ContinuousWavelet<T>::transform(const int n, const T x[])
     }
     if (x == nullptr){throw std::invalid_argument("x is NULL");}
     // Do the work
-    auto nScales = getNumberOfScales();
-    auto cwt = reinterpret_cast<std::complex<T> *> (pImpl->mCWT);
-    auto dt = static_cast<T> (1./getSamplingRate());
-    int option = 0; // Let algorithm decide
-    auto error = convolve(nSamples, pImpl->mLeadingDimension, x, 
-                          nScales, pImpl->mScales.data(),
-                          *pImpl->mWavelet, cwt, option, dt);
-    if (error != 0)
+    pImpl->transform(x);
+    pImpl->mHaveTransform = true;
+}
+
+/// Reset the real-time stream
+template<class T>
+void ContinuousWavelet<T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->mHaveTransform = false;
+    if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
     {
-        throw std::runtime_error("Error computing CWT");
+        pImpl->resetInitialConditions();
     }
-    pImpl->mHaveTransform = true;
+}
+
+/// Processing mode
+template<class T>
+RTSeis::ProcessingMode ContinuousWavelet<T>::getProcessingMode() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mMode;
+}
+
+/// Latency
+template<class T>
+int ContinuousWavelet<T>::getLatency() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mHalfSupport;
+}
+
+/// Number of new columns
+template<class T>
+int ContinuousWavelet<T>::getNumberOfNewColumns() const
+{
+    if (!haveTransform()){throw std::runtime_error("CWT not yet computed");}
+    return pImpl->mNewColumns;
 }
 
 /// Number of samples
@@ -406,37 +774,199 @@ bool ContinuousWavelet<T>::haveTransform() const noexcept
     return pImpl->mHaveTransform;
 }
 
+/// Storage
+template<class T>
+void ContinuousWavelet<T>::setStorage(const ContinuousWaveletStorage storage,
+                                      const bool decimate)
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->mStorage = storage;
+    pImpl->computeDecimationFactors(decimate);
+    pImpl->allocateStorage();
+    pImpl->mHaveTransform = false;
+}
+
+template<class T>
+ContinuousWaveletStorage ContinuousWavelet<T>::getStorage() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mStorage;
+}
+
+/// Decimation factor
+template<class T>
+int ContinuousWavelet<T>::getDecimationFactor(const int iScale) const
+{
+    auto nScales = getNumberOfScales(); // Throws
+    if (iScale < 0 || iScale >= nScales)
+    {
+        throw std::invalid_argument("iScale = " + std::to_string(iScale)
+                                  + " must be in range [0,"
+                                  + std::to_string(nScales - 1) + "]");
+    }
+    return pImpl->mDecimation[iScale];
+}
+
+/// Row callback
+template<class T>
+void ContinuousWavelet<T>::setRowCallback(
+    const std::function<void (int, int, const std::complex<T> *)> &callback)
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->mCallback = callback;
+}
+
+template<class T>
+void ContinuousWavelet<T>::clearRowCallback() noexcept
+{
+    pImpl->mCallback = nullptr;
+}
+
+/// Number of columns in a row
+template<class T>
+int ContinuousWavelet<T>::getNumberOfColumns(const int iScale) const
+{
+    if (!haveTransform()){throw std::runtime_error("CWT not yet computed");}
+    auto nScales = getNumberOfScales();
+    if (iScale < 0 || iScale >= nScales)
+    {
+        throw std::invalid_argument("iScale = " + std::to_string(iScale)
+                                  + " must be in range [0,"
+                                  + std::to_string(nScales - 1) + "]");
+    }
+    return pImpl->mRowColumns[iScale];
+}
+
+/// Row pointers
+template<class T>
+const std::complex<T> *
+ContinuousWavelet<T>::getTransformRowPointer(const int iScale) const
+{
+    [[maybe_unused]] auto nColumns = getNumberOfColumns(iScale); // Throws
+    if (pImpl->mStorage != ContinuousWaveletStorage::COMPLEX)
+    {
+        throw std::runtime_error("Complex transform is not retained");
+    }
+    return static_cast<const std::complex<T> *> (pImpl->mCWT)
+         + pImpl->mRowOffsets[iScale];
+}
+
+template<class T>
+const float *ContinuousWavelet<T>::getAmplitudeRowPointer(
+    const int iScale) const
+{
+    [[maybe_unused]] auto nColumns = getNumberOfColumns(iScale); // Throws
+    if (pImpl->mStorage != ContinuousWaveletStorage::AMPLITUDE)
+    {
+        throw std::runtime_error("Amplitude is not retained");
+    }
+    return static_cast<const float *> (pImpl->mCWT)
+         + pImpl->mRowOffsets[iScale];
+}
+
+template<class T>
+const float *ContinuousWavelet<T>::getPowerRowPointer(const int iScale) const
+{
+    [[maybe_unused]] auto nColumns = getNumberOfColumns(iScale); // Throws
+    if (pImpl->mStorage != ContinuousWaveletStorage::POWER)
+    {
+        throw std::runtime_error("Power is not retained");
+    }
+    return static_cast<const float *> (pImpl->mCWT)
+         + pImpl->mRowOffsets[iScale];
+}
+
 /// Get the transform
 template<class T>
 void ContinuousWavelet<T>::getTransform(
     const int nSamples, const int nScales, std::complex<T> *cwtOut[]) const
 {
     if (!haveTransform()){throw std::runtime_error("CWT not yet computed");}
-    auto n = getNumberOfSamples();
-    auto ns = getNumberOfScales();
-    auto cwt = *cwtOut;
-    if (n != nSamples)
+    if (pImpl->mStorage != ContinuousWaveletStorage::COMPLEX)
     {
-        throw std::invalid_argument("nSamples = " + std::to_string(nSamples)
-                                  + " must equal " + std::to_string(n));
+        throw std::runtime_error("Complex transform is not retained");
     }
-    if (ns != nScales)
+    if (pImpl->isDecimated())
     {
-        throw std::invalid_argument("nScales = " + std::to_string(nScales)
-                                  + " must equal " + std::to_string(ns));
+        throw std::runtime_error("Transform is decimated - use row pointers");
     }
+    pImpl->checkMatrixDimensions(nSamples, nScales);
+    auto cwt = *cwtOut;
     if (cwt == nullptr){throw std::invalid_argument("cwt it NULL");}
-    auto ldx = pImpl->mLeadingDimension;
-    auto cwtPtr = reinterpret_cast<std::complex<T> *> (pImpl->mCWT);
-    for (int i=0; i<ns; ++i)
-    {
-        auto i1 = i*ldx; 
-        auto i2 = i*ldx + nSamples;
-        auto j1 = i*nSamples;
-        std::copy(cwtPtr + i1, cwtPtr + i2, cwt + j1);
+    for (int i=0; i<nScales; ++i)
+    {
+        auto cwtPtr = getTransformRowPointer(i);
+        std::copy(cwtPtr, cwtPtr + nSamples, cwt + i*nSamples);
     } 
 }
 
+/// Get the amplitude of the transform
+template<class T>
+void ContinuousWavelet<T>::getAmplitudeTransform(
+    const int nSamples, const int nScales, T *amplitudeOut[]) const
+{
+    if (!haveTransform()){throw std::runtime_error("CWT not yet computed");}
+    auto storage = pImpl->mStorage;
+    if (storage == ContinuousWaveletStorage::NONE)
+    {
+        throw std::runtime_error("Transform is not retained");
+    }
+    if (pImpl->isDecimated())
+    {
+        throw std::runtime_error("Transform is decimated - use row pointers");
+    }
+    pImpl->checkMatrixDimensions(nSamples, nScales);
+    auto amplitude = *amplitudeOut;
+    if (amplitude == nullptr){throw std::invalid_argument("amplitude is NULL");}
+    for (int i=0; i<nScales; ++i)
+    {
+        auto ampPtr = amplitude + i*nSamples;
+        if (storage == ContinuousWaveletStorage::COMPLEX)
+        {
+            auto cwtPtr = getTransformRowPointer(i);
+            for (int j=0; j<nSamples; ++j){ampPtr[j] = std::abs(cwtPtr[j]);}
+        }
+        else if (storage == ContinuousWaveletStorage::AMPLITUDE)
+        {
+            auto rowPtr = getAmplitudeRowPointer(i);
+            std::copy(rowPtr, rowPtr + nSamples, ampPtr);
+        }
+        else
+        {
+            auto rowPtr = getPowerRowPointer(i);
+            for (int j=0; j<nSamples; ++j)
+            {
+                ampPtr[j] = std::sqrt(static_cast<T> (rowPtr[j]));
+            }
+        }
+    }
+}
+
+/// Get the phase of the transform
+template<class T>
+void ContinuousWavelet<T>::getPhaseTransform(
+    const int nSamples, const int nScales, T *phaseOut[]) const
+{
+    if (!haveTransform()){throw std::runtime_error("CWT not yet computed");}
+    if (pImpl->mStorage != ContinuousWaveletStorage::COMPLEX)
+    {
+        throw std::runtime_error("Complex transform is not retained");
+    }
+    if (pImpl->isDecimated())
+    {
+        throw std::runtime_error("Transform is decimated - use row pointers");
+    }
+    pImpl->checkMatrixDimensions(nSamples, nScales);
+    auto phase = *phaseOut;
+    if (phase == nullptr){throw std::invalid_argument("phase is NULL");}
+    for (int i=0; i<nScales; ++i)
+    {
+        auto cwtPtr = getTransformRowPointer(i);
+        auto phasePtr = phase + i*nSamples;
+        for (int j=0; j<nSamples; ++j){phasePtr[j] = std::arg(cwtPtr[j]);}
+    }
+}
+
 ///--------------------------------------------------------------------------///
 ///                          Template Instantiation                          ///
 ///--------------------------------------------------------------------------///
@@ -7,8 +7,10 @@
 #define RTSEIS_LOGGING 1
 #include "private/throw.hpp"
 #include "rtseis/utilities/transforms/enums.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
 #include "rtseis/utilities/transforms/dft.hpp"
 #include "rtseis/log.h"
+#include "private/dftPlanCache.hpp"
 
 using namespace RTSeis::Utilities::Transforms;
 
@@ -28,7 +30,7 @@ public:
     {
         clear();
     }
-    /// (Deep) copy operator
+    /// Copy operator.  The plan is shared with dft.
     DFTImpl& operator=(const DFTImpl &dft)
     {
         if (&dft == this){return *this;}
@@ -41,41 +43,6 @@ public:
             clear();
             return *this;
         }
-        if (specSize_ > 0)
-        {
-            Ipp8u *pIn = nullptr;
-            Ipp8u *pOut = nullptr;
-            if (ldoFFT_)
-            {
-                if (precision_ == RTSeis::Precision::DOUBLE)
-                {
-                    pIn  = reinterpret_cast<Ipp8u *> (dft.pFFTSpec64_);
-                    pOut = reinterpret_cast<Ipp8u *> (pFFTSpec64_);
-                    ippsCopy_8u(pIn, pOut, specSize_);
-                }
-                else
-                {
-                    pIn  = reinterpret_cast<Ipp8u *> (dft.pFFTSpec32_);
-                    pOut = reinterpret_cast<Ipp8u *> (pFFTSpec32_);
-                    ippsCopy_8u(pIn, pOut, specSize_);
-                }
-            }
-            else
-            {
-                if (precision_ == RTSeis::Precision::DOUBLE)
-                {
-                    pIn  = reinterpret_cast<Ipp8u *> (dft.pDFTSpec64_);
-                    pOut = reinterpret_cast<Ipp8u *> (pDFTSpec64_);
-                    ippsCopy_8u(pIn, pOut, specSize_);
-                }
-                else
-                {
-                    pIn  = reinterpret_cast<Ipp8u *> (dft.pDFTSpec32_);
-                    pOut = reinterpret_cast<Ipp8u *> (pDFTSpec32_);
-                    ippsCopy_8u(pIn, pOut, specSize_);
-                }
-            }
-        }
         if (bufferSize_ > 0)
         {
             ippsCopy_8u(dft.pBuf_, pBuf_, bufferSize_);
@@ -99,10 +66,6 @@ public:
     /// Releases memory on the module
     void clear()
     {
-        if (pFFTSpec64_ != nullptr){ippsFree(pFFTSpec64_);}
-        if (pDFTSpec64_ != nullptr){ippsFree(pDFTSpec64_);}
-        if (pFFTSpec32_ != nullptr){ippsFree(pFFTSpec32_);}
-        if (pDFTSpec32_ != nullptr){ippsFree(pDFTSpec32_);}
         if (pBuf_ != nullptr){ippsFree(pBuf_);}
         if (work64fc_ != nullptr){ippsFree(work64fc_);}
         if (work32fc_ != nullptr){ippsFree(work32fc_);}
@@ -110,6 +73,7 @@ public:
         pDFTSpec64_ = nullptr;
         pFFTSpec32_ = nullptr;
         pDFTSpec32_ = nullptr;
+        mPlan = nullptr;
         pBuf_ = nullptr;
         work64fc_ = nullptr;
         work32fc_ = nullptr;
@@ -117,7 +81,6 @@ public:
         lenft_ = 0;
         nwork_ = 0;
         bufferSize_ = 0;
-        specSize_ = 0;
         order_ = 0;
         precision_ = RTSeis::Precision::DOUBLE;
         ldoFFT_ = false;
@@ -129,106 +92,44 @@ public:
                    const RTSeis::Precision precision)
     {
         clear();
-        // Decide between DFT and FFT
+        // Pad to the next length whose prime factors are 2, 3, 5, and 7
         order_ =-1;
         length_ = length;
+        if (ldoFFT){length_ = DFTUtilities::nextFastLength(length);}
+        // Powers of 2 use the radix-2 FFT.  Otherwise, the DFT.
         double dlen = static_cast<double> (length_);
         int orderWork = static_cast<int> (std::round(std::log2(dlen)));
         int n2 = static_cast<int> (std::pow(2, orderWork));
-        if (ldoFFT || n2 == length)
+        if (n2 == length_)
         {
-            // Forcing the FFT
-            if (n2 != length)
-            {
-                // Pad 
-                if (n2 < length)
-                {
-                    orderWork = orderWork + 1;
-                    n2 = static_cast<int> (std::pow(2, orderWork));
-                }
-                if (n2 < length)
-                {
-                    RTSEIS_ERRMSG("%s", "Algorithmic failure");
-                    clear();
-                    return -1;
-                }
-            }
             ldoFFT_ = true;
             order_ = orderWork;
-            length_ = n2;
         }
         lenft_ = length_;
         nwork_ = 2*lenft_;
-        // Initialize the appropriate transform
-        IppStatus status;
-        int sizeInit;
+        // Get the transform from the plan cache
+        mPlan = DFTPlanCache::getPlan(DFTPlanCache::Domain::COMPLEX,
+                                      length_, ldoFFT_, precision);
+        if (mPlan == nullptr)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to initialize transform");
+            clear();
+            return -1;
+        }
+        bufferSize_ = mPlan->getBufferSize();
+        if (bufferSize_ > 0){pBuf_ = ippsMalloc_8u(bufferSize_);}
         if (precision == RTSeis::Precision::DOUBLE)
         {
             if (ldoFFT_)
             {
-                status = ippsFFTGetSize_C_64fc(order_,
-                                               IPP_FFT_DIV_INV_BY_N,
-                                               ippAlgHintNone,
-                                               &specSize_,
-                                               &sizeInit,
-                                               &bufferSize_);
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to get buffer sizes");
-                    clear();
-                    return -1;
-                }
-                pFFTSpec64_ = nullptr;
-                Ipp8u *pSpecBuffer = ippsMalloc_8u(sizeInit);
-                Ipp8u *pSpec = ippsMalloc_8u(specSize_);
-                status = ippsFFTInit_C_64fc(&pFFTSpec64_,
-                                            order_,
-                                            IPP_FFT_DIV_INV_BY_N,
-                                            ippAlgHintNone,
-                                            pSpec,
-                                            pSpecBuffer);
-                if (pSpecBuffer){ippsFree(pSpecBuffer);}
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to initialize FFT");
-                    ippsFree(pSpec);
-                    clear();
-                    return -1; 
-                }
-                pBuf_ = ippsMalloc_8u(bufferSize_);
+                pFFTSpec64_
+                    = mPlan->getSpecification<IppsFFTSpec_C_64fc> ();
             }
-            // DFT
             else
             {
-                status = ippsDFTGetSize_C_64fc(length_,
-                                               IPP_FFT_DIV_INV_BY_N,
-                                               ippAlgHintNone,
-                                               &specSize_,
-                                               &sizeInit,
-                                               &bufferSize_);
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to get buffer sizes");
-                    clear();
-                    return -1;
-                }
-                Ipp8u *pSpecBuffer = ippsMalloc_8u(sizeInit);
-                pDFTSpec64_ = reinterpret_cast<IppsDFTSpec_C_64fc *>
-                                              (ippsMalloc_8u(specSize_));
-                status = ippsDFTInit_C_64fc(length_,
-                                            IPP_FFT_DIV_INV_BY_N,
-                                            ippAlgHintNone,
-                                            pDFTSpec64_,
-                                            pSpecBuffer);
-                if (pSpecBuffer){ippsFree(pSpecBuffer);}
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to initialize DFT");
-                    clear();
-                    return -1;
-                }
-                pBuf_ = ippsMalloc_8u(bufferSize_);
-            } // End DFT/FFT check
+                pDFTSpec64_
+                    = mPlan->getSpecification<IppsDFTSpec_C_64fc> ();
+            }
             work64fc_ = ippsMalloc_64fc(nwork_);
             ippsZero_64fc(work64fc_, nwork_);
         }
@@ -237,72 +138,17 @@ public:
         {
             if (ldoFFT_)
             {
-                status = ippsFFTGetSize_C_32fc(order_,
-                                               IPP_FFT_DIV_INV_BY_N,
-                                               ippAlgHintNone,
-                                               &specSize_,
-                                               &sizeInit,
-                                               &bufferSize_);
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to get buffer sizes");
-                    clear();
-                    return -1; 
-                }
-                pFFTSpec32_ = nullptr;
-                Ipp8u *pSpecBuffer = ippsMalloc_8u(sizeInit);
-                Ipp8u *pSpec = ippsMalloc_8u(specSize_);
-                status = ippsFFTInit_C_32fc(&pFFTSpec32_,
-                                            order_,
-                                            IPP_FFT_DIV_INV_BY_N,
-                                            ippAlgHintNone,
-                                            pSpec,
-                                            pSpecBuffer);
-                if (pSpecBuffer){ippsFree(pSpecBuffer);}
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to initialize FFT");
-                    ippsFree(pSpec);
-                    clear();
-                    return -1; 
-                }
-                pBuf_ = ippsMalloc_8u(bufferSize_);
+                pFFTSpec32_
+                    = mPlan->getSpecification<IppsFFTSpec_C_32fc> ();
             }
-            // DFT
             else
             {
-                status = ippsDFTGetSize_C_32fc(length_,
-                                               IPP_FFT_DIV_INV_BY_N,
-                                               ippAlgHintNone,
-                                               &specSize_,
-                                               &sizeInit,
-                                               &bufferSize_);
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to get buffer sizes");
-                    clear();
-                    return -1; 
-                }
-                Ipp8u *pSpecBuffer = ippsMalloc_8u(sizeInit);
-                pDFTSpec32_ = reinterpret_cast<IppsDFTSpec_C_32fc *>
-                                              (ippsMalloc_8u(specSize_));
-                status = ippsDFTInit_C_32fc(length_,
-                                            IPP_FFT_DIV_INV_BY_N,
-                                            ippAlgHintNone,
-                                            pDFTSpec32_,
-                                            pSpecBuffer);
-                if (pSpecBuffer){ippsFree(pSpecBuffer);}
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to initialize DFT");
-                    clear();
-                    return -1;
-                }
-                pBuf_ = ippsMalloc_8u(bufferSize_);
-            } // End DFT/FFT check
+                pDFTSpec32_
+                    = mPlan->getSpecification<IppsDFTSpec_C_32fc> ();
+            }
             work32fc_ = ippsMalloc_32fc(nwork_);
             ippsZero_32fc(work32fc_, nwork_);
-        } // End check on precision
+        }
         precision_ = precision;
         linit_ = true;
         return 0;
@@ -611,17 +457,19 @@ public:
     }
 private:
     /// State structure for double FFT
-    IppsFFTSpec_C_64fc *pFFTSpec64_ = nullptr;
+    const IppsFFTSpec_C_64fc *pFFTSpec64_ = nullptr;
     /// State structure for double DFT
-    IppsDFTSpec_C_64fc *pDFTSpec64_ = nullptr;
+    const IppsDFTSpec_C_64fc *pDFTSpec64_ = nullptr;
     /// Workspace for input signals.  This has dimension [nwork_].
     Ipp64fc *work64fc_ = nullptr;
     /// State structure for double FFT
-    IppsFFTSpec_C_32fc *pFFTSpec32_ = nullptr;
+    const IppsFFTSpec_C_32fc *pFFTSpec32_ = nullptr;
     /// State structure for float FFT
-    IppsDFTSpec_C_32fc *pDFTSpec32_ = nullptr; 
+    const IppsDFTSpec_C_32fc *pDFTSpec32_ = nullptr;
     /// Workspace for input signals.  This has dimension [nwork_].
     Ipp32fc *work32fc_ = nullptr;
+    /// The shared FFT or DFT plan.  The specifications point into this.
+    std::shared_ptr<const DFTPlanCache::Plan> mPlan;
     /// Workspace for DFT or FFT
     Ipp8u *pBuf_ = nullptr;
     /// The maximum length of the input signal.
@@ -633,8 +481,6 @@ private:
     int nwork_ = 0;
     /// The length of the DFT/FFT buffer.
     int bufferSize_ = 0;
-    /// The length of the DFT/FFT pointer.
-    int specSize_ = 0;
     /// Specified length of FFT is 2**order.
     int order_ = 0;
     /// Precision of module.
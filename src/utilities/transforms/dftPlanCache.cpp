@@ -0,0 +1,288 @@
+#include <map>
+#include <list>
+#include <tuple>
+#include <mutex>
+#include <cmath>
+#include <memory>
+#include <ipps.h>
+#include "rtseis/utilities/transforms/dftPlanCache.hpp"
+#include "private/dftPlanCache.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+
+/// (domain, length, FFT or DFT, precision, normalization)
+using PlanKey = std::tuple<int, int, bool, int, int>;
+/// The number of most recently requested plans that are kept alive after
+/// their last transform is destroyed.
+constexpr int MAX_RETAINED_PLANS = 8;
+
+/// The process-wide plan registry.  The table does not own the plans; a
+/// plan is destroyed with its last transform, unless it is one of the most
+/// recently requested plans, and its entry is then expired.
+class PlanTable
+{
+public:
+    /// Marks the plan as the most recently requested.  The least recently
+    /// requested plan beyond MAX_RETAINED_PLANS is let go.
+    void retain(const std::shared_ptr<const DFTPlanCache::Plan> &plan)
+    {
+        for (auto it = mRecent.begin(); it != mRecent.end(); ++it)
+        {
+            if (*it == plan)
+            {
+                mRecent.splice(mRecent.begin(), mRecent, it);
+                return;
+            }
+        }
+        mRecent.push_front(plan);
+        if (static_cast<int> (mRecent.size()) > MAX_RETAINED_PLANS)
+        {
+            mRecent.pop_back();
+        }
+    }
+    /// Lets go of the retained plans that no transform is using.
+    void releaseRetained()
+    {
+        mRecent.remove_if([](const auto &plan)
+                          {
+                              return plan.use_count() == 1;
+                          });
+    }
+    /// Removes the entries whose plans have been destroyed.
+    /// @result The number of entries removed.
+    int purge()
+    {
+        int nRemoved = 0;
+        for (auto it = mTable.begin(); it != mTable.end();)
+        {
+            if (it->second.expired())
+            {
+                it = mTable.erase(it);
+                nRemoved = nRemoved + 1;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        return nRemoved;
+    }
+    std::map<PlanKey, std::weak_ptr<const DFTPlanCache::Plan>> mTable;
+    /// Strong references to the most recently requested plans.  The front
+    /// is the most recent.
+    std::list<std::shared_ptr<const DFTPlanCache::Plan>> mRecent;
+    std::mutex mMutex;
+};
+
+PlanTable &getTable()
+{
+    static PlanTable table;
+    return table;
+}
+
+/// Initializes the IPP specification.
+int createPlan(const DFTPlanCache::Domain domain,
+               const int length, const bool ldoFFT,
+               const RTSeis::Precision precision,
+               const int normalization,
+               DFTPlanCache::Plan *plan)
+{
+    bool lreal = (domain == DFTPlanCache::Domain::REAL);
+    bool ldouble = (precision == RTSeis::Precision::DOUBLE);
+    auto order = static_cast<int> (std::round(std::log2(length)));
+    int specSize = 0;
+    int sizeInit = 0;
+    int bufferSize = 0;
+    IppStatus status;
+    // Get the sizes
+    if (ldoFFT)
+    {
+        if (lreal && ldouble)
+        {
+            status = ippsFFTGetSize_R_64f(order, normalization, ippAlgHintNone,
+                                          &specSize, &sizeInit, &bufferSize);
+        }
+        else if (lreal)
+        {
+            status = ippsFFTGetSize_R_32f(order, normalization, ippAlgHintNone,
+                                          &specSize, &sizeInit, &bufferSize);
+        }
+        else if (ldouble)
+        {
+            status = ippsFFTGetSize_C_64fc(order, normalization,
+                                           ippAlgHintNone,
+                                           &specSize, &sizeInit, &bufferSize);
+        }
+        else
+        {
+            status = ippsFFTGetSize_C_32fc(order, normalization,
+                                           ippAlgHintNone,
+                                           &specSize, &sizeInit, &bufferSize);
+        }
+    }
+    else
+    {
+        if (lreal && ldouble)
+        {
+            status = ippsDFTGetSize_R_64f(length, normalization,
+                                          ippAlgHintNone,
+                                          &specSize, &sizeInit, &bufferSize);
+        }
+        else if (lreal)
+        {
+            status = ippsDFTGetSize_R_32f(length, normalization,
+                                          ippAlgHintNone,
+                                          &specSize, &sizeInit, &bufferSize);
+        }
+        else if (ldouble)
+        {
+            status = ippsDFTGetSize_C_64fc(length, normalization,
+                                           ippAlgHintNone,
+                                           &specSize, &sizeInit, &bufferSize);
+        }
+        else
+        {
+            status = ippsDFTGetSize_C_32fc(length, normalization,
+                                           ippAlgHintNone,
+                                           &specSize, &sizeInit, &bufferSize);
+        }
+    }
+    if (status != ippStsNoErr){return -1;}
+    // Initialize
+    plan->mMemory = ippsMalloc_8u(specSize);
+    Ipp8u *pSpecBuffer = nullptr;
+    if (sizeInit > 0){pSpecBuffer = ippsMalloc_8u(sizeInit);}
+    auto pSpec = plan->mMemory;
+    if (ldoFFT)
+    {
+        if (lreal && ldouble)
+        {
+            IppsFFTSpec_R_64f *spec = nullptr;
+            status = ippsFFTInit_R_64f(&spec, order, normalization,
+                                       ippAlgHintNone, pSpec, pSpecBuffer);
+            plan->mSpec = spec;
+        }
+        else if (lreal)
+        {
+            IppsFFTSpec_R_32f *spec = nullptr;
+            status = ippsFFTInit_R_32f(&spec, order, normalization,
+                                       ippAlgHintNone, pSpec, pSpecBuffer);
+            plan->mSpec = spec;
+        }
+        else if (ldouble)
+        {
+            IppsFFTSpec_C_64fc *spec = nullptr;
+            status = ippsFFTInit_C_64fc(&spec, order, normalization,
+                                        ippAlgHintNone, pSpec, pSpecBuffer);
+            plan->mSpec = spec;
+        }
+        else
+        {
+            IppsFFTSpec_C_32fc *spec = nullptr;
+            status = ippsFFTInit_C_32fc(&spec, order, normalization,
+                                        ippAlgHintNone, pSpec, pSpecBuffer);
+            plan->mSpec = spec;
+        }
+    }
+    else
+    {
+        if (lreal && ldouble)
+        {
+            auto spec = reinterpret_cast<IppsDFTSpec_R_64f *> (pSpec);
+            status = ippsDFTInit_R_64f(length, normalization, ippAlgHintNone,
+                                       spec, pSpecBuffer);
+            plan->mSpec = spec;
+        }
+        else if (lreal)
+        {
+            auto spec = reinterpret_cast<IppsDFTSpec_R_32f *> (pSpec);
+            status = ippsDFTInit_R_32f(length, normalization, ippAlgHintNone,
+                                       spec, pSpecBuffer);
+            plan->mSpec = spec;
+        }
+        else if (ldouble)
+        {
+            auto spec = reinterpret_cast<IppsDFTSpec_C_64fc *> (pSpec);
+            status = ippsDFTInit_C_64fc(length, normalization, ippAlgHintNone,
+                                        spec, pSpecBuffer);
+            plan->mSpec = spec;
+        }
+        else
+        {
+            auto spec = reinterpret_cast<IppsDFTSpec_C_32fc *> (pSpec);
+            status = ippsDFTInit_C_32fc(length, normalization, ippAlgHintNone,
+                                        spec, pSpecBuffer);
+            plan->mSpec = spec;
+        }
+    }
+    if (pSpecBuffer != nullptr){ippsFree(pSpecBuffer);}
+    if (status != ippStsNoErr){return -1;}
+    plan->mBufferSize = bufferSize;
+    return 0;
+}
+
+}
+
+/// Gets or creates a plan
+std::shared_ptr<const DFTPlanCache::Plan>
+DFTPlanCache::getPlan(const Domain domain, const int length,
+                      const bool ldoFFT, const RTSeis::Precision precision,
+                      const int normalization)
+{
+    if (length < 1){return nullptr;}
+    PlanKey key(static_cast<int> (domain), length, ldoFFT,
+                static_cast<int> (precision), normalization);
+    auto &table = getTable();
+    // Plans are created under the lock so that two threads asking for the
+    // same key do not both build it
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    auto entry = table.mTable.find(key);
+    if (entry != table.mTable.end())
+    {
+        auto plan = entry->second.lock();
+        if (plan)
+        {
+            table.retain(plan);
+            return plan;
+        }
+    }
+    auto plan = std::make_shared<Plan> ();
+    if (createPlan(domain, length, ldoFFT, precision, normalization,
+                   plan.get()) != 0)
+    {
+        return nullptr;
+    }
+    // Drop the entries of destroyed plans so the table is bounded by the
+    // number of live plans
+    table.purge();
+    table.mTable.insert_or_assign(key, plan);
+    table.retain(plan);
+    return plan;
+}
+
+/// Number of plans
+int DFTPlanCache::getNumberOfPlans() noexcept
+{
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    table.purge();
+    return static_cast<int> (table.mTable.size());
+}
+
+/// Releases the plans no longer used by any transform
+int DFTPlanCache::releaseUnusedPlans() noexcept
+{
+    auto &table = getTable();
+    std::lock_guard<std::mutex> lock(table.mMutex);
+    table.releaseRetained();
+    return table.purge();
+}
+
+/// Maximum number of retained plans
+int DFTPlanCache::getMaximumNumberOfRetainedPlans() noexcept
+{
+    return MAX_RETAINED_PLANS;
+}
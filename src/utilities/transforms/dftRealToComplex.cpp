@@ -5,8 +5,10 @@
 #define RTSEIS_LOGGING 1
 #include "private/throw.hpp"
 #include "rtseis/utilities/transforms/enums.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
 #include "rtseis/utilities/transforms/dftRealToComplex.hpp"
 #include "rtseis/log.h"
+#include "private/dftPlanCache.hpp"
 #include <ipps.h>
 
 using namespace RTSeis::Utilities::Transforms;
@@ -27,7 +29,7 @@ public:
     {
         clear();
     }
-    /// (Deep) copy operator
+    /// Copy operator.  The plan is shared with dftr2c.
     DFTImpl& operator=(const DFTImpl &dftr2c)
     {
         if (&dftr2c == this){return *this;}
@@ -40,41 +42,6 @@ public:
             clear();
             return *this;
         }
-        if (specSize_ > 0)
-        {
-            Ipp8u *pIn = nullptr;
-            Ipp8u *pOut = nullptr;
-            if (ldoFFT_)
-            {
-                if (precision_ == RTSeis::Precision::DOUBLE)
-                {
-                    pIn  = reinterpret_cast<Ipp8u *> (dftr2c.pFFTSpec64_);
-                    pOut = reinterpret_cast<Ipp8u *> (pFFTSpec64_);
-                    ippsCopy_8u(pIn, pOut, specSize_);
-                }
-                else
-                {
-                    pIn  = reinterpret_cast<Ipp8u *> (dftr2c.pFFTSpec32_);
-                    pOut = reinterpret_cast<Ipp8u *> (pFFTSpec32_);
-                    ippsCopy_8u(pIn, pOut, specSize_);
-                }
-            }
-            else
-            {
-                if (precision_ == RTSeis::Precision::DOUBLE)
-                {
-                    pIn  = reinterpret_cast<Ipp8u *> (dftr2c.pDFTSpec64_);
-                    pOut = reinterpret_cast<Ipp8u *> (pDFTSpec64_);
-                    ippsCopy_8u(pIn, pOut, specSize_);
-                }
-                else
-                {
-                    pIn  = reinterpret_cast<Ipp8u *> (dftr2c.pDFTSpec32_);
-                    pOut = reinterpret_cast<Ipp8u *> (pDFTSpec32_);
-                    ippsCopy_8u(pIn, pOut, specSize_);
-                }
-            }
-        }
         if (bufferSize_ > 0)
         {
             ippsCopy_8u(dftr2c.pBuf_, pBuf_, bufferSize_);
@@ -98,10 +65,6 @@ public:
     /// Releases memory on the module
     void clear()
     {
-        if (pFFTSpec64_ != nullptr){ippsFree(pFFTSpec64_);}
-        if (pDFTSpec64_ != nullptr){ippsFree(pDFTSpec64_);}
-        if (pFFTSpec32_ != nullptr){ippsFree(pFFTSpec32_);}
-        if (pDFTSpec32_ != nullptr){ippsFree(pDFTSpec32_);}
         if (pBuf_ != nullptr){ippsFree(pBuf_);}
         if (work64f_ != nullptr){ippsFree(work64f_);}
         if (work32f_ != nullptr){ippsFree(work32f_);}
@@ -109,6 +72,7 @@ public:
         pDFTSpec64_ = nullptr;
         pFFTSpec32_ = nullptr;
         pDFTSpec32_ = nullptr;
+        mPlan = nullptr;
         pBuf_ = nullptr;
         work64f_ = nullptr;
         work32f_ = nullptr;
@@ -116,7 +80,6 @@ public:
         lenft_ = 0;
         nwork_ = 0;
         bufferSize_ = 0;
-        specSize_ = 0;
         order_ = 0;
         precision_ = RTSeis::Precision::DOUBLE;
         ldoFFT_ = false;
@@ -129,106 +92,44 @@ public:
                    const RTSeis::Precision precision)
     {
         clear();
-        // Decide between DFT and FFT
+        // Pad to the next length whose prime factors are 2, 3, 5, and 7
         order_ =-1;
         length_ = length;
+        if (ldoFFT){length_ = DFTUtilities::nextFastLength(length);}
+        // Powers of 2 use the radix-2 FFT.  Otherwise, the DFT.
         double dlen = static_cast<double> (length_);
         int orderWork = static_cast<int> (std::round(std::log2(dlen)));
         int n2 = static_cast<int> (std::pow(2, orderWork));
-        if (ldoFFT || n2 == length)
+        if (n2 == length_)
         {
-            // Forcing the FFT
-            if (n2 != length)
-            {
-                // Pad 
-                if (n2 < length)
-                {
-                    orderWork = orderWork + 1;
-                    n2 = static_cast<int> (std::pow(2, orderWork));
-                }
-                if (n2 < length)
-                {
-                    RTSEIS_ERRMSG("%s", "Algorithmic failure");
-                    clear();
-                    return -1;
-                }
-            }
             ldoFFT_ = true;
             order_ = orderWork;
-            length_ = n2;
         }
         lenft_ = length_/2 + 1;
         nwork_ = std::max(length_, 2*lenft_);
-        // Initialize the appropriate transform
-        IppStatus status;
-        int sizeInit;
+        // Get the transform from the plan cache
+        mPlan = DFTPlanCache::getPlan(DFTPlanCache::Domain::REAL,
+                                      length_, ldoFFT_, precision);
+        if (mPlan == nullptr)
+        {
+            RTSEIS_ERRMSG("%s", "Failed to initialize transform");
+            clear();
+            return -1;
+        }
+        bufferSize_ = mPlan->getBufferSize();
+        if (bufferSize_ > 0){pBuf_ = ippsMalloc_8u(bufferSize_);}
         if (precision == RTSeis::Precision::DOUBLE)
         {
             if (ldoFFT_)
             {
-                status = ippsFFTGetSize_R_64f(order_,
-                                              IPP_FFT_DIV_INV_BY_N,
-                                              ippAlgHintNone,
-                                              &specSize_,
-                                              &sizeInit,
-                                              &bufferSize_);
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to get buffer sizes");
-                    clear();
-                    return -1;
-                }
-                pFFTSpec64_ = nullptr;
-                Ipp8u *pSpecBuffer = ippsMalloc_8u(sizeInit);
-                Ipp8u *pSpec = ippsMalloc_8u(specSize_);
-                status = ippsFFTInit_R_64f(&pFFTSpec64_,
-                                           order_,
-                                           IPP_FFT_DIV_INV_BY_N,
-                                           ippAlgHintNone,
-                                           pSpec,
-                                           pSpecBuffer);
-                if (pSpecBuffer){ippsFree(pSpecBuffer);}
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to initialize FFT");
-                    ippsFree(pSpec);
-                    clear();
-                    return -1; 
-                }
-                pBuf_ = ippsMalloc_8u(bufferSize_);
+                pFFTSpec64_
+                    = mPlan->getSpecification<IppsFFTSpec_R_64f> ();
             }
-            // DFT
             else
             {
-                status = ippsDFTGetSize_R_64f(length_,
-                                              IPP_FFT_DIV_INV_BY_N,
-                                              ippAlgHintNone,
-                                              &specSize_,
-                                              &sizeInit,
-                                              &bufferSize_);
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to get buffer sizes");
-                    clear();
-                    return -1;
-                }
-                Ipp8u *pSpecBuffer = ippsMalloc_8u(sizeInit);
-                pDFTSpec64_ = reinterpret_cast<IppsDFTSpec_R_64f *>
-                                              (ippsMalloc_8u(specSize_));
-                status = ippsDFTInit_R_64f(length_,
-                                           IPP_FFT_DIV_INV_BY_N,
-                                           ippAlgHintNone,
-                                           pDFTSpec64_,
-                                           pSpecBuffer);
-                if (pSpecBuffer){ippsFree(pSpecBuffer);}
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to initialize DFT");
-                    clear();
-                    return -1;
-                }
-                pBuf_ = ippsMalloc_8u(bufferSize_);
-            } // End DFT/FFT check
+                pDFTSpec64_
+                    = mPlan->getSpecification<IppsDFTSpec_R_64f> ();
+            }
             work64f_ = ippsMalloc_64f(nwork_);
             ippsZero_64f(work64f_, nwork_);
         }
@@ -237,72 +138,17 @@ public:
         {
             if (ldoFFT_)
             {
-                status = ippsFFTGetSize_R_32f(order_,
-                                              IPP_FFT_DIV_INV_BY_N,
-                                              ippAlgHintNone,
-                                              &specSize_,
-                                              &sizeInit,
-                                              &bufferSize_);
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to get buffer sizes");
-                    clear();
-                    return -1; 
-                }
-                pFFTSpec32_ = nullptr;
-                Ipp8u *pSpecBuffer = ippsMalloc_8u(sizeInit);
-                Ipp8u *pSpec = ippsMalloc_8u(specSize_);
-                status = ippsFFTInit_R_32f(&pFFTSpec32_,
-                                           order_,
-                                           IPP_FFT_DIV_INV_BY_N,
-                                           ippAlgHintNone,
-                                           pSpec,
-                                           pSpecBuffer);
-                if (pSpecBuffer){ippsFree(pSpecBuffer);}
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to initialize FFT");
-                    ippsFree(pSpec);
-                    clear();
-                    return -1; 
-                }
-                pBuf_ = ippsMalloc_8u(bufferSize_);
+                pFFTSpec32_
+                    = mPlan->getSpecification<IppsFFTSpec_R_32f> ();
             }
-            // DFT
             else
             {
-                status = ippsDFTGetSize_R_32f(length_,
-                                              IPP_FFT_DIV_INV_BY_N,
-                                              ippAlgHintNone,
-                                              &specSize_,
-                                              &sizeInit,
-                                              &bufferSize_);
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to get buffer sizes");
-                    clear();
-                    return -1; 
-                }
-                Ipp8u *pSpecBuffer = ippsMalloc_8u(sizeInit);
-                pDFTSpec32_ = reinterpret_cast<IppsDFTSpec_R_32f *>
-                                              (ippsMalloc_8u(specSize_));
-                status = ippsDFTInit_R_32f(length_,
-                                           IPP_FFT_DIV_INV_BY_N,
-                                           ippAlgHintNone,
-                                           pDFTSpec32_,
-                                           pSpecBuffer);
-                if (pSpecBuffer){ippsFree(pSpecBuffer);}
-                if (status != ippStsNoErr)
-                {
-                    RTSEIS_ERRMSG("%s", "Failed to initialize DFT");
-                    clear();
-                    return -1;
-                }
-                pBuf_ = ippsMalloc_8u(bufferSize_);
-            } // End DFT/FFT check
+                pDFTSpec32_
+                    = mPlan->getSpecification<IppsDFTSpec_R_32f> ();
+            }
             work32f_ = ippsMalloc_32f(nwork_);
             ippsZero_32f(work32f_, nwork_);
-        } // End check on precision
+        }
         precision_ = precision;
         linit_ = true;
         return 0;
@@ -611,17 +457,19 @@ public:
     }
 private:
     /// State structure for double FFT
-    IppsFFTSpec_R_64f *pFFTSpec64_ = nullptr;
+    const IppsFFTSpec_R_64f *pFFTSpec64_ = nullptr;
     /// State structure for double DFT
-    IppsDFTSpec_R_64f *pDFTSpec64_ = nullptr;
+    const IppsDFTSpec_R_64f *pDFTSpec64_ = nullptr;
     /// Workspace for input signals.  This has dimension [nwork_].
     Ipp64f *work64f_ = nullptr;
     /// State structure for double FFT
-    IppsFFTSpec_R_32f *pFFTSpec32_ = nullptr;
+    const IppsFFTSpec_R_32f *pFFTSpec32_ = nullptr;
     /// State structure for float FFT
-    IppsDFTSpec_R_32f *pDFTSpec32_ = nullptr; 
+    const IppsDFTSpec_R_32f *pDFTSpec32_ = nullptr;
     /// Workspace for input signals.  This has dimension [nwork_].
     Ipp32f *work32f_ = nullptr;
+    /// The shared FFT or DFT plan.  The specifications point into this.
+    std::shared_ptr<const DFTPlanCache::Plan> mPlan;
     /// Workspace for DFT or FFT
     Ipp8u *pBuf_ = nullptr;
     /// The maximum length of the input signal.
@@ -633,8 +481,6 @@ private:
     int nwork_ = 0;
     /// The length of the DFT/FFT buffer.
     int bufferSize_ = 0;
-    /// The length of the DFT/FFT pointer.
-    int specSize_ = 0;
     /// Specified length of FFT is 2**order.
     int order_ = 0;
     /// Precision of module.
@@ -284,6 +284,33 @@ int DFTUtilities::nextPowerOfTwo(const int n)
     return n2;
 }
 
+/// Next 2, 3, 5, 7-smooth number
+int DFTUtilities::nextFastLength(const int n)
+{
+    if (n < 0)
+    {
+        RTSEIS_THROW_IA("n=%d must be positive", n);
+    }
+    if (n <= 1){return 1;}
+    // For every product of powers of 3, 5, and 7 less than the best length
+    // find the smallest power of 2 that brings the product to at least n
+    auto target = static_cast<int64_t> (n);
+    int64_t best = static_cast<int64_t> (nextPowerOfTwo(n));
+    for (int64_t p7 = 1; p7 < best; p7 = 7*p7)
+    {
+        for (int64_t p57 = p7; p57 < best; p57 = 5*p57)
+        {
+            for (int64_t p357 = p57; p357 < best; p357 = 3*p357)
+            {
+                auto length = p357;
+                while (length < target){length = 2*length;}
+                best = std::min(best, length);
+            }
+        }
+    }
+    return static_cast<int> (best);
+}
+
 /// fftshift
 template<typename T> std::vector<T> 
 RTSeis::Utilities::Transforms::DFTUtilities::fftShift(const std::vector<T> &x)
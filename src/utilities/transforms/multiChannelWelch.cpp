@@ -0,0 +1,416 @@
+#include <cstdio>
+#include <cstdlib>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <ipps.h>
+#include <mkl.h>
+#include "private/throw.hpp"
+#include "private/welchScaling.hpp"
+#include "private/pad.hpp"
+#include "rtseis/enums.hpp"
+#include "rtseis/utilities/transforms/multiChannelWelch.hpp"
+#include "rtseis/utilities/transforms/utilities.hpp"
+#include "rtseis/utilities/transforms/slidingWindowRealDFT.hpp"
+#include "rtseis/utilities/transforms/slidingWindowRealDFTParameters.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+
+/// Scatters the DFT of a channel's segment into the segment matrices.
+/// The segments at each frequency are a row major matrix of dimension
+/// [nChannels x ldw] so that the channel's DFT is written with stride
+/// nChannels*ldw.
+template<typename T>
+void scatterSegment(const int nFrequencies, const size_t stride,
+                    const std::complex<T> *__restrict__ dft,
+                    std::complex<double> *__restrict__ segments)
+{
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        segments[k*stride] = std::complex<double> (dft[k]);
+    }
+}
+
+}
+
+class MultiChannelWelch::MultiChannelWelchImpl
+{
+public:
+    class SlidingWindowRealDFT mSlidingWindowRealDFT;
+    class SlidingWindowRealDFTParameters mParameters;
+    /// The DFTs of every channel's segments.  At each frequency this is a
+    /// row major matrix of dimension [mChannels x mLeadingDimension].
+    std::vector<std::complex<double>> mSegments;
+    /// The cross-spectral density matrices.  At each frequency this is a
+    /// row major matrix of dimension [mChannels x mChannels] of which only
+    /// the upper triangle is computed.
+    std::vector<std::complex<double>> mCSD;
+    double mDensityScaling = 1;
+    double mSamplingRate = 1;
+    int mChannels = 0;
+    int mFrequencies = 0;
+    int mWindows = 0;
+    /// The padded number of segments so that each channel's segments
+    /// begin on a 64 byte boundary.
+    int mLeadingDimension = 0;
+    bool mInitialized = false;
+    bool mHaveTransform = false;
+};
+
+/// Constructors
+MultiChannelWelch::MultiChannelWelch() :
+    pImpl(std::make_unique<MultiChannelWelchImpl> ())
+{
+}
+
+MultiChannelWelch::MultiChannelWelch(const MultiChannelWelch &welch)
+{
+    *this = welch;
+}
+
+MultiChannelWelch::MultiChannelWelch(MultiChannelWelch &&welch) noexcept
+{
+    *this = std::move(welch);
+}
+
+/// Operators
+MultiChannelWelch&
+MultiChannelWelch::operator=(const MultiChannelWelch &welch)
+{
+    if (&welch == this){return *this;}
+    if (pImpl){pImpl.reset();}
+    pImpl = std::make_unique<MultiChannelWelchImpl> (*welch.pImpl);
+    return *this;
+}
+
+MultiChannelWelch&
+MultiChannelWelch::operator=(MultiChannelWelch &&welch) noexcept
+{
+    if (&welch == this){return *this;}
+    pImpl = std::move(welch.pImpl);
+    return *this;
+}
+
+/// Destructor
+MultiChannelWelch::~MultiChannelWelch() = default;
+
+/// Clears memory
+void MultiChannelWelch::clear() noexcept
+{
+    pImpl->mSlidingWindowRealDFT.clear();
+    pImpl->mParameters.clear();
+    pImpl->mSegments.clear();
+    pImpl->mCSD.clear();
+    pImpl->mDensityScaling = 1;
+    pImpl->mSamplingRate = 1;
+    pImpl->mChannels = 0;
+    pImpl->mFrequencies = 0;
+    pImpl->mWindows = 0;
+    pImpl->mLeadingDimension = 0;
+    pImpl->mInitialized = false;
+    pImpl->mHaveTransform = false;
+}
+
+/// Initialize
+void MultiChannelWelch::initialize(
+    const int nChannels,
+    const SlidingWindowRealDFTParameters &parameters,
+    const double samplingRate)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must be positive", nChannels);
+    }
+    if (samplingRate <= 0)
+    {
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
+    }
+    if (!parameters.isValid())
+    {
+        RTSEIS_THROW_IA("%s", "parameters are not valid");
+    }
+    if (parameters.getProcessingMode() != RTSeis::ProcessingMode::POST)
+    {
+        RTSEIS_THROW_IA("%s", "only post-processing is supported");
+    }
+    // Initialize the sliding window DFT
+    pImpl->mSamplingRate = samplingRate;
+    try
+    {
+        pImpl->mParameters = parameters;
+        pImpl->mSlidingWindowRealDFT.initialize(pImpl->mParameters);
+    }
+    catch (const std::exception &e)
+    {
+        clear();
+        RTSEIS_THROW_RTE("%s", "Failed to initialize sliding DFT");
+    }
+    // Compute the scaling
+    int nWindow = pImpl->mParameters.getWindowLength();
+    std::vector<double> window = pImpl->mParameters.getWindow();
+    pImpl->mDensityScaling
+        = WelchScaling::computeDensityScaling(nWindow, window.data());
+    // Set space for the segments and cross-spectra
+    auto nFrequencies = pImpl->mSlidingWindowRealDFT.getNumberOfFrequencies();
+    auto nWindows = pImpl->mSlidingWindowRealDFT.getNumberOfTransformWindows();
+    pImpl->mChannels = nChannels;
+    pImpl->mFrequencies = nFrequencies;
+    pImpl->mWindows = nWindows;
+    pImpl->mLeadingDimension = padLength(nWindows,
+                                         sizeof(std::complex<double>), 64);
+    pImpl->mSegments.resize(static_cast<size_t> (nFrequencies)
+                           *nChannels*pImpl->mLeadingDimension);
+    pImpl->mCSD.resize(static_cast<size_t> (nFrequencies)
+                      *nChannels*nChannels);
+    pImpl->mInitialized = true;
+}
+
+bool MultiChannelWelch::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+bool MultiChannelWelch::haveTransform() const noexcept
+{
+    return pImpl->mHaveTransform;
+}
+
+int MultiChannelWelch::getNumberOfChannels() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mChannels;
+}
+
+int MultiChannelWelch::getNumberOfFrequencies() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mFrequencies;
+}
+
+int MultiChannelWelch::getNumberOfSamples() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mSlidingWindowRealDFT.getNumberOfSamples();
+}
+
+/// Transform
+void MultiChannelWelch::transform(const int nChannels, const int nSamples,
+                                  const double x[])
+{
+    int nSamplesRef = getNumberOfSamples(); // Throws if not initialized
+    if (nChannels != pImpl->mChannels)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must equal %d",
+                        nChannels, pImpl->mChannels);
+    }
+    if (nSamples != nSamplesRef)
+    {
+        RTSEIS_THROW_IA("nSamples = %d must equal %d", nSamples, nSamplesRef);
+    }
+    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    pImpl->mHaveTransform = false;
+    auto nFrequencies = pImpl->mFrequencies;
+    auto nWindows = pImpl->mWindows;
+    auto ldw = pImpl->mLeadingDimension;
+    auto stride = static_cast<size_t> (nChannels)*ldw;
+    auto lDouble = (pImpl->mParameters.getPrecision()
+                 == RTSeis::Precision::DOUBLE);
+    // Transform each channel once and scatter its segments
+    auto &swdft = pImpl->mSlidingWindowRealDFT;
+    for (int c=0; c<nChannels; ++c)
+    {
+        swdft.transform(nSamples, x + static_cast<size_t> (c)*nSamples);
+        for (int iw=0; iw<nWindows; ++iw)
+        {
+            auto segments = pImpl->mSegments.data()
+                          + static_cast<size_t> (c)*ldw + iw;
+            if (lDouble)
+            {
+                scatterSegment(nFrequencies, stride,
+                               swdft.getTransform64f(iw), segments);
+            }
+            else
+            {
+                scatterSegment(nFrequencies, stride,
+                               swdft.getTransform32f(iw), segments);
+            }
+        }
+    }
+    // At each frequency S = alpha X X^H where X is the [nChannels x nWindows]
+    // matrix of segment DFTs.  Only the upper triangle is computed.
+    const double alpha = 2.0/(nWindows*pImpl->mDensityScaling);
+    const std::complex<double> *segmentsPtr = pImpl->mSegments.data();
+    std::complex<double> *csdPtr = pImpl->mCSD.data();
+    #pragma omp parallel for \
+     firstprivate(nFrequencies, nChannels, nWindows, ldw, stride, alpha) \
+     shared(segmentsPtr, csdPtr) \
+     default(none)
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        auto a = segmentsPtr + k*stride;
+        auto s = csdPtr + static_cast<size_t> (k)*nChannels*nChannels;
+        cblas_zherk(CblasRowMajor, CblasUpper, CblasNoTrans,
+                    nChannels, nWindows, alpha, a, ldw,
+                    0.0, s, nChannels);
+    }
+    pImpl->mHaveTransform = true;
+}
+
+/// Cross-spectral density of two channels
+void MultiChannelWelch::getCrossSpectralDensity(
+    const int iChannel, const int jChannel,
+    const int nFrequencies, std::complex<double> *csdIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Throws initialization error
+    auto nChannels = pImpl->mChannels;
+    if (iChannel < 0 || iChannel >= nChannels)
+    {
+        RTSEIS_THROW_IA("iChannel = %d must be in range [0,%d]",
+                        iChannel, nChannels - 1);
+    }
+    if (jChannel < 0 || jChannel >= nChannels)
+    {
+        RTSEIS_THROW_IA("jChannel = %d must be in range [0,%d]",
+                        jChannel, nChannels - 1);
+    }
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    auto csd = *csdIn;
+    if (csd == nullptr){RTSEIS_THROW_IA("%s", "csd is NULL");}
+    if (!haveTransform())
+    {
+        RTSEIS_THROW_RTE("%s", "cross-spectra not yet computed");
+    }
+    // The lower triangle is the conjugate of the upper triangle
+    auto i = std::min(iChannel, jChannel);
+    auto j = std::max(iChannel, jChannel);
+    auto matrixSize = static_cast<size_t> (nChannels)*nChannels;
+    auto s = pImpl->mCSD.data() + static_cast<size_t> (i)*nChannels + j;
+    for (int k=0; k<nFreqs; ++k){csd[k] = s[k*matrixSize];}
+    if (iChannel > jChannel)
+    {
+        for (int k=0; k<nFreqs; ++k){csd[k] = std::conj(csd[k]);}
+    }
+}
+
+/// Cross-spectral density matrix at a frequency
+void MultiChannelWelch::getCrossSpectralDensityMatrix(
+    const int iFrequency, const int nChannels,
+    std::complex<double> *csdIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Throws initialization error
+    if (iFrequency < 0 || iFrequency >= nFreqs)
+    {
+        RTSEIS_THROW_IA("iFrequency = %d must be in range [0,%d]",
+                        iFrequency, nFreqs - 1);
+    }
+    if (nChannels != pImpl->mChannels)
+    {
+        RTSEIS_THROW_IA("nChannels = %d must equal %d",
+                        nChannels, pImpl->mChannels);
+    }
+    auto csd = *csdIn;
+    if (csd == nullptr){RTSEIS_THROW_IA("%s", "csd is NULL");}
+    if (!haveTransform())
+    {
+        RTSEIS_THROW_RTE("%s", "cross-spectra not yet computed");
+    }
+    auto s = pImpl->mCSD.data()
+           + static_cast<size_t> (iFrequency)*nChannels*nChannels;
+    for (int i=0; i<nChannels; ++i)
+    {
+        for (int j=i; j<nChannels; ++j)
+        {
+            csd[i*nChannels + j] = s[i*nChannels + j];
+            csd[j*nChannels + i] = std::conj(s[i*nChannels + j]);
+        }
+    }
+}
+
+/// Coherence
+void MultiChannelWelch::getCoherence(const int iChannel, const int jChannel,
+                                     const int nFrequencies,
+                                     double *coherenceIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Throws initialization error
+    auto nChannels = pImpl->mChannels;
+    if (iChannel < 0 || iChannel >= nChannels)
+    {
+        RTSEIS_THROW_IA("iChannel = %d must be in range [0,%d]",
+                        iChannel, nChannels - 1);
+    }
+    if (jChannel < 0 || jChannel >= nChannels)
+    {
+        RTSEIS_THROW_IA("jChannel = %d must be in range [0,%d]",
+                        jChannel, nChannels - 1);
+    }
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    auto coherence = *coherenceIn;
+    if (coherence == nullptr){RTSEIS_THROW_IA("%s", "coherence is NULL");}
+    if (!haveTransform())
+    {
+        RTSEIS_THROW_RTE("%s", "cross-spectra not yet computed");
+    }
+    // |S_ij| = |S_ji| so the cross-spectrum is read from the upper triangle
+    // of the matrices.  Nothing is written to the class so concurrent calls
+    // are safe.
+    auto matrixSize = static_cast<size_t> (nChannels)*nChannels;
+    auto sij = pImpl->mCSD.data()
+             + static_cast<size_t> (std::min(iChannel, jChannel))*nChannels
+             + std::max(iChannel, jChannel);
+    auto sii = pImpl->mCSD.data() + static_cast<size_t> (iChannel)*nChannels
+             + iChannel;
+    auto sjj = pImpl->mCSD.data() + static_cast<size_t> (jChannel)*nChannels
+             + jChannel;
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        auto denom = sii[k*matrixSize].real()*sjj[k*matrixSize].real();
+        coherence[k] = 0;
+        if (denom > 0)
+        {
+            coherence[k] = std::min(1.0,
+                                    std::norm(sij[k*matrixSize])/denom);
+        }
+    }
+}
+
+/// Frequencies
+void MultiChannelWelch::getFrequencies(const int nFrequencies,
+                                       double *freqsIn[]) const
+{
+    auto nFreqs = getNumberOfFrequencies(); // Throws initialization error
+    if (nFrequencies != nFreqs)
+    {
+        RTSEIS_THROW_IA("nFrequencies = %d must equal %d",
+                        nFrequencies, nFreqs);
+    }
+    if (*freqsIn == nullptr)
+    {
+        RTSEIS_THROW_IA("%s", "frequencies is NULL");
+    }
+    int nSamples = pImpl->mParameters.getDFTLength();
+    DFTUtilities::realToComplexDFTFrequencies(nSamples,
+                                              1.0/pImpl->mSamplingRate,
+                                              nFreqs,
+                                              freqsIn);
+}
@@ -2,6 +2,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <cassert>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 #include <complex> // Put this before fftw
 #include <fftw/fftw3.h>
 #include <ipps.h>
@@ -41,6 +44,17 @@ inline int padLength32f(const int n, const int alignment=64)
 }
 */
 
+namespace
+{
+/// Enables FFTw's multi-threaded plans.  This only needs to happen once.
+bool initializeFFTWThreads()
+{
+    static const bool initialized = (fftw_init_threads() != 0) &&
+                                    (fftwf_init_threads() != 0);
+    return initialized;
+}
+}
+
 class SlidingWindowRealDFT::SlidingWindowRealDFTImpl
 {
 public:
@@ -57,6 +71,8 @@ public:
         mParameters.clear();
         if (mHaveDoublePlan){fftw_destroy_plan(mDoublePlan);}
         if (mHaveFloatPlan){fftwf_destroy_plan(mFloatPlan);}
+        if (mHaveDoubleColumnPlan){fftw_destroy_plan(mDoubleColumnPlan);}
+        if (mHaveFloatColumnPlan){fftwf_destroy_plan(mFloatColumnPlan);}
         if (mOutData64f != nullptr){fftw_free(mOutData64f);}
         if (mOutData32f != nullptr){fftwf_free(mOutData32f);}
         if (mWindow64f != nullptr){ippsFree(mWindow64f);}
@@ -79,20 +95,190 @@ public:
         mNumberOfColumns = 0;
         mDataOffset = 0;
         mFTOffset = 0;
+        mPending64f.clear();
+        mPending32f.clear();
+        mRingHead = 0;
+        mRingWindows = 0;
+        mNewWindows = 0;
         mPrecision = RTSeis::Precision::DOUBLE;
+        mMode = RTSeis::ProcessingMode::POST;
         mDetrendType = SlidingWindowDetrendType::REMOVE_NONE;
         mHaveDoublePlan = false;
         mHaveFloatPlan = false;
+        mHaveDoubleColumnPlan = false;
+        mHaveFloatColumnPlan = false;
+        mThreads = 1;
         mApplyWindow = false;
         mHaveTransform = false;
         mInitialized = false;
     }
+    /// Gets the input data for the precision T.
+    template<typename T> T *getInData() noexcept
+    {
+        if constexpr (std::is_same<T, double>::value){return mInData64f;}
+        else {return mInData32f;}
+    }
+    /// Gets the window function for the precision T.
+    template<typename T> const T *getWindow() const noexcept
+    {
+        if constexpr (std::is_same<T, double>::value){return mWindow64f;}
+        else {return mWindow32f;}
+    }
+    /// Gets the pending real-time samples for the precision T.
+    template<typename T> std::vector<T> &getPending() noexcept
+    {
+        if constexpr (std::is_same<T, double>::value){return mPending64f;}
+        else {return mPending32f;}
+    }
+    /// Copies the signal to a row of the input data then detrends and
+    /// tapers it.
+    template<typename U, typename T>
+    void prepareWindow(const U *xptr, const int ncopy, T *dptr) const
+    {
+        // Zero and copy
+        std::fill(dptr, dptr + mDataOffset, 0);
+        std::copy(xptr, xptr + ncopy, dptr);
+        // Demean?
+        if (mDetrendType == SlidingWindowDetrendType::REMOVE_MEAN)
+        {
+            T mean;
+            FilterImplementations::removeMean(ncopy, dptr, &dptr, &mean);
+        }
+        else if (mDetrendType == SlidingWindowDetrendType::REMOVE_TREND)
+        {
+            T intercept;
+            T slope;
+            FilterImplementations::removeTrend(ncopy, dptr, &dptr,
+                                               &intercept, &slope);
+        }
+        // Window
+        if (mApplyWindow)
+        {
+            auto window = getWindow<T> ();
+            #pragma omp simd
+            for (int i = 0; i < mSamplesPerSegment; ++i)
+            {
+                dptr[i] = window[i]*dptr[i];
+            }
+        }
+    }
+    /// Transforms every window of the signal.
+    template<typename U, typename T>
+    void transformPost(const int nSamples, const U x[])
+    {
+        auto inData = getInData<T> ();
+        int nColumns = mNumberOfColumns;
+        int nDataOffset = mDataOffset;
+        int nPtsPerSeg = mSamplesPerSegment;
+        int shift = nPtsPerSeg - mSamplesInOverlap;
+        // Each window is prepared independently
+        #pragma omp parallel for num_threads(mThreads) \
+         default(none) shared(x, inData) \
+         firstprivate(nSamples, nColumns, nDataOffset, nPtsPerSeg, shift)
+        for (int icol = 0; icol < nColumns; ++icol)
+        {
+            auto xIndex = icol*shift; // Extract x
+            auto ncopy = std::min(nPtsPerSeg, nSamples - xIndex);
+            prepareWindow(x + xIndex, ncopy, inData + icol*nDataOffset);
+        }
+        // Transform
+        if constexpr (std::is_same<T, double>::value)
+        {
+            fftw_execute(mDoublePlan);
+        }
+        else
+        {
+            fftwf_execute(mFloatPlan);
+        }
+        mHaveTransform = true;
+    }
+    /// Appends the packet to the pending samples then transforms the
+    /// completed windows into the ring of output columns.
+    template<typename U, typename T>
+    void transformRealTime(const int nSamples, const U x[])
+    {
+        mNewWindows = 0;
+        if (nSamples < 1){return;}
+        auto &pending = getPending<T> ();
+        pending.insert(pending.end(), x, x + nSamples);
+        auto nPending = static_cast<int> (pending.size());
+        if (nPending < mSamplesPerSegment){return;}
+        int shift = mSamplesPerSegment - mSamplesInOverlap;
+        int nWindows = (nPending - mSamplesPerSegment)/shift + 1;
+        // Windows that would be overwritten in this packet are skipped
+        int nSkip = std::max(0, nWindows - mNumberOfColumns);
+        for (int iw = nSkip; iw < nWindows; ++iw)
+        {
+            auto dptr = getInData<T> () + mRingHead*mDataOffset;
+            prepareWindow(pending.data() + iw*shift, mSamplesPerSegment, dptr);
+            if constexpr (std::is_same<T, double>::value)
+            {
+                fftw_execute_dft_r2c(mDoubleColumnPlan, dptr,
+                                     mOutData64f + mRingHead*mFTOffset);
+            }
+            else
+            {
+                fftwf_execute_dft_r2c(mFloatColumnPlan, dptr,
+                                      mOutData32f + mRingHead*mFTOffset);
+            }
+            mRingHead = (mRingHead + 1)%mNumberOfColumns;
+            mRingWindows = std::min(mRingWindows + 1, mNumberOfColumns);
+        }
+        mNewWindows = nWindows - nSkip;
+        // Retain the samples that begin the next window
+        pending.erase(pending.begin(), pending.begin() + nWindows*shift);
+        mHaveTransform = true;
+    }
+    /// Transforms the signal or packet.
+    template<typename U>
+    void transform(const int nSamples, const U x[])
+    {
+        if (mMode == RTSeis::ProcessingMode::REAL_TIME)
+        {
+            if (mPrecision == RTSeis::Precision::DOUBLE)
+            {
+                transformRealTime<U, double> (nSamples, x);
+            }
+            else
+            {
+                transformRealTime<U, float> (nSamples, x);
+            }
+        }
+        else
+        {
+            if (mPrecision == RTSeis::Precision::DOUBLE)
+            {
+                transformPost<U, double> (nSamples, x);
+            }
+            else
+            {
+                transformPost<U, float> (nSamples, x);
+            }
+        }
+    }
+    /// Maps the chronological window index to a column of the output data.
+    [[nodiscard]] int getColumn(const int iWindow) const noexcept
+    {
+        if (mMode == RTSeis::ProcessingMode::POST){return iWindow;}
+        return (mRingHead - mRingWindows + iWindow + mNumberOfColumns)
+               %mNumberOfColumns;
+    }
+    /// Gets the number of transform windows that can be accessed.
+    [[nodiscard]] int getNumberOfTransformWindows() const noexcept
+    {
+        if (mMode == RTSeis::ProcessingMode::POST){return mNumberOfColumns;}
+        return mRingWindows;
+    }
 
 //private:
     /// The parameters that went into initialization
     class SlidingWindowRealDFTParameters mParameters;
     /// FFTw plan
     fftw_plan  mDoublePlan;
+    /// FFTw plan for a single column.  This is used in real-time.
+    fftw_plan  mDoubleColumnPlan;
+    /// Holds the samples that have not yet completed a window in real-time.
+    std::vector<double> mPending64f;
     /// Holds the data to Fourier transform.  This is an array of dimension
     /// [mInDataOffset x mNumberOfColumns]
     double *mInData64f = nullptr;
@@ -104,6 +290,11 @@ public:
     double *mWindow64f = nullptr;
     /// Holds the FFTw floating arithmetic plan
     fftwf_plan mFloatPlan;
+    /// FFTw floating arithmetic plan for a single column.  This is used in
+    /// real-time.
+    fftwf_plan mFloatColumnPlan;
+    /// Holds the samples that have not yet completed a window in real-time.
+    std::vector<float> mPending32f;
     /// Holds the data to Fourier transform.  This is an array of dimension
     /// [mInDataOffset x mNumberOfColumns]
     float *mInData32f = nullptr;
@@ -135,8 +326,19 @@ public:
     int mFTOffset = 0;
     /// The number of samples in a segment
     int mSamplesPerSegment = 0; 
+    /// The column of the output data to which the next window is written.
+    /// This is used in real-time.
+    int mRingHead = 0;
+    /// The number of windows retained in the output data in real-time.
+    int mRingWindows = 0;
+    /// The number of windows completed by the last real-time transform.
+    int mNewWindows = 0;
+    /// The number of threads.
+    int mThreads = 1;
     /// The precision of the module
     RTSeis::Precision mPrecision = RTSeis::Precision::DOUBLE;
+    /// The processing mode
+    RTSeis::ProcessingMode mMode = RTSeis::ProcessingMode::POST;
     /// The detrend strategy
     SlidingWindowDetrendType mDetrendType
        = SlidingWindowDetrendType::REMOVE_NONE;
@@ -144,6 +346,10 @@ public:
     bool mHaveDoublePlan = false;
     /// Flag indicating that I have a plan (for single precision)
     bool mHaveFloatPlan = false;
+    /// Flag indicating that I have a single column plan (for double precision)
+    bool mHaveDoubleColumnPlan = false;
+    /// Flag indicating that I have a single column plan (for single precision)
+    bool mHaveFloatColumnPlan = false;
     /// Flag indicating whether or not I will apply the window function.
     bool mApplyWindow = false;
     /// Flag indicating the transform was applied
@@ -217,6 +423,12 @@ SlidingWindowRealDFT::operator=(const SlidingWindowRealDFT &swdft)
                 *sizeof(fftwf_complex);
         std::memcpy(pImpl->mOutData32f, swdft.pImpl->mOutData32f, nbytes);
     }
+    pImpl->mPending64f = swdft.pImpl->mPending64f;
+    pImpl->mPending32f = swdft.pImpl->mPending32f;
+    pImpl->mRingHead = swdft.pImpl->mRingHead;
+    pImpl->mRingWindows = swdft.pImpl->mRingWindows;
+    pImpl->mNewWindows = swdft.pImpl->mNewWindows;
+    pImpl->mHaveTransform = swdft.pImpl->mHaveTransform;
     return *this;
 }
 
@@ -252,6 +464,7 @@ void SlidingWindowRealDFT::initialize(
     auto cols = static_cast<double> (nSamples - nSamplesInOverlap)
                /static_cast<double> (nSamplesPerSegment - nSamplesInOverlap);
     auto ncols = static_cast<int> (cols);
+    pImpl->mParameters = parameters;
     pImpl->mSamples = nSamples;
     pImpl->mSamplesInOverlap = nSamplesInOverlap;
     pImpl->mSamplesPerSegment = nSamplesPerSegment;
@@ -259,7 +472,9 @@ void SlidingWindowRealDFT::initialize(
     pImpl->mNumberOfFrequencies = dftLength/2 + 1;
     pImpl->mNumberOfColumns = ncols;
     pImpl->mPrecision = parameters.getPrecision();
+    pImpl->mMode = parameters.getProcessingMode();
     pImpl->mDetrendType = parameters.getDetrendType();
+    pImpl->mThreads = parameters.getNumberOfThreads();
     if (luseWindow)
     {
         auto window = parameters.getWindow();
@@ -292,9 +507,13 @@ void SlidingWindowRealDFT::initialize(
         pImpl->mDataOffset = padLength32f(pImpl->mDFTLength, 64);
         pImpl->mFTOffset = padLength32f(pImpl->mNumberOfFrequencies, 64);
     }
-    // Make the real-to-complex Fourier transform plans
+    // Make the real-to-complex Fourier transform plans.  The batched
+    // post-processing plan may use multiple threads.
     pImpl->mInDataLength  = pImpl->mDataOffset*pImpl->mNumberOfColumns;
     pImpl->mOutDataLength = pImpl->mFTOffset*pImpl->mNumberOfColumns;
+    bool lthreaded = pImpl->mThreads > 1 &&
+                     pImpl->mMode == RTSeis::ProcessingMode::POST &&
+                     initializeFFTWThreads();
     if (pImpl->mPrecision == RTSeis::Precision::DOUBLE)
     {
         auto nbytes = static_cast<size_t> (pImpl->mInDataLength)
@@ -306,32 +525,67 @@ void SlidingWindowRealDFT::initialize(
         pImpl->mOutData64f
             = reinterpret_cast<fftw_complex *> (fftw_malloc(nbytes));
         memset(pImpl->mOutData64f, 0, nbytes);
-        pImpl->mDoublePlan = fftw_plan_many_dft_r2c(rank, nForward, howMany,
-                                                    pImpl->mInData64f, inembed,
-                                                    istride, pImpl->mDataOffset,
-                                                    pImpl->mOutData64f, onembed,
-                                                    ostride, pImpl->mFTOffset,
-                                                    FFTW_PATIENT);
-        pImpl->mHaveDoublePlan = true;
+        // In real-time each completed window is transformed individually.
+        // Every row is 64 byte aligned so this plan can be executed on any
+        // row.
+        if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
+        {
+            pImpl->mDoubleColumnPlan
+                = fftw_plan_dft_r2c_1d(pImpl->mDFTLength,
+                                       pImpl->mInData64f,
+                                       pImpl->mOutData64f,
+                                       FFTW_PATIENT);
+            pImpl->mHaveDoubleColumnPlan = true;
+            pImpl->mPending64f.reserve(2*nSamplesPerSegment);
+        }
+        else
+        {
+            if (lthreaded){fftw_plan_with_nthreads(pImpl->mThreads);}
+            pImpl->mDoublePlan
+                = fftw_plan_many_dft_r2c(rank, nForward, howMany,
+                                         pImpl->mInData64f, inembed,
+                                         istride, pImpl->mDataOffset,
+                                         pImpl->mOutData64f, onembed,
+                                         ostride, pImpl->mFTOffset,
+                                         FFTW_PATIENT);
+            if (lthreaded){fftw_plan_with_nthreads(1);}
+            pImpl->mHaveDoublePlan = true;
+        }
     }
     else
     {
         auto nbytes = static_cast<size_t> (pImpl->mInDataLength)
                      *sizeof(float);
-        pImpl->mInData32f = static_cast<float *> (fftw_malloc(nbytes));
+        pImpl->mInData32f = static_cast<float *> (fftwf_malloc(nbytes));
         memset(pImpl->mInData32f, 0, nbytes);
         nbytes = static_cast<size_t> (pImpl->mOutDataLength)
                 *sizeof(fftwf_complex);
         pImpl->mOutData32f
-            = reinterpret_cast<fftwf_complex *> (fftw_malloc(nbytes));
+            = reinterpret_cast<fftwf_complex *> (fftwf_malloc(nbytes));
         memset(pImpl->mOutData32f, 0, nbytes);
-        pImpl->mFloatPlan = fftwf_plan_many_dft_r2c(rank, nForward, howMany,
-                                                    pImpl->mInData32f, inembed,
-                                                    istride, pImpl->mDataOffset,
-                                                    pImpl->mOutData32f, onembed,
-                                                    ostride, pImpl->mFTOffset,
-                                                    FFTW_PATIENT);
-        pImpl->mHaveFloatPlan = true;
+        if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
+        {
+            pImpl->mFloatColumnPlan
+                = fftwf_plan_dft_r2c_1d(pImpl->mDFTLength,
+                                        pImpl->mInData32f,
+                                        pImpl->mOutData32f,
+                                        FFTW_PATIENT);
+            pImpl->mHaveFloatColumnPlan = true;
+            pImpl->mPending32f.reserve(2*nSamplesPerSegment);
+        }
+        else
+        {
+            if (lthreaded){fftwf_plan_with_nthreads(pImpl->mThreads);}
+            pImpl->mFloatPlan
+                = fftwf_plan_many_dft_r2c(rank, nForward, howMany,
+                                          pImpl->mInData32f, inembed,
+                                          istride, pImpl->mDataOffset,
+                                          pImpl->mOutData32f, onembed,
+                                          ostride, pImpl->mFTOffset,
+                                          FFTW_PATIENT);
+            if (lthreaded){fftwf_plan_with_nthreads(1);}
+            pImpl->mHaveFloatPlan = true;
+        }
     }
     pImpl->mHaveTransform = false;
     pImpl->mInitialized = true;
@@ -479,7 +733,37 @@ int SlidingWindowRealDFT::getNumberOfFrequencies() const
 int SlidingWindowRealDFT::getNumberOfTransformWindows() const
 {
     if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
-    return pImpl->mNumberOfColumns;
+    return pImpl->getNumberOfTransformWindows();
+}
+
+/// Gets the number of windows completed by the last real-time transform
+int SlidingWindowRealDFT::getNumberOfNewTransformWindows() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (pImpl->mMode == RTSeis::ProcessingMode::POST)
+    {
+        return pImpl->mHaveTransform ? pImpl->mNumberOfColumns : 0;
+    }
+    return pImpl->mNewWindows;
+}
+
+/// Gets the processing mode
+RTSeis::ProcessingMode SlidingWindowRealDFT::getProcessingMode() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mMode;
+}
+
+/// Discards the pending samples and windows
+void SlidingWindowRealDFT::resetInitialConditions()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->mPending64f.clear();
+    pImpl->mPending32f.clear();
+    pImpl->mRingHead = 0;
+    pImpl->mRingWindows = 0;
+    pImpl->mNewWindows = 0;
+    pImpl->mHaveTransform = false;
 }
 
 /// Gets number of samples
@@ -505,65 +789,59 @@ RTSeis::Precision SlidingWindowRealDFT::getPrecision() const
 /// Actually perform the transform
 void SlidingWindowRealDFT::transform(const int nSamples, const double x[])
 {
-    pImpl->mHaveTransform = false;
     // Check the class is initialized and that the inputs are as expected
     if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
-    if (nSamples != getNumberOfSamples())
+    if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
     {
-        RTSEIS_THROW_IA("Number of samples = %d must equal %d",
-                        nSamples, getNumberOfSamples());
+        if (nSamples < 0)
+        {
+            RTSEIS_THROW_IA("nSamples = %d cannot be negative", nSamples);
+        }
+        if (nSamples > 0 && x == nullptr)
+        {
+            RTSEIS_THROW_IA("%s", "x is NULL");
+        }
     }
-    if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
-    // Handle the float case
-    if (pImpl->mPrecision != RTSeis::Precision::DOUBLE)
+    else
     {
-        RTSEIS_THROW_RTE("%s", "Float precision not yet implemented");
-    }
-    // Loop over the windows
-    //#pragma omp parallel shared(inData, window) default(None)
-    {
-    auto *window = pImpl->mWindow64f;
-    auto *inData = pImpl->mInData64f;
-    int nDataOffset = pImpl->mDataOffset;
-    int nPtsPerSeg = pImpl->mSamplesPerSegment;
-    int nOverlap   = pImpl->mSamplesInOverlap;
-    int shift = nPtsPerSeg - nOverlap;
-    auto lwindow = pImpl->mApplyWindow;
-    SlidingWindowDetrendType detrendType = pImpl->mDetrendType;
-    //#pragma omp for
-    for (auto icol=0; icol<pImpl->mNumberOfColumns; ++icol)
-    {
-        auto xIndex = icol*shift; // Extract x
-        auto dataIndex = icol*nDataOffset;
-        auto xptr = &x[xIndex];
-        auto dptr = &inData[dataIndex];
-#ifdef DEBUG
-        assert(xIndex < nSamples);
-#endif
-        auto ncopy = std::min(nPtsPerSeg, nSamples - xIndex);
-        // Zero and copy
-        std::memset(dptr, 0, static_cast<size_t> (nDataOffset)*sizeof(double));
-        std::copy(xptr, xptr + ncopy, dptr); //dptr, xptr, static_cast<size_t> (ncopy)*sizeof(double));
-        // Demean?
-        if (detrendType == SlidingWindowDetrendType::REMOVE_MEAN)
+        pImpl->mHaveTransform = false;
+        if (nSamples != getNumberOfSamples())
         {
-            double mean;
-            FilterImplementations::removeMean(ncopy, xptr, &dptr, &mean);
+            RTSEIS_THROW_IA("Number of samples = %d must equal %d",
+                            nSamples, getNumberOfSamples());
         }
-        else if (detrendType == SlidingWindowDetrendType::REMOVE_TREND)
+        if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    }
+    pImpl->transform(nSamples, x);
+}
+
+/// Actually perform the transform
+void SlidingWindowRealDFT::transform(const int nSamples, const float x[])
+{
+    // Check the class is initialized and that the inputs are as expected
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
+    {
+        if (nSamples < 0)
         {
-            double intercept;
-            double slope;
-            FilterImplementations::removeTrend(ncopy, xptr, &dptr,
-                                               &intercept, &slope);
+            RTSEIS_THROW_IA("nSamples = %d cannot be negative", nSamples);
         }
-        // Window
-        if (lwindow){ippsMul_64f_I(window, dptr, nPtsPerSeg);}
+        if (nSamples > 0 && x == nullptr)
+        {
+            RTSEIS_THROW_IA("%s", "x is NULL");
+        }
+    }
+    else
+    {
+        pImpl->mHaveTransform = false;
+        if (nSamples != getNumberOfSamples())
+        {
+            RTSEIS_THROW_IA("Number of samples = %d must equal %d",
+                            nSamples, getNumberOfSamples());
+        }
+        if (x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
     }
-    } // End parallel
-    // Transform
-    fftw_execute(pImpl->mDoublePlan);
-    pImpl->mHaveTransform = true;
+    pImpl->transform(nSamples, x);
 }
 
 /// Returns a pointer to the transform in the i'th window
@@ -579,12 +857,13 @@ SlidingWindowRealDFT::getTransform64f(const int iWindow) const
     {
         RTSEIS_THROW_RTE("%s", "Precision is FLOAT - call getTransform32f");
     }
-    if (iWindow < 0 || iWindow >= pImpl->mNumberOfColumns)
+    auto nWindows = pImpl->getNumberOfTransformWindows();
+    if (iWindow < 0 || iWindow >= nWindows)
     {
         RTSEIS_THROW_IA("iWindow = %d must be in range [0,%d]",
-                        iWindow, pImpl->mNumberOfColumns);
+                        iWindow, nWindows - 1);
     }
-    int indx = pImpl->mFTOffset*iWindow;
+    int indx = pImpl->mFTOffset*pImpl->getColumn(iWindow);
     auto ptr = reinterpret_cast<const std::complex<double> *>
                (pImpl->mOutData64f + indx);
     return ptr; 
@@ -602,12 +881,13 @@ SlidingWindowRealDFT::getTransform32f(const int iWindow) const
     {
         RTSEIS_THROW_RTE("%s", "Precision is DOUBLE - call getTransform64f");
     }
-    if (iWindow < 0 || iWindow >= pImpl->mNumberOfColumns)
+    auto nWindows = pImpl->getNumberOfTransformWindows();
+    if (iWindow < 0 || iWindow >= nWindows)
     {
         RTSEIS_THROW_IA("iWindow = %d must be in range [0,%d]",
-                        iWindow, pImpl->mNumberOfColumns);
+                        iWindow, nWindows - 1);
     }
-    int indx = pImpl->mFTOffset*iWindow;
+    int indx = pImpl->mFTOffset*pImpl->getColumn(iWindow);
     auto ptr = reinterpret_cast<const std::complex<float> *>
                (pImpl->mOutData32f + indx);
     return ptr;
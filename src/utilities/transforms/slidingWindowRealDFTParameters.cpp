@@ -26,6 +26,10 @@ public:
     SlidingWindowDetrendType mDetrendType = SlidingWindowDetrendType::REMOVE_NONE;
     /// Defines the precision
     RTSeis::Precision mPrecision = RTSeis::Precision::DOUBLE;
+    /// Defines the processing mode
+    RTSeis::ProcessingMode mMode = RTSeis::ProcessingMode::POST;
+    /// The number of threads
+    int mThreads = 1;
 };
 
 /// Constructor
@@ -81,6 +85,8 @@ void SlidingWindowRealDFTParameters::clear() noexcept
     pImpl->mWindowType = SlidingWindowType::BOXCAR;
     pImpl->mDetrendType = SlidingWindowDetrendType::REMOVE_NONE;
     pImpl->mPrecision = RTSeis::Precision::DOUBLE;
+    pImpl->mMode = RTSeis::ProcessingMode::POST;
+    pImpl->mThreads = 1;
 }
 
 /// Set number of samples
@@ -268,6 +274,33 @@ RTSeis::Precision SlidingWindowRealDFTParameters::getPrecision() const noexcept
     return pImpl->mPrecision;
 }
 
+void SlidingWindowRealDFTParameters::setProcessingMode(
+    const RTSeis::ProcessingMode mode) noexcept
+{
+    pImpl->mMode = mode;
+}
+
+RTSeis::ProcessingMode
+SlidingWindowRealDFTParameters::getProcessingMode() const noexcept
+{
+    return pImpl->mMode;
+}
+
+/// Sets the number of threads
+void SlidingWindowRealDFTParameters::setNumberOfThreads(const int nThreads)
+{
+    if (nThreads < 1)
+    {
+        RTSEIS_THROW_IA("Number of threads = %d must be positive", nThreads);
+    }
+    pImpl->mThreads = nThreads;
+}
+
+int SlidingWindowRealDFTParameters::getNumberOfThreads() const noexcept
+{
+    return pImpl->mThreads;
+}
+
 /// Check if class is usable
 bool SlidingWindowRealDFTParameters::isValid() const noexcept
 {
@@ -0,0 +1,479 @@
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include "rtseis/enums.hpp"
+#include "private/pad.hpp"
+#include "rtseis/utilities/transforms/sparseFrequencyDFT.hpp"
+
+using namespace RTSeis::Utilities::Transforms;
+
+namespace
+{
+/// The sliding DFT recurrences are recomputed from the retained samples
+/// after this many window lengths so that roundoff does not accumulate.
+constexpr int RESYNC_WINDOWS = 16;
+
+/// @brief Evaluates the DFT of the retained window at one frequency for
+///        every channel with the Goertzel algorithm.
+/// @param[in] nChannels    The number of channels.
+/// @param[in] ldc          The leading dimension of the ring and work arrays.
+/// @param[in] n            The window length.
+/// @param[in] pos          The index of the oldest sample in the ring.
+/// @param[in] ring         The last n samples of each channel.  This is a
+///                         row major matrix of dimension [n x ldc].
+/// @param[in] omega        The normalized angular frequency.
+/// @param[out] s1          Workspace of dimension [ldc].
+/// @param[out] s2          Workspace of dimension [ldc].
+/// @param[out] re          The real part of the DFT.  This has dimension
+///                         [nChannels].
+/// @param[out] im          The imaginary part of the DFT.  This has
+///                         dimension [nChannels].
+void goertzel(const int nChannels, const int ldc, const int n,
+              const int pos, const double *__restrict__ ring,
+              const double omega,
+              double *__restrict__ s1, double *__restrict__ s2,
+              double *__restrict__ re, double *__restrict__ im)
+{
+    const double coef = 2*std::cos(omega);
+    std::fill(s1, s1 + nChannels, 0);
+    std::fill(s2, s2 + nChannels, 0);
+    // The ring is traversed from the oldest to the newest sample
+    for (int m=0; m<n; ++m)
+    {
+        auto idx = pos + m;
+        if (idx >= n){idx = idx - n;}
+        const double *__restrict__ xm = ring + static_cast<size_t> (idx)*ldc;
+        #pragma omp simd
+        for (int c=0; c<nChannels; ++c)
+        {
+            double s0 = xm[c] + coef*s1[c] - s2[c];
+            s2[c] = s1[c];
+            s1[c] = s0;
+        }
+    }
+    // X = e^{-i omega (n-1)} (s_{n-1} - e^{-i omega} s_{n-2})
+    const double cosw = std::cos(omega);
+    const double sinw = std::sin(omega);
+    const double br = std::cos(omega*(n - 1));
+    const double bi =-std::sin(omega*(n - 1));
+    #pragma omp simd
+    for (int c=0; c<nChannels; ++c)
+    {
+        double yr = s1[c] - cosw*s2[c];
+        double yi = sinw*s2[c];
+        re[c] = br*yr - bi*yi;
+        im[c] = bi*yr + br*yi;
+    }
+}
+
+}
+
+template<RTSeis::ProcessingMode E, class T>
+class SparseFrequencyDFT<E, T>::SparseFrequencyDFTImpl
+{
+public:
+    /// Zeros the retained samples and the recurrences
+    void resetInitialConditions() noexcept
+    {
+        std::fill(mRing.begin(), mRing.end(), 0);
+        std::fill(mRe.begin(), mRe.end(), 0);
+        std::fill(mIm.begin(), mIm.end(), 0);
+        mRingPosition = 0;
+        mSamplesToNextWindow = mWindowLength;
+        mSamplesSinceSync = 0;
+        mNewWindows = 0;
+    }
+    /// Recomputes every recurrence from the retained samples
+    void resynchronize() noexcept
+    {
+        for (int f=0; f<mFrequencies; ++f)
+        {
+            auto offset = static_cast<size_t> (f)*mLeadingDimension;
+            goertzel(mChannels, mLeadingDimension, mWindowLength,
+                     mRingPosition, mRing.data(), mOmega[f],
+                     mWork1.data(), mWork2.data(),
+                     mRe.data() + offset, mIm.data() + offset);
+        }
+        mSamplesSinceSync = 0;
+    }
+    /// Advances the sliding DFT recurrences by one sample
+    void slide(const double *__restrict__ xNew) noexcept
+    {
+        const double *__restrict__ xOld = mRing.data()
+                  + static_cast<size_t> (mRingPosition)*mLeadingDimension;
+        for (int f=0; f<mFrequencies; ++f)
+        {
+            auto offset = static_cast<size_t> (f)*mLeadingDimension;
+            double *__restrict__ re = mRe.data() + offset;
+            double *__restrict__ im = mIm.data() + offset;
+            const double ar = mA[2*f];
+            const double ai = mA[2*f + 1];
+            const double br = mB[2*f];
+            const double bi = mB[2*f + 1];
+            #pragma omp simd
+            for (int c=0; c<mChannels; ++c)
+            {
+                double dr = re[c] - xOld[c];
+                double di = im[c];
+                re[c] = ar*dr - ai*di + br*xNew[c];
+                im[c] = ai*dr + ar*di + bi*xNew[c];
+            }
+        }
+    }
+    /// Writes the DFT in the current window to the output
+    void emitWindow() noexcept
+    {
+        if (!mSliding){resynchronize();}
+        auto out = mOutput.data()
+                 + static_cast<size_t> (mNewWindows)*mChannels*mFrequencies;
+        for (int f=0; f<mFrequencies; ++f)
+        {
+            auto offset = static_cast<size_t> (f)*mLeadingDimension;
+            for (int c=0; c<mChannels; ++c)
+            {
+                out[c*mFrequencies + f]
+                    = std::complex<T> (static_cast<T> (mRe[offset + c]),
+                                       static_cast<T> (mIm[offset + c]));
+            }
+        }
+        mNewWindows = mNewWindows + 1;
+    }
+    /// Processes a packet
+    void transform(const int nSamples, const T x[])
+    {
+        mNewWindows = 0;
+        if (nSamples < 1){return;}
+        // Make space for the windows completed by this packet
+        int nWindows = 0;
+        if (mSamplesToNextWindow <= nSamples)
+        {
+            nWindows = 1 + (nSamples - mSamplesToNextWindow)/mHopLength;
+        }
+        auto outputLength = static_cast<size_t> (nWindows)
+                           *mChannels*mFrequencies;
+        if (mOutput.size() < outputLength){mOutput.resize(outputLength);}
+        for (int i=0; i<nSamples; ++i)
+        {
+            auto xi = x + static_cast<size_t> (i)*mChannels;
+            auto ring = mRing.data()
+                      + static_cast<size_t> (mRingPosition)*mLeadingDimension;
+            // Update the recurrences then replace the oldest sample
+            std::copy(xi, xi + mChannels, mWork1.data());
+            if (mSliding){slide(mWork1.data());}
+            std::copy(mWork1.data(), mWork1.data() + mChannels, ring);
+            mRingPosition = mRingPosition + 1;
+            if (mRingPosition == mWindowLength){mRingPosition = 0;}
+            if (mSliding)
+            {
+                mSamplesSinceSync = mSamplesSinceSync + 1;
+                if (mSamplesSinceSync >= mResyncInterval){resynchronize();}
+            }
+            mSamplesToNextWindow = mSamplesToNextWindow - 1;
+            if (mSamplesToNextWindow == 0)
+            {
+                emitWindow();
+                mSamplesToNextWindow = mHopLength;
+            }
+        }
+    }
+///private:
+    /// The retained samples.  This is a row major matrix of dimension
+    /// [mWindowLength x mLeadingDimension].
+    std::vector<double> mRing;
+    /// The real and imaginary parts of the recurrences.  These are row
+    /// major matrices of dimension [mFrequencies x mLeadingDimension].
+    std::vector<double> mRe;
+    std::vector<double> mIm;
+    /// Workspace of dimension [mLeadingDimension].
+    std::vector<double> mWork1;
+    std::vector<double> mWork2;
+    /// The normalized angular frequencies.
+    std::vector<double> mOmega;
+    /// e^{i omega} interleaved as (real, imaginary).
+    std::vector<double> mA;
+    /// e^{-i omega (N - 1)} interleaved as (real, imaginary).
+    std::vector<double> mB;
+    /// The output windows.  Each window is a row major matrix of dimension
+    /// [mChannels x mFrequencies].
+    std::vector<std::complex<T>> mOutput;
+    /// The number of samples processed since the last resynchronization.
+    int64_t mSamplesSinceSync = 0;
+    /// The number of samples between resynchronizations.
+    int64_t mResyncInterval = 0;
+    /// The number of channels.
+    int mChannels = 0;
+    /// The padded number of channels so that each row begins on a
+    /// 64 byte boundary.
+    int mLeadingDimension = 0;
+    /// The number of frequencies.
+    int mFrequencies = 0;
+    /// The window length.
+    int mWindowLength = 0;
+    /// The number of samples between windows.
+    int mHopLength = 1;
+    /// The position of the oldest sample in the ring.
+    int mRingPosition = 0;
+    /// The number of samples until the next window is complete.
+    int mSamplesToNextWindow = 0;
+    /// The number of windows completed by the last transform.
+    int mNewWindows = 0;
+    /// Real-time or post-processing.
+    const RTSeis::ProcessingMode mMode = E;
+    /// True indicates the sliding DFT recurrences are used.  Otherwise,
+    /// each window is evaluated with the Goertzel algorithm.
+    bool mSliding = true;
+    /// Flag indicating the class is initialized.
+    bool mInitialized = false;
+};
+
+//============================================================================//
+
+/// C'tor
+template<RTSeis::ProcessingMode E, class T>
+SparseFrequencyDFT<E, T>::SparseFrequencyDFT() :
+    pImpl(std::make_unique<SparseFrequencyDFTImpl> ())
+{
+}
+
+/// Copy c'tor
+template<RTSeis::ProcessingMode E, class T>
+SparseFrequencyDFT<E, T>::SparseFrequencyDFT(const SparseFrequencyDFT &dft)
+{
+    *this = dft;
+}
+
+/// Move c'tor
+template<RTSeis::ProcessingMode E, class T>
+SparseFrequencyDFT<E, T>::SparseFrequencyDFT(
+    SparseFrequencyDFT &&dft) noexcept
+{
+    *this = std::move(dft);
+}
+
+/// Destructor
+template<RTSeis::ProcessingMode E, class T>
+SparseFrequencyDFT<E, T>::~SparseFrequencyDFT() = default;
+
+/// Copy assignment
+template<RTSeis::ProcessingMode E, class T>
+SparseFrequencyDFT<E, T>&
+SparseFrequencyDFT<E, T>::operator=(const SparseFrequencyDFT &dft)
+{
+    if (&dft == this){return *this;}
+    pImpl = std::make_unique<SparseFrequencyDFTImpl> (*dft.pImpl);
+    return *this;
+}
+
+/// Move assignment
+template<RTSeis::ProcessingMode E, class T>
+SparseFrequencyDFT<E, T>&
+SparseFrequencyDFT<E, T>::operator=(SparseFrequencyDFT &&dft) noexcept
+{
+    if (&dft == this){return *this;}
+    pImpl = std::move(dft.pImpl);
+    return *this;
+}
+
+/// Clear the class
+template<RTSeis::ProcessingMode E, class T>
+void SparseFrequencyDFT<E, T>::clear() noexcept
+{
+    pImpl = std::make_unique<SparseFrequencyDFTImpl> ();
+}
+
+/// Initialization
+template<RTSeis::ProcessingMode E, class T>
+void SparseFrequencyDFT<E, T>::initialize(const int nChannels,
+                                          const int nFrequencies,
+                                          const double frequencies[],
+                                          const int windowLength,
+                                          const int hopLength,
+                                          const double samplingRate,
+                                          const int maxPacketLength)
+{
+    clear();
+    if (nChannels < 1)
+    {
+        throw std::invalid_argument("nChannels = "
+                                  + std::to_string(nChannels)
+                                  + " must be positive");
+    }
+    if (nFrequencies < 1)
+    {
+        throw std::invalid_argument("nFrequencies = "
+                                  + std::to_string(nFrequencies)
+                                  + " must be positive");
+    }
+    if (frequencies == nullptr)
+    {
+        throw std::invalid_argument("frequencies is NULL");
+    }
+    if (windowLength < 1)
+    {
+        throw std::invalid_argument("windowLength = "
+                                  + std::to_string(windowLength)
+                                  + " must be positive");
+    }
+    if (hopLength < 1)
+    {
+        throw std::invalid_argument("hopLength = "
+                                  + std::to_string(hopLength)
+                                  + " must be positive");
+    }
+    if (samplingRate <= 0)
+    {
+        throw std::invalid_argument("samplingRate = "
+                                  + std::to_string(samplingRate)
+                                  + " must be positive");
+    }
+    if (maxPacketLength < 1)
+    {
+        throw std::invalid_argument("maxPacketLength = "
+                                  + std::to_string(maxPacketLength)
+                                  + " must be positive");
+    }
+    auto nyquist = samplingRate/2;
+    for (int f=0; f<nFrequencies; ++f)
+    {
+        if (frequencies[f] < 0 || frequencies[f] > nyquist)
+        {
+            throw std::invalid_argument("frequencies[" + std::to_string(f)
+                                      + "] = "
+                                      + std::to_string(frequencies[f])
+                                      + " must be in range [0,"
+                                      + std::to_string(nyquist) + "]");
+        }
+    }
+    pImpl->mChannels = nChannels;
+    pImpl->mLeadingDimension = padLength(nChannels, sizeof(double), 64);
+    pImpl->mFrequencies = nFrequencies;
+    pImpl->mWindowLength = windowLength;
+    pImpl->mHopLength = hopLength;
+    pImpl->mResyncInterval = static_cast<int64_t> (RESYNC_WINDOWS)
+                            *windowLength;
+    // Sliding costs a complex multiply-add per sample whereas Goertzel
+    // costs roughly 3 flops per sample per window
+    pImpl->mSliding = (8*static_cast<int64_t> (hopLength)
+                     < 3*static_cast<int64_t> (windowLength));
+    auto ldc = static_cast<size_t> (pImpl->mLeadingDimension);
+    pImpl->mRing.resize(static_cast<size_t> (windowLength)*ldc);
+    pImpl->mRe.resize(static_cast<size_t> (nFrequencies)*ldc);
+    pImpl->mIm.resize(static_cast<size_t> (nFrequencies)*ldc);
+    pImpl->mWork1.resize(ldc, 0);
+    pImpl->mWork2.resize(ldc, 0);
+    // A packet completes at most one window every hop after the first
+    auto maxWindows = 1 + (maxPacketLength - 1)/hopLength;
+    pImpl->mOutput.resize(static_cast<size_t> (maxWindows)
+                         *nChannels*nFrequencies);
+    pImpl->mOmega.resize(nFrequencies);
+    pImpl->mA.resize(2*nFrequencies);
+    pImpl->mB.resize(2*nFrequencies);
+    for (int f=0; f<nFrequencies; ++f)
+    {
+        auto omega = 2*M_PI*frequencies[f]/samplingRate;
+        pImpl->mOmega[f] = omega;
+        pImpl->mA[2*f]     = std::cos(omega);
+        pImpl->mA[2*f + 1] = std::sin(omega);
+        pImpl->mB[2*f]     = std::cos(omega*(windowLength - 1));
+        pImpl->mB[2*f + 1] =-std::sin(omega*(windowLength - 1));
+    }
+    pImpl->resetInitialConditions();
+    pImpl->mInitialized = true;
+}
+
+/// Initialized?
+template<RTSeis::ProcessingMode E, class T>
+bool SparseFrequencyDFT<E, T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Number of channels
+template<RTSeis::ProcessingMode E, class T>
+int SparseFrequencyDFT<E, T>::getNumberOfChannels() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mChannels;
+}
+
+/// Number of frequencies
+template<RTSeis::ProcessingMode E, class T>
+int SparseFrequencyDFT<E, T>::getNumberOfFrequencies() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mFrequencies;
+}
+
+/// Window length
+template<RTSeis::ProcessingMode E, class T>
+int SparseFrequencyDFT<E, T>::getWindowLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mWindowLength;
+}
+
+/// Hop length
+template<RTSeis::ProcessingMode E, class T>
+int SparseFrequencyDFT<E, T>::getHopLength() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mHopLength;
+}
+
+/// Reset initial conditions
+template<RTSeis::ProcessingMode E, class T>
+void SparseFrequencyDFT<E, T>::resetInitialConditions()
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Transform
+template<RTSeis::ProcessingMode E, class T>
+void SparseFrequencyDFT<E, T>::transform(const int nSamples, const T x[])
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    if (nSamples > 0 && x == nullptr)
+    {
+        throw std::invalid_argument("x is NULL");
+    }
+    // In post-processing every transform starts from a quiet window
+    if (pImpl->mMode == RTSeis::ProcessingMode::POST)
+    {
+        pImpl->resetInitialConditions();
+    }
+    pImpl->transform(nSamples, x);
+}
+
+/// Number of new windows
+template<RTSeis::ProcessingMode E, class T>
+int SparseFrequencyDFT<E, T>::getNumberOfNewWindows() const
+{
+    if (!isInitialized()){throw std::runtime_error("Class not initialized");}
+    return pImpl->mNewWindows;
+}
+
+/// Get the transform
+template<RTSeis::ProcessingMode E, class T>
+const std::complex<T> *
+SparseFrequencyDFT<E, T>::getTransform(const int iWindow) const
+{
+    auto nWindows = getNumberOfNewWindows(); // Throws
+    if (iWindow < 0 || iWindow >= nWindows)
+    {
+        throw std::invalid_argument("iWindow = " + std::to_string(iWindow)
+                                  + " must be in range [0,"
+                                  + std::to_string(nWindows - 1) + "]");
+    }
+    return pImpl->mOutput.data()
+         + static_cast<size_t> (iWindow)*pImpl->mChannels*pImpl->mFrequencies;
+}
+
+/// Template instantiation
+template class RTSeis::Utilities::Transforms::SparseFrequencyDFT<RTSeis::ProcessingMode::POST, double>;
+template class RTSeis::Utilities::Transforms::SparseFrequencyDFT<RTSeis::ProcessingMode::REAL_TIME, double>;
+template class RTSeis::Utilities::Transforms::SparseFrequencyDFT<RTSeis::ProcessingMode::POST, float>;
+template class RTSeis::Utilities::Transforms::SparseFrequencyDFT<RTSeis::ProcessingMode::REAL_TIME, float>;
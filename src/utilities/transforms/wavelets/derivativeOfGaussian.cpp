@@ -1,5 +1,6 @@
 #include <iostream>
 #include <complex>
+#include <string>
 #include <cmath>
 #include <cassert>
 #include "rtseis/utilities/transforms/wavelets/derivativeOfGaussian.hpp"
@@ -8,42 +9,66 @@ using namespace RTSeis::Utilities::Transforms::Wavelets;
 
 namespace
 {
+/// Evaluates the m'th derivative of a Gaussian in the time domain.  This
+/// uses the probabilists' Hermite polynomials, He_m, since
+/// d^m/dx^m e^{-x^2/2} = (-1)^m He_m(x) e^{-x^2/2}.
 template <typename T>
-void evaluateDOG(const int n,
-                 const bool isReal,
-                 const int m,
-                 const int derivativeSign,
-                 const T dt,
-                 const T gammaNorm,
-                 const T scale,
-                 const T k[],
-                 std::complex<T> *daughter)
-{
+void evaluateTimeDomain(const int n,
+                        const int m,
+                        const T gammaNorm,
+                        const T scale,
+                        std::complex<T> *daughter,
+                        const bool normalize)
+{
+    const T one = 1;
     const T half = 0.5;
-    T arg = 2*M_PI*scale/dt;
-    T norm =-derivativeSign*std::sqrt(arg)*gammaNorm;
-    // Evaluate ala Torrence and Compo 1998, Table 1
-    if (isReal)
+    // The (-1)^{m+1} (-1)^m = -1
+    T norm =-gammaNorm;
+    if (normalize){norm = one/std::sqrt(std::abs(scale))*norm;}
+    T xhalf = half*static_cast<T> (n - 1);
+    for (int i=0; i<n; ++i)
     {
-        #pragma omp simd
-        for (int i=0; i<n; ++i)
+        T xs = (static_cast<T> (i) - xhalf)/scale;
+        // He_{k+1}(x) = x He_k(x) - k He_{k-1}(x)
+        T hem1 = 0;
+        T he = 1;
+        for (int k=0; k<m; ++k)
         {
-            T sk = scale*k[i];
-            T halfsk2 = half*(sk*sk);
-            T re = norm*std::pow(sk, m)*std::exp(-halfsk2);
-            daughter[i] = std::complex<T> (re, 0);
+            T hep1 = xs*he - static_cast<T> (k)*hem1;
+            hem1 = he;
+            he = hep1;
         }
+        daughter[i] = std::complex<T> (norm*he*std::exp(-half*(xs*xs)), 0);
     }
-    else
+}
+
+/// Evaluates the Fourier transform of the m'th derivative of a Gaussian
+/// which is -s \sqrt{2 \pi} (-i s \omega)^m e^{-(s \omega)^2/2}/\sqrt{\Gamma}.
+template <typename T>
+void evaluateFrequencyDomain(const int n,
+                             const int m,
+                             const T gammaNorm,
+                             const T scale,
+                             const T omega[],
+                             std::complex<T> *daughter,
+                             const bool normalize)
+{
+    const T one = 1;
+    const T half = 0.5;
+    T norm =-scale*static_cast<T> (2.5066282746310002)*gammaNorm;
+    if (normalize){norm = one/std::sqrt(std::abs(scale))*norm;}
+    // (-i)^m cycles through 1, -i, -1, i
+    std::complex<T> phase(1, 0);
+    if (m%4 == 1){phase = std::complex<T> (0, -1);}
+    if (m%4 == 2){phase = std::complex<T> (-1, 0);}
+    if (m%4 == 3){phase = std::complex<T> (0, 1);}
+    #pragma omp simd
+    for (int i=0; i<n; ++i)
     {
-        #pragma omp simd
-        for (int i=0; i<n; ++i)
-        {
-            T sk = scale*k[i];
-            T halfsk2 = half*(sk*sk);
-            T im = norm*std::pow(sk, m)*std::exp(-halfsk2);
-            daughter[i] = std::complex<T> (0, im);
-        }
+        T sk = scale*omega[i];
+        T halfsk2 = half*(sk*sk);
+        T amp = norm*std::pow(sk, m)*std::exp(-halfsk2);
+        daughter[i] = amp*phase;
     }
 }
 }
@@ -51,11 +76,10 @@ void evaluateDOG(const int n,
 class DerivativeOfGaussian::DerivativeOfGaussianImpl
 {
 public:
-    double mNorm = 0; // Normalization $ \frac{1}{\sqrt{ \Gamma(m + 1/2) }}
-    double mSamplingPeriod = 1; // Sampling period (seconds)
-    int mDerivativeSign =-1; // Sign on derivative (2nd derivative)
+    /// Normalization $ \frac{1}{\sqrt{ \Gamma(m + 1/2) }}
+    double mNorm = 1/std::sqrt(std::tgamma(2.5));
     int mOrder = 2; // Ricker (Same as Torrence's software)
-    bool mIsReal = true; // Result is real or complex (2nd derivative real)
+    bool mNormalize = false; // Divide by 1/sqrt(s)
 };
 
 /// C'tor
@@ -77,7 +101,7 @@ DerivativeOfGaussian::DerivativeOfGaussian(DerivativeOfGaussian &&dog) noexcept
 }
 
 /// Copy assignment
-DerivativeOfGaussian& 
+DerivativeOfGaussian&
 DerivativeOfGaussian::operator=(const DerivativeOfGaussian &dog)
 {
     if (&dog == this){return *this;}
@@ -107,11 +131,9 @@ DerivativeOfGaussian::~DerivativeOfGaussian() = default;
 /// Clear
 void DerivativeOfGaussian::clear() noexcept
 {
-    pImpl->mNorm = 1;
-    pImpl->mSamplingPeriod = 1;
-    pImpl->mDerivativeSign =-1;
+    pImpl->mNorm = 1/std::sqrt(std::tgamma(2.5));
     pImpl->mOrder = 2;
-    pImpl->mIsReal = true;
+    pImpl->mNormalize = false;
 }
 
 /// Set the order
@@ -122,32 +144,9 @@ void DerivativeOfGaussian::setOrder(int order)
         throw std::invalid_argument("Order = " + std::to_string(order)
                                   + " must be positive");
     }
+    // Normalization factor taken right from Table 1 of Torrence and Compo
     pImpl->mOrder = order;
     pImpl->mNorm = 1/std::sqrt( std::tgamma(order + 0.5) );
-    // Derivative in Fourier domain is (i)^m
-    if (order%4 == 0) // i**0 = 1
-    {
-        pImpl->mDerivativeSign = 1;
-        pImpl->mIsReal = true;
-    }
-    else if (order%4 == 1) // i**1 = i
-    {
-        pImpl->mDerivativeSign = 1;
-        pImpl->mIsReal = false;
-    }
-    else if (order%4 == 2) // i**2 =-1
-    {
-        pImpl->mDerivativeSign =-1;
-        pImpl->mIsReal = true;
-    }
-    else //if (order%4 == 3) // i**3 =-i
-    {
-#ifndef DNDEBUG
-        assert(order%4 == 3);
-#endif
-        pImpl->mDerivativeSign =-1;
-        pImpl->mIsReal = false;
-    }
 }
 
 int DerivativeOfGaussian::getOrder() const noexcept
@@ -155,65 +154,21 @@ int DerivativeOfGaussian::getOrder() const noexcept
     return pImpl->mOrder;
 }
 
-/// Set the sampling period
-void DerivativeOfGaussian::setSamplingPeriod(const double dt)
+/// Normalization
+void DerivativeOfGaussian::enableNormalization() noexcept
 {
-    if (dt <= 0)
-    {
-        throw std::invalid_argument("dt = " + std::to_string(dt)
-                                  + " must be positive");
-    }
-    pImpl->mSamplingPeriod = dt;
+    pImpl->mNormalize = true;
 }
 
-double DerivativeOfGaussian::getSamplingPeriod() const noexcept
+void DerivativeOfGaussian::disableNormalization() noexcept
 {
-    return pImpl->mSamplingPeriod;
+    pImpl->mNormalize = false;
 }
 
-/*
-/// Initialize the class
-void DerivativeOfGaussian::initialize(const int order, const double dt)
-{
-    clear();
-    if (order < 0){throw std::invalid_argument("Order must be positive");}
-    if (dt <= 0){throw std::invalid_argument("dt must be positive");}
-    // Normalization factor taken right from Table 1 of Torrence and Compo, 1998
-    pImpl->mNorm = 1/std::sqrt( std::tgamma(order + 0.5) );
-    // Derivative in Fourier domain is (i)^m 
-    if (order%4 == 0) // i**0 = 1
-    {
-        pImpl->mDerivativeSign = 1;
-        pImpl->mIsReal = true;
-    }
-    else if (order%4 == 1) // i**1 = i
-    {
-        pImpl->mDerivativeSign = 1;
-        pImpl->mIsReal = false;
-    }
-    else if (order%4 == 2) // i**2 =-1
-    {
-        pImpl->mDerivativeSign =-1;
-        pImpl->mIsReal = true;
-    }
-    else //if (order%4 == 3) // i**3 =-i
-    {
-#ifndef DNDEBUG
-        assert(order%4 == 3);
-#endif
-        pImpl->mDerivativeSign =-1;
-        pImpl->mIsReal = false;
-    } 
-    pImpl->mSamplingPeriod = dt;
-    pImpl->mOrder = order;
-} 
-
-/// Initialized?
-bool DerivativeOfGaussian::isInitialized() const noexcept
+bool DerivativeOfGaussian::normalize() const noexcept
 {
-    return pImpl->mInitialized;
+    return pImpl->mNormalize;
 }
-*/
 
 /*
 /// Get the e-folding time
@@ -226,71 +181,59 @@ double DerivativeOfGaussian::getEFoldingTime(double s) const
 double DerivativeOfGaussian::getWavelength(double s) const
 {
     double lambda = (2*M_PI*s)/std::sqrt(pImpl->mOrder + 0.5);
-    return lambda; 
+    return lambda;
 }
 */
 
 /// Evaluate the wavelet
-void DerivativeOfGaussian::evaluate(const int n,
-                                    const double scale,
-                                    const double k[],
+void DerivativeOfGaussian::evaluate(const int n, const double scale,
                                     std::complex<double> *daughterIn[]) const
 {
     if (n < 1){return;}
+    if (scale <= 0){throw std::invalid_argument("scale must be positive");}
     auto daughter = *daughterIn;
-    if (scale < 0){throw std::invalid_argument("The scale must be positive");}
-    if (k == nullptr){throw std::invalid_argument("k is NULL");}
     if (daughter == nullptr){throw std::invalid_argument("daughter is NULL");}
-    evaluateDOG(n,
-                pImpl->mIsReal, getOrder(), pImpl->mDerivativeSign,
-                getSamplingPeriod(), pImpl->mNorm, scale, k, daughter); 
-/*
-    auto m = getOrder();
-    auto dt = getSamplingPeriod();
-    double norm =-pImpl->mDerivativeSign*std::sqrt(2*M_PI*scale/dt)*pImpl->mNorm;
-    // Evaluate ala Torrence and Compo 1998, Table 1
-    if (pImpl->mIsReal)
-    {
-        #pragma omp simd
-        for (int i=0; i<n; ++i)
-        {
-            auto sk = scale*k[i];
-            auto halfsk2 = 0.5*(sk*sk);
-            auto re = norm*std::pow(sk, m)*std::exp(-halfsk2); 
-            daughter[i] = std::complex<double> (re, 0);
-        }
-    } 
-    else
-    {
-        #pragma omp simd
-        for (int i=0; i<n; ++i)
-        {
-            auto sk = scale*k[i];
-            auto halfsk2 = 0.5*(sk*sk);
-            auto im = norm*std::pow(sk, m)*std::exp(-halfsk2);
-            daughter[i] = std::complex<double> (0, im);
-        }
-    }
-*/
+    evaluateTimeDomain(n, getOrder(), pImpl->mNorm, scale, daughter,
+                       normalize());
 }
 
-void DerivativeOfGaussian::evaluate(const int n,
-                                    const float scale,
-                                    const float k[],
+void DerivativeOfGaussian::evaluate(const int n, const float scale,
                                     std::complex<float> *daughterIn[]) const
 {
     if (n < 1){return;}
+    if (scale <= 0){throw std::invalid_argument("scale must be positive");}
+    auto daughter = *daughterIn;
+    if (daughter == nullptr){throw std::invalid_argument("daughter is NULL");}
+    evaluateTimeDomain(n, getOrder(), static_cast<float> (pImpl->mNorm),
+                       scale, daughter, normalize());
+}
+
+/// Evaluate the wavelet's Fourier transform
+void DerivativeOfGaussian::evaluateFrequencyDomain(
+    const int n, const double scale, const double omega[],
+    std::complex<double> *daughterIn[]) const
+{
+    if (n < 1){return;}
+    if (scale <= 0){throw std::invalid_argument("scale must be positive");}
+    if (omega == nullptr){throw std::invalid_argument("omega is NULL");}
+    auto daughter = *daughterIn;
+    if (daughter == nullptr){throw std::invalid_argument("daughter is NULL");}
+    ::evaluateFrequencyDomain(n, getOrder(), pImpl->mNorm, scale, omega,
+                              daughter, normalize());
+}
+
+void DerivativeOfGaussian::evaluateFrequencyDomain(
+    const int n, const float scale, const float omega[],
+    std::complex<float> *daughterIn[]) const
+{
+    if (n < 1){return;}
+    if (scale <= 0){throw std::invalid_argument("scale must be positive");}
+    if (omega == nullptr){throw std::invalid_argument("omega is NULL");}
     auto daughter = *daughterIn;
-    if (scale < 0){throw std::invalid_argument("The scale must be positive");}
-    if (k == nullptr){throw std::invalid_argument("k is NULL");}
     if (daughter == nullptr){throw std::invalid_argument("daughter is NULL");}
-    evaluateDOG(n,
-                pImpl->mIsReal,
-                getOrder(),
-                pImpl->mDerivativeSign,
-                static_cast<float> (getSamplingPeriod()),
-                static_cast<float> (pImpl->mNorm),
-                scale, k, daughter);
+    ::evaluateFrequencyDomain(n, getOrder(),
+                              static_cast<float> (pImpl->mNorm),
+                              scale, omega, daughter, normalize());
 }
 
 double DerivativeOfGaussian::computeConeOfInfluenceScalar() const noexcept
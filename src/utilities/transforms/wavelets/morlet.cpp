@@ -9,32 +9,26 @@ using namespace RTSeis::Utilities::Transforms::Wavelets;
 namespace
 {
 
-/*
 template<typename T>
 void evaluateFrequencyDomain(const int n,
-                             const T waveNumber,
-                             const T dt,
+                             const T omega0, // Dimensionless wavenumber
                              const T scale,
-                             const T k[],
-                             std::complex<T> *daughter)
+                             const T omega[], // Radians/sample
+                             std::complex<T> *daughter,
+                             const bool normalize)
 {
-    const std::complex<T> czero(0, 0);
+    const T one = 1;
     const T half = 0.5;
-    const T zero = 0;
-    const T pi14 = 0.7511255444649425; // std::pow(M_PI, -0.25);
-    T arg = 2*M_PI*scale/dt;
-    T norm = std::sqrt(arg)*pi14;
-    int nhalf = n/2;
-    std::fill(daughter, daughter + n, czero);
+    // s \sqrt{2 \pi} \pi^{-1/4}
+    T norm = scale*static_cast<T> (2.5066282746310002*0.7511255444649425);
+    if (normalize){norm = one/std::sqrt(std::abs(scale))*norm;}
     #pragma omp simd
-    for (int i=0; i<nhalf + 1; ++i)
+    for (int i=0; i<n; ++i)
     {
-        T res = scale*k[i] - waveNumber;
-        T expnt = -half*(res*res);
-        daughter[i] = std::complex<T> (norm*expnt, zero);
+        T res = scale*omega[i] - omega0;
+        daughter[i] = std::complex<T> (norm*std::exp(-half*(res*res)), 0);
     }
 }
-*/
 
 template<typename T>
 void evaluateTimeDomain(const int n, 
@@ -237,6 +231,34 @@ void Morlet::evaluate(const int n, const float scale,
     evaluateTimeDomain(n, omega0, scale, daughter, lnorm);
 }
 
+void Morlet::evaluateFrequencyDomain(
+    const int n, const double scale, const double omega[],
+    std::complex<double> *daughterIn[]) const
+{
+    if (n < 1){return;}
+    if (scale <= 0){throw std::invalid_argument("scale must be positive");}
+    if (omega == nullptr){throw std::invalid_argument("omega is NULL");}
+    auto daughter = *daughterIn;
+    if (daughter == nullptr){throw std::invalid_argument("daughter is NULL");}
+    auto omega0 = getParameter();
+    auto lnorm = normalize();
+    ::evaluateFrequencyDomain(n, omega0, scale, omega, daughter, lnorm);
+}
+
+void Morlet::evaluateFrequencyDomain(
+    const int n, const float scale, const float omega[],
+    std::complex<float> *daughterIn[]) const
+{
+    if (n < 1){return;}
+    if (scale <= 0){throw std::invalid_argument("scale must be positive");}
+    if (omega == nullptr){throw std::invalid_argument("omega is NULL");}
+    auto daughter = *daughterIn;
+    if (daughter == nullptr){throw std::invalid_argument("daughter is NULL");}
+    auto omega0 = static_cast<float> (getParameter());
+    auto lnorm = normalize();
+    ::evaluateFrequencyDomain(n, omega0, scale, omega, daughter, lnorm);
+}
+
 /// Clear
 void Morlet::clear() noexcept
 {
@@ -59,28 +59,47 @@ Ricker& Ricker::operator=(Ricker &&ricker) noexcept
 /// Destructor
 Ricker::~Ricker() = default;
 
-/// Sampling period
-void Ricker::setSamplingPeriod(const double dt)
+/// Normalization
+void Ricker::enableNormalization() noexcept
 {
-    pImpl->mDOG.setSamplingPeriod(dt);
+    pImpl->mDOG.enableNormalization();
 }
 
-double Ricker::getSamplingPeriod() const noexcept
+void Ricker::disableNormalization() noexcept
 {
-    return pImpl->mDOG.getSamplingPeriod();
+    pImpl->mDOG.disableNormalization();
+}
+
+bool Ricker::normalize() const noexcept
+{
+    return pImpl->mDOG.normalize();
 }
 
 /// Evaluate
 void Ricker::evaluate(const int n, const double scale,
-                      const double k[], std::complex<double> *w[]) const
+                      std::complex<double> *w[]) const
 {
-    pImpl->mDOG.evaluate(n, scale, k, w);
+    pImpl->mDOG.evaluate(n, scale, w);
 }
 
 void Ricker::evaluate(const int n, const float scale,
-                      const float k[], std::complex<float> *w[]) const
+                      std::complex<float> *w[]) const
+{
+    pImpl->mDOG.evaluate(n, scale, w);
+}
+
+void Ricker::evaluateFrequencyDomain(const int n, const double scale,
+                                     const double omega[],
+                                     std::complex<double> *w[]) const
+{
+    pImpl->mDOG.evaluateFrequencyDomain(n, scale, omega, w);
+}
+
+void Ricker::evaluateFrequencyDomain(const int n, const float scale,
+                                     const float omega[],
+                                     std::complex<float> *w[]) const
 {
-    pImpl->mDOG.evaluate(n, scale, k, w);
+    pImpl->mDOG.evaluateFrequencyDomain(n, scale, omega, w);
 }
 
 /// Clear
@@ -1,8 +1,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <complex>
+#include <vector>
+#include <algorithm>
 #include <ipps.h>
 #include "private/throw.hpp"
+#include "private/welchScaling.hpp"
 #include "rtseis/utilities/transforms/welch.hpp"
 #include "rtseis/utilities/transforms/utilities.hpp"
 #include "rtseis/utilities/transforms/slidingWindowRealDFT.hpp"
@@ -22,12 +25,19 @@ double computeSpectrumScaling(const int npts, const double samplingRate,
     return wsum2;
 }
 
-double computeDensityScaling(const int npts, const double window[])
+/// Computes the periodogram |X|^2 of a transform window
+template<typename T>
+void computePeriodogram(const int nFrequencies,
+                        const std::complex<T> *__restrict__ dft,
+                        double *__restrict__ periodogram)
 {
-    double wsum;
-    ippsSum_64f(window, npts, &wsum);
-    wsum = wsum*wsum;
-    return wsum;
+    #pragma omp simd
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        auto re = static_cast<double> (dft[k].real());
+        auto im = static_cast<double> (dft[k].imag());
+        periodogram[k] = re*re + im*im;
+    }
 }
 
 }
@@ -35,12 +45,126 @@ double computeDensityScaling(const int npts, const double window[])
 class Welch::WelchImpl
 {
 public:
+    /// Computes the periodogram of the iWindow'th transform window
+    void computePeriodogram(const int iWindow, double *periodogram) const
+    {
+        auto nFrequencies = mSlidingWindowRealDFT.getNumberOfFrequencies();
+        if (mParameters.getPrecision() == RTSeis::Precision::DOUBLE)
+        {
+            ::computePeriodogram(nFrequencies,
+                                 mSlidingWindowRealDFT.getTransform64f(iWindow),
+                                 periodogram);
+        }
+        else
+        {
+            ::computePeriodogram(nFrequencies,
+                                 mSlidingWindowRealDFT.getTransform32f(iWindow),
+                                 periodogram);
+        }
+    }
+    /// Discards the running estimate
+    void resetAverages()
+    {
+        std::fill(mSumSpectrum.begin(), mSumSpectrum.end(), 0);
+        mPeriodograms.clear();
+        if (mMode == RTSeis::ProcessingMode::REAL_TIME &&
+            mAveraging == WelchAveraging::BLOCK)
+        {
+            mPeriodograms.resize(static_cast<size_t> (mMaxSegments)
+                                *mSumSpectrum.size(), 0);
+        }
+        mPeriodogramHead = 0;
+        mSegments = 0;
+        mUpdatesSinceSummation = 0;
+        mWeight = 0;
+        mHaveTransform = false;
+    }
+    /// Folds the windows completed by the last real-time packet into the
+    /// running estimate.
+    void updateRealTime()
+    {
+        auto nNew = mSlidingWindowRealDFT.getNumberOfNewTransformWindows();
+        auto nWindows = mSlidingWindowRealDFT.getNumberOfTransformWindows();
+        auto nFrequencies = static_cast<int> (mSumSpectrum.size());
+        double *__restrict__ sumSpectrum = mSumSpectrum.data();
+        for (int iw=nWindows-nNew; iw<nWindows; ++iw)
+        {
+            if (mAveraging == WelchAveraging::EXPONENTIAL)
+            {
+                computePeriodogram(iw, mWork.data());
+                const double *__restrict__ work = mWork.data();
+                const double lambda = mForgettingFactor;
+                #pragma omp simd
+                for (int k=0; k<nFrequencies; ++k)
+                {
+                    sumSpectrum[k] = lambda*sumSpectrum[k] + work[k];
+                }
+                mWeight = lambda*mWeight + 1;
+                continue;
+            }
+            // Replace the oldest periodogram in the block
+            double *__restrict__ oldest = mPeriodograms.data()
+                       + static_cast<size_t> (mPeriodogramHead)*nFrequencies;
+            computePeriodogram(iw, mWork.data());
+            const double *__restrict__ work = mWork.data();
+            #pragma omp simd
+            for (int k=0; k<nFrequencies; ++k)
+            {
+                sumSpectrum[k] = sumSpectrum[k] - oldest[k] + work[k];
+                oldest[k] = work[k];
+            }
+            mPeriodogramHead = (mPeriodogramHead + 1)%mMaxSegments;
+            mSegments = std::min(mSegments + 1, mMaxSegments);
+            mWeight = mSegments;
+            // Periodically re-sum the block so that the running sum does
+            // not accumulate roundoff
+            mUpdatesSinceSummation = mUpdatesSinceSummation + 1;
+            if (mUpdatesSinceSummation >= mMaxSegments)
+            {
+                std::fill(mSumSpectrum.begin(), mSumSpectrum.end(), 0);
+                for (int is=0; is<mMaxSegments; ++is)
+                {
+                    const double *__restrict__ pi = mPeriodograms.data()
+                                 + static_cast<size_t> (is)*nFrequencies;
+                    #pragma omp simd
+                    for (int k=0; k<nFrequencies; ++k)
+                    {
+                        sumSpectrum[k] = sumSpectrum[k] + pi[k];
+                    }
+                }
+                mUpdatesSinceSummation = 0;
+            }
+        }
+        if (mWeight > 0){mHaveTransform = true;}
+    }
+
     class SlidingWindowRealDFT mSlidingWindowRealDFT;
     class SlidingWindowRealDFTParameters mParameters;
+    /// The (weighted) sum of the periodograms.
     std::vector<double> mSumSpectrum;
+    /// The periodograms of the most recent segments for block averaging in
+    /// real-time.  This is a row major matrix of dimension
+    /// [mMaxSegments x nFrequencies].
+    std::vector<double> mPeriodograms;
+    /// Workspace of dimension [nFrequencies].
+    std::vector<double> mWork;
     double mSpectrumScaling = 1;
     double mDensityScaling = 1;
     double mSamplingRate = 1;
+    /// The forgetting factor for exponential averaging.
+    double mForgettingFactor = 0.9;
+    /// The sum of the weights applied to the periodograms in mSumSpectrum.
+    double mWeight = 0;
+    /// The number of segments averaged with block averaging.
+    int mMaxSegments = 1;
+    /// The row of mPeriodograms holding the oldest segment.
+    int mPeriodogramHead = 0;
+    /// The number of segments in the block.
+    int mSegments = 0;
+    /// The number of block updates since the sum was recomputed.
+    int mUpdatesSinceSummation = 0;
+    RTSeis::ProcessingMode mMode = RTSeis::ProcessingMode::POST;
+    WelchAveraging mAveraging = WelchAveraging::BLOCK;
     bool mInitialized = false;
     bool mHaveTransform = false;
 };
@@ -86,9 +210,19 @@ void Welch::clear() noexcept
     pImpl->mSlidingWindowRealDFT.clear();
     pImpl->mParameters.clear();
     pImpl->mSumSpectrum.clear();
+    pImpl->mPeriodograms.clear();
+    pImpl->mWork.clear();
     pImpl->mSpectrumScaling = 1;
     pImpl->mDensityScaling = 1;
     pImpl->mSamplingRate = 1;
+    pImpl->mForgettingFactor = 0.9;
+    pImpl->mWeight = 0;
+    pImpl->mMaxSegments = 1;
+    pImpl->mPeriodogramHead = 0;
+    pImpl->mSegments = 0;
+    pImpl->mUpdatesSinceSummation = 0;
+    pImpl->mMode = RTSeis::ProcessingMode::POST;
+    pImpl->mAveraging = WelchAveraging::BLOCK;
     pImpl->mInitialized = false;
     pImpl->mHaveTransform = false;
 }
@@ -100,7 +234,7 @@ void Welch::initialize(const SlidingWindowRealDFTParameters &parameters,
     clear();
     if (samplingRate <= 0)
     {
-        RTSEIS_THROW_IA("samplingRate = %lf must be posistive", samplingRate);
+        RTSEIS_THROW_IA("samplingRate = %lf must be positive", samplingRate);
     }
     if (!parameters.isValid())
     {
@@ -124,10 +258,21 @@ void Welch::initialize(const SlidingWindowRealDFTParameters &parameters,
     pImpl->mSpectrumScaling = computeSpectrumScaling(nWindow,
                                                      pImpl->mSamplingRate,
                                                      window.data());
-    pImpl->mDensityScaling = computeDensityScaling(nWindow, window.data()); 
+    pImpl->mDensityScaling
+        = WelchScaling::computeDensityScaling(nWindow, window.data());
     // Set space for the intermediate output
     int nfreqs = pImpl->mSlidingWindowRealDFT.getNumberOfFrequencies();
     pImpl->mSumSpectrum.resize(nfreqs);
+    pImpl->mWork.resize(nfreqs);
+    // In real-time block averaging uses the segments retained by the
+    // sliding window DFT
+    pImpl->mMode = pImpl->mParameters.getProcessingMode();
+    auto nSamplesPerSegment = pImpl->mParameters.getWindowLength();
+    auto nSamplesInOverlap = pImpl->mParameters.getNumberOfSamplesInOverlap();
+    pImpl->mMaxSegments = std::max(1,
+        (pImpl->mParameters.getNumberOfSamples() - nSamplesInOverlap)
+       /(nSamplesPerSegment - nSamplesInOverlap));
+    pImpl->resetAverages();
     pImpl->mInitialized = true;
 }
 
@@ -157,12 +302,80 @@ int Welch::getNumberOfSamples() const
         RTSEIS_THROW_RTE("%s", "Class is not initialized");
     }
     return pImpl->mSlidingWindowRealDFT.getNumberOfSamples();
+}
 
+RTSeis::ProcessingMode Welch::getProcessingMode() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mMode;
 }
+
+/// Real-time averaging
+void Welch::setBlockAveraging()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    pImpl->mAveraging = WelchAveraging::BLOCK;
+    pImpl->resetAverages();
+}
+
+void Welch::setExponentialAveraging(const double forgettingFactor)
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    if (forgettingFactor <= 0 || forgettingFactor >= 1)
+    {
+        RTSEIS_THROW_IA("forgettingFactor = %lf must be in range (0,1)",
+                        forgettingFactor);
+    }
+    pImpl->mAveraging = WelchAveraging::EXPONENTIAL;
+    pImpl->mForgettingFactor = forgettingFactor;
+    pImpl->resetAverages();
+}
+
+WelchAveraging Welch::getAveraging() const
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    return pImpl->mAveraging;
+}
+
+void Welch::resetInitialConditions()
+{
+    if (!isInitialized())
+    {
+        RTSEIS_THROW_RTE("%s", "Class is not initialized");
+    }
+    pImpl->mSlidingWindowRealDFT.resetInitialConditions();
+    pImpl->resetAverages();
+}
+
 void Welch::transform(const int nSamples, const double x[])
 {
-    pImpl->mHaveTransform = true;
     int nSamplesRef = getNumberOfSamples(); // Throws if not inittialized
+    if (pImpl->mMode == RTSeis::ProcessingMode::REAL_TIME)
+    {
+        if (nSamples < 0)
+        {
+            RTSEIS_THROW_IA("nSamples = %d must be non-negative", nSamples);
+        }
+        if (nSamples > 0 && x == nullptr)
+        {
+            RTSEIS_THROW_IA("%s", "x is NULL");
+        }
+        pImpl->mSlidingWindowRealDFT.transform(nSamples, x);
+        pImpl->updateRealTime();
+        return;
+    }
     if (nSamples != nSamplesRef)
     {
         RTSEIS_THROW_IA("nSamples = %d must equal %d", nSamples, nSamplesRef);
@@ -174,27 +387,19 @@ void Welch::transform(const int nSamples, const double x[])
     auto nWindows = pImpl->mSlidingWindowRealDFT.getNumberOfTransformWindows();
     // Initialize the summation
     double *pSumSpectrum = pImpl->mSumSpectrum.data();
-    auto cPtr = pImpl->mSlidingWindowRealDFT.getTransform64f(0);
-    auto pDFT = reinterpret_cast<const Ipp64fc *> (cPtr);
-    #pragma omp simd
-    for (auto k=0; k<nFrequencies; ++k)
-    {
-        pSumSpectrum[k] = pDFT[k].re*pDFT[k].re
-                        + pDFT[k].im*pDFT[k].im;
-    }
+    pImpl->computePeriodogram(0, pSumSpectrum);
     // And sum the other windows
+    double *pWork = pImpl->mWork.data();
     for (auto i=1; i<nWindows; ++i)
     {
-        cPtr = pImpl->mSlidingWindowRealDFT.getTransform64f(i);
-        pDFT = reinterpret_cast<const Ipp64fc *> (cPtr);
+        pImpl->computePeriodogram(i, pWork);
         #pragma omp simd
         for (auto k=0; k<nFrequencies; ++k)
         {
-            pSumSpectrum[k] = pSumSpectrum[k]
-                            + pDFT[k].re*pDFT[k].re
-                            + pDFT[k].im*pDFT[k].im;
+            pSumSpectrum[k] = pSumSpectrum[k] + pWork[k];
         }
     }
+    pImpl->mWeight = nWindows;
     pImpl->mHaveTransform = true;
 }
 
@@ -213,10 +418,9 @@ void Welch::getPowerSpectrum(const int nFrequencies,
     {
         RTSEIS_THROW_RTE("%s", "welch transform not yet computed");
     }
-    // Copy and scale
-    auto nWindows = pImpl->mSlidingWindowRealDFT.getNumberOfTransformWindows();
+    // Copy and scale by the (weighted) number of averaged segments
     double xscal = 0;
-    if (nFreqs > 0){xscal = 2.0/(nWindows*pImpl->mSpectrumScaling);}
+    if (nFreqs > 0){xscal = 2.0/(pImpl->mWeight*pImpl->mSpectrumScaling);}
     ippsMulC_64f(pImpl->mSumSpectrum.data(), xscal, ptr, nFreqs);
 }
 
@@ -234,10 +438,9 @@ void Welch::getPowerSpectralDensity(const int nFrequencies, double *psd[]) const
     {
         RTSEIS_THROW_RTE("%s", "welch transform not yet computed");
     }
-    auto nWindows = pImpl->mSlidingWindowRealDFT.getNumberOfTransformWindows();
-    // Copy and scale
+    // Copy and scale by the (weighted) number of averaged segments
     double xscal = 0;
-    if (nFreqs > 0){xscal = 2.0/(nWindows*pImpl->mDensityScaling);}
+    if (nFreqs > 0){xscal = 2.0/(pImpl->mWeight*pImpl->mDensityScaling);}
     ippsMulC_64f(pImpl->mSumSpectrum.data(), xscal, ptr, nFreqs);
 }
 
@@ -2,14 +2,16 @@
 #include <cstdlib>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <ipps.h>
 #include "private/throw.hpp"
 #include "rtseis/utilities/trigger/waterLevel.hpp"
 
-using namespace RTSeis::Utilities::Trigger::PostProcessing;
+namespace PostProcessing = RTSeis::Utilities::Trigger::PostProcessing;
+namespace RealTime = RTSeis::Utilities::Trigger::RealTime;
 
 template<class T>
-class WaterLevel<T>::WaterLevelImpl
+class PostProcessing::WaterLevel<T>::WaterLevelImpl
 {
 public:
     std::vector<std::pair<int, int>> mWindows;
@@ -21,28 +23,29 @@ public:
 
 /// C'tor
 template<class T>
-WaterLevel<T>::WaterLevel() :
+PostProcessing::WaterLevel<T>::WaterLevel() :
     pImpl(std::make_unique<WaterLevelImpl> ())
 {
 }
 
 /// Copy c'tor
 template<class T>
-WaterLevel<T>::WaterLevel(const WaterLevel &trigger)
+PostProcessing::WaterLevel<T>::WaterLevel(const WaterLevel &trigger)
 {
     *this = trigger;
 }
 
 /// Move c'tor
 template<class T>
-WaterLevel<T>::WaterLevel(WaterLevel &&trigger) noexcept
+PostProcessing::WaterLevel<T>::WaterLevel(WaterLevel &&trigger) noexcept
 {
     *this = std::move(trigger);
 }
 
 /// Copy assignment operator
 template<class T>
-WaterLevel<T>& WaterLevel<T>::operator=(const WaterLevel &trigger)
+PostProcessing::WaterLevel<T>&
+PostProcessing::WaterLevel<T>::operator=(const WaterLevel &trigger)
 {
     if (&trigger == this){return *this;}
     pImpl = std::make_unique<WaterLevelImpl> (*trigger.pImpl);
@@ -51,7 +54,8 @@ WaterLevel<T>& WaterLevel<T>::operator=(const WaterLevel &trigger)
 
 /// Move assignment operator
 template<class T>
-WaterLevel<T>& WaterLevel<T>::operator=(WaterLevel &&trigger) noexcept
+PostProcessing::WaterLevel<T>&
+PostProcessing::WaterLevel<T>::operator=(WaterLevel &&trigger) noexcept
 {
     if (&trigger == this){return *this;}
     pImpl = std::move(trigger.pImpl);
@@ -60,11 +64,11 @@ WaterLevel<T>& WaterLevel<T>::operator=(WaterLevel &&trigger) noexcept
 
 /// Destructor
 template<class T>
-WaterLevel<T>::~WaterLevel() = default;
+PostProcessing::WaterLevel<T>::~WaterLevel() = default;
 
 /// Clears the class
 template<class T>
-void WaterLevel<T>::clear() noexcept
+void PostProcessing::WaterLevel<T>::clear() noexcept
 {
     pImpl->mWindows.clear();
     pImpl->mOnTolerance = 0;
@@ -74,15 +78,15 @@ void WaterLevel<T>::clear() noexcept
 
 /// Gets the number of triggers
 template<class T>
-int WaterLevel<T>::getNumberOfWindows() const noexcept
+int PostProcessing::WaterLevel<T>::getNumberOfWindows() const noexcept
 {
     return static_cast<int> (pImpl->mWindows.size());
 }
 
 /// Initialize the class
 template<class T>
-void WaterLevel<T>::initialize(const double onTolerance,
-                               const double offTolerance)
+void PostProcessing::WaterLevel<T>::initialize(const double onTolerance,
+                                               const double offTolerance)
 {
     clear();
     pImpl->mOnTolerance = onTolerance;
@@ -92,14 +96,15 @@ void WaterLevel<T>::initialize(const double onTolerance,
 
 /// Is the class initialized?
 template<class T>
-bool WaterLevel<T>::isInitialized() const noexcept
+bool PostProcessing::WaterLevel<T>::isInitialized() const noexcept
 {
     return pImpl->mInitialized;
 }
 
 /// Gets the triggers
 template<class T>
-std::vector<std::pair<int, int>> WaterLevel<T>::getWindows() const
+std::vector<std::pair<int, int>>
+PostProcessing::WaterLevel<T>::getWindows() const
 {
     if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
     return pImpl->mWindows;
@@ -107,8 +112,8 @@ std::vector<std::pair<int, int>> WaterLevel<T>::getWindows() const
 
 /// Gets the triggers
 template<class T>
-void WaterLevel<T>::getWindows(const int nWindows,
-                               std::pair<int, int> *windowsIn[]) const
+void PostProcessing::WaterLevel<T>::getWindows(
+    const int nWindows, std::pair<int, int> *windowsIn[]) const
 {
     if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
     auto nwinRef = getNumberOfWindows();
@@ -122,7 +127,7 @@ void WaterLevel<T>::getWindows(const int nWindows,
 
 /// Applies
 template<class T>
-void WaterLevel<T>::apply(const int nSamples, const T x[])
+void PostProcessing::WaterLevel<T>::apply(const int nSamples, const T x[])
 {
     pImpl->mWindows.clear();
     if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
@@ -201,6 +206,246 @@ void WaterLevel<T>::apply(const int nSamples, const T x[])
 */
 }
 
+//----------------------------------------------------------------------------//
+//                                  Real Time                                 //
+//----------------------------------------------------------------------------//
+template<class T>
+class RealTime::WaterLevel<T>::WaterLevelImpl
+{
+public:
+    /// Resets the state machine
+    void resetInitialConditions() noexcept
+    {
+        mSamplesProcessed = 0;
+        mPrevious = 0;
+        mNumberOfEvents = 0;
+        mDroppedEvents = 0;
+        mHavePrevious = false;
+        mTriggered = false;
+    }
+    /// Records an event
+    void addEvent(const int64_t sample, const bool isOn) noexcept
+    {
+        if (mNumberOfEvents < static_cast<int> (mEvents.size()))
+        {
+            mEvents[mNumberOfEvents].sample = sample;
+            mEvents[mNumberOfEvents].isOn = isOn;
+            mNumberOfEvents = mNumberOfEvents + 1;
+        }
+        else
+        {
+            mDroppedEvents = mDroppedEvents + 1;
+        }
+    }
+    /// Advances the state machine
+    void apply(const int nSamples, const T x[]) noexcept
+    {
+        mNumberOfEvents = 0;
+        mDroppedEvents = 0;
+        if (nSamples < 1){return;}
+        const auto on  = static_cast<T> (mOnTolerance);
+        const auto off = static_cast<T> (mOffTolerance);
+        int i0 = 0;
+        // The very first sample can only turn the trigger on
+        if (!mHavePrevious)
+        {
+            if (x[0] > on)
+            {
+                addEvent(mSamplesProcessed, true);
+                mTriggered = true;
+            }
+            mPrevious = x[0];
+            mHavePrevious = true;
+            i0 = 1;
+        }
+        auto previous = mPrevious;
+        auto triggered = mTriggered;
+        for (int i=i0; i<nSamples; ++i)
+        {
+            // Searching for end of window
+            if (triggered)
+            {
+                if (previous >= off && x[i] < off)
+                {
+                    addEvent(mSamplesProcessed + i, false);
+                    triggered = false;
+                }
+            }
+            // Searching for start of window
+            else
+            {
+                if (previous < on && x[i] >= on)
+                {
+                    addEvent(mSamplesProcessed + i, true);
+                    triggered = true;
+                }
+            }
+            previous = x[i];
+        }
+        mPrevious = previous;
+        mTriggered = triggered;
+        mSamplesProcessed = mSamplesProcessed + nSamples;
+    }
+    /// The event buffer.  This is allocated on initialization.
+    std::vector<WaterLevelEvent> mEvents;
+    /// The number of samples processed since initialization or reset.
+    int64_t mSamplesProcessed = 0;
+    /// The on and off tolerances.
+    double mOnTolerance = 0;
+    double mOffTolerance = 0;
+    /// The last sample of the previous packet.
+    T mPrevious = 0;
+    /// The number of events found by the last application.
+    int mNumberOfEvents = 0;
+    /// The number of events that did not fit in the buffer.
+    int mDroppedEvents = 0;
+    /// Flag indicating the previous sample is valid.
+    bool mHavePrevious = false;
+    /// Flag indicating a trigger window is open.
+    bool mTriggered = false;
+    bool mInitialized = false;
+};
+
+/// C'tor
+template<class T>
+RealTime::WaterLevel<T>::WaterLevel() :
+    pImpl(std::make_unique<WaterLevelImpl> ())
+{
+}
+
+/// Copy c'tor
+template<class T>
+RealTime::WaterLevel<T>::WaterLevel(const WaterLevel &trigger)
+{
+    *this = trigger;
+}
+
+/// Move c'tor
+template<class T>
+RealTime::WaterLevel<T>::WaterLevel(WaterLevel &&trigger) noexcept
+{
+    *this = std::move(trigger);
+}
+
+/// Copy assignment operator
+template<class T>
+RealTime::WaterLevel<T>&
+RealTime::WaterLevel<T>::operator=(const WaterLevel &trigger)
+{
+    if (&trigger == this){return *this;}
+    pImpl = std::make_unique<WaterLevelImpl> (*trigger.pImpl);
+    return *this;
+}
+
+/// Move assignment operator
+template<class T>
+RealTime::WaterLevel<T>&
+RealTime::WaterLevel<T>::operator=(WaterLevel &&trigger) noexcept
+{
+    if (&trigger == this){return *this;}
+    pImpl = std::move(trigger.pImpl);
+    return *this;
+}
+
+/// Destructor
+template<class T>
+RealTime::WaterLevel<T>::~WaterLevel() = default;
+
+/// Clears the class
+template<class T>
+void RealTime::WaterLevel<T>::clear() noexcept
+{
+    pImpl->resetInitialConditions();
+    pImpl->mEvents.clear();
+    pImpl->mOnTolerance = 0;
+    pImpl->mOffTolerance = 0;
+    pImpl->mInitialized = false;
+}
+
+/// Initialize the class
+template<class T>
+void RealTime::WaterLevel<T>::initialize(const double onTolerance,
+                                         const double offTolerance,
+                                         const int maxEvents)
+{
+    clear();
+    if (maxEvents < 1)
+    {
+        RTSEIS_THROW_IA("maxEvents = %d must be positive", maxEvents);
+    }
+    pImpl->mEvents.resize(maxEvents);
+    pImpl->mOnTolerance = onTolerance;
+    pImpl->mOffTolerance = offTolerance;
+    pImpl->mInitialized = true;
+}
+
+/// Is the class initialized?
+template<class T>
+bool RealTime::WaterLevel<T>::isInitialized() const noexcept
+{
+    return pImpl->mInitialized;
+}
+
+/// Resets the state machine
+template<class T>
+void RealTime::WaterLevel<T>::resetInitialConditions()
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    pImpl->resetInitialConditions();
+}
+
+/// Applies
+template<class T>
+void RealTime::WaterLevel<T>::apply(const int nSamples, const T x[])
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    if (nSamples > 0 && x == nullptr){RTSEIS_THROW_IA("%s", "x is NULL");}
+    pImpl->apply(nSamples, x);
+}
+
+/// Is the trigger on?
+template<class T>
+bool RealTime::WaterLevel<T>::isTriggered() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mTriggered;
+}
+
+/// Gets the number of events
+template<class T>
+int RealTime::WaterLevel<T>::getNumberOfEvents() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mNumberOfEvents;
+}
+
+/// Gets the number of dropped events
+template<class T>
+int RealTime::WaterLevel<T>::getNumberOfDroppedEvents() const
+{
+    if (!isInitialized()){RTSEIS_THROW_RTE("%s", "Class not initialized");}
+    return pImpl->mDroppedEvents;
+}
+
+/// Gets the events
+template<class T>
+void RealTime::WaterLevel<T>::getEvents(const int nEvents,
+                                        WaterLevelEvent *eventsIn[]) const
+{
+    auto nEventsRef = getNumberOfEvents(); // Throws
+    if (nEvents != nEventsRef)
+    {
+        RTSEIS_THROW_IA("nEvents = %d must equal %d", nEvents, nEventsRef);
+    }
+    if (nEvents < 1){return;}
+    auto events = *eventsIn;
+    if (events == nullptr){RTSEIS_THROW_IA("%s", "events is NULL");}
+    std::copy(pImpl->mEvents.begin(), pImpl->mEvents.begin() + nEvents,
+              events);
+}
+
 /// Template instantiation
 template class RTSeis::Utilities::Trigger::PostProcessing::WaterLevel<double>;
 template class RTSeis::Utilities::Trigger::PostProcessing::WaterLevel<float>;
+template class RTSeis::Utilities::Trigger::RealTime::WaterLevel<double>;
+template class RTSeis::Utilities::Trigger::RealTime::WaterLevel<float>;
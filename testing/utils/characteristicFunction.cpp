@@ -5,10 +5,21 @@
 #include <numeric>
 #include <cmath>
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <ipps.h>
+#include "private/channelBlocks.hpp"
 #include "rtseis/utilities/characteristicFunction/classicSTALTA.hpp"
 #include "rtseis/utilities/characteristicFunction/carlSTALTA.hpp"
+#include "rtseis/utilities/characteristicFunction/characteristicFunctionBank.hpp"
+#include "rtseis/utilities/characteristicFunction/iirKurtosis.hpp"
+#include "rtseis/utilities/characteristicFunction/multiChannelClassicSTALTA.hpp"
+#include "rtseis/utilities/characteristicFunction/multiChannelIIRKurtosis.hpp"
+#include "rtseis/utilities/characteristicFunction/recursiveSTALTA.hpp"
+#include "rtseis/utilities/transforms/firEnvelope.hpp"
 #include <gtest/gtest.h>
 
 namespace
@@ -91,6 +102,568 @@ TEST(UtilitiesCharacteristicFunction, carlSTALTA)
 */
 }
 
+TEST(UtilitiesCharacteristicFunction, multiChannelClassicSTALTA)
+{
+    int nlta = 2000;
+    int nsta = 1000;
+    auto x = readTextFile("data/gse2.txt");
+    auto yRef = readTextFile("data/classicSTALTA_ref.txt");
+    ASSERT_TRUE(x.size() > 0);
+    ASSERT_TRUE(x.size() == yRef.size());
+    // The STA/LTA is scale invariant so every channel should match
+    const int nChannels = 67;
+    auto nSamples = static_cast<int> (x.size());
+    std::vector<double> xs(nSamples*nChannels);
+    for (int i=0; i<nSamples; ++i)
+    {
+        for (int c=0; c<nChannels; ++c)
+        {
+            xs[i*nChannels + c] = static_cast<double> (c + 1)*x[i];
+        }
+    }
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::POST, double> stalta;
+    EXPECT_NO_THROW(stalta.initialize(nChannels, nsta, nlta));
+    EXPECT_TRUE(stalta.isInitialized());
+    EXPECT_EQ(stalta.getNumberOfChannels(), nChannels);
+    EXPECT_EQ(stalta.getShortTermWindowLength(), nsta);
+    EXPECT_EQ(stalta.getLongTermWindowLength(), nlta);
+    std::vector<double> y(xs.size());
+    auto yPtr = y.data();
+    for (int k=0; k<2; ++k) // Second application verifies the reset
+    {
+        EXPECT_NO_THROW(stalta.apply(nSamples, xs.data(), &yPtr));
+        double error = 0;
+        for (int i=0; i<nSamples; ++i)
+        {
+            for (int c=0; c<nChannels; ++c)
+            {
+                error = std::max(error,
+                                 std::abs(y[i*nChannels + c] - yRef[i]));
+            }
+        }
+        EXPECT_LT(error, 1.e-8);
+    }
+    // Real-time with random packet sizes should match post-processing
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::REAL_TIME, double> rt;
+    EXPECT_NO_THROW(rt.initialize(nChannels, nsta, nlta));
+    std::vector<double> yrt(xs.size());
+    for (int iter=0; iter<2; ++iter)
+    {
+        int i0 = 0;
+        while (i0 < nSamples)
+        {
+            auto nloc = std::min(nSamples - i0, 1 + rand()%700);
+            auto yrtPtr = yrt.data() + i0*nChannels;
+            EXPECT_NO_THROW(rt.apply(nloc, xs.data() + i0*nChannels,
+                                     &yrtPtr));
+            i0 = i0 + nloc;
+        }
+        double error;
+        ippsNormDiff_Inf_64f(y.data(), yrt.data(), y.size(), &error);
+        EXPECT_LT(error, 1.e-10);
+        rt.resetInitialConditions();
+    }
+    // Copy
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::POST, double>
+        staltaCopy(stalta);
+    EXPECT_NO_THROW(staltaCopy.apply(nSamples, xs.data(), &yPtr));
+    double error;
+    ippsNormDiff_Inf_64f(y.data(), yrt.data(), y.size(), &error);
+    EXPECT_LT(error, 1.e-10);
+    // Long run with short windows exercises the periodic re-summation.
+    // Compare to a brute force computation.
+    nsta = 5;
+    nlta = 23;
+    nSamples = 5000;
+    const int nc = 3;
+    std::vector<float> xf(nSamples*nc);
+    for (auto &xi : xf){xi = static_cast<float> (rand())/RAND_MAX - 0.5f;}
+    // Long quiet stretch in which the output must be zero
+    std::fill(xf.begin() + 2000*nc, xf.begin() + 2500*nc, 0);
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::REAL_TIME, float> rtf;
+    EXPECT_NO_THROW(rtf.initialize(nc, nsta, nlta));
+    std::vector<float> yf(xf.size());
+    int i0 = 0;
+    while (i0 < nSamples)
+    {
+        auto nloc = std::min(nSamples - i0, 1 + rand()%50);
+        auto yfPtr = yf.data() + i0*nc;
+        EXPECT_NO_THROW(rtf.apply(nloc, xf.data() + i0*nc, &yfPtr));
+        i0 = i0 + nloc;
+    }
+    const double primer = std::numeric_limits<float>::max()/(4*nlta);
+    double emax = 0;
+    for (int c=0; c<nc; ++c)
+    {
+        for (int i=0; i<nSamples; ++i)
+        {
+            double sta = 0;
+            for (int j=std::max(0, i-nsta+1); j<=i; ++j)
+            {
+                double x2 = xf[j*nc + c]*xf[j*nc + c];
+                sta = sta + x2;
+            }
+            double lta = 0;
+            for (int j=std::max(0, i-nlta+1); j<=i; ++j)
+            {
+                double x2 = xf[j*nc + c]*xf[j*nc + c];
+                lta = lta + x2;
+            }
+            double yi = 0;
+            if (lta > 0)
+            {
+                lta = (lta + primer*std::max(0, nlta - 1 - i))/nlta;
+                yi = (sta/nsta)/lta;
+            }
+            emax = std::max(emax, std::abs(yi - yf[i*nc + c]));
+        }
+    }
+    EXPECT_LT(emax, 1.e-5);
+}
+
+TEST(UtilitiesCharacteristicFunction, multiChannelClassicSTALTASmallAmplitude)
+{
+    // Ground motions in m or m/s are tiny.  The STA/LTA is scale invariant
+    // so the second channel, scaled by 1e-9, must match the first channel.
+    const int nlta = 200;
+    const int nsta = 20;
+    auto x = readTextFile("data/gse2.txt");
+    ASSERT_TRUE(x.size() > 0);
+    auto nSamples = static_cast<int> (x.size());
+    std::vector<double> xs(2*nSamples);
+    std::vector<float> xf(2*nSamples);
+    for (int i=0; i<nSamples; ++i)
+    {
+        xs[2*i] = x[i];
+        xs[2*i + 1] = 1.e-9*x[i];
+        xf[2*i] = static_cast<float> (xs[2*i]);
+        xf[2*i + 1] = static_cast<float> (xs[2*i + 1]);
+    }
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::POST, double> stalta;
+    EXPECT_NO_THROW(stalta.initialize(2, nsta, nlta));
+    std::vector<double> y(xs.size());
+    auto yPtr = y.data();
+    EXPECT_NO_THROW(stalta.apply(nSamples, xs.data(), &yPtr));
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::POST, float> staltaf;
+    EXPECT_NO_THROW(staltaf.initialize(2, nsta, nlta));
+    std::vector<float> yf(xf.size());
+    auto yfPtr = yf.data();
+    EXPECT_NO_THROW(staltaf.apply(nSamples, xf.data(), &yfPtr));
+    double ymax = 0;
+    double emax = 0;
+    double emaxf = 0;
+    for (int i=nlta; i<nSamples; ++i)
+    {
+        ymax = std::max(ymax, y[2*i]);
+        emax = std::max(emax, std::abs(y[2*i + 1] - y[2*i])
+                             /std::max(1.0, y[2*i]));
+        emaxf = std::max(emaxf,
+                         std::abs(static_cast<double> (yf[2*i + 1] - yf[2*i]))
+                        /std::max(1.0, static_cast<double> (yf[2*i])));
+    }
+    EXPECT_GT(ymax, 1);
+    EXPECT_LT(emax, 1.e-10);
+    EXPECT_LT(emaxf, 1.e-4);
+}
+
+TEST(UtilitiesCharacteristicFunction, recursiveSTALTA)
+{
+    int nlta = 2000;
+    int nsta = 200;
+    auto x = readTextFile("data/gse2.txt");
+    ASSERT_TRUE(x.size() > 0);
+    auto nSamples = static_cast<int> (x.size());
+    // Reference follows ObsPy's recursive_sta_lta
+    std::vector<double> yRef(nSamples, 0);
+    double sta = 0;
+    double lta = 0;
+    for (int i=0; i<nSamples; ++i)
+    {
+        sta = (1./nsta)*x[i]*x[i] + (1 - 1./nsta)*sta;
+        lta = (1./nlta)*x[i]*x[i] + (1 - 1./nlta)*lta;
+        if (i >= nlta){yRef[i] = sta/lta;}
+    }
+    RecursiveSTALTA<RTSeis::ProcessingMode::POST, double> stalta;
+    EXPECT_NO_THROW(stalta.initialize(nsta, nlta));
+    EXPECT_TRUE(stalta.isInitialized());
+    EXPECT_EQ(stalta.getNumberOfChannels(), 1);
+    std::vector<double> y(nSamples);
+    auto yPtr = y.data();
+    EXPECT_NO_THROW(stalta.apply(nSamples, x.data(), &yPtr));
+    double error;
+    ippsNormDiff_Inf_64f(yRef.data(), y.data(), nSamples, &error);
+    EXPECT_LT(error, 1.e-10);
+    // In place
+    std::vector<double> xy(x);
+    auto xyPtr = xy.data();
+    EXPECT_NO_THROW(stalta.apply(nSamples, xy.data(), &xyPtr));
+    EXPECT_TRUE(std::equal(xy.begin(), xy.end(), y.begin()));
+    // The state carries across 1-sample packets, including the end of
+    // the warm-up period
+    RecursiveSTALTA<RTSeis::ProcessingMode::REAL_TIME, double> rt;
+    EXPECT_NO_THROW(rt.initialize(nsta, nlta));
+    std::vector<double> yrt(nSamples);
+    for (int i=0; i<nSamples; ++i)
+    {
+        auto yrtPtr = yrt.data() + i;
+        EXPECT_NO_THROW(rt.apply(1, x.data() + i, &yrtPtr));
+    }
+    EXPECT_TRUE(std::equal(yrt.begin(), yrt.end(), y.begin()));
+}
+
+TEST(UtilitiesCharacteristicFunction, recursiveSTALTASmallAmplitude)
+{
+    // Like ObsPy there is no absolute threshold so the second channel,
+    // scaled by 1e-9, must match the first channel.
+    const int nlta = 200;
+    const int nsta = 20;
+    auto x = readTextFile("data/gse2.txt");
+    ASSERT_TRUE(x.size() > 0);
+    auto nSamples = static_cast<int> (x.size());
+    std::vector<double> xs(2*nSamples);
+    std::vector<float> xf(2*nSamples);
+    for (int i=0; i<nSamples; ++i)
+    {
+        xs[2*i] = x[i];
+        xs[2*i + 1] = 1.e-9*x[i];
+        xf[2*i] = static_cast<float> (xs[2*i]);
+        xf[2*i + 1] = static_cast<float> (xs[2*i + 1]);
+    }
+    RecursiveSTALTA<RTSeis::ProcessingMode::POST, double> stalta;
+    EXPECT_NO_THROW(stalta.initialize(2, nsta, nlta));
+    std::vector<double> y(xs.size());
+    auto yPtr = y.data();
+    EXPECT_NO_THROW(stalta.apply(nSamples, xs.data(), &yPtr));
+    RecursiveSTALTA<RTSeis::ProcessingMode::POST, float> staltaf;
+    EXPECT_NO_THROW(staltaf.initialize(2, nsta, nlta));
+    std::vector<float> yf(xf.size());
+    auto yfPtr = yf.data();
+    EXPECT_NO_THROW(staltaf.apply(nSamples, xf.data(), &yfPtr));
+    double ymax = 0;
+    double emax = 0;
+    double emaxf = 0;
+    for (int i=nlta; i<nSamples; ++i)
+    {
+        ymax = std::max(ymax, y[2*i]);
+        emax = std::max(emax, std::abs(y[2*i + 1] - y[2*i])
+                             /std::max(1.0, y[2*i]));
+        emaxf = std::max(emaxf,
+                         std::abs(static_cast<double> (yf[2*i + 1] - yf[2*i]))
+                        /std::max(1.0, static_cast<double> (yf[2*i])));
+    }
+    EXPECT_GT(ymax, 1);
+    EXPECT_LT(emax, 1.e-10);
+    EXPECT_LT(emaxf, 1.e-4);
+}
+
+TEST(UtilitiesCharacteristicFunction, recursiveSTALTAStepResponse)
+{
+    // A step of amplitude a at sample n0 gives
+    //   STA[n] = a^2 (1 - (1 - 1/nsta)^(n - n0 + 1))
+    // and likewise for the LTA so the ratio does not depend on a.
+    const int nsta = 10;
+    const int nlta = 100;
+    const int n0 = 50;
+    const int nSamples = 1000;
+    const std::vector<double> amplitudes({1, 25, 1.e-3});
+    const auto nChannels = static_cast<int> (amplitudes.size());
+    std::vector<double> x(nSamples*nChannels, 0);
+    std::vector<float> xf(x.size(), 0);
+    for (int i=n0; i<nSamples; ++i)
+    {
+        for (int c=0; c<nChannels; ++c)
+        {
+            x[i*nChannels + c] = amplitudes[c];
+            xf[i*nChannels + c] = static_cast<float> (amplitudes[c]);
+        }
+    }
+    RecursiveSTALTA<RTSeis::ProcessingMode::POST, double> stalta;
+    EXPECT_NO_THROW(stalta.initialize(nChannels, nsta, nlta));
+    std::vector<double> y(x.size());
+    auto yPtr = y.data();
+    EXPECT_NO_THROW(stalta.apply(nSamples, x.data(), &yPtr));
+    RecursiveSTALTA<RTSeis::ProcessingMode::POST, float> staltaf;
+    EXPECT_NO_THROW(staltaf.initialize(nChannels, nsta, nlta));
+    std::vector<float> yf(xf.size());
+    auto yfPtr = yf.data();
+    EXPECT_NO_THROW(staltaf.apply(nSamples, xf.data(), &yfPtr));
+    double emax = 0;
+    double emaxf = 0;
+    for (int i=0; i<nSamples; ++i)
+    {
+        double yi = 0;
+        if (i >= nlta)
+        {
+            auto m = static_cast<double> (i - n0 + 1);
+            yi = (1 - std::pow(1 - 1./nsta, m))/(1 - std::pow(1 - 1./nlta, m));
+        }
+        for (int c=0; c<nChannels; ++c)
+        {
+            emax = std::max(emax, std::abs(y[i*nChannels + c] - yi));
+            emaxf = std::max(emaxf, std::abs(yf[i*nChannels + c] - yi));
+        }
+    }
+    EXPECT_LT(emax, 1.e-12);
+    EXPECT_LT(emaxf, 1.e-5);
+}
+
+TEST(UtilitiesCharacteristicFunction, multiChannelIIRKurtosis)
+{
+    const double c1 = 0.01;
+    const double bias =-3*c1 - 3;
+    const int nSamples = 200;
+    // A signal equal to its running mean has no fluctuation so only the
+    // bias enters the recursion.  With k4bar = 0 initially this gives
+    //   y[n] = kStar (1 - (1 + c1)^(n + 1)), kStar =-bias/c1,
+    // regardless of the level or the second moment.
+    const std::vector<double> levels({0, 1, -7.5});
+    const std::vector<double> mu2s({1, 0.25, 40});
+    const auto nChannels = static_cast<int> (levels.size());
+    std::vector<double> x(nSamples*nChannels);
+    for (int i=0; i<nSamples; ++i)
+    {
+        for (int c=0; c<nChannels; ++c){x[i*nChannels + c] = levels[c];}
+    }
+    MultiChannelIIRKurtosis<RTSeis::ProcessingMode::POST, double> kurtosis;
+    EXPECT_NO_THROW(kurtosis.initialize(nChannels, c1));
+    EXPECT_TRUE(kurtosis.isInitialized());
+    EXPECT_EQ(kurtosis.getNumberOfChannels(), nChannels);
+    for (int c=0; c<nChannels; ++c)
+    {
+        EXPECT_NO_THROW(kurtosis.setInitialConditions(c, levels[c],
+                                                      mu2s[c], 0));
+    }
+    std::vector<double> y(x.size());
+    auto yPtr = y.data();
+    EXPECT_NO_THROW(kurtosis.apply(nSamples, x.data(), &yPtr));
+    const double kStar =-bias/c1;
+    double emax = 0;
+    for (int i=0; i<nSamples; ++i)
+    {
+        auto yi = kStar*(1 - std::pow(1 + c1, i + 1));
+        for (int c=0; c<nChannels; ++c)
+        {
+            emax = std::max(emax,
+                            std::abs(y[i*nChannels + c] - yi)/std::abs(yi));
+        }
+    }
+    EXPECT_LT(emax, 1.e-12);
+    // An impulse of amplitude A from the default state (mu1 = 0, mu2 = 1,
+    // k4bar = 0).  The first sample is c1 A^4 + bias.  The running mean is
+    // then c1 A and mu2 is (1 - c1) + c2 A^2 so the next sample follows
+    // with dx2 = (c1 A)^2/mu2.
+    const std::vector<double> amplitudes({1, 2, 0.5});
+    std::fill(x.begin(), x.end(), 0);
+    for (int c=0; c<nChannels; ++c){x[c] = amplitudes[c];}
+    MultiChannelIIRKurtosis<RTSeis::ProcessingMode::REAL_TIME, double> rt;
+    EXPECT_NO_THROW(rt.initialize(nChannels, c1));
+    std::vector<double> yrt(x.size());
+    for (int i=0; i<nSamples; ++i)
+    {
+        auto yrtPtr = yrt.data() + i*nChannels;
+        EXPECT_NO_THROW(rt.apply(1, x.data() + i*nChannels, &yrtPtr));
+    }
+    const double a1 = 1 - c1;
+    const double c2 = 0.5*(1 - a1*a1);
+    for (int c=0; c<nChannels; ++c)
+    {
+        auto A = amplitudes[c];
+        auto y0 = c1*A*A*A*A + bias;
+        auto mu2 = a1 + c2*A*A;
+        auto dx2 = (c1*A)*(c1*A)/mu2;
+        auto y1 = (1 + c1 - 2*c1*dx2)*y0 + c1*dx2*dx2 + bias;
+        EXPECT_NEAR(yrt[c], y0, 1.e-12*std::abs(y0));
+        EXPECT_NEAR(yrt[nChannels + c], y1, 1.e-12*std::abs(y1));
+    }
+    // The per-sample arithmetic is shared with IIRKurtosis so each channel
+    // is bitwise identical to the scalar filter
+    std::vector<double> xc(nSamples);
+    std::vector<double> yc(nSamples);
+    for (int c=0; c<nChannels; ++c)
+    {
+        RealTime::IIRKurtosis<double> scalar;
+        EXPECT_NO_THROW(scalar.initialize(c1));
+        for (int i=0; i<nSamples; ++i){xc[i] = x[i*nChannels + c];}
+        auto ycPtr = yc.data();
+        EXPECT_NO_THROW(scalar.apply(nSamples, xc.data(), &ycPtr));
+        for (int i=0; i<nSamples; ++i)
+        {
+            EXPECT_EQ(yc[i], yrt[i*nChannels + c]);
+        }
+    }
+    // Single precision
+    std::vector<float> xf(x.begin(), x.end());
+    std::vector<float> yf(xf.size());
+    MultiChannelIIRKurtosis<RTSeis::ProcessingMode::POST, float> kurtosisf;
+    EXPECT_NO_THROW(kurtosisf.initialize(nChannels, static_cast<float> (c1)));
+    auto yfPtr = yf.data();
+    EXPECT_NO_THROW(kurtosisf.apply(nSamples, xf.data(), &yfPtr));
+    for (int c=0; c<nChannels; ++c)
+    {
+        auto A = amplitudes[c];
+        auto y0 = c1*A*A*A*A + bias;
+        EXPECT_NEAR(yf[c], y0, 1.e-5*std::abs(y0));
+    }
+}
+
+TEST(UtilitiesCharacteristicFunction, channelStateLayout)
+{
+    // A single channel, as in the bank, is dense
+    ChannelState<double> ring;
+    ring.allocate(2000, 1);
+    EXPECT_EQ(ring.getLeadingDimension(), 1);
+    EXPECT_EQ(ring.getSizeInBytes(), 2000*sizeof(double));
+    ChannelState<float> ringf;
+    ringf.allocate(10, 15);
+    EXPECT_EQ(ringf.getLeadingDimension(), 15);
+    EXPECT_EQ(ringf.row(1) - ringf.row(0), 15);
+    // Rows spanning a cache line begin on a cache line
+    ring.allocate(3, 67);
+    EXPECT_EQ(ring.getLeadingDimension(), 72);
+    EXPECT_EQ(reinterpret_cast<uintptr_t> (ring.row(2))%64, 0u);
+    ring.zero();
+    EXPECT_EQ(ring.row(2)[66], 0.0);
+}
+
+TEST(UtilitiesCharacteristicFunction, characteristicFunctionBank)
+{
+    auto x = readTextFile("data/gse2.txt");
+    ASSERT_TRUE(x.size() > 0);
+    auto nSamples = static_cast<int> (x.size());
+    const int nsta = 200;
+    const int nlta = 2000;
+    const double c1 = 1./(200*2.);
+    const int nTaps = 301;
+    // References
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::REAL_TIME, double>
+        classic;
+    classic.initialize(1, nsta, nlta);
+    RecursiveSTALTA<RTSeis::ProcessingMode::REAL_TIME, double> recursive;
+    recursive.initialize(nsta, nlta);
+    RealTime::IIRKurtosis<double> kurtosis;
+    kurtosis.initialize(c1);
+    RTSeis::Utilities::Transforms::FIREnvelope<
+        RTSeis::ProcessingMode::REAL_TIME, double> envelope;
+    envelope.initialize(nTaps);
+    std::vector<std::vector<double>> yRef(4, std::vector<double> (nSamples));
+    auto yPtr = yRef[0].data();
+    classic.apply(nSamples, x.data(), &yPtr);
+    yPtr = yRef[1].data();
+    recursive.apply(nSamples, x.data(), &yPtr);
+    yPtr = yRef[2].data();
+    kurtosis.apply(nSamples, x.data(), &yPtr);
+    yPtr = yRef[3].data();
+    envelope.transform(nSamples, x.data(), &yPtr);
+
+    CharacteristicFunctionBank<double> bank;
+    EXPECT_EQ(bank.getNumberOfCharacteristicFunctions(), 0);
+    EXPECT_NO_THROW(bank.enableFIREnvelope(nTaps));
+    EXPECT_NO_THROW(bank.enableIIRKurtosis(c1));
+    EXPECT_NO_THROW(bank.enableRecursiveSTALTA(nsta, nlta));
+    EXPECT_NO_THROW(bank.enableClassicSTALTA(nsta, nlta));
+    EXPECT_EQ(bank.getNumberOfCharacteristicFunctions(), 4);
+    EXPECT_EQ(bank.getOutputIndex(CharacteristicFunctionType::CLASSIC_STALTA),
+              0);
+    EXPECT_EQ(bank.getOutputIndex(CharacteristicFunctionType::FIR_ENVELOPE),
+              3);
+    std::vector<std::vector<double>> y(4, std::vector<double> (nSamples));
+    std::array<double *, 4> yPtrs;
+    for (int iter=0; iter<2; ++iter)
+    {
+        int i0 = 0;
+        while (i0 < nSamples)
+        {
+            auto nloc = std::min(nSamples - i0, 1 + rand()%1500);
+            for (int k=0; k<4; ++k){yPtrs[k] = y[k].data() + i0;}
+            EXPECT_NO_THROW(bank.apply(nloc, x.data() + i0, yPtrs.data()));
+            i0 = i0 + nloc;
+        }
+        for (int k=0; k<3; ++k)
+        {
+            EXPECT_TRUE(std::equal(y[k].begin(), y[k].end(),
+                                   yRef[k].begin()));
+        }
+        // IPP may block the FIR filters differently
+        double error;
+        ippsNormDiff_Inf_64f(yRef[3].data(), y[3].data(), nSamples, &error);
+        EXPECT_LT(error, 1.e-8);
+        bank.resetInitialConditions();
+    }
+    // A subset
+    bank.disable(CharacteristicFunctionType::CLASSIC_STALTA);
+    bank.disable(CharacteristicFunctionType::FIR_ENVELOPE);
+    EXPECT_FALSE(bank.isEnabled(CharacteristicFunctionType::CLASSIC_STALTA));
+    EXPECT_EQ(bank.getNumberOfCharacteristicFunctions(), 2);
+    EXPECT_EQ(bank.getOutputIndex(CharacteristicFunctionType::IIR_KURTOSIS),
+              1);
+    EXPECT_THROW([[maybe_unused]] auto index
+        = bank.getOutputIndex(CharacteristicFunctionType::FIR_ENVELOPE),
+        std::invalid_argument);
+    auto bankCopy = bank;
+    yPtrs[0] = y[1].data();
+    yPtrs[1] = y[2].data();
+    EXPECT_NO_THROW(bankCopy.apply(nSamples, x.data(), yPtrs.data()));
+    EXPECT_TRUE(std::equal(y[1].begin(), y[1].end(), yRef[1].begin()));
+    EXPECT_TRUE(std::equal(y[2].begin(), y[2].end(), yRef[2].begin()));
+}
+
+TEST(UtilitiesCharacteristicFunction, characteristicFunctionBankMatchesModules)
+{
+    auto x = readTextFile("data/gse2.txt");
+    ASSERT_TRUE(x.size() > 0);
+    auto nSamples = static_cast<int> (x.size());
+    const int nsta = 50;
+    const int nlta = 500;
+    const double c1 = 0.02;
+    const int nTaps = 101;
+    // An empty packet is a no-op even when nothing is enabled
+    CharacteristicFunctionBank<double> bank;
+    EXPECT_NO_THROW(bank.apply(0, x.data(), nullptr));
+    std::array<double *, 4> yPtrs;
+    yPtrs.fill(nullptr);
+    EXPECT_THROW(bank.apply(nSamples, x.data(), yPtrs.data()),
+                 std::runtime_error);
+    // Each module run on its own over the whole signal
+    MultiChannelClassicSTALTA<RTSeis::ProcessingMode::REAL_TIME, double>
+        classic;
+    EXPECT_NO_THROW(classic.initialize(1, nsta, nlta));
+    RecursiveSTALTA<RTSeis::ProcessingMode::REAL_TIME, double> recursive;
+    EXPECT_NO_THROW(recursive.initialize(nsta, nlta));
+    RealTime::IIRKurtosis<double> kurtosis;
+    EXPECT_NO_THROW(kurtosis.initialize(c1));
+    RTSeis::Utilities::Transforms::FIREnvelope<
+        RTSeis::ProcessingMode::REAL_TIME, double> envelope;
+    EXPECT_NO_THROW(envelope.initialize(nTaps));
+    std::vector<std::vector<double>> yRef(4, std::vector<double> (nSamples));
+    auto yPtr = yRef[0].data();
+    EXPECT_NO_THROW(classic.apply(nSamples, x.data(), &yPtr));
+    yPtr = yRef[1].data();
+    EXPECT_NO_THROW(recursive.apply(nSamples, x.data(), &yPtr));
+    yPtr = yRef[2].data();
+    EXPECT_NO_THROW(kurtosis.apply(nSamples, x.data(), &yPtr));
+    yPtr = yRef[3].data();
+    EXPECT_NO_THROW(envelope.transform(nSamples, x.data(), &yPtr));
+    // The bank interleaves the same modules block by block
+    EXPECT_NO_THROW(bank.enableClassicSTALTA(nsta, nlta));
+    EXPECT_NO_THROW(bank.enableRecursiveSTALTA(nsta, nlta));
+    EXPECT_NO_THROW(bank.enableIIRKurtosis(c1));
+    EXPECT_NO_THROW(bank.enableFIREnvelope(nTaps));
+    std::vector<std::vector<double>> y(4, std::vector<double> (nSamples));
+    for (int k=0; k<4; ++k){yPtrs[k] = y[k].data();}
+    EXPECT_NO_THROW(bank.apply(nSamples, x.data(), yPtrs.data()));
+    for (int k=0; k<3; ++k)
+    {
+        EXPECT_TRUE(std::equal(y[k].begin(), y[k].end(), yRef[k].begin()));
+    }
+    // IPP may block the FIR filters differently
+    double error = 0;
+    for (int i=0; i<nSamples; ++i)
+    {
+        error = std::max(error, std::abs(y[3][i] - yRef[3][i]));
+    }
+    EXPECT_LT(error, 1.e-8);
+}
+
 std::vector<double> computeCarlSTALTA(const int n,
                                       const double x[],
                                       const int nsta,
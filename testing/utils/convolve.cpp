@@ -1,10 +1,15 @@
 #include <iostream>
 #include <cstdio>
 #include <cstdlib>
+#include <cmath>
 #include <string>
+#include <fstream>
 #include <stdexcept>
 #include <ipps.h>
+#include <vector>
 #include "rtseis/utilities/math/convolve.hpp"
+#include "rtseis/utilities/math/convolutionWisdom.hpp"
+#include "rtseis/utilities/filterImplementations/firFilter.hpp"
 #include <gtest/gtest.h>
 
 namespace
@@ -427,6 +432,116 @@ TEST(UtilitiesConvolve, autoCorrelate)
         ippsNormDiff_Inf_64f(c.data(), cref.data(), c.size(), &emax);
         EXPECT_LE(emax, 1.e-10);
     }
-} 
+}
+
+TEST(UtilitiesConvolve, wisdom)
+{
+    ConvolutionWisdom::forgetWisdom();
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 0);
+    std::vector<double> a(3000), b(200);
+    for (int i = 0; i < static_cast<int> (a.size()); ++i)
+    {
+        a[i] = std::sin(0.01*i);
+    }
+    for (int i = 0; i < static_cast<int> (b.size()); ++i)
+    {
+        b[i] = 1.0/static_cast<double> (i + 1);
+    }
+    // AUTO benchmarks once and must agree with the direct implementation
+    auto cRef = Convolve::convolve(a, b, Convolve::Mode::FULL,
+                                   Convolve::Implementation::DIRECT);
+    auto c = Convolve::convolve(a, b, Convolve::Mode::FULL,
+                                Convolve::Implementation::AUTO);
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 1);
+    EXPECT_TRUE(ConvolutionWisdom::haveAlgorithm(
+                    ConvolutionWisdom::Operation::CONVOLVE,
+                    static_cast<int> (b.size()), static_cast<int> (a.size()),
+                    RTSeis::Precision::DOUBLE));
+    ASSERT_EQ(c.size(), cRef.size());
+    double emax = 0;
+    ippsNormDiff_Inf_64f(c.data(), cRef.data(), static_cast<int> (c.size()),
+                         &emax);
+    EXPECT_LE(emax, 1.e-10);
+    c = Convolve::convolve(a, b, Convolve::Mode::FULL,
+                           Convolve::Implementation::AUTO);
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 1);
+    // AUTO FIR filtering must agree with the direct form
+    using namespace RTSeis::Utilities::FilterImplementations;
+    FIRFilter<RTSeis::ProcessingMode::REAL_TIME, double> fir, firRef;
+    EXPECT_NO_THROW(fir.initialize(static_cast<int> (b.size()), b.data(),
+                                   FIRImplementation::AUTO, 500));
+    EXPECT_NO_THROW(firRef.initialize(static_cast<int> (b.size()), b.data(),
+                                      FIRImplementation::DIRECT));
+    // The filter is tuned at initialization, not on first application
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 2);
+    std::vector<double> y(a.size()), yRef(a.size());
+    for (int i = 0; i < static_cast<int> (a.size()); i = i + 500)
+    {
+        double *yPtr = y.data() + i;
+        double *yRefPtr = yRef.data() + i;
+        EXPECT_NO_THROW(fir.apply(500, a.data() + i, &yPtr));
+        EXPECT_NO_THROW(firRef.apply(500, a.data() + i, &yRefPtr));
+    }
+    ippsNormDiff_Inf_64f(y.data(), yRef.data(), static_cast<int> (y.size()),
+                         &emax);
+    EXPECT_LE(emax, 1.e-10);
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 2);
+    // Export then import the wisdom
+    // The real-time filter is keyed separately from post-processing
+    EXPECT_FALSE(ConvolutionWisdom::haveAlgorithm(
+                     ConvolutionWisdom::Operation::FIR_FILTER,
+                     static_cast<int> (b.size()), 500,
+                     RTSeis::Precision::DOUBLE,
+                     RTSeis::ProcessingMode::POST));
+    auto algorithm = ConvolutionWisdom::getAlgorithm(
+                        ConvolutionWisdom::Operation::FIR_FILTER,
+                        static_cast<int> (b.size()), 500,
+                        RTSeis::Precision::DOUBLE,
+                        RTSeis::ProcessingMode::REAL_TIME);
+    const std::string wisdomFile = "convolutionWisdom.txt";
+    EXPECT_NO_THROW(ConvolutionWisdom::exportWisdom(wisdomFile));
+    ConvolutionWisdom::forgetWisdom();
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 0);
+    EXPECT_NO_THROW(ConvolutionWisdom::importWisdom(wisdomFile));
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 2);
+    EXPECT_EQ(ConvolutionWisdom::getAlgorithm(
+                 ConvolutionWisdom::Operation::FIR_FILTER,
+                 static_cast<int> (b.size()), 500,
+                 RTSeis::Precision::DOUBLE,
+                 RTSeis::ProcessingMode::REAL_TIME), algorithm);
+    EXPECT_THROW(ConvolutionWisdom::importWisdom("notAWisdomFile.txt"),
+                 std::invalid_argument);
+    // Lengths in an imported file are rounded like any other key
+    ConvolutionWisdom::forgetWisdom();
+    {
+    std::ofstream ofl(wisdomFile);
+    ofl << "# RTSeis convolution wisdom 2" << std::endl;
+    ofl << "0 200 500 2 1 1" << std::endl;
+    ofl << "0 256 512 2 1 0" << std::endl;
+    }
+    EXPECT_NO_THROW(ConvolutionWisdom::importWisdom(wisdomFile));
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 1);
+    EXPECT_TRUE(ConvolutionWisdom::haveAlgorithm(
+                    ConvolutionWisdom::Operation::FIR_FILTER, 200, 500,
+                    RTSeis::Precision::DOUBLE,
+                    RTSeis::ProcessingMode::REAL_TIME));
+    EXPECT_EQ(ConvolutionWisdom::getAlgorithm(
+                 ConvolutionWisdom::Operation::FIR_FILTER, 200, 500,
+                 RTSeis::Precision::DOUBLE,
+                 RTSeis::ProcessingMode::REAL_TIME),
+              ConvolutionWisdom::Algorithm::DIRECT);
+    // An AUTO filter with wisdom is built without benchmarking
+    EXPECT_NO_THROW(fir.initialize(static_cast<int> (b.size()), b.data(),
+                                   FIRImplementation::AUTO, 500));
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 1);
+    // Without wisdom, AUTO does not benchmark very long problems
+    std::vector<double> aLong(100000, 1);
+    EXPECT_NO_THROW(c = Convolve::convolve(aLong, b, Convolve::Mode::FULL,
+                                           Convolve::Implementation::AUTO));
+    EXPECT_EQ(c.size(), aLong.size() + b.size() - 1);
+    EXPECT_EQ(ConvolutionWisdom::getNumberOfEntries(), 1);
+    std::remove(wisdomFile.c_str());
+    ConvolutionWisdom::forgetWisdom();
+}
 
 }
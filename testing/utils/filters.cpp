@@ -1,3 +1,7 @@
+    // Repeated packetized application must not allocate.  The filters
+    // obtain their taps, delay lines, and IPP states from the workspace
+    // allocator so its count is the number of IPP allocations while the
+    // replaced operator new counts every C++ allocation.
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -8,6 +12,8 @@
 #include <algorithm>
 #include <complex>
 #include <vector>
+#include <atomic>
+#include <new>
 #include <ipps.h>
 #include "rtseis/utilities/filterDesign/fir.hpp"
 #include "rtseis/utilities/filterRepresentations/fir.hpp"
@@ -18,10 +24,37 @@
 #include "rtseis/utilities/filterImplementations/firFilter.hpp"
 #include "rtseis/utilities/filterImplementations/multiRateFIRFilter.hpp"
 #include "rtseis/utilities/filterImplementations/medianFilter.hpp"
+#include "rtseis/utilities/filterImplementations/multiChannelSOSFilter.hpp"
+#include "rtseis/utilities/filterImplementations/resample.hpp"
 #include "rtseis/utilities/filterImplementations/sosFilter.hpp"
 #include "rtseis/utilities/filterImplementations/enums.hpp"
+#include "private/filterWorkspace.hpp"
 #include <gtest/gtest.h>
 
+namespace
+{
+/// Counts the calls to the global operator new in this test binary.
+std::atomic<long> nNewCalls{0};
+}
+
+void *operator new(std::size_t size)
+{
+    nNewCalls.fetch_add(1, std::memory_order_relaxed);
+    auto ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr){throw std::bad_alloc();}
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 namespace
 {
 
@@ -424,6 +457,77 @@ TEST(UtilitiesFilterImplementations, iiriir)
     free(x);
 }
 //============================================================================//
+TEST(UtilitiesFilterImplementations, parallelIIRIIR)
+{
+    const int npts = 150001;
+    std::vector<double> x(npts);
+    for (int i = 0; i < npts; ++i)
+    {
+        x[i] = 1 + std::sin(0.001*i) + 0.5*std::cos(0.37*i)
+             + static_cast<double> (rand()%1000)/1000.0 - 0.5;
+    }
+    // Fourth order Butterworth lowpass filter as SOS and BA
+    const int ns = 2;
+    const double bs[6] = {0.00482434, 0.00964869, 0.00482434,
+                          1.0, 2.0, 1.0};
+    const double as[6] = {1.0, -1.04859958, 0.29614036,
+                          1.0, -1.32091343, 0.63273879};
+    const double b[5] = {0.00482434, 0.01929737, 0.02894606,
+                         0.01929737, 0.00482434};
+    const double a[5] = {1.0, -2.36951301, 2.31398841,
+                         -1.05466541, 0.18737949};
+    std::vector<double> yref(npts);
+    std::vector<double> y(npts);
+    double *yptr = nullptr;
+    double error;
+    IIRIIRFilter<double> sos;
+    EXPECT_NO_THROW(sos.initialize(ns, bs, as));
+    EXPECT_EQ(sos.getFilterOrder(), 4);
+    EXPECT_EQ(sos.getInitialConditionLength(), 4);
+    yptr = yref.data();
+    EXPECT_NO_THROW(sos.apply(npts, x.data(), &yptr));
+    // Block-parallel passes
+    EXPECT_THROW(sos.setNumberOfThreads(0), std::invalid_argument);
+    EXPECT_NO_THROW(sos.setNumberOfThreads(4));
+    auto sosCopy = sos;
+    EXPECT_EQ(sosCopy.getNumberOfThreads(), 4);
+    for (int k = 0; k < 2; ++k)
+    {
+        yptr = y.data();
+        EXPECT_NO_THROW(sosCopy.apply(npts, x.data(), &yptr));
+        ippsNormDiff_Inf_64f(y.data(), yref.data(), npts, &error);
+        EXPECT_LE(error, 1.e-10);
+    }
+    // The edges must be treated identically for any number of threads.
+    // Compare both forms sample by sample at the ends of the signal.
+    const int nEdge = 500;
+    IIRIIRFilter<double> ba;
+    EXPECT_NO_THROW(ba.initialize(5, b, 5, a));
+    std::vector<double> yba1(npts);
+    yptr = yba1.data();
+    EXPECT_NO_THROW(ba.apply(npts, x.data(), &yptr));
+    EXPECT_NO_THROW(ba.setNumberOfThreads(4));
+    yptr = y.data();
+    EXPECT_NO_THROW(ba.apply(npts, x.data(), &yptr));
+    for (int i = 0; i < nEdge; ++i)
+    {
+        EXPECT_EQ(y[i], yba1[i]);
+        EXPECT_EQ(y[npts - 1 - i], yba1[npts - 1 - i]);
+    }
+    yptr = y.data();
+    EXPECT_NO_THROW(sosCopy.apply(npts, x.data(), &yptr));
+    for (int i = 0; i < nEdge; ++i)
+    {
+        EXPECT_NEAR(y[i], yref[i], 1.e-10);
+        EXPECT_NEAR(y[npts - 1 - i], yref[npts - 1 - i], 1.e-10);
+    }
+    // A constant signal starts in steady-state so there is no transient
+    std::fill(x.begin(), x.begin() + 100, 2.0);
+    yptr = y.data();
+    EXPECT_NO_THROW(sos.apply(100, x.data(), &yptr));
+    for (int i = 0; i < 100; ++i){EXPECT_NEAR(y[i], 2.0, 1.e-6);}
+}
+//============================================================================//
 //int filters_firMRFilter_test(const int npts, const double x[],
 //                             const std::string fileName)
 TEST(UtiltiesFilterImplementations, multirateFIR)
@@ -657,6 +761,58 @@ TEST(UtilitiesFilterImplementations, fir)
     free(x);
 }
 //============================================================================//
+TEST(UtilitiesFilterImplementations, partitionedFIR)
+{
+    double *x = NULL;
+    int npts;
+    auto ierr = readTextFile(&npts, &x, "data/gse2.txt");
+    EXPECT_EQ(ierr, 0);
+    // A long, windowed-sinc lowpass filter
+    const int nb = 1201;
+    std::vector<double> b(nb);
+    for (int i = 0; i < nb; ++i)
+    {
+        double t = static_cast<double> (i - nb/2);
+        double sinc = (i == nb/2) ? 1 : std::sin(0.1*M_PI*t)/(0.1*M_PI*t);
+        double window = 0.54 - 0.46*std::cos(2*M_PI*i/(nb - 1));
+        b[i] = 0.1*sinc*window;
+    }
+    // Use the start of the signal as the initial conditions
+    std::vector<double> zi(x, x + (nb - 1));
+    FIRFilter<RTSeis::ProcessingMode::POST, double> fir;
+    EXPECT_NO_THROW(fir.initialize(nb, b.data(), FIRImplementation::DIRECT));
+    EXPECT_NO_THROW(fir.setInitialConditions(nb - 1, zi.data()));
+    std::vector<double> yref(npts), y(npts);
+    double *yptr = yref.data();
+    EXPECT_NO_THROW(fir.apply(npts, x, &yptr));
+    // Packetized partitioned convolution should match the direct form
+    FIRFilter<RTSeis::ProcessingMode::REAL_TIME, double> firrt;
+    EXPECT_NO_THROW(firrt.initialize(nb, b.data(), FIRImplementation::FFT));
+    EXPECT_EQ(firrt.getInitialConditionLength(), nb - 1);
+    EXPECT_NO_THROW(firrt.setInitialConditions(nb - 1, zi.data()));
+    for (int job = 0; job < 2; ++job)
+    {
+        int nxloc = 0;
+        while (nxloc < npts)
+        {
+            int nptsPass = std::min(npts - nxloc, 1 + rand()%300);
+            if (job == 1){nptsPass = std::min(npts - nxloc, 64);}
+            yptr = y.data() + nxloc;
+            EXPECT_NO_THROW(firrt.apply(nptsPass, x + nxloc, &yptr));
+            nxloc = nxloc + nptsPass;
+        }
+        double error;
+        ippsNormDiff_Inf_64f(yref.data(), y.data(), npts, &error);
+        EXPECT_LE(error, 1.e-10);
+        firrt.resetInitialConditions();
+    }
+    std::vector<double> ziOut(nb - 1);
+    double *ziPtr = ziOut.data();
+    EXPECT_NO_THROW(firrt.getInitialConditions(nb - 1, &ziPtr));
+    EXPECT_TRUE(std::equal(zi.begin(), zi.end(), ziOut.begin()));
+    free(x);
+}
+//============================================================================//
 //int filters_sosFilter_test(const int npts, const double x[],
 //                           const std::string fileName)
 TEST(UtilitiesFilterImplementations, sos)
@@ -781,6 +937,316 @@ TEST(UtilitiesFilterImplementations, sos)
     free(x);
 }
 //============================================================================//
+TEST(UtilitiesFilterImplementations, blockParallelIIR)
+{
+    // Long enough to be split into several blocks
+    const int npts = 200001;
+    std::vector<double> x(npts);
+    for (int i = 0; i < npts; ++i)
+    {
+        x[i] = std::sin(0.001*i) + 0.5*std::cos(0.37*i)
+             + static_cast<double> (rand()%1000)/1000.0 - 0.5;
+    }
+    std::vector<double> yref(npts);
+    std::vector<double> y(npts);
+    double *yptr = nullptr;
+    double error;
+    // SOS filter
+    const int ns = 2;
+    const double bs[6] = {0.00482434, 0.00964869, 0.00482434,
+                          1.0, 2.0, 1.0};
+    const double as[6] = {1.0, -1.04859958, 0.29614036,
+                          1.0, -1.32091343, 0.63273879};
+    SOSFilter<RTSeis::ProcessingMode::POST, double> sos;
+    EXPECT_NO_THROW(sos.initialize(ns, bs, as));
+    EXPECT_EQ(sos.getNumberOfThreads(), 1);
+    std::vector<double> zi(sos.getInitialConditionLength());
+    for (int i = 0; i < static_cast<int> (zi.size()); ++i)
+    {
+        zi[i] = 0.1*(i + 1);
+    }
+    EXPECT_NO_THROW(sos.setInitialConditions(zi.size(), zi.data()));
+    yptr = yref.data();
+    EXPECT_NO_THROW(sos.apply(npts, x.data(), &yptr));
+    EXPECT_THROW(sos.setNumberOfThreads(0), std::invalid_argument);
+    EXPECT_NO_THROW(sos.setNumberOfThreads(4));
+    EXPECT_EQ(sos.getNumberOfThreads(), 4);
+    yptr = y.data();
+    EXPECT_NO_THROW(sos.apply(npts, x.data(), &yptr));
+    ippsNormDiff_Inf_64f(y.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-10);
+    // Direct form IIR filter
+    const double b[5] = {0.00482434, 0.01929737, 0.02894606,
+                         0.01929737, 0.00482434};
+    const double a[5] = {1.0, -2.36951301, 2.31398841,
+                         -1.05466541, 0.18737949};
+    IIRFilter<RTSeis::ProcessingMode::POST, double> iir;
+    EXPECT_NO_THROW(iir.initialize(5, b, 5, a));
+    zi.resize(iir.getInitialConditionLength());
+    for (int i = 0; i < static_cast<int> (zi.size()); ++i)
+    {
+        zi[i] = 0.1*(i + 1);
+    }
+    EXPECT_NO_THROW(iir.setInitialConditions(zi.size(), zi.data()));
+    yptr = yref.data();
+    EXPECT_NO_THROW(iir.apply(npts, x.data(), &yptr));
+    EXPECT_NO_THROW(iir.setNumberOfThreads(4));
+    auto iirCopy = iir;
+    EXPECT_EQ(iirCopy.getNumberOfThreads(), 4);
+    EXPECT_NO_THROW(iirCopy.resetInitialConditions());
+    yptr = y.data();
+    EXPECT_NO_THROW(iirCopy.apply(npts, x.data(), &yptr));
+    ippsNormDiff_Inf_64f(y.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-10);
+}
+//============================================================================//
+TEST(UtilitiesFilterImplementations, multiChannelSOS)
+{
+    double *x = NULL;
+    int npts;
+    auto ierr = readTextFile(&npts, &x, "data/gse2.txt");
+    EXPECT_EQ(ierr, 0);
+    const int ns = 4;
+    const double bs[12] = {0.000401587491686,  0.000803175141692,  0.000401587491549,
+                           1.000000000000000, -2.000000394412897,  0.999999999730209,
+                           1.000000000000000,  1.999999605765104,  1.000000000341065,
+                           1.000000000000000, -1.999999605588274,  1.000000000269794};
+    const double as[12] = {1.000000000000000, -1.488513049541281,  0.562472929601870,
+                           1.000000000000000, -1.704970593447777,  0.792206889942566,
+                           1.000000000000000, -1.994269533089365,  0.994278822534674,
+                           1.000000000000000, -1.997472946622339,  0.997483252685326};
+    // Make a handful of scaled channels.  Use a number of channels that
+    // isn't a multiple of the vector length to exercise the remainder loop.
+    const int nChannels = 67;
+    std::vector<double> xMC(static_cast<size_t> (npts)*nChannels);
+    std::vector<double> yMC(xMC.size());
+    for (int i=0; i<npts; i++)
+    {
+        for (int c=0; c<nChannels; c++)
+        {
+            xMC[static_cast<size_t> (i)*nChannels + c]
+                = x[i]*static_cast<double> (c + 1);
+        }
+    }
+    std::vector<double> zi(2*ns);
+    for (int i=0; i<2*ns; i++){zi[i] = 0.001*(i + 1);}
+    // Compute the reference solutions one channel at a time
+    std::vector<double> yref(xMC.size());
+    std::vector<double> xc(npts), yc(npts);
+    SOSFilter<RTSeis::ProcessingMode::REAL_TIME, double> sos;
+    EXPECT_NO_THROW(sos.initialize(ns, bs, as));
+    for (int c=0; c<nChannels; c++)
+    {
+        if (c%2 == 0)
+        {
+            EXPECT_NO_THROW(sos.setInitialConditions(2*ns, zi.data()));
+        }
+        else
+        {
+            std::vector<double> zero(2*ns, 0);
+            EXPECT_NO_THROW(sos.setInitialConditions(2*ns, zero.data()));
+        }
+        for (int i=0; i<npts; i++)
+        {
+            xc[i] = xMC[static_cast<size_t> (i)*nChannels + c];
+        }
+        double *yptr = yc.data();
+        EXPECT_NO_THROW(sos.apply(npts, xc.data(), &yptr));
+        for (int i=0; i<npts; i++)
+        {
+            yref[static_cast<size_t> (i)*nChannels + c] = yc[i];
+        }
+    }
+    // Post-processing
+    MultiChannelSOSFilter<RTSeis::ProcessingMode::POST, double> mcsos;
+    EXPECT_NO_THROW(mcsos.initialize(nChannels, ns, bs, as));
+    EXPECT_EQ(mcsos.getNumberOfChannels(), nChannels);
+    EXPECT_EQ(mcsos.getNumberOfSections(), ns);
+    EXPECT_EQ(mcsos.getInitialConditionLength(), 2*ns);
+    for (int c=0; c<nChannels; c=c+2)
+    {
+        EXPECT_NO_THROW(mcsos.setInitialConditions(c, 2*ns, zi.data()));
+    }
+    double *yptr = yMC.data();
+    auto timeStart = std::chrono::high_resolution_clock::now();
+    EXPECT_NO_THROW(mcsos.apply(npts, xMC.data(), &yptr));
+    auto timeEnd = std::chrono::high_resolution_clock::now();
+    double error;
+    ippsNormDiff_Inf_64f(yMC.data(), yref.data(),
+                         static_cast<int> (yMC.size()), &error);
+    EXPECT_LE(error, 1.e-8);
+    std::chrono::duration<double> tdif = timeEnd - timeStart;
+    fprintf(stdout, "Multi-channel SOS computation time %.8lf (s)\n",
+            tdif.count());
+    // Do packetized tests
+    MultiChannelSOSFilter<RTSeis::ProcessingMode::REAL_TIME, double> mcsosrt;
+    EXPECT_NO_THROW(mcsosrt.initialize(nChannels, ns, bs, as));
+    for (int c=0; c<nChannels; c=c+2)
+    {
+        EXPECT_NO_THROW(mcsosrt.setInitialConditions(c, 2*ns, zi.data()));
+    }
+    std::vector<int> packetSize({1, 2, 3, 16, 64, 100, 200, 512, 1000});
+    for (auto job=0; job<2; job++)
+    {
+        for (auto ip=0; ip<static_cast<int> (packetSize.size()); ip++)
+        {
+            std::fill(yMC.begin(), yMC.end(), 0);
+            int nxloc = 0;
+            while (nxloc < npts)
+            {
+                int nptsPass = packetSize[ip];
+                if (job == 1)
+                {
+                     nptsPass = std::max(1, nptsPass + rand()%50 - 25);
+                }
+                nptsPass = std::min(nptsPass, npts - nxloc);
+                auto offset = static_cast<size_t> (nxloc)*nChannels;
+                yptr = yMC.data() + offset;
+                EXPECT_NO_THROW(mcsosrt.apply(nptsPass, xMC.data() + offset,
+                                              &yptr));
+                nxloc = nxloc + nptsPass;
+            }
+            mcsosrt.resetInitialConditions();
+            ippsNormDiff_Inf_64f(yMC.data(), yref.data(),
+                                 static_cast<int> (yMC.size()), &error);
+            EXPECT_LE(error, 1.e-8);
+        }
+    }
+    free(x);
+}
+//============================================================================//
+TEST(UtilitiesFilterImplementations, sharedFilterDesign)
+{
+    // Copies share the filter design but must carry independent delay lines
+    double *x = NULL;
+    int npts;
+    auto ierr = readTextFile(&npts, &x, "data/gse2.txt");
+    EXPECT_EQ(ierr, 0);
+    const int ns = 2;
+    const double bs[6] = {0.000401587491686,  0.000803175141692,  0.000401587491549,
+                          1.000000000000000, -2.000000394412897,  0.999999999730209};
+    const double as[6] = {1.000000000000000, -1.488513049541281,  0.562472929601870,
+                          1.000000000000000, -1.704970593447777,  0.792206889942566};
+    const double b[5] = {0.1, 0.2, 0.4, 0.2, 0.1};
+    const double a[3] = {1.0, -0.5, 0.25};
+    std::vector<double> yref(npts), y1(npts), y2(npts);
+    int nhalf = npts/2;
+    // FIR
+    FIRFilter<RTSeis::ProcessingMode::REAL_TIME, double> fir;
+    EXPECT_NO_THROW(fir.initialize(5, b, FIRImplementation::DIRECT));
+    auto firCopy = fir; // Copy before using
+    double *yptr = yref.data();
+    EXPECT_NO_THROW(fir.apply(npts, x, &yptr));
+    fir.resetInitialConditions();
+    yptr = y1.data();
+    EXPECT_NO_THROW(fir.apply(nhalf, x, &yptr));
+    auto firCopy2 = fir; // Copy mid-stream
+    yptr = y1.data() + nhalf;
+    EXPECT_NO_THROW(fir.apply(npts - nhalf, x + nhalf, &yptr));
+    std::copy(y1.begin(), y1.begin() + nhalf, y2.begin());
+    yptr = y2.data() + nhalf;
+    EXPECT_NO_THROW(firCopy2.apply(npts - nhalf, x + nhalf, &yptr));
+    double error;
+    ippsNormDiff_Inf_64f(y1.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-14);
+    ippsNormDiff_Inf_64f(y2.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-14);
+    yptr = y2.data();
+    EXPECT_NO_THROW(firCopy.apply(npts, x, &yptr));
+    ippsNormDiff_Inf_64f(y2.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-14);
+    // SOS
+    SOSFilter<RTSeis::ProcessingMode::REAL_TIME, double> sos;
+    EXPECT_NO_THROW(sos.initialize(ns, bs, as));
+    yptr = yref.data();
+    EXPECT_NO_THROW(sos.apply(npts, x, &yptr));
+    sos.resetInitialConditions();
+    yptr = y1.data();
+    EXPECT_NO_THROW(sos.apply(nhalf, x, &yptr));
+    auto sosCopy = sos;
+    yptr = y1.data() + nhalf;
+    EXPECT_NO_THROW(sos.apply(npts - nhalf, x + nhalf, &yptr));
+    std::copy(y1.begin(), y1.begin() + nhalf, y2.begin());
+    yptr = y2.data() + nhalf;
+    EXPECT_NO_THROW(sosCopy.apply(npts - nhalf, x + nhalf, &yptr));
+    ippsNormDiff_Inf_64f(y1.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-14);
+    ippsNormDiff_Inf_64f(y2.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-14);
+    // IIR
+    IIRFilter<RTSeis::ProcessingMode::REAL_TIME, double> iir;
+    EXPECT_NO_THROW(iir.initialize(5, b, 3, a,
+                                   IIRDFImplementation::DF2_FAST));
+    yptr = yref.data();
+    EXPECT_NO_THROW(iir.apply(npts, x, &yptr));
+    iir.resetInitialConditions();
+    yptr = y1.data();
+    EXPECT_NO_THROW(iir.apply(nhalf, x, &yptr));
+    auto iirCopy = iir;
+    yptr = y1.data() + nhalf;
+    EXPECT_NO_THROW(iir.apply(npts - nhalf, x + nhalf, &yptr));
+    std::copy(y1.begin(), y1.begin() + nhalf, y2.begin());
+    yptr = y2.data() + nhalf;
+    EXPECT_NO_THROW(iirCopy.apply(npts - nhalf, x + nhalf, &yptr));
+    ippsNormDiff_Inf_64f(y1.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-12);
+    ippsNormDiff_Inf_64f(y2.data(), yref.data(), npts, &error);
+    EXPECT_LE(error, 1.e-12);
+    free(x);
+}
+//============================================================================//
+TEST(UtilitiesFilterImplementations, allocationFreeApply)
+{
+    // Repeated packetized application must not allocate.  The filters
+    // obtain their taps, delay lines, and IPP states from the workspace
+    // allocator so its count is the number of IPP allocations.
+    const int ns = 2;
+    const double bs[6] = {0.000401587491686,  0.000803175141692,  0.000401587491549,
+                          1.000000000000000, -2.000000394412897,  0.999999999730209};
+    const double as[6] = {1.000000000000000, -1.488513049541281,  0.562472929601870,
+                          1.000000000000000, -1.704970593447777,  0.792206889942566};
+    const double b[5] = {0.1, 0.2, 0.4, 0.2, 0.1};
+    const int nPackets = 100;
+    const int packetSize = 64;
+    const int nLong = 100000;
+    std::vector<double> x64(nLong, 1), y64(nLong);
+    std::vector<float> x32(packetSize, 1), y32(packetSize);
+    double *y64ptr = y64.data();
+    float *y32ptr = y32.data();
+    auto nAllocations = Workspace::getNumberOfAllocations();
+    auto nNew = nNewCalls.load();
+    FIRFilter<RTSeis::ProcessingMode::REAL_TIME, float> fir32;
+    FIRFilter<RTSeis::ProcessingMode::POST, double> fir64;
+    SOSFilter<RTSeis::ProcessingMode::REAL_TIME, float> sos32;
+    SOSFilter<RTSeis::ProcessingMode::POST, double> sos64;
+    SOSFilter<RTSeis::ProcessingMode::POST, double> sosParallel;
+    EXPECT_NO_THROW(fir32.initialize(5, b, FIRImplementation::DIRECT));
+    EXPECT_NO_THROW(fir64.initialize(5, b, FIRImplementation::DIRECT));
+    EXPECT_NO_THROW(sos32.initialize(ns, bs, as));
+    EXPECT_NO_THROW(sos64.initialize(ns, bs, as));
+    EXPECT_NO_THROW(sosParallel.initialize(ns, bs, as));
+    EXPECT_NO_THROW(sosParallel.setNumberOfThreads(4));
+    // The counters must see the initialization's allocations
+    EXPECT_GT(Workspace::getNumberOfAllocations(), nAllocations);
+    EXPECT_GT(nNewCalls.load(), nNew);
+    // The block-parallel filter builds its engines and scratch space when
+    // it is initialized so even its first application does not allocate
+    nAllocations = Workspace::getNumberOfAllocations();
+    nNew = nNewCalls.load();
+    sosParallel.apply(nLong, x64.data(), &y64ptr);
+    for (int i = 0; i < nPackets; ++i)
+    {
+        fir32.apply(packetSize, x32.data(), &y32ptr);
+        fir64.apply(packetSize, x64.data(), &y64ptr);
+        sos32.apply(packetSize, x32.data(), &y32ptr);
+        sos64.apply(packetSize, x64.data(), &y64ptr);
+    }
+    sosParallel.apply(nLong, x64.data(), &y64ptr);
+    auto nNewAfter = nNewCalls.load();
+    EXPECT_EQ(Workspace::getNumberOfAllocations(), nAllocations);
+    EXPECT_EQ(nNewAfter, nNew);
+}
+//============================================================================//
 //int filters_medianFilter_test(const int npts, const double x[],
 //                              const std::string fileName)
 TEST(UtilitiesFilterImplementations, medianFilter)
@@ -872,6 +1338,68 @@ TEST(UtilitiesFilterImplementations, medianFilter)
     free(x);
 }
 //============================================================================//
+TEST(UtilitiesFilterImplementations, slidingMedianFilter)
+{
+    double *x = NULL;
+    int npts;
+    auto ierr = readTextFile(&npts, &x, "data/gse2.txt");
+    EXPECT_EQ(ierr, 0);
+    // The sliding heap must reproduce the reference solution
+    double *yref = nullptr;
+    int npref;
+    ierr = readTextFile(&npref, &yref, "data/medianFilterReference.txt");
+    EXPECT_EQ(ierr, 0);
+    std::vector<double> y(npts), y2(npts);
+    MedianFilter<RTSeis::ProcessingMode::POST, double> median;
+    EXPECT_NO_THROW(median.initialize(11,
+                    MedianFilterImplementation::SLIDING_HEAP));
+    double *yptr = y.data();
+    EXPECT_NO_THROW(median.apply(npts, x, &yptr));
+    double error;
+    ippsNormDiff_Inf_64f(y.data(), yref, npts, &error);
+    EXPECT_LE(error, 1.e-14);
+    // Long windows with initial conditions must match the direct form
+    for (auto maskSize : {101, 1001})
+    {
+        std::vector<double> zi(maskSize - 1);
+        for (int i = 0; i < maskSize - 1; ++i){zi[i] = x[npts - 1 - i];}
+        MedianFilter<RTSeis::ProcessingMode::POST, double> direct;
+        EXPECT_NO_THROW(direct.initialize(maskSize,
+                        MedianFilterImplementation::DIRECT));
+        EXPECT_NO_THROW(direct.setInitialConditions(maskSize - 1, zi.data()));
+        yptr = y.data();
+        EXPECT_NO_THROW(direct.apply(npts, x, &yptr));
+        MedianFilter<RTSeis::ProcessingMode::POST, double> heap;
+        EXPECT_NO_THROW(heap.initialize(maskSize,
+                        MedianFilterImplementation::SLIDING_HEAP));
+        EXPECT_NO_THROW(heap.setInitialConditions(maskSize - 1, zi.data()));
+        yptr = y2.data();
+        EXPECT_NO_THROW(heap.apply(npts, x, &yptr));
+        ippsNormDiff_Inf_64f(y.data(), y2.data(), npts, &error);
+        EXPECT_LE(error, 1.e-14);
+        // Packetized real-time filtering
+        MedianFilter<RTSeis::ProcessingMode::REAL_TIME, double> heaprt;
+        EXPECT_NO_THROW(heaprt.initialize(maskSize));
+        EXPECT_NO_THROW(heaprt.setInitialConditions(maskSize - 1, zi.data()));
+        for (int job = 0; job < 2; ++job)
+        {
+            int nxloc = 0;
+            while (nxloc < npts)
+            {
+                int nptsPass = std::min(npts - nxloc, 1 + rand()%400);
+                yptr = y2.data() + nxloc;
+                EXPECT_NO_THROW(heaprt.apply(nptsPass, x + nxloc, &yptr));
+                nxloc = nxloc + nptsPass;
+            }
+            ippsNormDiff_Inf_64f(y.data(), y2.data(), npts, &error);
+            EXPECT_LE(error, 1.e-14);
+            heaprt.resetInitialConditions();
+        }
+    }
+    free(yref);
+    free(x);
+}
+//============================================================================//
 //int filters_downsample_test() //const int npts, const double x[])
 TEST(UtilitiesFilterImplementations, downsample)
 {
@@ -1091,6 +1619,210 @@ TEST(UtilitiesFilterImplementations, decimate)
     free(x);
 }
 //============================================================================//
+TEST(UtilitiesFilterImplementations, multistageDecimate)
+{
+    // Decimate 1000 Hz data to 10 Hz.  The 1 Hz signal should pass and the
+    // 60 Hz signal should not alias.
+    const int downFactor = 100;
+    const int npts = 30000;
+    const double dt = 1.0/1000.0;
+    auto signal = [](const double t)
+    {
+        return std::sin(2*M_PI*1.0*t);
+    };
+    std::vector<double> x(npts);
+    for (int i = 0; i < npts; ++i)
+    {
+        x[i] = signal(i*dt) + std::sin(2*M_PI*60.0*i*dt);
+    }
+    Decimate<RTSeis::ProcessingMode::POST, double> decimate;
+    EXPECT_THROW(decimate.initialize(7, 31, true,
+                                     DecimationImplementation::MULTISTAGE),
+                 std::invalid_argument);
+    EXPECT_NO_THROW(decimate.initialize(downFactor, 31, true,
+                                        DecimationImplementation::MULTISTAGE));
+    EXPECT_EQ(decimate.getNumberOfStages(), 3);
+    EXPECT_EQ(decimate.getDownsamplingFactor(), downFactor);
+    int ny = decimate.estimateSpace(npts);
+    EXPECT_EQ(ny, npts/downFactor);
+    std::vector<double> y(ny);
+    int nyDecim = 0;
+    auto yptr = y.data();
+    EXPECT_NO_THROW(decimate.apply(npts, x.data(), ny, &nyDecim, &yptr));
+    EXPECT_EQ(nyDecim, ny);
+    // Away from the edges the phase shift should be removed
+    auto nEdge = static_cast<int> (decimate.getGroupDelay())/downFactor + 1;
+    double error = 0;
+    for (int i = nEdge; i < ny - nEdge; ++i)
+    {
+        error = std::max(error, std::abs(y[i] - signal(i*downFactor*dt)));
+    }
+    EXPECT_LE(error, 1.e-2);
+    // The real-time decimator should reproduce the post-processing
+    // decimator without phase shift removal for any packet size
+    EXPECT_NO_THROW(decimate.initialize(downFactor, 31, false,
+                                        DecimationImplementation::MULTISTAGE));
+    std::vector<double> yRef(ny);
+    yptr = yRef.data();
+    EXPECT_NO_THROW(decimate.apply(npts, x.data(), ny, &nyDecim, &yptr));
+    Decimate<RTSeis::ProcessingMode::REAL_TIME, double> rtDecim;
+    EXPECT_NO_THROW(rtDecim.initialize(downFactor, 31, false,
+                                       DecimationImplementation::MULTISTAGE));
+    auto groupDelay = rtDecim.getGroupDelay();
+    EXPECT_NEAR(groupDelay, decimate.getGroupDelay(), 1.e-14);
+    std::vector<int> packetSize({1, 7, 64, 100, 513, 1000, 4096});
+    for (auto job = 0; job < 2; ++job)
+    {
+        for (const auto np : packetSize)
+        {
+            std::fill(y.begin(), y.end(), 0);
+            int nxloc = 0;
+            int nyloc = 0;
+            while (nxloc < npts)
+            {
+                int nptsPass = std::min(np, npts - nxloc);
+                if (job == 1)
+                {
+                    nptsPass = std::min(np + rand()%50, npts - nxloc);
+                }
+                int nyDec = 0;
+                yptr = &y[nyloc];
+                EXPECT_NO_THROW(rtDecim.apply(nptsPass, &x[nxloc],
+                                              ny - nyloc, &nyDec, &yptr));
+                nxloc = nxloc + nptsPass;
+                nyloc = nyloc + nyDec;
+            }
+            rtDecim.resetInitialConditions();
+            EXPECT_EQ(nyloc, ny);
+            ippsNormDiff_Inf_64f(y.data(), yRef.data(), ny, &error);
+            EXPECT_LE(error, 1.e-12);
+        }
+    }
+    // The reported group delay should align the output with the input
+    error = 0;
+    for (int i = 2*nEdge; i < ny; ++i)
+    {
+        error = std::max(error,
+                         std::abs(y[i] - signal(i*downFactor*dt
+                                              - groupDelay*dt)));
+    }
+    EXPECT_LE(error, 1.e-2);
+}
+//============================================================================//
+TEST(UtilitiesFilterImplementations, resample)
+{
+    auto signal = [](const double t)
+    {
+        return std::sin(2*M_PI*1.3*t) + 0.5*std::cos(2*M_PI*4.1*t);
+    };
+    // Resample 40 Hz data to 100 Hz
+    const int npts = 4000;
+    double dt = 1.0/40.0;
+    double ratio = 100.0/40.0;
+    std::vector<double> x(npts);
+    for (int i = 0; i < npts; ++i){x[i] = signal(i*dt);}
+    Resample<RTSeis::ProcessingMode::POST, double> resample;
+    EXPECT_THROW(resample.initialize(0), std::invalid_argument);
+    EXPECT_THROW(resample.initialize(ratio, 4), std::invalid_argument);
+    EXPECT_NO_THROW(resample.initialize(ratio));
+    EXPECT_EQ(resample.getInitialConditionLength(),
+              resample.getFilterLength() - 1);
+    int ny = resample.estimateSpace(npts);
+    EXPECT_EQ(ny, 10000);
+    std::vector<double> y(ny);
+    int nyOut = 0;
+    auto yptr = y.data();
+    EXPECT_NO_THROW(resample.apply(npts, x.data(), ny, &nyOut, &yptr));
+    EXPECT_EQ(nyOut, ny);
+    // Away from the edges the post-processing output has no delay
+    auto nEdge = static_cast<int> (resample.getFilterLength()*ratio);
+    double error = 0;
+    for (int i = nEdge; i < ny - nEdge; ++i)
+    {
+        error = std::max(error, std::abs(y[i] - signal(i*dt/ratio)));
+    }
+    EXPECT_LE(error, 1.e-3);
+    // Remove clock drift from a 100.0003 Hz station in real-time.  The
+    // drift then changes to 99.9995 Hz half way through.
+    dt = 1.0/100.0003;
+    std::vector<double> ratios({100.0/100.0003, 100.0/99.9995});
+    for (int i = 0; i < npts; ++i){x[i] = signal(i*dt);}
+    Resample<RTSeis::ProcessingMode::REAL_TIME, double> rtResample;
+    EXPECT_NO_THROW(rtResample.initialize(ratios[0]));
+    auto groupDelay = rtResample.getGroupDelay();
+    y.resize(npts + 1);
+    for (auto job = 0; job < 2; ++job)
+    {
+        std::fill(y.begin(), y.end(), 0);
+        EXPECT_NO_THROW(rtResample.setRatio(ratios[0]));
+        rtResample.resetInitialConditions();
+        std::vector<double> timeExpected;
+        double time = 0;
+        int nxloc = 0;
+        int nyloc = 0;
+        while (nxloc < npts)
+        {
+            int nptsPass = std::min(64, npts - nxloc);
+            if (job == 1){nptsPass = std::min(1 + rand()%100, npts - nxloc);}
+            int nyPass = rtResample.estimateSpace(nptsPass);
+            yptr = &y[nyloc];
+            EXPECT_NO_THROW(rtResample.apply(nptsPass, &x[nxloc],
+                                             npts + 1 - nyloc, &nyOut, &yptr));
+            EXPECT_EQ(nyOut, nyPass);
+            for (int i = 0; i < nyOut; ++i)
+            {
+                timeExpected.push_back(time);
+                time = time + 1.0/rtResample.getRatio();
+            }
+            nxloc = nxloc + nptsPass;
+            nyloc = nyloc + nyOut;
+            if (nxloc >= npts/2 && rtResample.getRatio() == ratios[0])
+            {
+                EXPECT_NO_THROW(rtResample.setRatio(ratios[1]));
+            }
+        }
+        EXPECT_EQ(nyloc, static_cast<int> (timeExpected.size()));
+        // The output is delayed by the filter
+        error = 0;
+        for (int i = 2*nEdge; i < nyloc; ++i)
+        {
+            auto yRef = signal((timeExpected[i] - groupDelay)*dt);
+            error = std::max(error, std::abs(y[i] - yRef));
+        }
+        EXPECT_LE(error, 1.e-3);
+    }
+    // A packet spanning several of the internal blocks must match the
+    // same signal passed in small packets
+    const int nLong = 10001;
+    x.resize(nLong);
+    for (int i = 0; i < nLong; ++i){x[i] = signal(i*dt);}
+    EXPECT_NO_THROW(rtResample.setRatio(ratios[0]));
+    rtResample.resetInitialConditions();
+    int nyLong = rtResample.estimateSpace(nLong);
+    std::vector<double> yLong(nyLong);
+    yptr = yLong.data();
+    EXPECT_NO_THROW(rtResample.apply(nLong, x.data(), nyLong, &nyOut, &yptr));
+    EXPECT_EQ(nyOut, nyLong);
+    rtResample.resetInitialConditions();
+    y.assign(nyLong + 1, 0);
+    int nyloc = 0;
+    for (int nxloc = 0; nxloc < nLong; nxloc = nxloc + 100)
+    {
+        int nptsPass = std::min(100, nLong - nxloc);
+        yptr = &y[nyloc];
+        EXPECT_NO_THROW(rtResample.apply(nptsPass, &x[nxloc],
+                                         nyLong + 1 - nyloc, &nyOut, &yptr));
+        nyloc = nyloc + nyOut;
+    }
+    EXPECT_EQ(nyloc, nyLong);
+    error = 0;
+    for (int i = 0; i < std::min(nyloc, nyLong); ++i)
+    {
+        error = std::max(error, std::abs(y[i] - yLong[i]));
+    }
+    EXPECT_LE(error, 1.e-10);
+}
+//============================================================================//
 void read_decimate(const int nq, std::vector<double> *xdecim)
 {
     xdecim->resize(0);
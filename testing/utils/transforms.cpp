@@ -16,14 +16,19 @@
 #include "rtseis/utilities/transforms/enums.hpp"
 #include "rtseis/utilities/transforms/dftRealToComplex.hpp"
 #include "rtseis/utilities/transforms/dft.hpp"
+#include "rtseis/utilities/transforms/dftPlanCache.hpp"
 #include "rtseis/utilities/transforms/hilbert.hpp"
 #include "rtseis/utilities/transforms/envelope.hpp"
 #include "rtseis/utilities/transforms/firEnvelope.hpp"
 #include "rtseis/utilities/transforms/welch.hpp"
+#include "rtseis/utilities/transforms/multiChannelWelch.hpp"
 #include "rtseis/utilities/transforms/slidingWindowRealDFTParameters.hpp"
 #include "rtseis/utilities/transforms/slidingWindowRealDFT.hpp"
+#include "rtseis/utilities/transforms/sparseFrequencyDFT.hpp"
 #include "rtseis/utilities/transforms/utilities.hpp"
 #include "rtseis/utilities/transforms/wavelets/morlet.hpp"
+#include "rtseis/utilities/transforms/wavelets/ricker.hpp"
+#include "private/dftPlanCache.hpp"
 #include "rtseis/utilities/transforms/continuousWavelet.hpp"
 #include "rtseis/utilities/windowFunctions.hpp"
 #include <gtest/gtest.h>
@@ -138,6 +143,32 @@ TEST(UtilitiesTransforms, NextPow2)
     EXPECT_EQ(DFTUtilities::nextPowerOfTwo(131072), 131072);
 }
 
+TEST(UtilitiesTransforms, NextFastLength)
+{
+    EXPECT_EQ(DFTUtilities::nextFastLength(0), 1);
+    EXPECT_EQ(DFTUtilities::nextFastLength(1), 1);
+    EXPECT_EQ(DFTUtilities::nextFastLength(11), 12);
+    EXPECT_EQ(DFTUtilities::nextFastLength(13), 14);
+    EXPECT_EQ(DFTUtilities::nextFastLength(1024), 1024);
+    EXPECT_EQ(DFTUtilities::nextFastLength(1025), 1029);
+    EXPECT_EQ(DFTUtilities::nextFastLength(12001), 12005);
+    EXPECT_EQ(DFTUtilities::nextFastLength(100001), 100352);
+    EXPECT_THROW(DFTUtilities::nextFastLength(-1), std::invalid_argument);
+    // Compare to a brute-force search
+    for (int n = 2; n < 2000; ++n)
+    {
+        int nFast = n;
+        while (true)
+        {
+            int m = nFast;
+            for (int p : {2, 3, 5, 7}){while (m%p == 0){m = m/p;}}
+            if (m == 1){break;}
+            nFast = nFast + 1;
+        }
+        EXPECT_EQ(DFTUtilities::nextFastLength(n), nFast);
+    }
+}
+
 //int transforms_unwrap_test(void)
 TEST(UtilitiesTransforms, Unwrap)
 {
@@ -467,8 +498,8 @@ TEST(UtilitiesTransforms, dftr2c)
         auto lendft = npts/2 + 1;
         std::complex<double> *zrefDFT = new std::complex<double>[lendft];
         ASSERT_EQ(rfft(npts, x, npts, lendft, zrefDFT), 0);
-        // Compute an FFT w/ FFTw
-        auto np2 = DFTUtilities::nextPowerOfTwo(npts);
+        // Compute an FFT w/ FFTw.  The FFT pads to a 2, 3, 5, 7-smooth length.
+        auto np2 = DFTUtilities::nextFastLength(npts);
         auto lenfft = np2/2 + 1;
         std::complex<double> *zrefFFT = new std::complex<double>[lenfft];
         ASSERT_EQ(rfft(npts, x, np2, lenfft, zrefFFT), 0);
@@ -569,6 +600,127 @@ TEST(UtilitiesTransforms, dftr2c)
     delete[] x;
 }
 
+TEST(UtilitiesTransforms, DFTPlanCache)
+{
+    const int npts = 1000;
+    std::vector<double> x(npts);
+    for (auto &xi : x){xi = static_cast<double> (rand())/RAND_MAX;}
+    DFTPlanCache::releaseUnusedPlans();
+    auto nPlans0 = DFTPlanCache::getNumberOfPlans();
+    DFTRealToComplex<double> dft;
+    EXPECT_NO_THROW(dft.initialize(npts, FourierTransformImplementation::DFT));
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + 1);
+    // Identical transforms and copies share the plan
+    DFTRealToComplex<double> dftSame;
+    EXPECT_NO_THROW(dftSame.initialize(npts,
+                                       FourierTransformImplementation::DFT));
+    DFTRealToComplex<double> dftCopy(dft);
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + 1);
+    // A different precision is a different plan
+    DFTRealToComplex<float> dft32;
+    EXPECT_NO_THROW(dft32.initialize(npts,
+                                     FourierTransformImplementation::DFT));
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + 2);
+    auto lendft = dft.getTransformLength();
+    std::vector<std::complex<double>> z(lendft), zSame(lendft), zCopy(lendft);
+    auto zptr = z.data();
+    auto zSamePtr = zSame.data();
+    auto zCopyPtr = zCopy.data();
+    EXPECT_NO_THROW(dft.forwardTransform(npts, x.data(), lendft, &zptr));
+    EXPECT_NO_THROW(dftSame.forwardTransform(npts, x.data(), lendft,
+                                             &zSamePtr));
+    EXPECT_NO_THROW(dftCopy.forwardTransform(npts, x.data(), lendft,
+                                             &zCopyPtr));
+    for (int i = 0; i < lendft; ++i)
+    {
+        EXPECT_EQ(z[i], zSame[i]);
+        EXPECT_EQ(z[i], zCopy[i]);
+    }
+    // Plans in use are not released.  Unused plans are.
+    dft32.clear();
+    EXPECT_EQ(DFTPlanCache::releaseUnusedPlans(), 1);
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + 1);
+    dft.clear();
+    dftSame.clear();
+    dftCopy.clear();
+    EXPECT_EQ(DFTPlanCache::releaseUnusedPlans(), 1);
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0);
+}
+
+TEST(UtilitiesTransforms, DFTPlanCacheBounded)
+{
+    DFTPlanCache::releaseUnusedPlans();
+    auto nPlans0 = DFTPlanCache::getNumberOfPlans();
+    auto nRetained = DFTPlanCache::getMaximumNumberOfRetainedPlans();
+    EXPECT_GT(nRetained, 0);
+    // The cache only holds on to the plans of a few dropped transforms
+    for (int npts = 100; npts < 400; ++npts)
+    {
+        DFTRealToComplex<double> dft;
+        EXPECT_NO_THROW(dft.initialize(npts,
+                                       FourierTransformImplementation::DFT));
+        EXPECT_LE(DFTPlanCache::getNumberOfPlans(), nPlans0 + nRetained);
+    }
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + nRetained);
+    EXPECT_EQ(DFTPlanCache::releaseUnusedPlans(), nRetained);
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0);
+    // Live plans are kept and a dropped plan is rebuilt on demand
+    DFTRealToComplex<double> dftKeep;
+    EXPECT_NO_THROW(dftKeep.initialize(128,
+                                       FourierTransformImplementation::DFT));
+    for (int npts = 100; npts < 400; ++npts)
+    {
+        DFTRealToComplex<double> dft;
+        EXPECT_NO_THROW(dft.initialize(npts,
+                                       FourierTransformImplementation::DFT));
+    }
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + 1 + nRetained);
+    EXPECT_EQ(DFTPlanCache::releaseUnusedPlans(), nRetained);
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + 1);
+    dftKeep.clear();
+    EXPECT_EQ(DFTPlanCache::releaseUnusedPlans(), 1);
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0);
+}
+
+TEST(UtilitiesTransforms, DFTPlanCacheReuse)
+{
+    const int npts = 777;
+    DFTPlanCache::releaseUnusedPlans();
+    auto nPlans0 = DFTPlanCache::getNumberOfPlans();
+    // Destroying the last transform then recreating it reuses the plan
+    auto plan = DFTPlanCache::getPlan(DFTPlanCache::Domain::REAL, npts, false,
+                                      RTSeis::Precision::DOUBLE);
+    ASSERT_NE(plan, nullptr);
+    std::weak_ptr<const DFTPlanCache::Plan> weakPlan = plan;
+    plan = nullptr;
+    EXPECT_FALSE(weakPlan.expired());
+    plan = DFTPlanCache::getPlan(DFTPlanCache::Domain::REAL, npts, false,
+                                 RTSeis::Precision::DOUBLE);
+    EXPECT_EQ(plan, weakPlan.lock());
+    plan = nullptr;
+    {
+    DFTRealToComplex<double> dft;
+    EXPECT_NO_THROW(dft.initialize(npts, FourierTransformImplementation::DFT));
+    }
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + 1);
+    {
+    DFTRealToComplex<double> dft;
+    EXPECT_NO_THROW(dft.initialize(npts, FourierTransformImplementation::DFT));
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0 + 1);
+    }
+    EXPECT_FALSE(weakPlan.expired());
+    // Once enough other plans are requested the idle plan is let go
+    for (int i = 1; i <= DFTPlanCache::getMaximumNumberOfRetainedPlans(); ++i)
+    {
+        DFTRealToComplex<double> dft;
+        EXPECT_NO_THROW(dft.initialize(npts + i,
+                                       FourierTransformImplementation::DFT));
+    }
+    EXPECT_TRUE(weakPlan.expired());
+    DFTPlanCache::releaseUnusedPlans();
+    EXPECT_EQ(DFTPlanCache::getNumberOfPlans(), nPlans0);
+}
+
 TEST(UtilitiesTransforms, Hilbert)
 {
     std::vector<std::complex<double>> h10(10), h11(11);
@@ -996,6 +1148,291 @@ TEST(UtilitiesTransforms, Spectrogram)
     ASSERT_LE(resmax, 1.e-7);
 }
 
+TEST(UtilitiesTransforms, RealTimeSlidingWindowRealDFT)
+{
+    const int npts = 3000;
+    const int windowLength = 64;
+    const int nSamplesInOverlap = 48;
+    const int shift = windowLength - nSamplesInOverlap;
+    std::vector<double> x(npts);
+    for (auto &xi : x){xi = static_cast<double> (rand()%1000)/1000.0 - 0.5;}
+    SlidingWindowRealDFTParameters parameters;
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(npts));
+    EXPECT_NO_THROW(parameters.setWindow(windowLength,
+                                         SlidingWindowType::HAMMING));
+    EXPECT_NO_THROW(parameters.setDFTLength(80));
+    EXPECT_NO_THROW(parameters.setNumberOfSamplesInOverlap(nSamplesInOverlap));
+    EXPECT_NO_THROW(
+        parameters.setDetrendType(SlidingWindowDetrendType::REMOVE_MEAN));
+    EXPECT_EQ(parameters.getProcessingMode(), RTSeis::ProcessingMode::POST);
+    // Reference post-processing solution
+    SlidingWindowRealDFT sdftRef;
+    EXPECT_NO_THROW(sdftRef.initialize(parameters));
+    EXPECT_NO_THROW(sdftRef.transform(npts, x.data()));
+    // Real-time with a display that spans 500 samples
+    parameters.setNumberOfSamples(500);
+    parameters.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    SlidingWindowRealDFT sdft;
+    EXPECT_NO_THROW(sdft.initialize(parameters));
+    EXPECT_EQ(sdft.getProcessingMode(), RTSeis::ProcessingMode::REAL_TIME);
+    EXPECT_EQ(sdft.getNumberOfTransformWindows(), 0);
+    const int nRing = (500 - nSamplesInOverlap)/shift;
+    const int nFrequencies = sdft.getNumberOfFrequencies();
+    int nWindowsTotal = 0;
+    int nxloc = 0;
+    double resmax = 0;
+    while (nxloc < npts)
+    {
+        auto nptsPass = std::min(npts - nxloc, 1 + rand()%200);
+        if (nxloc == 0){nptsPass = 10;} // Too short for a window
+        EXPECT_NO_THROW(sdft.transform(nptsPass, x.data() + nxloc));
+        nxloc = nxloc + nptsPass;
+        auto nNew = sdft.getNumberOfNewTransformWindows();
+        nWindowsTotal = nWindowsTotal + nNew;
+        EXPECT_EQ(nWindowsTotal,
+                  std::max(0, (nxloc - nSamplesInOverlap)/shift));
+        auto nWindows = sdft.getNumberOfTransformWindows();
+        EXPECT_EQ(nWindows, std::min(nWindowsTotal, nRing));
+        // Compare the retained windows
+        for (int iw = 0; iw < nWindows; ++iw)
+        {
+            auto jw = nWindowsTotal - nWindows + iw;
+            auto cptr = sdft.getTransform64f(iw);
+            auto cref = sdftRef.getTransform64f(jw);
+            for (int j = 0; j < nFrequencies; ++j)
+            {
+                resmax = std::max(resmax, std::abs(cptr[j] - cref[j]));
+            }
+        }
+    }
+    EXPECT_LE(resmax, 1.e-12);
+    // A copy retains the state
+    SlidingWindowRealDFT sdftCopy(sdft);
+    EXPECT_EQ(sdftCopy.getNumberOfTransformWindows(), nRing);
+    EXPECT_NO_THROW(sdft.resetInitialConditions());
+    EXPECT_EQ(sdft.getNumberOfTransformWindows(), 0);
+    EXPECT_THROW(sdft.getTransform64f(0), std::runtime_error);
+}
+
+TEST(UtilitiesTransforms, FloatThreadedSlidingWindowRealDFT)
+{
+    const int npts = 4000;
+    const int windowLength = 100;
+    const int nSamplesInOverlap = 60;
+    std::vector<double> x(npts);
+    for (auto &xi : x){xi = static_cast<double> (rand()%1000)/1000.0 - 0.5;}
+    std::vector<float> x32(x.begin(), x.end());
+    SlidingWindowRealDFTParameters parameters;
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(npts));
+    EXPECT_NO_THROW(parameters.setWindow(windowLength,
+                                         SlidingWindowType::HANN));
+    EXPECT_NO_THROW(parameters.setNumberOfSamplesInOverlap(nSamplesInOverlap));
+    EXPECT_NO_THROW(
+        parameters.setDetrendType(SlidingWindowDetrendType::REMOVE_TREND));
+    EXPECT_EQ(parameters.getNumberOfThreads(), 1);
+    EXPECT_THROW(parameters.setNumberOfThreads(0), std::invalid_argument);
+    // Reference double precision solution
+    SlidingWindowRealDFT sdftRef;
+    EXPECT_NO_THROW(sdftRef.initialize(parameters));
+    EXPECT_NO_THROW(sdftRef.transform(npts, x.data()));
+    const int nWindows = sdftRef.getNumberOfTransformWindows();
+    const int nFrequencies = sdftRef.getNumberOfFrequencies();
+    // Multi-threaded double and float precision with both input types
+    EXPECT_NO_THROW(parameters.setNumberOfThreads(4));
+    SlidingWindowRealDFT sdft64;
+    EXPECT_NO_THROW(sdft64.initialize(parameters));
+    EXPECT_NO_THROW(sdft64.transform(npts, x.data()));
+    parameters.setPrecision(RTSeis::Precision::FLOAT);
+    SlidingWindowRealDFT sdft32;
+    EXPECT_NO_THROW(sdft32.initialize(parameters));
+    EXPECT_EQ(sdft32.getPrecision(), RTSeis::Precision::FLOAT);
+    EXPECT_THROW(sdft32.getTransform32f(0), std::runtime_error);
+    EXPECT_NO_THROW(sdft32.transform(npts, x32.data()));
+    EXPECT_THROW(sdft32.getTransform64f(0), std::runtime_error);
+    double error64 = 0;
+    double error32 = 0;
+    double cmax = 0;
+    for (int iw = 0; iw < nWindows; ++iw)
+    {
+        auto cref = sdftRef.getTransform64f(iw);
+        auto c64 = sdft64.getTransform64f(iw);
+        auto c32 = sdft32.getTransform32f(iw);
+        for (int j = 0; j < nFrequencies; ++j)
+        {
+            std::complex<double> c32d(c32[j].real(), c32[j].imag());
+            error64 = std::max(error64, std::abs(c64[j] - cref[j]));
+            error32 = std::max(error32, std::abs(c32d - cref[j]));
+            cmax = std::max(cmax, std::abs(cref[j]));
+        }
+    }
+    EXPECT_LE(error64, 1.e-12);
+    EXPECT_LE(error32, 1.e-5*cmax);
+    // Real-time float precision from double packets
+    parameters.setNumberOfSamples(1000);
+    parameters.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    SlidingWindowRealDFT sdftRT;
+    EXPECT_NO_THROW(sdftRT.initialize(parameters));
+    int nWindowsTotal = 0;
+    error32 = 0;
+    for (int nxloc = 0; nxloc < npts; nxloc = nxloc + 250)
+    {
+        EXPECT_NO_THROW(sdftRT.transform(250, x.data() + nxloc));
+        nWindowsTotal = nWindowsTotal + sdftRT.getNumberOfNewTransformWindows();
+        auto nRetained = sdftRT.getNumberOfTransformWindows();
+        for (int iw = 0; iw < nRetained; ++iw)
+        {
+            auto cref = sdftRef.getTransform64f(nWindowsTotal - nRetained + iw);
+            auto c32 = sdftRT.getTransform32f(iw);
+            for (int j = 0; j < nFrequencies; ++j)
+            {
+                std::complex<double> c32d(c32[j].real(), c32[j].imag());
+                error32 = std::max(error32, std::abs(c32d - cref[j]));
+            }
+        }
+    }
+    EXPECT_EQ(nWindowsTotal, nWindows);
+    EXPECT_LE(error32, 1.e-5*cmax);
+    // After a reset the stream must match a fresh instance.  The 30 sample
+    // packet leaves samples pending that the reset must discard.
+    EXPECT_NO_THROW(sdftRT.transform(30, x32.data() + 1234));
+    EXPECT_NO_THROW(sdftRT.resetInitialConditions());
+    SlidingWindowRealDFT sdftFresh;
+    EXPECT_NO_THROW(sdftFresh.initialize(parameters));
+    bool same = true;
+    for (int nxloc = 0; nxloc < 1000; nxloc = nxloc + 125)
+    {
+        EXPECT_NO_THROW(sdftRT.transform(125, x32.data() + nxloc));
+        EXPECT_NO_THROW(sdftFresh.transform(125, x32.data() + nxloc));
+        auto nRetained = sdftFresh.getNumberOfTransformWindows();
+        EXPECT_EQ(sdftRT.getNumberOfTransformWindows(), nRetained);
+        EXPECT_EQ(sdftRT.getNumberOfNewTransformWindows(),
+                  sdftFresh.getNumberOfNewTransformWindows());
+        if (sdftRT.getNumberOfTransformWindows() != nRetained){continue;}
+        for (int iw = 0; iw < nRetained; ++iw)
+        {
+            auto c32 = sdftRT.getTransform32f(iw);
+            auto c32Ref = sdftFresh.getTransform32f(iw);
+            same = same && std::equal(c32, c32 + nFrequencies, c32Ref);
+        }
+    }
+    EXPECT_TRUE(same);
+}
+
+TEST(UtilitiesTransforms, SparseFrequencyDFT)
+{
+    const int nChannels = 3;
+    const int nSamples = 2000;
+    const int windowLength = 100;
+    const double samplingRate = 100;
+    std::vector<double> frequencies({0, 5, 12.3, 50});
+    auto nFrequencies = static_cast<int> (frequencies.size());
+    std::vector<double> x(nSamples*nChannels);
+    for (int i=0; i<nSamples; ++i)
+    {
+        for (int c=0; c<nChannels; ++c)
+        {
+            x[i*nChannels + c] = std::sin(2*M_PI*5*i/samplingRate + c)
+                               + 0.5*std::cos(0.37*(c + 1)*i)
+                               + 0.1*(c - 1);
+        }
+    }
+    // Brute force evaluation of the window ending at sample i
+    auto reference = [&](const int i, const int c, const int f)
+    {
+        auto omega = 2*M_PI*frequencies[f]/samplingRate;
+        std::complex<double> xsum(0, 0);
+        for (int m=0; m<windowLength; ++m)
+        {
+            auto xm = x[(i - windowLength + 1 + m)*nChannels + c];
+            xsum = xsum + xm*std::polar(1.0, -omega*m);
+        }
+        return xsum;
+    };
+    // Sliding DFT (hop of 1) and Goertzel (hop of 40) evaluations
+    for (auto hopLength : std::vector<int> {1, 40})
+    {
+        SparseFrequencyDFT<RTSeis::ProcessingMode::POST, double> dft;
+        EXPECT_NO_THROW(dft.initialize(nChannels, nFrequencies,
+                                       frequencies.data(), windowLength,
+                                       hopLength, samplingRate));
+        EXPECT_EQ(dft.getNumberOfChannels(), nChannels);
+        EXPECT_EQ(dft.getNumberOfFrequencies(), nFrequencies);
+        EXPECT_EQ(dft.getWindowLength(), windowLength);
+        EXPECT_EQ(dft.getHopLength(), hopLength);
+        EXPECT_NO_THROW(dft.transform(nSamples, x.data()));
+        auto nWindows = dft.getNumberOfNewWindows();
+        EXPECT_EQ(nWindows, (nSamples - windowLength)/hopLength + 1);
+        double emax = 0;
+        for (int iw=0; iw<nWindows; ++iw)
+        {
+            auto i = windowLength - 1 + iw*hopLength;
+            auto X = dft.getTransform(iw);
+            for (int c=0; c<nChannels; ++c)
+            {
+                for (int f=0; f<nFrequencies; ++f)
+                {
+                    auto e = std::abs(X[c*nFrequencies + f]
+                                    - reference(i, c, f));
+                    emax = std::max(emax, e);
+                }
+            }
+        }
+        EXPECT_LE(emax, 1.e-10);
+        // Post-processing starts anew
+        EXPECT_NO_THROW(dft.transform(windowLength, x.data()));
+        EXPECT_EQ(dft.getNumberOfNewWindows(), 1);
+        EXPECT_LE(std::abs(dft.getTransform(0)[1] - reference(windowLength - 1,
+                                                              0, 1)), 1.e-10);
+    }
+    // Stream variable length packets in single precision
+    const int hopLength = 7;
+    SparseFrequencyDFT<RTSeis::ProcessingMode::REAL_TIME, float> dftRT;
+    EXPECT_THROW(dftRT.initialize(nChannels, nFrequencies,
+                                  frequencies.data(), windowLength,
+                                  hopLength, samplingRate, 0),
+                 std::invalid_argument);
+    // Packets are at most 50 samples so the output is allocated up front
+    EXPECT_NO_THROW(dftRT.initialize(nChannels, nFrequencies,
+                                     frequencies.data(), windowLength,
+                                     hopLength, samplingRate, 50));
+    std::vector<float> x32(x.begin(), x.end());
+    int i1 = 0;
+    int iPacket = 0;
+    int iWindow = 0;
+    double emax = 0;
+    while (i1 < nSamples)
+    {
+        auto nx = std::min(nSamples - i1, 1 + (13*iPacket)%50);
+        EXPECT_NO_THROW(dftRT.transform(nx, x32.data() + i1*nChannels));
+        for (int iw=0; iw<dftRT.getNumberOfNewWindows(); ++iw)
+        {
+            auto i = windowLength - 1 + iWindow*hopLength;
+            EXPECT_LT(i, i1 + nx);
+            auto X = dftRT.getTransform(iw);
+            for (int c=0; c<nChannels; ++c)
+            {
+                for (int f=0; f<nFrequencies; ++f)
+                {
+                    auto Xf = std::complex<double> (X[c*nFrequencies + f]);
+                    emax = std::max(emax, std::abs(Xf - reference(i, c, f)));
+                }
+            }
+            iWindow = iWindow + 1;
+        }
+        i1 = i1 + nx;
+        iPacket = iPacket + 1;
+    }
+    EXPECT_EQ(iWindow, (nSamples - windowLength)/hopLength + 1);
+    EXPECT_LE(emax, 1.e-4);
+    // A reset restarts the window count
+    EXPECT_NO_THROW(dftRT.resetInitialConditions());
+    EXPECT_NO_THROW(dftRT.transform(windowLength - 1, x32.data()));
+    EXPECT_EQ(dftRT.getNumberOfNewWindows(), 0);
+    EXPECT_NO_THROW(dftRT.transform(1,
+                                    x32.data() + (windowLength - 1)*nChannels));
+    EXPECT_EQ(dftRT.getNumberOfNewWindows(), 1);
+}
+
 TEST(UtilitiesTransforms, Welch)
 {
     // Dirty trick - I need to read a 3 column text file so I can use envelope
@@ -1089,6 +1526,216 @@ TEST(UtilitiesTransforms, Welch)
     EXPECT_LE(error, 1.e-5);
 }
 
+TEST(UtilitiesTransforms, RealTimeWelch)
+{
+    const double samplingRate = 100;
+    const int nSignal = 12000;
+    const int nSamplesPerSegment = 256;
+    const int nSamplesInOverlap = 128;
+    const int nSpan = 4096;
+    std::vector<double> x(nSignal);
+    for (int i=0; i<nSignal; ++i)
+    {
+        x[i] = std::sin(2*M_PI*7.3*i/samplingRate)*(1 + 0.0001*i)
+             + 0.2*std::cos(0.9*i) + 0.05*std::sin(0.013*i*i);
+    }
+    SlidingWindowRealDFTParameters parameters;
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(nSpan));
+    EXPECT_NO_THROW(parameters.setWindow(nSamplesPerSegment,
+                                         SlidingWindowType::HANN));
+    EXPECT_NO_THROW(parameters.setNumberOfSamplesInOverlap(nSamplesInOverlap));
+    EXPECT_NO_THROW(parameters.setDetrendType(
+                        SlidingWindowDetrendType::REMOVE_MEAN));
+    EXPECT_NO_THROW(parameters.setDFTLength(nSamplesPerSegment));
+    auto postParameters = parameters;
+    parameters.setProcessingMode(RTSeis::ProcessingMode::REAL_TIME);
+    Welch welch;
+    EXPECT_NO_THROW(welch.initialize(parameters, samplingRate));
+    EXPECT_EQ(welch.getProcessingMode(), RTSeis::ProcessingMode::REAL_TIME);
+    EXPECT_EQ(welch.getAveraging(), WelchAveraging::BLOCK);
+    auto nFrequencies = welch.getNumberOfFrequencies();
+    std::vector<double> psd(nFrequencies);
+    std::vector<double> psdRef(nFrequencies);
+    auto psdPtr = psd.data();
+    auto psdRefPtr = psdRef.data();
+    // Nothing is available until a segment is complete
+    EXPECT_NO_THROW(welch.transform(nSamplesPerSegment - 1, x.data()));
+    EXPECT_FALSE(welch.haveTransform());
+    EXPECT_NO_THROW(welch.resetInitialConditions());
+    // Stream the signal in variable length packets
+    auto stream = [&](Welch &w)
+    {
+        int i1 = 0;
+        int iPacket = 0;
+        while (i1 < nSignal)
+        {
+            auto nx = std::min(nSignal - i1, 1 + (97*iPacket)%300);
+            EXPECT_NO_THROW(w.transform(nx, x.data() + i1));
+            i1 = i1 + nx;
+            iPacket = iPacket + 1;
+        }
+    };
+    stream(welch);
+    EXPECT_TRUE(welch.haveTransform());
+    EXPECT_NO_THROW(welch.getPowerSpectralDensity(nFrequencies, &psdPtr));
+    // Block averaging matches post-processing the most recent segments
+    auto shift = nSamplesPerSegment - nSamplesInOverlap;
+    auto nWindows = (nSignal - nSamplesPerSegment)/shift + 1;
+    auto nBlock = (nSpan - nSamplesInOverlap)/shift;
+    auto i0 = (nWindows - nBlock)*shift;
+    Welch welchPost;
+    EXPECT_NO_THROW(welchPost.initialize(postParameters, samplingRate));
+    EXPECT_NO_THROW(welchPost.transform(nSpan, x.data() + i0));
+    EXPECT_NO_THROW(welchPost.getPowerSpectralDensity(nFrequencies,
+                                                      &psdRefPtr));
+    double emax = 0;
+    double pmax = 0;
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        emax = std::max(emax, std::abs(psd[k] - psdRef[k]));
+        pmax = std::max(pmax, psdRef[k]);
+    }
+    EXPECT_LE(emax/pmax, 1.e-10);
+    // Exponential averaging of single segment estimates
+    const double lambda = 0.8;
+    EXPECT_NO_THROW(welch.setExponentialAveraging(lambda));
+    EXPECT_EQ(welch.getAveraging(), WelchAveraging::EXPONENTIAL);
+    EXPECT_THROW(welch.setExponentialAveraging(1), std::invalid_argument);
+    EXPECT_NO_THROW(welch.resetInitialConditions());
+    stream(welch);
+    EXPECT_NO_THROW(welch.getPowerSpectralDensity(nFrequencies, &psdPtr));
+    auto segmentParameters = postParameters;
+    EXPECT_NO_THROW(segmentParameters.setNumberOfSamples(nSamplesPerSegment));
+    EXPECT_NO_THROW(welchPost.initialize(segmentParameters, samplingRate));
+    std::fill(psdRef.begin(), psdRef.end(), 0);
+    std::vector<double> psdSegment(nFrequencies);
+    auto psdSegmentPtr = psdSegment.data();
+    double weight = 0;
+    for (int iw=0; iw<nWindows; ++iw)
+    {
+        EXPECT_NO_THROW(welchPost.transform(nSamplesPerSegment,
+                                            x.data() + iw*shift));
+        EXPECT_NO_THROW(welchPost.getPowerSpectralDensity(nFrequencies,
+                                                          &psdSegmentPtr));
+        for (int k=0; k<nFrequencies; ++k)
+        {
+            psdRef[k] = lambda*psdRef[k] + psdSegment[k];
+        }
+        weight = lambda*weight + 1;
+    }
+    emax = 0;
+    pmax = 0;
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        psdRef[k] = psdRef[k]/weight;
+        emax = std::max(emax, std::abs(psd[k] - psdRef[k]));
+        pmax = std::max(pmax, psdRef[k]);
+    }
+    EXPECT_LE(emax/pmax, 1.e-10);
+}
+
+TEST(UtilitiesTransforms, MultiChannelWelch)
+{
+    const double samplingRate = 100;
+    const int nSamples = 3000;
+    const int nChannels = 3;
+    std::vector<double> x(nChannels*nSamples);
+    for (int i=0; i<nSamples; ++i)
+    {
+        auto x0 = std::sin(2*M_PI*7.3*i/samplingRate)
+                + 0.2*std::cos(0.9*i) + 0.05*std::sin(0.013*i*i);
+        x[i] = x0;
+        x[nSamples + i] = 2*x0;
+        x[2*nSamples + i] = std::cos(2*M_PI*7.3*i/samplingRate + 0.3)
+                          + 0.3*std::sin(0.0007*i*i);
+    }
+    SlidingWindowRealDFTParameters parameters;
+    EXPECT_NO_THROW(parameters.setNumberOfSamples(nSamples));
+    EXPECT_NO_THROW(parameters.setWindow(256, SlidingWindowType::HANN));
+    EXPECT_NO_THROW(parameters.setNumberOfSamplesInOverlap(128));
+    EXPECT_NO_THROW(parameters.setDetrendType(
+                        SlidingWindowDetrendType::REMOVE_MEAN));
+    EXPECT_NO_THROW(parameters.setDFTLength(256));
+    MultiChannelWelch welch;
+    EXPECT_NO_THROW(welch.initialize(nChannels, parameters, samplingRate));
+    EXPECT_EQ(welch.getNumberOfChannels(), nChannels);
+    EXPECT_EQ(welch.getNumberOfSamples(), nSamples);
+    EXPECT_NO_THROW(welch.transform(nChannels, nSamples, x.data()));
+    EXPECT_TRUE(welch.haveTransform());
+    auto nFrequencies = welch.getNumberOfFrequencies();
+    // The auto-spectra match Welch
+    Welch welchRef;
+    EXPECT_NO_THROW(welchRef.initialize(parameters, samplingRate));
+    std::vector<double> psdRef(nFrequencies);
+    auto psdRefPtr = psdRef.data();
+    std::vector<std::complex<double>> s00(nFrequencies);
+    std::vector<std::complex<double>> s01(nFrequencies);
+    std::vector<std::complex<double>> s10(nFrequencies);
+    auto s00Ptr = s00.data();
+    auto s01Ptr = s01.data();
+    auto s10Ptr = s10.data();
+    EXPECT_NO_THROW(welchRef.transform(nSamples, x.data()));
+    EXPECT_NO_THROW(welchRef.getPowerSpectralDensity(nFrequencies,
+                                                     &psdRefPtr));
+    EXPECT_NO_THROW(welch.getCrossSpectralDensity(0, 0, nFrequencies,
+                                                  &s00Ptr));
+    EXPECT_NO_THROW(welch.getCrossSpectralDensity(0, 1, nFrequencies,
+                                                  &s01Ptr));
+    EXPECT_NO_THROW(welch.getCrossSpectralDensity(1, 0, nFrequencies,
+                                                  &s10Ptr));
+    auto pmax = *std::max_element(psdRef.begin(), psdRef.end());
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        EXPECT_NEAR(s00[k].real(), psdRef[k], 1.e-10*pmax);
+        EXPECT_NEAR(s00[k].imag(), 0, 1.e-10*pmax);
+        // The second channel is twice the first
+        EXPECT_NEAR(std::abs(s01[k] - 2*psdRef[k]), 0, 1.e-10*pmax);
+        EXPECT_NEAR(std::abs(s10[k] - std::conj(s01[k])), 0, 1.e-10*pmax);
+    }
+    // Coherence
+    std::vector<double> coh01(nFrequencies);
+    std::vector<double> coh02(nFrequencies);
+    auto coh01Ptr = coh01.data();
+    auto coh02Ptr = coh02.data();
+    EXPECT_NO_THROW(welch.getCoherence(0, 1, nFrequencies, &coh01Ptr));
+    EXPECT_NO_THROW(welch.getCoherence(0, 2, nFrequencies, &coh02Ptr));
+    double cohMin = 1;
+    for (int k=0; k<nFrequencies; ++k)
+    {
+        if (psdRef[k] > 1.e-8*pmax){EXPECT_NEAR(coh01[k], 1, 1.e-8);}
+        EXPECT_GE(coh02[k], 0);
+        EXPECT_LE(coh02[k], 1);
+        cohMin = std::min(cohMin, coh02[k]);
+    }
+    EXPECT_LT(cohMin, 0.5);
+    // The coherence is symmetric
+    std::vector<double> coh20(nFrequencies);
+    auto coh20Ptr = coh20.data();
+    EXPECT_NO_THROW(welch.getCoherence(2, 0, nFrequencies, &coh20Ptr));
+    EXPECT_TRUE(std::equal(coh02.begin(), coh02.end(), coh20.begin()));
+    // The matrix is Hermitian and consistent with the pairwise spectra
+    std::vector<std::complex<double>> csd(nChannels*nChannels);
+    auto csdPtr = csd.data();
+    std::vector<std::complex<double>> sij(nFrequencies);
+    auto sijPtr = sij.data();
+    const int iFrequency = 19;
+    EXPECT_NO_THROW(welch.getCrossSpectralDensityMatrix(iFrequency, nChannels,
+                                                        &csdPtr));
+    for (int i=0; i<nChannels; ++i)
+    {
+        for (int j=0; j<nChannels; ++j)
+        {
+            EXPECT_NO_THROW(welch.getCrossSpectralDensity(i, j, nFrequencies,
+                                                          &sijPtr));
+            EXPECT_NEAR(std::abs(csd[i*nChannels + j] - sij[iFrequency]),
+                        0, 1.e-14*pmax);
+        }
+    }
+    EXPECT_THROW(welch.getCrossSpectralDensity(0, nChannels, nFrequencies,
+                                               &sijPtr),
+                 std::invalid_argument);
+}
+
 TEST(UtilitiesTransforms, CWT)
 {
     // Read the signal and answer
@@ -1154,6 +1801,231 @@ TEST(UtilitiesTransforms, CWT)
 */
 }
 
+TEST(UtilitiesTransforms, CWTRicker)
+{
+    // Compare against a direct correlation with the time domain wavelet
+    const int nSamples = 301;
+    const double samplingRate = 40;
+    const double dt = 1/samplingRate;
+    std::vector<double> x(nSamples);
+    for (int i=0; i<nSamples; ++i)
+    {
+        x[i] = std::sin(0.13*i) + 0.5*std::cos(0.61*i) + 0.01*(i%7);
+    }
+    std::vector<double> scales({4, 7.5, 12, 20, 30});
+    auto nScales = static_cast<int> (scales.size());
+    Wavelets::Ricker ricker;
+    ContinuousWavelet<double> cwt;
+    EXPECT_NO_THROW(cwt.initialize(nSamples, nScales, scales.data(),
+                                   ricker, samplingRate));
+    EXPECT_NO_THROW(cwt.transform(nSamples, x.data()));
+    std::vector<std::complex<double>> cwtOut(nSamples*nScales);
+    auto cwtPtr = cwtOut.data();
+    EXPECT_NO_THROW(cwt.getTransform(nSamples, nScales, &cwtPtr));
+    // The wavelet must span every lag, -(n-1) to n-1
+    int nw = 2*nSamples - 1;
+    std::vector<std::complex<double>> w(nw);
+    double emax = 0;
+    double amax = 0;
+    for (int j=0; j<nScales; ++j)
+    {
+        auto wPtr = w.data();
+        ricker.evaluate(nw, scales[j], &wPtr);
+        auto xnorm = dt/std::sqrt(scales[j]);
+        for (int i=0; i<nSamples; ++i)
+        {
+            std::complex<double> ref(0, 0);
+            for (int k=0; k<nSamples; ++k)
+            {
+                ref = ref + x[k]*std::conj(w[k - i + nSamples - 1]);
+            }
+            ref = xnorm*ref;
+            emax = std::max(emax, std::abs(ref - cwtOut[j*nSamples + i]));
+            amax = std::max(amax, std::abs(ref));
+        }
+    }
+    EXPECT_NEAR(emax/amax, 0, 1.e-10);
+    EXPECT_THROW(cwt.initialize(nSamples, 1, std::vector<double>{-1}.data(),
+                                ricker, samplingRate),
+                 std::invalid_argument);
+}
+
+TEST(UtilitiesTransforms, RealTimeCWT)
+{
+    const int nSamples = 801;
+    const double samplingRate = 100;
+    std::vector<double> x(nSamples);
+    for (int i=0; i<nSamples; ++i)
+    {
+        x[i] = std::sin(0.21*i) + 0.3*std::cos(0.05*i*(1 + 0.001*i));
+    }
+    std::vector<double> scales({5, 10, 20});
+    auto nScales = static_cast<int> (scales.size());
+    Wavelets::Morlet morlet;
+    ContinuousWavelet<double> cwt;
+    EXPECT_NO_THROW(cwt.initialize(nSamples, nScales, scales.data(),
+                                   morlet, samplingRate));
+    EXPECT_EQ(cwt.getLatency(), 0);
+    EXPECT_NO_THROW(cwt.transform(nSamples, x.data()));
+    std::vector<std::complex<double>> cwtRef(nSamples*nScales);
+    auto cwtPtr = cwtRef.data();
+    EXPECT_NO_THROW(cwt.getTransform(nSamples, nScales, &cwtPtr));
+    // Stream the signal in variable length packets
+    const int maxPacket = 64;
+    ContinuousWavelet<double> cwtRT;
+    EXPECT_NO_THROW(cwtRT.initialize(maxPacket, nScales, scales.data(),
+                                     morlet, samplingRate,
+                                     RTSeis::ProcessingMode::REAL_TIME));
+    EXPECT_EQ(cwtRT.getProcessingMode(), RTSeis::ProcessingMode::REAL_TIME);
+    auto latency = cwtRT.getLatency();
+    EXPECT_GT(latency, 0);
+    EXPECT_LT(latency, 10*20);
+    std::vector<std::vector<std::complex<double>>> rows(nScales);
+    std::vector<std::complex<double>> packet(maxPacket*nScales);
+    int i1 = 0;
+    int iPacket = 0;
+    while (i1 < nSamples)
+    {
+        auto nx = std::min(nSamples - i1, 1 + (17*iPacket)%maxPacket);
+        EXPECT_NO_THROW(cwtRT.transform(nx, x.data() + i1));
+        auto nNew = cwtRT.getNumberOfNewColumns();
+        EXPECT_LE(nNew, nx);
+        if (nNew > 0)
+        {
+            auto pPtr = packet.data();
+            EXPECT_NO_THROW(cwtRT.getTransform(nNew, nScales, &pPtr));
+            for (int j=0; j<nScales; ++j)
+            {
+                rows[j].insert(rows[j].end(), packet.data() + j*nNew,
+                               packet.data() + (j + 1)*nNew);
+            }
+        }
+        i1 = i1 + nx;
+        iPacket = iPacket + 1;
+    }
+    EXPECT_THROW(cwtRT.transform(maxPacket + 1, x.data()),
+                 std::invalid_argument);
+    // Every column whose support was received should match
+    double emax = 0;
+    double amax = 0;
+    for (int j=0; j<nScales; ++j)
+    {
+        EXPECT_EQ(static_cast<int> (rows[j].size()), nSamples - latency);
+        for (int i=0; i<static_cast<int> (rows[j].size()); ++i)
+        {
+            emax = std::max(emax, std::abs(rows[j][i] - cwtRef[j*nSamples + i]));
+            amax = std::max(amax, std::abs(cwtRef[j*nSamples + i]));
+        }
+    }
+    EXPECT_LE(emax/amax, 1.e-6);
+    // A copy continues the stream and a reset starts a new one
+    ContinuousWavelet<double> cwtCopy(cwtRT);
+    EXPECT_EQ(cwtCopy.getLatency(), latency);
+    EXPECT_NO_THROW(cwtCopy.resetInitialConditions());
+    EXPECT_NO_THROW(cwtCopy.transform(maxPacket, x.data()));
+    EXPECT_EQ(cwtCopy.getNumberOfNewColumns(), std::max(0, maxPacket - latency));
+}
+
+TEST(UtilitiesTransforms, CWTStorage)
+{
+    const int nSamples = 601;
+    const double samplingRate = 100;
+    std::vector<double> x(nSamples);
+    for (int i=0; i<nSamples; ++i)
+    {
+        x[i] = std::sin(0.21*i) + 0.3*std::cos(0.05*i*(1 + 0.001*i));
+    }
+    std::vector<double> scales({5, 10, 20});
+    auto nScales = static_cast<int> (scales.size());
+    Wavelets::Morlet morlet;
+    ContinuousWavelet<double> cwt;
+    EXPECT_NO_THROW(cwt.initialize(nSamples, nScales, scales.data(),
+                                   morlet, samplingRate));
+    EXPECT_EQ(cwt.getStorage(), ContinuousWaveletStorage::COMPLEX);
+    EXPECT_NO_THROW(cwt.transform(nSamples, x.data()));
+    std::vector<std::complex<double>> cwtRef(nSamples*nScales);
+    auto cwtPtr = cwtRef.data();
+    EXPECT_NO_THROW(cwt.getTransform(nSamples, nScales, &cwtPtr));
+    // Amplitude and power storage
+    std::vector<double> amp(nSamples*nScales);
+    auto ampPtr = amp.data();
+    EXPECT_NO_THROW(cwt.setStorage(ContinuousWaveletStorage::AMPLITUDE));
+    EXPECT_NO_THROW(cwt.transform(nSamples, x.data()));
+    EXPECT_THROW(cwt.getTransform(nSamples, nScales, &cwtPtr),
+                 std::runtime_error);
+    EXPECT_NO_THROW(cwt.getAmplitudeTransform(nSamples, nScales, &ampPtr));
+    for (int i=0; i<nSamples*nScales; ++i)
+    {
+        EXPECT_NEAR(amp[i], std::abs(cwtRef[i]), 1.e-5*(1 + amp[i]));
+    }
+    EXPECT_NO_THROW(cwt.setStorage(ContinuousWaveletStorage::POWER));
+    EXPECT_NO_THROW(cwt.transform(nSamples, x.data()));
+    for (int j=0; j<nScales; ++j)
+    {
+        auto power = cwt.getPowerRowPointer(j);
+        for (int i=0; i<nSamples; ++i)
+        {
+            auto pRef = std::norm(cwtRef[j*nSamples + i]);
+            EXPECT_NEAR(power[i], pRef, 1.e-5*(1 + pRef));
+        }
+    }
+    // Decimated rows hold every D'th column
+    EXPECT_NO_THROW(cwt.setStorage(ContinuousWaveletStorage::COMPLEX, true));
+    EXPECT_NO_THROW(cwt.transform(nSamples, x.data()));
+    EXPECT_THROW(cwt.getTransform(nSamples, nScales, &cwtPtr),
+                 std::runtime_error);
+    EXPECT_GT(cwt.getDecimationFactor(nScales - 1), 1);
+    for (int j=0; j<nScales; ++j)
+    {
+        auto decimation = cwt.getDecimationFactor(j);
+        auto nColumns = cwt.getNumberOfColumns(j);
+        EXPECT_EQ(nColumns, (nSamples + decimation - 1)/decimation);
+        auto row = cwt.getTransformRowPointer(j);
+        for (int i=0; i<nColumns; ++i)
+        {
+            EXPECT_NEAR(std::abs(row[i] - cwtRef[j*nSamples + i*decimation]),
+                        0, 1.e-12);
+        }
+    }
+    // Stream through the callback without retaining anything
+    const int maxPacket = 50;
+    ContinuousWavelet<double> cwtRT;
+    EXPECT_NO_THROW(cwtRT.initialize(maxPacket, nScales, scales.data(),
+                                     morlet, samplingRate,
+                                     RTSeis::ProcessingMode::REAL_TIME));
+    EXPECT_NO_THROW(cwtRT.setStorage(ContinuousWaveletStorage::NONE, true));
+    std::vector<std::vector<std::complex<double>>> rows(nScales);
+    cwtRT.setRowCallback([&rows](const int iScale, const int nColumns,
+                                 const std::complex<double> row[])
+    {
+        rows[iScale].insert(rows[iScale].end(), row, row + nColumns);
+    });
+    for (int i1=0; i1<nSamples; i1=i1+maxPacket)
+    {
+        auto nx = std::min(maxPacket, nSamples - i1);
+        EXPECT_NO_THROW(cwtRT.transform(nx, x.data() + i1));
+    }
+    const std::complex<double> *rowPtr = nullptr;
+    EXPECT_THROW(rowPtr = cwtRT.getTransformRowPointer(0), std::runtime_error);
+    EXPECT_EQ(rowPtr, nullptr);
+    double emax = 0;
+    double amax = 0;
+    auto latency = cwtRT.getLatency();
+    for (int j=0; j<nScales; ++j)
+    {
+        auto decimation = cwtRT.getDecimationFactor(j);
+        auto nColumns = static_cast<int> (rows[j].size());
+        EXPECT_EQ(nColumns, (nSamples - latency + decimation - 1)/decimation);
+        for (int i=0; i<nColumns; ++i)
+        {
+            auto ref = cwtRef[j*nSamples + i*decimation];
+            emax = std::max(emax, std::abs(rows[j][i] - ref));
+            amax = std::max(amax, std::abs(ref));
+        }
+    }
+    EXPECT_LE(emax/amax, 1.e-6);
+}
+
 //============================================================================//
 //                              Private functions                             //
 //============================================================================//
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <ipps.h>
 #include "rtseis/utilities/trigger/waterLevel.hpp"
 #include <gtest/gtest.h>
@@ -56,4 +57,71 @@ fclose(fout);
 */
 }
 
+TEST(UtilitiesTrigger, realTimeWaterLevel)
+{
+    double triggerOn = 0.8;
+    double triggerOff = 0.2;
+    double dt = 0.01;
+    double freq = 1;
+    double tlen = 10;
+    auto len = static_cast<int> (tlen/dt) + 1;
+    std::vector<double> x(len);
+    for (int i=0; i<len; ++i)
+    {
+        x[i] = std::sin(2*M_PI*freq*dt*i);
+    }
+    // Reference windows
+    PostProcessing::WaterLevel<double> postTrigger;
+    EXPECT_NO_THROW(postTrigger.initialize(triggerOn, triggerOff));
+    EXPECT_NO_THROW(postTrigger.apply(x.size(), x.data()));
+    auto refWindows = postTrigger.getWindows();
+    // Process the signal in variable length packets
+    RealTime::WaterLevel<double> trigger;
+    EXPECT_NO_THROW(trigger.initialize(triggerOn, triggerOff, 64));
+    EXPECT_TRUE(trigger.isInitialized());
+    std::vector<int> packetSizes{1, 2, 3, 16, 64, 100, 7, 1000};
+    std::vector<RealTime::WaterLevelEvent> events;
+    std::vector<RealTime::WaterLevelEvent> packetEvents(64);
+    for (int job=0; job<2; ++job)
+    {
+        events.clear();
+        int i0 = 0;
+        int ip = 0;
+        while (i0 < len)
+        {
+            auto nSamples = std::min(len - i0,
+                                     packetSizes[ip%packetSizes.size()]);
+            EXPECT_NO_THROW(trigger.apply(nSamples, x.data() + i0));
+            EXPECT_EQ(trigger.getNumberOfDroppedEvents(), 0);
+            auto nEvents = trigger.getNumberOfEvents();
+            auto eventsPtr = packetEvents.data();
+            EXPECT_NO_THROW(trigger.getEvents(nEvents, &eventsPtr));
+            for (int i=0; i<nEvents; ++i){events.push_back(packetEvents[i]);}
+            i0 = i0 + nSamples;
+            ip = ip + 1;
+        }
+        EXPECT_EQ(events.size(), 2*refWindows.size());
+        for (int i=0; i<static_cast<int> (refWindows.size()); ++i)
+        {
+            EXPECT_TRUE(events[2*i].isOn);
+            EXPECT_FALSE(events[2*i+1].isOn);
+            EXPECT_EQ(events[2*i].sample, refWindows[i].first);
+            EXPECT_EQ(events[2*i+1].sample, refWindows[i].second);
+        }
+        // A window straddling the end of the signal remains open
+        EXPECT_NO_THROW(trigger.apply(1, &triggerOn));
+        EXPECT_EQ(trigger.getNumberOfEvents(), 1);
+        EXPECT_TRUE(trigger.isTriggered());
+        // Restart
+        EXPECT_NO_THROW(trigger.resetInitialConditions());
+        EXPECT_FALSE(trigger.isTriggered());
+    }
+    // Overflowing the event buffer
+    EXPECT_NO_THROW(trigger.initialize(triggerOn, triggerOff, 4));
+    EXPECT_NO_THROW(trigger.apply(len, x.data()));
+    EXPECT_EQ(trigger.getNumberOfEvents(), 4);
+    EXPECT_EQ(trigger.getNumberOfDroppedEvents(),
+              static_cast<int> (2*refWindows.size() - 4));
+}
+
 }